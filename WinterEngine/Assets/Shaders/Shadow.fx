@@ -4,6 +4,12 @@
 cbuffer Transform : register(b0)
 {
     matrix wvp;
+    bool useSkinning;
+}
+
+cbuffer BoneTransformBuffer : register(b4)
+{
+    matrix boneTransforms[256];
 }
 
 struct VS_INPUT
@@ -12,6 +18,8 @@ struct VS_INPUT
     float3 normal : NORMAL;
     float3 tangent : TANGENT;
     float2 texCoord : TEXCOORD;
+    int4 blendIndices : BLENDINDICES;
+    float4 blendWeights : BLENDWEIGHT;
 };
 
 struct VS_OUTPUT
@@ -22,8 +30,18 @@ struct VS_OUTPUT
 
 VS_OUTPUT VS(VS_INPUT input)
 {
+    float3 localPosition = input.position;
+    if (useSkinning)
+    {
+        matrix skin = boneTransforms[input.blendIndices.x] * input.blendWeights.x;
+        skin += boneTransforms[input.blendIndices.y] * input.blendWeights.y;
+        skin += boneTransforms[input.blendIndices.z] * input.blendWeights.z;
+        skin += boneTransforms[input.blendIndices.w] * input.blendWeights.w;
+        localPosition = mul(float4(localPosition, 1.0f), skin).xyz;
+    }
+
     VS_OUTPUT output;
-    output.position = mul(float4(input.position, 1.0f), wvp);
+    output.position = mul(float4(localPosition, 1.0f), wvp);
     output.lightNDCPosition = output.position; //mul(float4(input.position, 1.0f), wvp);
     return output;
 }
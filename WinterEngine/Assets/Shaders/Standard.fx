@@ -34,6 +34,12 @@ cbuffer SettingsBuffer : register(b3)
     bool useShadowMap;
     float bumpWeight;
     float depthBias;
+    bool useSkinning;
+}
+
+cbuffer BoneTransformBuffer : register(b4)
+{
+    matrix boneTransforms[256];
 }
 
 Texture2D diffuseMap : register(t0);
@@ -50,6 +56,8 @@ struct VS_INPUT
     float3 normal : NORMAL;
     float3 tangent : TANGENT;
 	float2 texCoord : TEXCOORD;
+    int4 blendIndices : BLENDINDICES;
+    float4 blendWeights : BLENDWEIGHT;
 };
 
 struct VS_OUTPUT
@@ -72,11 +80,24 @@ VS_OUTPUT VS(VS_INPUT input)
         float bumpColor = (2.0f * bumpMapColor.r) - 1.0f;
         localPosition += (input.normal * bumpColor * bumpWeight);
     }
+
+    float3 localNormal = input.normal;
+    float3 localTangent = input.tangent;
+    if (useSkinning)
+    {
+        matrix skin = boneTransforms[input.blendIndices.x] * input.blendWeights.x;
+        skin += boneTransforms[input.blendIndices.y] * input.blendWeights.y;
+        skin += boneTransforms[input.blendIndices.z] * input.blendWeights.z;
+        skin += boneTransforms[input.blendIndices.w] * input.blendWeights.w;
+        localPosition = mul(float4(localPosition, 1.0f), skin).xyz;
+        localNormal = mul(localNormal, (float3x3)skin);
+        localTangent = mul(localTangent, (float3x3)skin);
+    }
     
     VS_OUTPUT output;
     output.position = mul(float4(localPosition, 1.0f), wvp);
-    output.worldNormal = mul(input.normal, (float3x3)world);
-    output.worldTangent = mul(input.tangent, (float3x3)world);
+    output.worldNormal = mul(localNormal, (float3x3)world);
+    output.worldTangent = mul(localTangent, (float3x3)world);
     output.texCoord = input.texCoord;
     output.dirToLight = -lightDirection;
     output.dirToView = normalize(viewPosition - (mul(float4(localPosition, 1.0f), world).xyz));
@@ -31,6 +31,14 @@ cbuffer SettingsBuffer : register(b3)
     float blendThickness;
 }
 
+cbuffer GridBuffer : register(b4)
+{
+    uint gridColumns;
+    uint gridRows;
+    float tileCount;
+    int baseVertex;
+}
+
 Texture2D lowMap : register(t0);
 Texture2D highMap : register(t1);
 
@@ -38,10 +46,9 @@ SamplerState textureSampler : register(s0);
 
 struct VS_INPUT
 {
-    float3 position : POSITION;
-    float3 normal : NORMAL;
-    float3 tangent : TANGENT;
-	float2 texCoord : TEXCOORD;
+    float height : HEIGHT;
+    float2 packedNormal : PACKEDNORMAL;
+    uint vertexId : SV_VertexID;
 };
 
 struct VS_OUTPUT
@@ -55,16 +62,30 @@ struct VS_OUTPUT
     float4 worldPosition : TEXCOORD3;
 };
 
+// Same as VertexCompression::DecodeOctahedral
+float3 DecodeOctahedral(float2 encoded)
+{
+    float3 n = float3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+    float t = saturate(-n.z);
+    n.xy += (n.xy >= 0.0f) ? -t : t;
+    return normalize(n);
+}
+
 VS_OUTPUT VS(VS_INPUT input)
 {
-    float3 localPosition = input.position;
+    // Grid position from the vertex id, the index buffer of a chunk is relative to baseVertex
+    uint index = input.vertexId + baseVertex;
+    float2 grid = float2(index % gridColumns, index / gridColumns);
+    float3 localPosition = float3(grid.x, input.height, grid.y);
+    float3 normal = DecodeOctahedral(input.packedNormal);
+    float3 tangent = normalize(float3(normal.y, -normal.x, 0.0f));
     
     VS_OUTPUT output;
     output.position = mul(float4(localPosition, 1.0f), wvp);
     output.worldPosition = mul(float4(localPosition, 1.0f), world);
-    output.worldNormal = mul(input.normal, (float3x3)world);
-    output.worldTangent = mul(input.tangent, (float3x3)world);
-    output.texCoord = input.texCoord;
+    output.worldNormal = mul(normal, (float3x3)world);
+    output.worldTangent = mul(tangent, (float3x3)world);
+    output.texCoord = (grid / float2(gridColumns, gridRows)) * tileCount;
     output.dirToLight = -lightDirection;
     output.dirToView = normalize(viewPosition - (mul(float4(localPosition, 1.0f), world).xyz));
     return output;
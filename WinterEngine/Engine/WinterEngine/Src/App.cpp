@@ -29,12 +29,14 @@ void App::Run(const AppConfig& config)
 	);
 	ASSERT(myWindow.IsActive(), "Failed to create a window");
 	auto handle = myWindow.GetWindowHandle();
+	JobSystem::StaticInitialize();
 	GraphicsSystem::StaticInitialize(handle, false);
 	InputSystem::StaticInitialize(handle);
 	SimpleDraw::StaticInitialize(config.maxVertexCount);
 	DebugUI::StaticInitialize(handle, false, true);
 	TextureCache::StaticInitialize("../../Assets/Images/");
 	ModelCache::StaticInitialize();
+	TransformSystem::StaticInitialize();
 	
 
 	ASSERT(mCurrentState != nullptr, "App: need an app state");
@@ -59,8 +61,12 @@ void App::Run(const AppConfig& config)
 			mCurrentState = std::exchange(mNextState, nullptr);
 			mCurrentState->Initialize();
 		}
+		TextureCache::Get()->Update();
+		ModelCache::Get()->Update();
+
 		float deltaTime = TimeUtil::GetDeltaTime();
 		mCurrentState->Update(deltaTime);
+		TransformSystem::Get()->Update();
 		GraphicsSystem* gs = GraphicsSystem::Get();
 		gs->BeginRender();
 			mCurrentState->Render();
@@ -72,8 +78,11 @@ void App::Run(const AppConfig& config)
 
 	mCurrentState->Terminate();
 
+	// Finish in flight loads before the caches they report to go away
+	JobSystem::StaticTerminate();
 	ModelCache::StaticTerminate();
 	TextureCache::StaticTerminate();
+	TransformSystem::StaticTerminate();
 	SimpleDraw::StaticTerminate();
 	DebugUI::StaticTerminate();
 	InputSystem::StaticTerminate();
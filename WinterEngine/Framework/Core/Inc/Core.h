@@ -2,6 +2,8 @@
 
 #include "Common.h"
 #include "DebugUtil.h"
+#include "JobSystem.h"
+#include "MappedFile.h"
 #include "TimeUtil.h"
 #include "Window.h"
 #include "WindowMessageHandler.h"
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+namespace WinterEngine::Core
+{
+	// Fixed pool of worker threads. Submit is fire and forget, ParallelFor
+	// splits a range into batches and blocks until every batch has run.
+	class JobSystem final
+	{
+	public:
+		using Job = std::function<void()>;
+		using RangeJob = std::function<void(uint32_t begin, uint32_t end)>;
+
+		// threadCount 0 = one worker per hardware thread minus the main thread
+		static void StaticInitialize(uint32_t threadCount = 0);
+		static void StaticTerminate();
+		static JobSystem* Get();
+
+		JobSystem() = default;
+		~JobSystem();
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem(const JobSystem&&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&&) = delete;
+
+		void Initialize(uint32_t threadCount);
+		void Terminate();
+
+		void Submit(Job job);
+		void ParallelFor(uint32_t count, uint32_t batchSize, const RangeJob& job);
+
+		uint32_t GetThreadCount() const;
+
+	private:
+		void WorkerLoop();
+
+		std::vector<std::thread> mWorkers;
+		std::deque<Job> mJobs;
+		std::mutex mMutex;
+		std::condition_variable mCondition;
+		bool mRunning = false;
+	};
+}
\ No newline at end of file
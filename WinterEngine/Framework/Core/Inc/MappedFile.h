@@ -0,0 +1,31 @@
+#pragma once
+
+namespace WinterEngine::Core
+{
+	// Read only view of a file mapped into the address space. The data
+	// stays valid until Terminate is called or the object is destroyed.
+	class MappedFile final
+	{
+	public:
+		MappedFile() = default;
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile(MappedFile&& rhs) noexcept;
+		MappedFile& operator=(MappedFile&& rhs) noexcept;
+
+		bool Initialize(const std::filesystem::path& filePath);
+		void Terminate();
+
+		bool IsValid() const { return mData != nullptr; }
+		const uint8_t* GetData() const { return mData; }
+		size_t GetSize() const { return mSize; }
+
+	private:
+		HANDLE mFile = INVALID_HANDLE_VALUE;
+		HANDLE mMapping = nullptr;
+		const uint8_t* mData = nullptr;
+		size_t mSize = 0;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,159 @@
+#include "Precompile.h"
+#include "JobSystem.h"
+
+#include "DebugUtil.h"
+
+using namespace WinterEngine::Core;
+
+namespace
+{
+	std::unique_ptr<JobSystem> sJobSystem;
+
+	struct ParallelForState
+	{
+		const JobSystem::RangeJob* job = nullptr;
+		uint32_t count = 0;
+		uint32_t batchSize = 0;
+		uint32_t batchCount = 0;
+		std::atomic<uint32_t> nextBatch = 0;
+		std::atomic<uint32_t> batchesDone = 0;
+	};
+
+	void RunBatches(ParallelForState& state)
+	{
+		uint32_t batch = state.nextBatch.fetch_add(1);
+		while (batch < state.batchCount)
+		{
+			const uint32_t begin = batch * state.batchSize;
+			const uint32_t end = std::min(begin + state.batchSize, state.count);
+			(*state.job)(begin, end);
+			state.batchesDone.fetch_add(1);
+			batch = state.nextBatch.fetch_add(1);
+		}
+	}
+}
+
+void JobSystem::StaticInitialize(uint32_t threadCount)
+{
+	ASSERT(sJobSystem == nullptr, "JobSystem: is already initialized");
+	if (threadCount == 0)
+	{
+		const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+		threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+	}
+	sJobSystem = std::make_unique<JobSystem>();
+	sJobSystem->Initialize(threadCount);
+}
+
+void JobSystem::StaticTerminate()
+{
+	if (sJobSystem != nullptr)
+	{
+		sJobSystem->Terminate();
+		sJobSystem.reset();
+	}
+}
+
+JobSystem* JobSystem::Get()
+{
+	ASSERT(sJobSystem != nullptr, "JobSystem: is not initialized");
+	return sJobSystem.get();
+}
+
+JobSystem::~JobSystem()
+{
+	ASSERT(mWorkers.empty(), "JobSystem: must be terminated");
+}
+
+void JobSystem::Initialize(uint32_t threadCount)
+{
+	mRunning = true;
+	mWorkers.reserve(threadCount);
+	for (uint32_t i = 0; i < threadCount; ++i)
+	{
+		mWorkers.emplace_back(&JobSystem::WorkerLoop, this);
+	}
+}
+
+void JobSystem::Terminate()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mRunning = false;
+	}
+	mCondition.notify_all();
+	for (std::thread& worker : mWorkers)
+	{
+		worker.join();
+	}
+	mWorkers.clear();
+}
+
+void JobSystem::Submit(Job job)
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mJobs.push_back(std::move(job));
+	}
+	mCondition.notify_one();
+}
+
+void JobSystem::ParallelFor(uint32_t count, uint32_t batchSize, const RangeJob& job)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	batchSize = std::max(batchSize, 1u);
+	const uint32_t batchCount = (count + batchSize - 1) / batchSize;
+	if (batchCount == 1 || mWorkers.empty())
+	{
+		job(0, count);
+		return;
+	}
+
+	// Helpers that start after every batch is claimed exit without touching job,
+	// the shared state keeps the counters alive until the last one returns.
+	auto state = std::make_shared<ParallelForState>();
+	state->job = &job;
+	state->count = count;
+	state->batchSize = batchSize;
+	state->batchCount = batchCount;
+
+	const uint32_t helperCount = std::min(batchCount - 1, GetThreadCount());
+	for (uint32_t i = 0; i < helperCount; ++i)
+	{
+		Submit([state]() { RunBatches(*state); });
+	}
+
+	RunBatches(*state);
+	while (state->batchesDone.load() < batchCount)
+	{
+		std::this_thread::yield();
+	}
+}
+
+uint32_t JobSystem::GetThreadCount() const
+{
+	return static_cast<uint32_t>(mWorkers.size());
+}
+
+void JobSystem::WorkerLoop()
+{
+	while (true)
+	{
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mCondition.wait(lock, [this]() { return !mRunning || !mJobs.empty(); });
+			if (mJobs.empty())
+			{
+				return;
+			}
+			job = std::move(mJobs.front());
+			mJobs.pop_front();
+		}
+		job();
+	}
+}
\ No newline at end of file
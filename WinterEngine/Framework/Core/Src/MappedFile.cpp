@@ -0,0 +1,85 @@
+#include "Precompile.h"
+#include "MappedFile.h"
+
+using namespace WinterEngine::Core;
+
+MappedFile::~MappedFile()
+{
+	Terminate();
+}
+
+MappedFile::MappedFile(MappedFile&& rhs) noexcept
+	: mFile(std::exchange(rhs.mFile, INVALID_HANDLE_VALUE))
+	, mMapping(std::exchange(rhs.mMapping, nullptr))
+	, mData(std::exchange(rhs.mData, nullptr))
+	, mSize(std::exchange(rhs.mSize, 0))
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& rhs) noexcept
+{
+	if (this != &rhs)
+	{
+		Terminate();
+		mFile = std::exchange(rhs.mFile, INVALID_HANDLE_VALUE);
+		mMapping = std::exchange(rhs.mMapping, nullptr);
+		mData = std::exchange(rhs.mData, nullptr);
+		mSize = std::exchange(rhs.mSize, 0);
+	}
+	return *this;
+}
+
+bool MappedFile::Initialize(const std::filesystem::path& filePath)
+{
+	Terminate();
+
+	mFile = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (mFile == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize = {};
+	if (!GetFileSizeEx(mFile, &fileSize) || fileSize.QuadPart == 0)
+	{
+		Terminate();
+		return false;
+	}
+
+	mMapping = CreateFileMappingW(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mMapping == nullptr)
+	{
+		Terminate();
+		return false;
+	}
+
+	mData = static_cast<const uint8_t*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+	if (mData == nullptr)
+	{
+		Terminate();
+		return false;
+	}
+
+	mSize = static_cast<size_t>(fileSize.QuadPart);
+	return true;
+}
+
+void MappedFile::Terminate()
+{
+	if (mData != nullptr)
+	{
+		UnmapViewOfFile(mData);
+		mData = nullptr;
+	}
+	if (mMapping != nullptr)
+	{
+		CloseHandle(mMapping);
+		mMapping = nullptr;
+	}
+	if (mFile != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(mFile);
+		mFile = INVALID_HANDLE_VALUE;
+	}
+	mSize = 0;
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Common.h"
+
+namespace WinterEngine::Graphics
+{
+	// Key times are kept apart from the values so seeking only walks a float array
+	template<class T>
+	struct Keyframes
+	{
+		std::vector<float> times;	// seconds, ascending
+		std::vector<T> values;
+
+		bool empty() const { return times.empty(); }
+		uint32_t size() const { return static_cast<uint32_t>(times.size()); }
+	};
+
+	// Channels left empty keep the bone's bind pose value
+	struct BoneAnimation
+	{
+		Keyframes<Math::Vector3> positionKeys;
+		Keyframes<Math::Quaternion> rotationKeys;
+		Keyframes<Math::Vector3> scaleKeys;
+
+		bool empty() const { return positionKeys.empty() && rotationKeys.empty() && scaleKeys.empty(); }
+	};
+
+	struct AnimationClip
+	{
+		std::string name;
+		float duration = 0.0f;	// seconds
+		std::vector<BoneAnimation> boneAnimations;	// indexed by bone, same size as the skeleton
+	};
+}
\ No newline at end of file
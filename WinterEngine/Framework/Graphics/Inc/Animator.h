@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Animation.h"
+#include "ModelCache.h"
+
+namespace WinterEngine::Graphics
+{
+	// Plays the clips of one skinned model instance. Update advances time, samples the keys
+	// into a local pose, cross-fades with the previous clip while a blend is running and
+	// rebuilds the skinning palette. Each channel remembers the key it used last frame, so
+	// normal playback steps forward a key or two instead of searching.
+	class Animator final
+	{
+	public:
+		// Animators only touch their own state, so many characters can be split across the JobSystem
+		static void UpdateAll(Animator* const* animators, uint32_t count, float deltaTime);
+
+		void Initialize(ModelId modelId);
+		void Initialize(const Model& model);
+		void Terminate();
+
+		// Fades out whatever is playing over blendDuration seconds, 0 switches straight away
+		void PlayClip(uint32_t clipIndex, bool looping, float blendDuration = 0.0f);
+		void Stop();
+		void Update(float deltaTime);
+
+		bool IsPlaying() const;
+		bool IsFinished() const;
+		uint32_t GetClipCount() const;
+		const AnimationClip* GetClip(uint32_t clipIndex) const;
+		uint32_t GetBoneCount() const;
+
+		// Valid after Update. Bone transforms are model space, skin transforms are
+		// offset * bone transform and go straight into the vertex shader palette
+		const std::vector<Math::Matrix4>& GetBoneTransforms() const { return mBoneTransforms; }
+		const std::vector<Math::Matrix4>& GetSkinTransforms() const { return mSkinTransforms; }
+		// Goes up every time the palette is rebuilt, lets consumers skip work when the pose is unchanged
+		uint32_t GetPoseVersion() const { return mPoseVersion; }
+
+		float playbackSpeed = 1.0f;
+
+	private:
+		struct KeyCursor
+		{
+			uint32_t position = 0;
+			uint32_t rotation = 0;
+			uint32_t scale = 0;
+		};
+
+		// Local bone transforms, one entry per bone
+		struct Pose
+		{
+			std::vector<Math::Vector3> positions;
+			std::vector<Math::Quaternion> rotations;
+			std::vector<Math::Vector3> scales;
+		};
+
+		struct Layer
+		{
+			const AnimationClip* clip = nullptr;
+			float time = 0.0f;
+			bool looping = false;
+			std::vector<KeyCursor> cursors;
+		};
+
+		void StartLayer(Layer& layer, uint32_t clipIndex, bool looping);
+		void AdvanceLayer(Layer& layer, float deltaTime);
+		void SampleLayer(Layer& layer, Pose& pose);
+		void BuildPalette();
+
+		const Model* mModel = nullptr;
+		Pose mBindPose;
+		Pose mPose;
+		Pose mBlendPose;
+		Layer mCurrent;
+		Layer mPrevious;	// fading out while mBlendTime < mBlendDuration
+		float mBlendTime = 0.0f;
+		float mBlendDuration = 0.0f;
+
+		std::vector<Math::Matrix4> mBoneTransforms;
+		std::vector<Math::Matrix4> mSkinTransforms;
+		uint32_t mPoseVersion = 0;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+
+// Pieces SceneBVH and MeshBVH build and traverse their trees with
+namespace WinterEngine::Graphics::BVHUtil
+{
+	// Box and centroid of one primitive while a tree is built, index says which primitive
+	struct BuildEntry
+	{
+		Math::AABB aabb;
+		Math::Vector3 centroid;
+		uint32_t index;
+	};
+
+	// Binned SAH: centroids drop into bins along each axis, every plane between two bins is
+	// scored as leftArea * leftCount + rightArea * rightCount and the cheapest one wins. The
+	// entries are reordered left side first and the left count returned. splitCost is that
+	// score, FLT_MAX when all centroids sit in one spot and the range is just halved
+	uint32_t PartitionBinnedSAH(BuildEntry* entries, uint32_t count, float& splitCost);
+
+	// Ray cast stacks keep the entry distance of a waiting node next to its index, so the node
+	// can be dropped once a closer hit turns up
+	inline uint32_t FloatBits(float value)
+	{
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+
+	inline float BitsFloat(uint32_t bits)
+	{
+		float value;
+		memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+}
\ No newline at end of file
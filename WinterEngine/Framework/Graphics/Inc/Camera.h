@@ -50,6 +50,12 @@ namespace WinterEngine::Graphics
 		Math::Matrix4 GetPerspectiveMatrix() const;
 		Math::Matrix4 GetOrthographicMatrix() const;
 
+		// World space planes of the view volume, for either projection mode
+		Math::Frustum GetFrustum() const;
+
+		// Fraction of the viewport height covered by a sphere, 1 when the camera is inside it
+		float GetScreenSize(const Math::Vector3& center, float radius) const;
+
 	private:
 		ProjectionMode mProjectionMode = ProjectionMode::Perspective;
 
@@ -17,6 +17,7 @@ namespace WinterEngine::Graphics
 
 	private:
 		ID3D11Buffer* mConstantBuffer = nullptr;
+		uint32_t mBufferSize = 0;
 	};
 
 	template<class DataType>
@@ -0,0 +1,70 @@
+#pragma once
+
+namespace WinterEngine::Graphics
+{
+	class Animator;
+	class Camera;
+	class RenderObject;
+	class RenderGroup;
+
+	// Frustum culling in front of the effects. Add everything that may be drawn, Cull against
+	// the camera of a pass, then hand the pass to the effect so it only draws what survived.
+	// Groups are tested as a whole first, the render objects of a visible group are tested
+	// again one by one. Objects without bounds are never culled. A group added with its
+	// animator is tested on its bind-pose box grown to hold the posed bones plus the padding,
+	// and draws all of its render objects skinned when visible.
+	class CullingPass final
+	{
+	public:
+		struct VisibleGroup
+		{
+			const RenderGroup* renderGroup = nullptr;
+			const Animator* animator = nullptr;
+			const uint8_t* objectMask = nullptr;	// 1 per render object that is visible
+		};
+
+		struct Stats
+		{
+			uint32_t testedObjects = 0;	// standalone objects plus the render objects of every group
+			uint32_t visibleObjects = 0;
+			uint32_t testedGroups = 0;
+			uint32_t visibleGroups = 0;
+			float cullTime = 0.0f;	// milliseconds
+		};
+
+		void Clear();
+		void Add(const RenderObject& renderObject);
+		void Add(const RenderGroup& renderGroup);
+		// Padding covers the mesh around the outermost bones, model space units
+		void Add(const RenderGroup& renderGroup, const Animator& animator, float padding = 0.0f);
+
+		// Rebuilds the visible lists, the objects added must still be alive
+		void Cull(const Camera& camera);
+		void Cull(const Math::Frustum& frustum);
+
+		const std::vector<const RenderObject*>& GetVisibleObjects() const { return mVisibleObjects; }
+		const std::vector<VisibleGroup>& GetVisibleGroups() const { return mVisibleGroups; }
+		const Stats& GetStats() const { return mStats; }
+
+		void DebugUI(const char* name);
+
+	private:
+		std::vector<const RenderObject*> mRenderObjects;
+		struct GroupEntry
+		{
+			const RenderGroup* renderGroup = nullptr;
+			const Animator* animator = nullptr;
+			float padding = 0.0f;
+		};
+
+		std::vector<GroupEntry> mRenderGroups;
+
+		std::vector<Math::AABB> mBoxes;
+		std::vector<uint8_t> mVisible;
+		std::vector<uint8_t> mObjectMasks;
+
+		std::vector<const RenderObject*> mVisibleObjects;
+		std::vector<VisibleGroup> mVisibleGroups;
+		Stats mStats;
+	};
+}
\ No newline at end of file
@@ -5,11 +5,17 @@
 #include "GraphicsSystem.h"
 #include "Colors.h"
 #include "VertexTypes.h"
+#include "VertexCompression.h"
 #include "MeshTypes.h"
+#include "MeshOptimizer.h"
 #include "MeshBuffer.h"
 #include "VertexShader.h"
 #include "PixelShader.h"
 #include "Camera.h"
+#include "CullingPass.h"
+#include "BVHUtil.h"
+#include "SceneBVH.h"
+#include "MeshBVH.h"
 #include "ConstantBuffer.h"
 #include "MeshBuilder.h"
 #include "Texture.h"
@@ -20,10 +26,17 @@
 #include "RenderTarget.h"
 #include "RenderObject.h"
 #include "Transform.h"
+#include "TransformSystem.h"
 #include "StandardEffect.h"
+#include "LoadState.h"
 #include "TextureCache.h"
 #include "DirectionalLight.h"
 #include "Material.h"
+#include "Skeleton.h"
+#include "Animation.h"
+#include "Animator.h"
+#include "Skinning.h"
+#include "SkinnedMesh.h"
 #include "Model.h"
 #include "ModelIO.h"
 #include "ModelCache.h"
@@ -31,5 +44,6 @@
 #include "GaussianBlurEffect.h"
 #include "Terrain.h"
 #include "TerrainEffect.h"
+#include "TerrainStreamer.h"
 #include "ShadowEffect.h"
 #include "PortalEffect.h"
\ No newline at end of file
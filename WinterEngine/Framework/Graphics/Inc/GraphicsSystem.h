@@ -4,10 +4,42 @@
 
 namespace WinterEngine::Graphics
 {
+	// Work submitted between two EndRender calls, recorded with or without a device
+	struct GraphicsStats
+	{
+		uint32_t drawCalls = 0;
+		uint32_t verticesSubmitted = 0;
+		uint32_t stateChanges = 0;
+		uint32_t resourcesCreated = 0;
+		uint64_t bytesUploaded = 0;
+		float renderTime = 0.0f;
+	};
+
+	// Pipeline slots the resource wrappers bind to, see GraphicsSystem::RecordBind
+	enum class BindPoint : uint32_t
+	{
+		RenderTarget,
+		Viewport,
+		VertexShader,
+		PixelShader,
+		BlendState,
+		MeshBuffer,	// vertex/index buffer and topology
+		VSConstantBuffer,
+		PSConstantBuffer,
+		VSSampler,
+		PSSampler,
+		VSTexture,
+		PSTexture,
+		Count
+	};
+
 	class GraphicsSystem final
 	{
 	public:
 		static void StaticInitialize(HWND window, bool fullscreen);
+		// No device or swap chain, resource wrappers only record what they would have submitted.
+		// Still built against the D3D11 headers, this takes the GPU out of the frame, not Windows
+		static void StaticInitializeHeadless(uint32_t width, uint32_t height);
 		static void StaticTerminate();
 		static GraphicsSystem* Get();
 
@@ -20,6 +52,7 @@ namespace WinterEngine::Graphics
 		GraphicsSystem& operator=(const GraphicsSystem&&) = delete;
 
 		void Initialize(HWND window, bool fullscreen);
+		void InitializeHeadless(uint32_t width, uint32_t height);
 		void Terminate();
 
 		void BeginRender();
@@ -40,6 +73,22 @@ namespace WinterEngine::Graphics
 		float GetBackBufferAspectRatio() const;
 		ID3D11Device* GetDevice() { return mD3DDevice; }
 		ID3D11DeviceContext* GetContext() { return mImmediateContext; }
+		bool IsHeadless() const { return mHeadless; }
+
+		void RecordDraw(uint32_t vertexCount);
+		// Counts a state change only when object differs from what the slot last had bound. The
+		// slots start out unknown every BeginRender, so the first bind of a frame always counts
+		void RecordBind(BindPoint point, uint32_t slot, const void* object);
+		// Null when the slot is unbound or unknown
+		const void* GetBoundObject(BindPoint point, uint32_t slot) const;
+		void RecordUpload(size_t byteCount);
+		void RecordResourceCreated(size_t byteCount);
+
+		// Totals for the last completed frame
+		const GraphicsStats& GetFrameStats() const { return mLastFrameStats; }
+		void DebugUI();
+
+		static constexpr uint32_t MaxBindSlots = 16;
 
 	private:
 		static LRESULT CALLBACK GraphicsSystemMessageHandler(HWND window, UINT message, WPARAM wParam, LPARAM lparam);
@@ -58,5 +107,17 @@ namespace WinterEngine::Graphics
 
 		Color mClearColor = Colors::Black;
 		UINT mVSync = 1;
+
+		struct Binding
+		{
+			const void* object = nullptr;
+			bool known = false;
+		};
+
+		Binding mBindings[static_cast<uint32_t>(BindPoint::Count)][MaxBindSlots];
+		GraphicsStats mFrameStats;
+		GraphicsStats mLastFrameStats;
+		float mRenderStartTime = 0.0f;
+		bool mHeadless = false;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,12 @@
+#pragma once
+
+namespace WinterEngine::Graphics
+{
+	// Status of a resource requested through one of the async cache calls
+	enum class LoadState
+	{
+		Pending,
+		Ready,
+		Failed
+	};
+}
\ No newline at end of file
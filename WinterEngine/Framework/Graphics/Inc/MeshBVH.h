@@ -0,0 +1,65 @@
+#pragma once
+
+#include "BVHUtil.h"
+
+namespace WinterEngine::Graphics
+{
+	// Static bounding volume hierarchy over the triangles of one mesh, for ray casts against
+	// the actual surface (picking, line of sight). Built once with binned SAH, nodes are stored
+	// depth first with the left child right after its parent, and each triangle keeps a copy of
+	// its corners so a leaf test never goes back to the vertex buffer. Positions are in
+	// the mesh's local space, transform rays into it for instanced meshes.
+	class MeshBVH final
+	{
+	public:
+		struct RayHit
+		{
+			uint32_t triangle = UINT32_MAX;	// index of the first of the triangle's three indices / 3
+			float distance = FLT_MAX;
+			float u = 0.0f;	// barycentric weights of the second and third corners
+			float v = 0.0f;
+		};
+
+		// Stride is in bytes, so the positions of vertex structs can be passed directly
+		void Initialize(const Math::Vector3* positions, size_t stride, const uint32_t* indices, size_t indexCount);
+		template<class MeshType>
+		void Initialize(const MeshType& mesh)
+		{
+			const Math::Vector3* positions = mesh.vertices.empty() ? nullptr : &mesh.vertices[0].position;
+			Initialize(positions, sizeof(typename MeshType::VertexType), mesh.indices.data(), mesh.indices.size());
+		}
+		void Terminate();
+
+		// Closest triangle along the ray, either side counts
+		bool RayCast(const Math::Ray& ray, float maxDistance, RayHit& hit) const;
+		// Split across the JobSystem once there are enough rays, misses keep a default RayHit
+		void RayCasts(const Math::Ray* rays, size_t count, float maxDistance, RayHit* hits) const;
+
+		const Math::AABB& GetAABB() const;
+		uint32_t GetTriangleCount() const { return static_cast<uint32_t>(mTriangles.size()); }
+		uint32_t GetNodeCount() const { return static_cast<uint32_t>(mNodes.size()); }
+
+	private:
+		// Leaves have a triangle count, internal nodes keep their right child in first
+		struct Node
+		{
+			Math::AABB aabb;
+			uint32_t first = 0;
+			uint32_t count = 0;
+		};
+
+		struct Triangle
+		{
+			Math::Vector3 a;
+			Math::Vector3 b;
+			Math::Vector3 c;
+			uint32_t index;
+		};
+
+		void BuildNode(uint32_t nodeIndex, BVHUtil::BuildEntry* entries, uint32_t first, uint32_t count);
+		bool RayCast(const Math::Ray& ray, float maxDistance, RayHit& hit, std::vector<uint32_t>& stack) const;
+
+		std::vector<Node> mNodes;
+		std::vector<Triangle> mTriangles;
+	};
+}
\ No newline at end of file
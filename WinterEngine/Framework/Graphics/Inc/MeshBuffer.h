@@ -34,6 +34,8 @@ namespace WinterEngine::Graphics
 		void SetTopology(Topology topology);
 		void Update(const void* vertices, uint32_t vertexCount);
 		void Render() const;
+		// baseVertex is added to every index, for ranges that share indices between placements
+		void Render(uint32_t startIndex, uint32_t indexCount, int32_t baseVertex = 0) const;
 
 	private:
 		void CreateVertexBuffer(const void* vertices, uint32_t vertexSize, uint32_t vertexCount);
@@ -43,8 +45,8 @@ namespace WinterEngine::Graphics
 		ID3D11Buffer* mIndexBuffer = nullptr;
 		D3D11_PRIMITIVE_TOPOLOGY mTopology = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
 
-		uint32_t mVertexSize;
-		uint32_t mVertexCount;
-		uint32_t mIndexCount;
+		uint32_t mVertexSize = 0;
+		uint32_t mVertexCount = 0;
+		uint32_t mIndexCount = 0;
 	};
 }
\ No newline at end of file
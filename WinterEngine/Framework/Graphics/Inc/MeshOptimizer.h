@@ -0,0 +1,47 @@
+#pragma once
+
+#include "MeshTypes.h"
+
+namespace WinterEngine::Graphics
+{
+	namespace MeshOptimizer
+	{
+		// Post transform cache: average cache miss ratio (transformed vertices per triangle)
+		// and average transform to vertex ratio, using a FIFO cache of cacheSize entries
+		struct VertexCacheStats
+		{
+			float acmr = 0.0f;
+			float atvr = 0.0f;
+		};
+
+		// Pre transform fetch: bytes pulled through 64 byte cache lines relative to the vertex buffer size
+		struct VertexFetchStats
+		{
+			uint64_t bytesFetched = 0;
+			float overfetch = 0.0f;
+		};
+
+		VertexCacheStats AnalyzeVertexCache(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize = 16);
+		VertexFetchStats AnalyzeVertexFetch(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t vertexSize);
+
+		// Merges bitwise identical vertices and remaps the indices, returns the number of vertices removed
+		uint32_t WeldVertices(Mesh& mesh);
+
+		// Reorders triangles for post transform cache locality (Forsyth's linear speed optimizer)
+		void OptimizeVertexCache(Mesh& mesh);
+		void OptimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount);
+
+		// Reorders vertices into first use order for fetch locality, unreferenced vertices are dropped
+		void OptimizeVertexFetch(Mesh& mesh);
+
+		// Weld, then cache, then fetch
+		void Optimize(Mesh& mesh);
+
+		// Quadric error edge collapse. Vertices are never moved, so the result is an index list
+		// over mesh.vertices; open borders stay in place and UV/normal seams only collapse along
+		// themselves. Stops once the index count reaches targetIndexCount or the next collapse
+		// would exceed targetError, given relative to the mesh extent. outError receives the
+		// largest error accepted.
+		std::vector<uint32_t> Simplify(const Mesh& mesh, uint32_t targetIndexCount, float targetError = 1.0f, float* outError = nullptr);
+	}
+}
\ No newline at end of file
@@ -10,6 +10,17 @@ namespace WinterEngine::Graphics
 		using VertexType = VertexT;
 		std::vector<VertexType> vertices;
 		std::vector<uint32_t> indices;
+
+		// Local space, empty until ComputeBounds runs
+		Math::AABB aabb;
+		Math::Sphere boundingSphere;
+
+		void ComputeBounds()
+		{
+			const Math::Vector3* positions = vertices.empty() ? nullptr : &vertices[0].position;
+			aabb = Math::ComputeAABB(positions, sizeof(VertexType), vertices.size());
+			boundingSphere = Math::ComputeBoundingSphere(positions, sizeof(VertexType), vertices.size(), aabb);
+		}
 	};
 
 	using MeshP = MeshBase<VertexP>;
@@ -2,15 +2,25 @@
 
 #include "MeshTypes.h"
 #include "Material.h"
+#include "Skeleton.h"
+#include "Animation.h"
 
 namespace WinterEngine::Graphics
 {
 	struct Model
 	{
+		// Simplified index list over the same vertices as the full mesh
+		struct LOD
+		{
+			std::vector<uint32_t> indices;
+			float error = 0.0f;	// relative to the mesh extent
+		};
+
 		struct MeshData
 		{
 			Mesh mesh;
 			uint32_t materialIndex = 0;
+			std::vector<LOD> lods;	// coarser with each level, the full mesh is level 0
 		};
 
 		struct MaterialData
@@ -24,5 +34,7 @@ namespace WinterEngine::Graphics
 
 		std::vector<MeshData> meshData;
 		std::vector<MaterialData> materialData;
+		Skeleton skeleton;	// empty for static models
+		std::vector<AnimationClip> animationClips;
 	};
 }
\ No newline at end of file
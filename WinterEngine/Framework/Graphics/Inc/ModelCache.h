@@ -1,6 +1,8 @@
 #pragma once
 
+#include "LoadState.h"
 #include "Model.h"
+#include "ModelIO.h"
 
 namespace WinterEngine::Graphics
 {
@@ -25,8 +27,44 @@ namespace WinterEngine::Graphics
 		ModelId LoadModel(const std::filesystem::path& filePath);
 		const Model* GetModel(ModelId id);
 
+		// Streams the model in over several Update calls. GetModel returns the
+		// meshes read so far and callback fires once per finished mesh. A file
+		// that can't be opened is logged and its state is Failed.
+		using MeshLoadedCallback = ModelIO::ModelReader::MeshCallback;
+		ModelId LoadModelStreamed(const std::filesystem::path& filePath, MeshLoadedCallback callback = nullptr);
+
+		// Reads the whole model on a JobSystem worker, GetModel returns nullptr
+		// until Update has picked up the finished model.
+		ModelId LoadModelAsync(const std::filesystem::path& filePath);
+
+		LoadState GetLoadState(ModelId id) const;
+		bool IsModelLoaded(ModelId id) const;
+
+		// Collects finished async loads and reads up to meshBudget meshes
+		// across all pending streamed models, once per frame
+		void Update(uint32_t meshBudget = 1);
+
 	private:
+		struct PendingModel
+		{
+			std::unique_ptr<ModelIO::ModelReader> reader;
+			MeshLoadedCallback callback;
+		};
+
+		struct LoadedModel
+		{
+			ModelId id = 0;
+			std::unique_ptr<Model> model;
+		};
+
 		using Inventory = std::map<ModelId, std::unique_ptr<Model>>;
+		using PendingModels = std::map<ModelId, PendingModel>;
+		using LoadStates = std::map<ModelId, LoadState>;
 		Inventory mInventory;
+		PendingModels mPendingModels;
+		LoadStates mAsyncLoadStates;
+
+		std::mutex mLoadedMutex;
+		std::vector<LoadedModel> mLoadedModels;
 	};
 }
\ No newline at end of file
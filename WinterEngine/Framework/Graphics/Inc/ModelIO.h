@@ -1,15 +1,81 @@
 #pragma once
 
+#include "Model.h"
+
 namespace WinterEngine::Graphics
 {
-	struct Model;
-
 	namespace ModelIO
 	{
-		void SaveModel(std::filesystem::path filePath, const Model& model);
+		// Savers return false when there was nothing to save or the file could not be written
+		bool SaveModel(std::filesystem::path filePath, const Model& model);
 		void LoadModel(std::filesystem::path filePath, Model& model);
 
-		void SaveMaterial(std::filesystem::path filePath, const Model& model);
+		// Binary container (<name>.modelbin) holding raw vertex and index
+		// blobs, mapped and copied in bulk on load instead of parsed.
+		// Compact storage writes meshes as CompactVertex plus a CompactSkin stream
+		// for skinned meshes, both decoded back to Vertex on load.
+		enum class VertexStorage : uint32_t
+		{
+			Full,
+			Compact
+		};
+
+		struct BinaryReport
+		{
+			uint32_t meshCount = 0;
+			uint32_t compactMeshCount = 0;
+			uint64_t fullVertexBytes = 0;	// vertex bytes if every mesh was stored as Vertex
+			uint64_t storedVertexBytes = 0;	// vertex bytes actually written
+			uint64_t indexBytes = 0;
+			uint64_t fileBytes = 0;
+		};
+
+		BinaryReport SaveModelBinary(std::filesystem::path filePath, const Model& model, VertexStorage vertexStorage = VertexStorage::Full);
+		bool LoadModelBinary(std::filesystem::path filePath, Model& model);
+		std::filesystem::path GetBinaryModelPath(std::filesystem::path filePath);
+
+		// Reads a model one mesh at a time so the caller can spread the work
+		// over several frames. Uses the binary file when one exists.
+		class ModelReader final
+		{
+		public:
+			using MeshCallback = std::function<void(const Model::MeshData& meshData, uint32_t meshIndex, uint32_t meshCount)>;
+
+			ModelReader() = default;
+			~ModelReader();
+
+			ModelReader(const ModelReader&) = delete;
+			ModelReader& operator=(const ModelReader&) = delete;
+
+			bool Open(std::filesystem::path filePath);
+			void Close();
+
+			// Appends the next mesh to model.meshData, returns false once all meshes are read
+			bool ReadNextMesh(Model& model, const MeshCallback& callback = nullptr);
+
+			bool IsDone() const;
+			uint32_t GetMeshCount() const { return mMeshCount; }
+			uint32_t GetMeshesRead() const { return mMeshesRead; }
+
+		private:
+			Core::MappedFile mMappedFile;
+			FILE* mFile = nullptr;
+			uint32_t mMeshCount = 0;
+			uint32_t mMeshesRead = 0;
+		};
+
+		bool SaveMaterial(std::filesystem::path filePath, const Model& model);
 		void LoadMaterial(std::filesystem::path filePath, Model& model);
+
+		// <name>.skeleton, only written for models with bones
+		bool SaveSkeleton(std::filesystem::path filePath, const Model& model);
+		void LoadSkeleton(std::filesystem::path filePath, Model& model);
+
+		// <name>.animset, every clip of the model. Bones without keys are not written
+		bool SaveAnimations(std::filesystem::path filePath, const Model& model);
+		void LoadAnimations(std::filesystem::path filePath, Model& model);
+
+		// Checks every skinned vertex has weights summing to 1 and bone indices inside the skeleton
+		bool ValidateSkinWeights(const Model& model, float tolerance = 0.001f);
 	}
 }
\ No newline at end of file
@@ -74,6 +74,7 @@ namespace WinterEngine::Graphics
 		StandardEffect* mStandardEffect;
 
 		MeshPX mPortalMesh;
+		std::vector<Math::Vector3> mProjectedPositions;
 		const MeshPX* mLinkedPortalMesh;
 		RenderObject* mPortalObject;
 		const RenderObject* mLinkedPortalObject;
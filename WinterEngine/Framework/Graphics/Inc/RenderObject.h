@@ -4,25 +4,70 @@
 #include "TextureCache.h"
 #include "ModelCache.h"
 #include "Transform.h"
+#include "TransformSystem.h"
 #include "Material.h"
+#include "Model.h"
 
 namespace WinterEngine::Graphics
 {
-	struct Model;
+	class Camera;
+
+	// World space copy of a pair of local bounds. Transforming is deferred to the first
+	// query after the world matrix (or the local bounds) changed, so static objects pay once
+	class WorldBounds
+	{
+	public:
+		void Update(const Math::AABB& aabb, const Math::Sphere& sphere, const Math::Matrix4& world) const;
+
+		const Math::AABB& GetAABB() const { return mWorldAABB; }
+		const Math::Sphere& GetSphere() const { return mWorldSphere; }
+
+	private:
+		mutable Math::Matrix4 mWorld;
+		mutable Math::AABB mLocalAABB;
+		mutable Math::Sphere mLocalSphere;
+		mutable Math::AABB mWorldAABB;
+		mutable Math::Sphere mWorldSphere;
+		mutable bool mValid = false;
+	};
 
 	class RenderObject
 	{
 	public:
 		void Terminate();
 
+		// Draws the index range of the given LOD, clamped to the coarsest level available
+		void Render(uint32_t lodLevel = 0) const;
+
+		// Cached TransformSystem result when transformId is set, otherwise built from transform
+		Math::Matrix4 GetWorldMatrix() const;
+
+		// World space versions of aabb/boundingSphere, empty when the object has no bounds.
+		// Objects inside a RenderGroup are placed by the group, cull those with the group's matrix
+		const Math::AABB& GetWorldAABB() const;
+		const Math::Sphere& GetWorldSphere() const;
+
+		struct LODRange
+		{
+			uint32_t startIndex = 0;
+			uint32_t indexCount = 0;
+		};
+
 		Transform transform;
+		TransformId transformId = 0;
 		MeshBuffer meshBuffer;
+		std::vector<LODRange> lodRanges;	// empty when the mesh has no LODs
+		Math::AABB aabb;	// model space, filled in by RenderGroup, set by hand for other meshes
+		Math::Sphere boundingSphere;
 
 		Material material;
 		TextureId diffuseMapId;
 		TextureId normalMapId;
 		TextureId specMapId;
 		TextureId bumpMapId;
+
+	private:
+		WorldBounds mWorldBounds;
 	};
 
 	class RenderGroup
@@ -32,8 +77,37 @@ namespace WinterEngine::Graphics
 		void Initialize(const Model& model);
 		void Terminate();
 
+		// Streamed/async setup: the group draws whatever meshes have been read so far,
+		// call StreamMeshes each frame to pick up meshes the ModelCache finished.
+		void InitializeStreamed(const std::filesystem::path& modelFilePath);
+		void InitializeAsync(const std::filesystem::path& modelFilePath);
+		void StreamMeshes();
+		bool IsFullyLoaded() const;
+
+		// Level 0 while the group covers more than lodScreenSize of the viewport height,
+		// each further level starts at half the screen size of the previous one
+		uint32_t GetLODLevel(const Camera& camera) const;
+
+		// Cached TransformSystem result when transformId is set, otherwise built from transform
+		Math::Matrix4 GetWorldMatrix() const;
+
+		// Around every render object of the group
+		const Math::AABB& GetWorldAABB() const;
+		const Math::Sphere& GetWorldSphere() const;
+
 		ModelId modelId;
 		Transform transform;
+		TransformId transformId = 0;
 		std::vector<RenderObject> renderObjects;
+		float boundingRadius = 0.0f;	// model space, around the origin
+		Math::AABB aabb;	// model space, merged from the meshes
+		Math::Sphere boundingSphere;
+		float lodScreenSize = 0.5f;
+		uint32_t lodCount = 1;
+
+	private:
+		void AddRenderObject(const Model& model, const Model::MeshData& meshData, bool loadTexturesAsync);
+
+		WorldBounds mWorldBounds;
 	};
 }
\ No newline at end of file
@@ -26,5 +26,7 @@ namespace WinterEngine::Graphics
 		ID3D11RenderTargetView* mOldRenderTargetView = nullptr;
 		ID3D11DepthStencilView* mOldDepthStencilView = nullptr;
 		D3D11_VIEWPORT mOldViewPort{};
+		const void* mOldRenderTarget = nullptr;	// what GraphicsSystem had bound, for its stats
+		const void* mOldViewport = nullptr;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "BVHUtil.h"
+
+namespace WinterEngine::Graphics
+{
+	class RenderObject;
+	class RenderGroup;
+
+	// Dynamic bounding volume hierarchy over world space boxes, one leaf per proxy. Build does a
+	// binned SAH build over every proxy. Insert, Remove and Update keep the tree valid in between:
+	// the tree is built around boxes fattened by the margin so small moves cost nothing, a move
+	// past it refits the leaf's ancestors in place, and a jump that leaves the old box behind
+	// reinserts the leaf next to its cheapest sibling. Refit shrinks every box bottom up after
+	// many moves, Build again once GetCost drifts too far above what a fresh build gave.
+	class SceneBVH final
+	{
+	public:
+		using ProxyId = uint32_t;
+		static constexpr ProxyId InvalidProxy = UINT32_MAX;
+
+		struct RayHit
+		{
+			ProxyId proxy = InvalidProxy;
+			float distance = FLT_MAX;
+		};
+
+		// Distance to the proxy's actual geometry or a negative value for a miss, lets a ray cast
+		// refine box hits into exact ones. Only called for boxes closer than the best hit so far
+		using RayCallback = std::function<float(ProxyId proxy, const Math::Ray& ray, float maxDistance)>;
+
+		void Clear();
+
+		// The box must not be empty, objects without bounds belong in a CullingPass instead
+		ProxyId Insert(const Math::AABB& aabb, const void* userData);
+		ProxyId Insert(const RenderObject& renderObject);
+		ProxyId Insert(const RenderGroup& renderGroup);
+		void Remove(ProxyId proxy);
+
+		// Returns false when the new box still fits the leaf and nothing had to change
+		bool Update(ProxyId proxy, const Math::AABB& aabb);
+
+		void Build();
+		void Refit();
+
+		// Proxies whose box touches the frustum or sphere, appended to results
+		void QueryFrustum(const Math::Frustum& frustum, std::vector<ProxyId>& results) const;
+		void QuerySphere(const Math::Sphere& sphere, std::vector<ProxyId>& results) const;
+		// Closest proxy along the ray, by box unless a callback refines the hits
+		bool RayCast(const Math::Ray& ray, float maxDistance, RayHit& hit, const RayCallback& callback = nullptr) const;
+
+		// Batch versions split across the JobSystem once there are enough queries. results[i] is
+		// cleared and filled for query i, keep the vectors around to reuse their memory. The ray
+		// callback is called from worker threads
+		void QueryFrustums(const Math::Frustum* frustums, size_t count, std::vector<std::vector<ProxyId>>& results) const;
+		void QuerySpheres(const Math::Sphere* spheres, size_t count, std::vector<std::vector<ProxyId>>& results) const;
+		void RayCasts(const Math::Ray* rays, size_t count, float maxDistance, RayHit* hits, const RayCallback& callback = nullptr) const;
+
+		const void* GetUserData(ProxyId proxy) const;
+		const Math::AABB& GetAABB(ProxyId proxy) const;
+		uint32_t GetProxyCount() const;
+
+		// Deepest leaf, root alone is 1
+		uint32_t GetHeight() const;
+		// SAH cost of the tree: summed surface area of the internal nodes over the root's area
+		float GetCost() const;
+
+		// How far leaf boxes reach past their proxy, in world units. Applies from the next Build
+		// or from each proxy's next refit
+		void SetMargin(float margin) { mMargin = margin; }
+		float GetMargin() const { return mMargin; }
+
+	private:
+		static constexpr uint32_t InvalidNode = UINT32_MAX;
+
+		// Leaves have no children, hold their proxy's exact box and point back at the proxy.
+		// Internal boxes enclose the fattened boxes below them, so queries only ever read nodes
+		struct Node
+		{
+			Math::AABB aabb;
+			uint32_t parent = InvalidNode;
+			uint32_t children[2] = { InvalidNode, InvalidNode };
+			ProxyId proxy = InvalidProxy;
+
+			bool IsLeaf() const { return children[0] == InvalidNode; }
+		};
+
+		struct Proxy
+		{
+			Math::AABB fatAABB;
+			const void* userData = nullptr;
+			uint32_t node = InvalidNode;	// InvalidNode once removed
+		};
+
+		uint32_t AllocateNode();
+		void FreeNode(uint32_t node);
+		Math::AABB Fatten(const Math::AABB& aabb) const;
+		// The box a node takes up in its parent, fattened for leaves
+		const Math::AABB& GetTreeAABB(uint32_t node) const;
+
+		void InsertLeaf(uint32_t leaf);
+		void RemoveLeaf(uint32_t leaf);
+		void RefitAncestors(uint32_t node);
+		uint32_t BuildRange(BVHUtil::BuildEntry* entries, uint32_t count);
+
+		void QueryFrustum(const Math::Frustum& frustum, std::vector<ProxyId>& results, std::vector<uint32_t>& stack) const;
+		void QuerySphere(const Math::Sphere& sphere, std::vector<ProxyId>& results, std::vector<uint32_t>& stack) const;
+		bool RayCast(const Math::Ray& ray, float maxDistance, RayHit& hit, const RayCallback& callback, std::vector<uint32_t>& stack) const;
+
+		std::vector<Node> mNodes;
+		std::vector<uint32_t> mFreeNodes;
+		std::vector<Proxy> mProxies;
+		std::vector<ProxyId> mFreeProxies;
+		uint32_t mRoot = InvalidNode;
+		float mMargin = 0.1f;
+
+		// Scratch space kept between calls
+		std::vector<BVHUtil::BuildEntry> mBuildEntries;	// index is the proxy
+		std::vector<std::pair<float, uint32_t>> mInsertQueue;
+	};
+}
\ No newline at end of file
@@ -9,8 +9,11 @@
 
 namespace WinterEngine::Graphics
 {
+	class Animator;
+	class CullingPass;
 	class RenderObject;
 	class RenderGroup;
+	class SkinnedMesh;
 
 	class ShadowEffect
 	{
@@ -23,25 +26,45 @@ namespace WinterEngine::Graphics
 
 		void Render(const RenderObject& renderObject);
 		void Render(const RenderGroup& renderGroup);
+		// Skinned on the GPU with the animator's palette, same as StandardEffect
+		void Render(const RenderGroup& renderGroup, const Animator& animator);
+		void Render(const RenderGroup& renderGroup, const SkinnedMesh& skinnedMesh);
+		// Only what survived the pass's last Cull, cull against GetLightCamera after Begin
+		void Render(const CullingPass& cullingPass);
 
 		void DebugUI();
 
 		void SetDirectionalLight(const DirectionalLight& directionalLight);
 		void SetFocus(const Math::Vector3& focusPoint);
 		void SetSize(float size);
+		// Centers the light camera on the bounds and sizes it to cover them from any light direction
+		void FitToBounds(const Math::Sphere& worldBounds);
 		const Camera& GetLightCamera() const;
 		const Texture& GetDepthMap() const;
 
 	private:
 		void UpdateLightCamera();
+		void DrawGroup(const RenderGroup& renderGroup, const Animator* animator, const uint8_t* objectMask);
+
+		static constexpr uint32_t MaxBoneCount = 256;
 
 		struct TransformData
 		{
 			Math::Matrix4 wvp;
+			int useSkinning = 0;
+			float padding[3] = {};
+		};
+
+		struct BoneTransformData
+		{
+			Math::Matrix4 boneTransforms[MaxBoneCount];
 		};
 
 		using TransformBuffer = TypedConstantBuffer<TransformData>;
+		using BoneTransformBuffer = TypedConstantBuffer<BoneTransformData>;
 		TransformBuffer mTransformBuffer;
+		BoneTransformBuffer mBoneTransformBuffer;
+		BoneTransformData mBoneTransformData;
 
 		VertexShader mVertexShader;
 		PixelShader mPixelShader;
@@ -53,5 +76,6 @@ namespace WinterEngine::Graphics
 
 		Math::Vector3 mFocusPoint = Math::Vector3::Zero;
 		float mSize = 100.0f;
+		float mFocusDistance = 100.0f;	// light camera distance back from the focus point
 	};
 }
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Common.h"
+
+namespace WinterEngine::Graphics
+{
+	struct Bone
+	{
+		std::string name;
+		int index = -1;
+		int parentIndex = -1;
+		std::vector<int> childIndices;
+
+		Math::Matrix4 toParentTransform;
+		Math::Matrix4 offsetTransform;	// model space to bone space (inverse bind pose)
+	};
+
+	// Bones are stored parent first, so walking the array in order visits
+	// every parent before its children
+	struct Skeleton
+	{
+		int rootIndex = -1;
+		std::vector<Bone> bones;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "MeshBuffer.h"
+#include "Model.h"
+#include "RenderObject.h"
+
+namespace WinterEngine::Graphics
+{
+	class Animator;
+
+	// CPU skinned copy of a model's meshes, for passes that draw static vertices (shadows,
+	// headless runs, effects without a bone buffer). Update skins every mesh once per pose into
+	// dynamic vertex buffers, the shadow and main passes then draw the same result.
+	class SkinnedMesh final
+	{
+	public:
+		void Initialize(ModelId modelId);
+		void Initialize(const Model& model);
+		void Terminate();
+
+		// Returns false when the animator's pose has not changed since the last call,
+		// so calling it from more than one pass in a frame costs nothing
+		bool Update(const Animator& animator);
+
+		// Same index ranges as the matching RenderObject of a group built from the same model
+		void Render(uint32_t meshIndex, uint32_t lodLevel = 0) const;
+
+		uint32_t GetMeshCount() const;
+		const std::vector<Vertex>& GetVertices(uint32_t meshIndex) const;
+
+	private:
+		struct SkinnedMeshData
+		{
+			const Mesh* bindMesh = nullptr;
+			std::vector<Vertex> vertices;
+			MeshBuffer meshBuffer;
+			std::vector<RenderObject::LODRange> lodRanges;
+		};
+
+		std::vector<SkinnedMeshData> mMeshes;
+		const Animator* mAnimator = nullptr;
+		uint32_t mPoseVersion = 0;
+	};
+}
\ No newline at end of file
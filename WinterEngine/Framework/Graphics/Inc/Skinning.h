@@ -0,0 +1,19 @@
+#pragma once
+
+#include "VertexTypes.h"
+
+namespace WinterEngine::Graphics
+{
+	// CPU version of the vertex shader skinning. Each vertex blends up to four palette matrices
+	// by its bone weights and moves position, normal and tangent with the result. Nothing else
+	// in output is written, so a buffer copied from the bind mesh once can be skinned into every
+	// frame. Bone indices must be below boneCount and unused slots need a weight of 0, the same
+	// rules the GPU path has. Normals and tangents are not renormalized, the shaders do that.
+	void SkinVertices(const Vertex* input, Vertex* output, size_t count, const Math::Matrix4* palette, size_t boneCount);
+
+	inline void SkinVertices(const std::vector<Vertex>& input, std::vector<Vertex>& output, const std::vector<Math::Matrix4>& palette)
+	{
+		ASSERT(output.size() >= input.size(), "SkinVertices: output holds %zu vertices, input has %zu", output.size(), input.size());
+		SkinVertices(input.data(), output.data(), input.size(), palette.data(), palette.size());
+	}
+}
\ No newline at end of file
@@ -9,9 +9,12 @@
 
 namespace WinterEngine::Graphics
 {
+	class Animator;
 	class Camera;
+	class CullingPass;
 	class RenderObject;
 	class RenderGroup;
+	class SkinnedMesh;
 	class Texture;
 
 	class StandardEffect final
@@ -25,6 +28,12 @@ namespace WinterEngine::Graphics
 
 		void Render(const RenderObject& renderObject);
 		void Render(const RenderGroup& renderGroup);
+		// Skinned on the GPU with the animator's palette
+		void Render(const RenderGroup& renderGroup, const Animator& animator);
+		// Already skinned on the CPU, draws the skinned mesh with the group's materials
+		void Render(const RenderGroup& renderGroup, const SkinnedMesh& skinnedMesh);
+		// Only what survived the pass's last Cull
+		void Render(const CullingPass& cullingPass);
 
 		void SetCamera(const Camera& camera);
 		void SetLightCamera(const Camera& camera);
@@ -33,6 +42,8 @@ namespace WinterEngine::Graphics
 
 		void DebugUI();
 
+		static constexpr uint32_t MaxBoneCount = 256;
+
 	private:
 		struct TransformData
 		{
@@ -52,24 +63,34 @@ namespace WinterEngine::Graphics
 			int useShadowMap = 1;
 			float bumpWeight = 1.0f;
 			float depthBias = 0.000003f;
-			float padding = 0.0f;
+			int useSkinning = 0;
+		};
+
+		struct BoneTransformData
+		{
+			Math::Matrix4 boneTransforms[MaxBoneCount];
 		};
 
 		using TransformBuffer = TypedConstantBuffer<TransformData>;
 		using LightBuffer = TypedConstantBuffer<DirectionalLight>;
 		using MaterialBuffer = TypedConstantBuffer<Material>;
 		using SettingsBuffer = TypedConstantBuffer<SettingsData>;
+		using BoneTransformBuffer = TypedConstantBuffer<BoneTransformData>;
+
+		void DrawGroup(const RenderGroup& renderGroup, const Animator* animator, const SkinnedMesh* skinnedMesh, const uint8_t* objectMask);
 
 		TransformBuffer mTransformBuffer;
 		LightBuffer mLightBuffer;
 		MaterialBuffer mMaterialBuffer;
 		SettingsBuffer mSettingsBuffer;
+		BoneTransformBuffer mBoneTransformBuffer;
 
 		VertexShader mVertexShader;
 		PixelShader mPixelShader;
 		Sampler mSampler;
 
 		SettingsData mSettingsData;
+		BoneTransformData mBoneTransformData;
 		const Camera* mCamera = nullptr;
 		const Camera* mLightCamera = nullptr;
 		const DirectionalLight* mDirectionalLight = nullptr;
@@ -4,18 +4,187 @@
 
 namespace WinterEngine::Graphics
 {
+	// Height field on a grid of unit cells. Each sample keeps only its height and a packed
+	// normal (TerrainVertex), positions and uvs follow from the sample's place in the grid
 	class Terrain final
 	{
 	public:
-		void Initialize(const std::filesystem::path& fileName, float maxHeight, float tileCount);
+		struct RayHit
+		{
+			Math::Vector3 position = Math::Vector3::Zero;
+			Math::Vector3 normal = Math::Vector3::YAxis;
+			float distance = FLT_MAX;	// FLT_MAX for a miss
+		};
+
+		static constexpr uint32_t ChunkSize = 64;	// cells per side of a chunk, the last row/column of chunks may be smaller
+		static constexpr uint32_t ChunkLodCount = 7;	// LOD l steps over 2^l cells, the last one draws a chunk as a single quad
+
+		// One DrawIndexed of a chunk, indices are relative to the chunk's first vertex
+		struct ChunkDraw
+		{
+			uint32_t startIndex = 0;
+			uint32_t indexCount = 0;
+			int32_t baseVertex = 0;
+		};
+
+		// Filled by SelectChunks, keep it around between frames so the buffers are reused
+		struct ChunkSelection
+		{
+			std::vector<ChunkDraw> draws;
+			std::vector<uint8_t> lods;	// per chunk, also for the culled ones
+			std::vector<uint8_t> visible;
+			uint32_t visibleChunks = 0;
+			uint32_t triangleCount = 0;
+		};
+
+		// How GetGround blends the four samples around a position
+		enum class Interpolation
+		{
+			Triangle,	// the two triangles of the cell as drawn, same heights as GetHeight
+			Bilinear	// smoother, the surface no longer creases along the cell diagonals
+		};
+
+		// What GetGround does with a position off the map
+		enum class OutOfBounds
+		{
+			Clamp,	// sample the closest point on the edge of the map
+			Fallback	// fallbackHeight with the normal straight up and no slope
+		};
+
+		struct GroundQuery
+		{
+			Interpolation interpolation = Interpolation::Triangle;
+			OutOfBounds outOfBounds = OutOfBounds::Clamp;
+			float fallbackHeight = 0.0f;
+		};
+
+		struct GroundSample
+		{
+			float height = 0.0f;
+			Math::Vector3 normal = Math::Vector3::YAxis;
+			float slope = 0.0f;	// rise over run down the steepest direction, tan of the angle to the horizontal
+			bool inside = false;	// false for positions off the map, whatever OutOfBounds did with them
+		};
+
+		// Sample size of a RAW heightmap, 16 bit samples are little endian
+		enum class SampleFormat
+		{
+			UInt8,
+			UInt16
+		};
+
+		// Square RAW heightmap, the file is mapped and read in one pass
+		void Initialize(const std::filesystem::path& fileName, float maxHeight, float tileCount, SampleFormat format = SampleFormat::UInt8);
+		// One byte per sample, rows of columns samples each, 255 maps to maxHeight
+		void Initialize(const uint8_t* samples, uint32_t rows, uint32_t columns, float maxHeight, float tileCount);
+		// 65535 maps to maxHeight
+		void Initialize(const uint16_t* samples, uint32_t rows, uint32_t columns, float maxHeight, float tileCount);
 		float GetHeight(const Math::Vector3& position) const;
-		const Mesh& GetMesh() const;
+		// Height, normal and slope under count positions (x and z, in terrain space), four at a
+		// time with SIMD and split across the JobSystem once there are enough. The map covers
+		// [0, GetColumns - 1] x [0, GetRows - 1] including its far edges, a NaN is off the map.
+		// Returns how many of the positions were inside
+		size_t GetGround(const Math::Vector3* positions, size_t count, const GroundQuery& query, GroundSample* samples) const;
+
+		// Vertex buffer for TerrainEffect, one per sample, rows of GetColumns vertices
+		const std::vector<TerrainVertex>& GetVertices() const;
+		// Index buffer for chunked rendering, pair it with GetVertices and draw the ranges
+		// SelectChunks picks. Holds every LOD of every chunk shape
+		const std::vector<uint32_t>& GetChunkIndices() const;
+		// Full Vertex mesh with an index buffer over every cell, over 12x the memory of the
+		// terrain itself. For tools and physics, rendering only needs GetVertices
+		void ExpandMesh(Mesh& mesh) const;
+
+		// Frustum culls the chunks and picks a LOD for each from its distance to viewPosition,
+		// both in terrain space. A chunk uses LOD l while it is within lodDistance * 2^l, then
+		// neighbours are pulled to within one LOD of each other and the edge facing a coarser
+		// neighbour drops every other vertex to match it, so there are no cracks
+		void SelectChunks(const Math::Frustum& frustum, const Math::Vector3& viewPosition, ChunkSelection& selection) const;
+		void SetLodDistance(float distance);
+		float GetLodDistance() const;
+
+		uint32_t GetChunkCount() const;
+		const Math::AABB& GetChunkAABB(uint32_t chunk) const;
+
+		// Walks the cells under the ray (2D DDA over the grid) and tests the two triangles of
+		// each cell it crosses, front to back. Blocks of cells whose height range the ray passes
+		// over or under are skipped without looking at a single cell
+		bool RayCast(const Math::Ray& ray, float maxDistance, RayHit& hit) const;
+		// Split across the JobSystem once there are enough rays
+		void RayCasts(const Math::Ray* rays, size_t count, float maxDistance, RayHit* hits) const;
 
 		float GetWidth() const;
 		float GetHeight() const;
+		uint32_t GetRows() const;
+		uint32_t GetColumns() const;
+		uint32_t GetTriangleCount() const;	// at full detail
+		float GetTileCount() const;	// uv repeats across the whole map
+		const Math::AABB& GetAABB() const;
 	private:
-		Mesh mMesh;
+		struct HeightRange
+		{
+			float minHeight;
+			float maxHeight;
+		};
+
+		// Edges of a chunk that stitch to a coarser neighbour, index into IndexRange::variants
+		enum ChunkEdge : uint32_t
+		{
+			Left = 1 << 0,
+			Right = 1 << 1,
+			Bottom = 1 << 2,
+			Top = 1 << 3,
+			EdgeCombinations = 1 << 4
+		};
+
+		struct IndexRange
+		{
+			uint32_t startIndex = 0;
+			uint32_t indexCount = 0;
+		};
+
+		// Chunks with the same cell counts share their indices
+		struct ChunkShape
+		{
+			uint32_t cellColumns = 0;
+			uint32_t cellRows = 0;
+			IndexRange ranges[ChunkLodCount][EdgeCombinations];
+		};
+
+		struct Chunk
+		{
+			uint32_t baseVertex = 0;
+			uint32_t shape = 0;
+		};
+
+		// Heights and central difference normals, rows split across the JobSystem
+		template<class Sample>
+		void BuildVertices(const Sample* samples, uint32_t rows, uint32_t columns, float maxHeight, float tileCount);
+		void BuildHeightBlocks();
+		void BuildChunks();
+		uint32_t FindChunkShape(uint32_t cellColumns, uint32_t cellRows);
+		float GetVertexHeight(uint32_t x, uint32_t z) const;
+		GroundSample SampleGround(float x, float z, const GroundQuery& query) const;
+		size_t SampleGrounds(const Math::Vector3* positions, size_t count, const GroundQuery& query, GroundSample* samples) const;
+		bool RayCastBlock(const Math::Ray& ray, uint32_t blockX, uint32_t blockZ, float tStart, float tEnd, RayHit& hit) const;
+
+		std::vector<TerrainVertex> mVertices;
+		Math::AABB mAABB;
 		uint32_t mRows = 0;
 		uint32_t mColumns = 0;
+		float mTileCount = 0.0f;
+
+		// Min/max height of each BlockSize x BlockSize run of cells
+		std::vector<HeightRange> mHeightBlocks;
+		uint32_t mBlockRows = 0;
+		uint32_t mBlockColumns = 0;
+
+		std::vector<Chunk> mChunks;
+		std::vector<Math::AABB> mChunkBoxes;	// apart from mChunks so they cull as one batch
+		std::vector<ChunkShape> mChunkShapes;
+		std::vector<uint32_t> mChunkIndices;
+		uint32_t mChunkRows = 0;
+		uint32_t mChunkColumns = 0;
+		float mLodDistance = 64.0f;
 	};
 }
\ No newline at end of file
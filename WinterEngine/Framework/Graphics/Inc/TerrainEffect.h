@@ -5,6 +5,7 @@
 #include "Material.h"
 #include "PixelShader.h"
 #include "Sampler.h"
+#include "Terrain.h"
 #include "VertexShader.h"
 
 namespace WinterEngine::Graphics
@@ -22,13 +23,21 @@ namespace WinterEngine::Graphics
 		void Begin();
 		void End();
 
+		// renderObject's mesh buffer holds Terrain::GetVertices and any index buffer over them
 		void Render(const RenderObject& renderObject);
+		// renderObject's mesh buffer holds Terrain::GetVertices and Terrain::GetChunkIndices
+		void Render(const RenderObject& renderObject, const Terrain::ChunkSelection& selection);
 		void DebugUI();
 
 		void SetCamera(const Camera& camera);
 		void SetDirectionalLight(const DirectionalLight& directionalLight);
+		// Grid the vertices are laid out on, positions and uvs are rebuilt from it
+		void SetTerrain(const Terrain& terrain);
 
 	private:
+		void UpdateBuffers(const RenderObject& renderObject);
+		void UpdateGrid(int32_t baseVertex);
+
 		struct TransformData
 		{
 			Math::Matrix4 wvp;
@@ -45,15 +54,26 @@ namespace WinterEngine::Graphics
 			float padding = 0.0f;
 		};
 
+		// SV_VertexID does not include the base vertex of a draw, so each chunk passes its own
+		struct GridData
+		{
+			uint32_t columns = 0;
+			uint32_t rows = 0;
+			float tileCount = 0.0f;
+			int32_t baseVertex = 0;
+		};
+
 		using TransformBuffer = TypedConstantBuffer<TransformData>;
 		using LightBuffer = TypedConstantBuffer<DirectionalLight>;
 		using MaterialBuffer = TypedConstantBuffer<Material>;
 		using SettingsBuffer = TypedConstantBuffer<SettingsData>;
+		using GridBuffer = TypedConstantBuffer<GridData>;
 
 		TransformBuffer mTransformBuffer;
 		LightBuffer mLightBuffer;
 		MaterialBuffer mMaterialBuffer;
 		SettingsBuffer mSettingsBuffer;
+		GridBuffer mGridBuffer;
 
 		VertexShader mVertexShader;
 		PixelShader mPixelShader;
@@ -62,5 +82,6 @@ namespace WinterEngine::Graphics
 		SettingsData mSettingsData;
 		const Camera* mCamera = nullptr;
 		const DirectionalLight* mDirectionalLight = nullptr;
+		const Terrain* mTerrain = nullptr;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "MeshTypes.h"
+#include "Terrain.h"
+
+namespace WinterEngine::Graphics
+{
+	// Streams square tiles of a heightmap that is too large to keep in memory. The tile file is
+	// memory mapped and tiles around the view are copied out on JobSystem workers, nearest first.
+	// Resident tiles are kept within a byte budget, the least recently wanted ones are evicted
+	// when a new tile needs the room, so the tiles left behind go first.
+	class TerrainStreamer final
+	{
+	public:
+		// Tile file: header, then every tile's (tileSize + 3)^2 samples row major in the sample
+		// format of the source, tiles in rows. A tile holds its own (tileSize + 1)^2 samples and a
+		// one sample apron around them, so each one stands alone and its edge normals match its
+		// neighbours'. Past the border of the map the apron and the padding of the far tiles
+		// repeat the nearest sample. Samples scale to heights the way Terrain's do
+		static bool WriteTiles(const std::filesystem::path& tilePath, const uint8_t* samples, uint32_t rows, uint32_t columns, float maxHeight, uint32_t tileSize);
+		static bool WriteTiles(const std::filesystem::path& tilePath, const uint16_t* samples, uint32_t rows, uint32_t columns, float maxHeight, uint32_t tileSize);
+		// Maps the RAW file rather than reading it, so it converts maps larger than memory
+		static bool ConvertRaw(const std::filesystem::path& rawPath, uint32_t rows, uint32_t columns, float maxHeight, uint32_t tileSize, const std::filesystem::path& tilePath,
+			Terrain::SampleFormat format = Terrain::SampleFormat::UInt8);
+
+		struct Settings
+		{
+			size_t residentBudget = 16 * 1024 * 1024;	// bytes of tile samples kept in memory
+			float loadRadius = 512.0f;	// tiles closer than this to the view are wanted
+			uint32_t maxLoadsInFlight = 4;
+			float hitchTime = 2.0f;	// milliseconds, longer Updates count as a hitch
+			float textureRepeat = 10.0f;	// uv repeats across the whole map, like Terrain's tileCount
+		};
+
+		struct Tile
+		{
+			uint32_t tileX = 0;
+			uint32_t tileZ = 0;
+			uint32_t cellColumns = 0;	// inside the map, edge tiles can be shorter than tileSize
+			uint32_t cellRows = 0;
+			Math::AABB aabb;	// world space
+			std::vector<uint8_t> samples;	// (tileSize + 3)^2 with the apron, as stored in the file, one or two bytes each
+			uint32_t lastWantedFrame = 0;
+		};
+
+		struct Stats
+		{
+			uint32_t residentTiles = 0;
+			size_t residentBytes = 0;
+			size_t peakResidentBytes = 0;
+			uint32_t loadsInFlight = 0;
+			uint32_t totalLoads = 0;
+			uint32_t totalEvictions = 0;
+			float loadsPerSecond = 0.0f;	// over the last second
+			float averageLoadTime = 0.0f;	// milliseconds on the worker, per tile
+			float updateTime = 0.0f;	// milliseconds
+			float worstUpdateTime = 0.0f;
+			uint32_t hitches = 0;	// Updates over Settings::hitchTime
+			uint32_t misses = 0;	// Updates that left the tile under the view missing
+		};
+
+		// Called from Update on the calling thread, the tile is valid for the duration of the call
+		using TileCallback = std::function<void(const Tile&)>;
+
+		TerrainStreamer() = default;
+		~TerrainStreamer();
+
+		TerrainStreamer(const TerrainStreamer&) = delete;
+		TerrainStreamer& operator=(const TerrainStreamer&) = delete;
+
+		// Rejects files whose tiles don't cover the map exactly or run past the end of the file
+		bool Initialize(const std::filesystem::path& tilePath, const Settings& settings);
+		// Waits for the loads still in flight and reports every resident tile as evicted
+		void Terminate();
+
+		void SetCallbacks(TileCallback onTileLoaded, TileCallback onTileEvicted);
+
+		// Once per frame: picks up finished loads, requests the tiles around viewPosition and
+		// evicts down to the budget
+		void Update(const Math::Vector3& viewPosition, float deltaTime);
+
+		// False when the position is outside the map or its tile is not resident
+		bool GetHeight(const Math::Vector3& position, float& height) const;
+		const Tile* GetTile(uint32_t tileX, uint32_t tileZ) const;
+
+		// Grid mesh of a resident tile in world space, vertices laid out like Terrain::ExpandMesh.
+		// Normals are the same central differences as Terrain's without its 16 bit packing, so the
+		// edges of neighbouring tiles match exactly and a Terrain of the same map to within the
+		// packing. The tiles are separate meshes without skirts or LODs, so mixing them with a
+		// Terrain or drawing them at different detail would still need the seams closed
+		void BuildTileMesh(const Tile& tile, Mesh& mesh) const;
+
+		uint32_t GetTileSize() const { return mTileSize; }
+		uint32_t GetTileRows() const { return mTileRows; }
+		uint32_t GetTileColumns() const { return mTileColumns; }
+		size_t GetTileBytes() const { return mTileBytes; }
+		const Stats& GetStats() const { return mStats; }
+
+		void DebugUI();
+
+	private:
+		enum class TileState : uint8_t
+		{
+			Unloaded,
+			Loading,
+			Resident
+		};
+
+		struct LoadedTile
+		{
+			uint32_t index = 0;
+			std::unique_ptr<Tile> tile;
+			float loadTime = 0.0f;
+		};
+
+		void CollectLoads();
+		void RequestTiles(const Math::Vector3& viewPosition);
+		void EvictTiles(const Math::Vector3& viewPosition);
+		void EvictTile(uint32_t index);
+		void LoadTile(uint32_t index);
+		float GetTileDistance(uint32_t index, const Math::Vector3& viewPosition) const;
+		// x and z in the tile's samples, -1 and tileSize + 1 are the apron
+		float GetSampleHeight(const Tile& tile, int32_t x, int32_t z) const;
+
+		Core::MappedFile mTileFile;
+		Settings mSettings;
+		uint32_t mRows = 0;
+		uint32_t mColumns = 0;
+		uint32_t mTileSize = 0;
+		uint32_t mTileRows = 0;
+		uint32_t mTileColumns = 0;
+		size_t mTileBytes = 0;
+		uint64_t mDataOffset = 0;
+		float mMaxHeight = 0.0f;
+		Terrain::SampleFormat mSampleFormat = Terrain::SampleFormat::UInt8;
+
+		std::vector<std::unique_ptr<Tile>> mTiles;	// per tile, null unless resident
+		std::vector<TileState> mTileStates;
+		std::vector<uint32_t> mResidentTiles;
+		std::vector<std::pair<float, uint32_t>> mWantedTiles;	// distance, tile
+		std::vector<uint32_t> mEvictionOrder;
+		uint32_t mFrame = 0;
+
+		TileCallback mOnTileLoaded;
+		TileCallback mOnTileEvicted;
+
+		std::mutex mLoadedMutex;
+		std::condition_variable mLoadedCondition;
+		std::vector<LoadedTile> mLoadedTiles;
+		std::atomic<uint32_t> mLoadsInFlight = 0;	// dropped under mLoadedMutex so Terminate can wait on it
+
+		Stats mStats;
+		float mLoadWindowTime = 0.0f;
+		uint32_t mLoadWindowCount = 0;
+		double mTotalLoadTime = 0.0;
+	};
+}
\ No newline at end of file
@@ -14,6 +14,17 @@ namespace WinterEngine::Graphics
 			RGBA_U32
 		};
 
+		// Decoded RGBA_U8 pixels, produced off the render thread by DecodeImage
+		struct ImageData
+		{
+			uint32_t width = 0;
+			uint32_t height = 0;
+			std::vector<uint8_t> pixels;
+		};
+
+		// CPU only, safe to call from worker threads
+		static bool DecodeImage(const std::filesystem::path& fileName, ImageData& imageData);
+
 		Texture() = default;
 		virtual ~Texture();
 
@@ -26,6 +37,7 @@ namespace WinterEngine::Graphics
 
 		virtual void Initialize(const std::filesystem::path& fileName);
 		virtual void Initialize(uint32_t width, uint32_t height, Format format);
+		void Initialize(const ImageData& imageData);
 		virtual void Terminate();
 
 		void BindVS(uint32_t slot) const;
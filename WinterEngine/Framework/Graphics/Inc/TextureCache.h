@@ -1,5 +1,6 @@
 #pragma once
 
+#include "LoadState.h"
 #include "Texture.h"
 
 namespace WinterEngine::Graphics
@@ -23,15 +24,37 @@ namespace WinterEngine::Graphics
 
 		void SetRootDirectory(std::filesystem::path root);
 
+		// Also finishes a LoadTextureAsync of the same file that is still pending
 		TextureId LoadTexture(const std::filesystem::path& fileName, bool useRootDir = true);
 		const Texture* GetTexture(TextureId id) const;
 
+		// Reads and decodes on a JobSystem worker, the id binds nothing until
+		// Update has uploaded the pixels on the render thread.
+		TextureId LoadTextureAsync(const std::filesystem::path& fileName, bool useRootDir = true);
+		LoadState GetLoadState(TextureId id) const;
+		bool IsReady(TextureId id) const;
+
+		// Uploads textures decoded since the last call, once per frame
+		void Update();
+
 		void BindVS(TextureId id, uint32_t slot) const;
 		void BindPS(TextureId id, uint32_t slot) const;
 
 	private:
+		struct DecodedTexture
+		{
+			TextureId id = 0;
+			bool success = false;
+			Texture::ImageData imageData;
+		};
+
 		using Inventory = std::unordered_map<TextureId, std::unique_ptr<Texture>>;
+		using LoadStates = std::unordered_map<TextureId, LoadState>;
 		Inventory mInventory;
+		LoadStates mLoadStates;
+
+		std::mutex mDecodedMutex;
+		std::vector<DecodedTexture> mDecodedTextures;
 		
 		std::filesystem::path mRootDirectory;
 	};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Transform.h"
+
+namespace WinterEngine::Graphics
+{
+	// Slot + 1 in the low 32 bits and the slot's generation in the high 32 bits, so an id kept
+	// past Destroy or Clear doesn't reach whatever reuses its slot. 0 = no transform
+	using TransformId = uint64_t;
+
+	// Local transforms live in parallel arrays with a parent index per entry. Update walks the
+	// hierarchy one depth level at a time, splitting each level across the JobSystem, and only
+	// rebuilds world matrices whose local transform or parent changed. Everything else reads
+	// the cached result, so effects can ask for the same world matrix in every pass for free.
+	class TransformSystem final
+	{
+	public:
+		static void StaticInitialize();
+		static void StaticTerminate();
+		static TransformSystem* Get();
+
+		TransformSystem() = default;
+		~TransformSystem() = default;
+
+		TransformSystem(const TransformSystem&) = delete;
+		TransformSystem(const TransformSystem&&) = delete;
+		TransformSystem& operator=(const TransformSystem&) = delete;
+		TransformSystem& operator=(const TransformSystem&&) = delete;
+
+		TransformId Create(const Transform& local = {}, TransformId parent = 0);
+		// Children of a destroyed transform become roots, keeping their local transform. Stale
+		// ids are ignored
+		void Destroy(TransformId id);
+		// Every id handed out so far goes stale
+		void Clear();
+		// False for 0 and for ids whose transform was destroyed or cleared
+		bool IsValid(TransformId id) const;
+
+		void SetParent(TransformId id, TransformId parent);
+		TransformId GetParent(TransformId id) const;
+
+		void SetLocal(TransformId id, const Transform& local);
+		void SetPosition(TransformId id, const Math::Vector3& position);
+		void SetRotation(TransformId id, const Math::Quaternion& rotation);
+		void SetScale(TransformId id, const Math::Vector3& scale);
+		Transform GetLocal(TransformId id) const;
+
+		// Valid after the Update that followed the last change
+		const Math::Matrix4& GetWorldMatrix(TransformId id) const;
+		Math::Vector3 GetWorldPosition(TransformId id) const;
+
+		// Once per frame after game code has moved things and before anything renders
+		void Update();
+
+		uint32_t GetTransformCount() const;
+		uint32_t GetLastUpdateCount() const { return mLastUpdateCount; }
+
+	private:
+		uint32_t GetSlot(TransformId id) const;
+		TransformId GetId(uint32_t slot) const;
+		void RebuildOrder();
+		void UpdateRange(const uint32_t* slots, uint32_t count);
+
+		// One entry per slot, destroyed slots are recycled through mFreeSlots
+		std::vector<Math::Vector3> mPositions;
+		std::vector<Math::Quaternion> mRotations;
+		std::vector<Math::Vector3> mScales;
+		std::vector<int> mParents;	// -1 for roots
+		std::vector<Math::Matrix4> mWorldMatrices;
+		std::vector<uint8_t> mLocalDirty;
+		std::vector<uint8_t> mWorldChanged;
+		std::vector<uint8_t> mAlive;
+		std::vector<uint32_t> mFreeSlots;
+		std::vector<uint32_t> mGenerations;	// bumped when a slot dies, kept through Clear
+
+		// Live slots sorted by depth, level n covers mOrder[mLevelStarts[n], mLevelStarts[n + 1])
+		std::vector<uint32_t> mOrder;
+		std::vector<uint32_t> mLevelStarts;
+		bool mOrderDirty = true;
+
+		std::atomic<uint32_t> mUpdateCount{ 0 };
+		uint32_t mLastUpdateCount = 0;
+	};
+}
\ No newline at end of file
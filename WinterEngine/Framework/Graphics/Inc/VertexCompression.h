@@ -0,0 +1,62 @@
+#pragma once
+
+#include "VertexTypes.h"
+
+namespace WinterEngine::Graphics
+{
+	// Storage only vertex for static meshes (18 bytes vs 76), decoded back to Vertex on load.
+	//   position: 16 bit unorm relative to the mesh bounds
+	//   normal/tangent: octahedral encoded, 16 bit snorm
+	//   uvCoord: half floats
+	//   bone indices/weights: separate CompactSkin stream, skinned meshes only
+	struct CompactVertex
+	{
+		uint16_t position[3] = {};
+		int16_t normal[2] = {};
+		int16_t tangent[2] = {};
+		uint16_t uvCoord[2] = {};
+	};
+
+	// Top 4 bone influences (12 bytes vs 32): 16 bit bone indices and 8 bit
+	// unorm weights, quantized so they always add up to exactly 255
+	struct CompactSkin
+	{
+		uint16_t boneIndices[Vertex::MaxBoneWeights] = {};
+		uint8_t boneWeights[Vertex::MaxBoneWeights] = {};
+	};
+
+	namespace VertexCompression
+	{
+		struct Bounds
+		{
+			Math::Vector3 min = Math::Vector3::Zero;
+			Math::Vector3 extent = Math::Vector3::Zero;
+		};
+
+		Bounds ComputeBounds(const std::vector<Vertex>& vertices);
+
+		// True when any vertex carries a bone weight
+		bool HasSkin(const std::vector<Vertex>& vertices);
+
+		CompactVertex Encode(const Vertex& vertex, const Bounds& bounds);
+		Vertex Decode(const CompactVertex& compactVertex, const Bounds& bounds);
+
+		void Encode(const std::vector<Vertex>& vertices, const Bounds& bounds, std::vector<CompactVertex>& outVertices);
+		void Decode(const CompactVertex* compactVertices, uint32_t vertexCount, const Bounds& bounds, std::vector<Vertex>& outVertices);
+
+		CompactSkin EncodeSkin(const Vertex& vertex);
+		void DecodeSkin(const CompactSkin& compactSkin, Vertex& vertex);
+
+		// DecodeSkin fills in the bone data of vertices that were already decoded
+		void EncodeSkin(const std::vector<Vertex>& vertices, std::vector<CompactSkin>& outSkin);
+		void DecodeSkin(const CompactSkin* compactSkin, uint32_t vertexCount, std::vector<Vertex>& vertices);
+
+		uint16_t FloatToHalf(float value);
+		float HalfToFloat(uint16_t value);
+
+		// Unit vector as two 16 bit snorms, a zero vector is kept as (-32768, -32768) which
+		// no unit vector encodes to
+		void EncodeOctahedral(const Math::Vector3& v, int16_t out[2]);
+		Math::Vector3 DecodeOctahedral(const int16_t in[2]);
+	}
+}
\ No newline at end of file
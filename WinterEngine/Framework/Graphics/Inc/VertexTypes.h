@@ -13,6 +13,8 @@ namespace WinterEngine::Graphics
 	constexpr uint32_t VE_TexCoord		= 0x1 << 4;
 	constexpr uint32_t VE_BlendIndex	= 0x1 << 5;
 	constexpr uint32_t VE_BlendWeight	= 0x1 << 6;
+	constexpr uint32_t VE_Height		= 0x1 << 7;
+	constexpr uint32_t VE_PackedNormal	= 0x1 << 8;
 
 	#define VERTEX_FORMAT(fmt)\
 		static constexpr uint32_t Format = fmt
@@ -49,6 +51,15 @@ namespace WinterEngine::Graphics
 		int boneIndices[MaxBoneWeights] = {};
 		float boneWeights[MaxBoneWeights] = {};
 	};
+
+	// One heightmap sample (8 bytes vs 76), the shader rebuilds x/z/uv from the vertex id.
+	// The normal is octahedral encoded like VertexCompression::EncodeOctahedral
+	struct TerrainVertex
+	{
+		VERTEX_FORMAT(VE_Height | VE_PackedNormal);
+		float height = 0.0f;
+		int16_t normal[2] = {};
+	};
 }
 
 
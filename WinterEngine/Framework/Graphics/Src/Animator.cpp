@@ -0,0 +1,302 @@
+#include "Precompile.h"
+#include "Animator.h"
+
+using namespace WinterEngine;
+using namespace WinterEngine::Graphics;
+
+namespace
+{
+	// Characters are heavy enough that a few per batch keeps every worker busy
+	constexpr uint32_t AnimatorBatchSize = 4;
+
+	// Index of the last key at or before time. Playback only moves forward between frames, so
+	// the cursor from the previous frame is almost always right or one step short. Going back
+	// in time (a loop or a restart) starts over from the first key.
+	template<class T>
+	uint32_t Seek(const Keyframes<T>& keys, float time, uint32_t& cursor)
+	{
+		const uint32_t keyCount = keys.size();
+		if (cursor >= keyCount || keys.times[cursor] > time)
+		{
+			cursor = 0;
+		}
+		while (cursor + 1 < keyCount && keys.times[cursor + 1] <= time)
+		{
+			++cursor;
+		}
+		return cursor;
+	}
+
+	template<class T>
+	float GetKeyBlend(const Keyframes<T>& keys, uint32_t key, float time)
+	{
+		const float start = keys.times[key];
+		const float length = keys.times[key + 1] - start;
+		return (length > 0.0f) ? Math::Clamp((time - start) / length, 0.0f, 1.0f) : 0.0f;
+	}
+
+	Math::Vector3 Sample(const Keyframes<Math::Vector3>& keys, float time, uint32_t& cursor)
+	{
+		const uint32_t key = Seek(keys, time, cursor);
+		if (key + 1 >= keys.size())
+		{
+			return keys.values[key];
+		}
+
+		const float t = GetKeyBlend(keys, key, time);
+		return keys.values[key] + ((keys.values[key + 1] - keys.values[key]) * t);
+	}
+
+	// Neighbouring keys are close together, nlerp is indistinguishable from slerp there
+	Math::Quaternion Sample(const Keyframes<Math::Quaternion>& keys, float time, uint32_t& cursor)
+	{
+		const uint32_t key = Seek(keys, time, cursor);
+		if (key + 1 >= keys.size())
+		{
+			return keys.values[key];
+		}
+
+		return Math::Nlerp(keys.values[key], keys.values[key + 1], GetKeyBlend(keys, key, time));
+	}
+}
+
+void Animator::UpdateAll(Animator* const* animators, uint32_t count, float deltaTime)
+{
+	Core::JobSystem::Get()->ParallelFor(count, AnimatorBatchSize, [animators, deltaTime](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			animators[i]->Update(deltaTime);
+		}
+	});
+}
+
+void Animator::Initialize(ModelId modelId)
+{
+	const Model* model = ModelCache::Get()->GetModel(modelId);
+	ASSERT(model != nullptr, "Animator: model is not loaded");
+	Initialize(*model);
+}
+
+void Animator::Initialize(const Model& model)
+{
+	mModel = &model;
+
+	// Bind pose in the same position/rotation/scale form the clips use, so unanimated
+	// channels and blends work on one representation
+	const std::vector<Bone>& bones = model.skeleton.bones;
+	const size_t boneCount = bones.size();
+	mBindPose.positions.resize(boneCount);
+	mBindPose.rotations.resize(boneCount);
+	mBindPose.scales.resize(boneCount);
+	for (size_t i = 0; i < boneCount; ++i)
+	{
+		const Math::Matrix4& m = bones[i].toParentTransform;
+		Math::Vector3 axisX = { m._11, m._12, m._13 };
+		const Math::Vector3 axisY = { m._21, m._22, m._23 };
+		const Math::Vector3 axisZ = { m._31, m._32, m._33 };
+		Math::Vector3 scale = { Math::Magnitude(axisX), Math::Magnitude(axisY), Math::Magnitude(axisZ) };
+		if (Math::Dot(Math::Cross(axisX, axisY), axisZ) < 0.0f)
+		{
+			// Mirrored, fold the flip into the x scale so what is left is a rotation
+			scale.x = -scale.x;
+			axisX = -axisX;
+		}
+
+		Math::Matrix4 rotation;
+		rotation._11 = axisX.x / scale.x; rotation._12 = axisX.y / scale.x; rotation._13 = axisX.z / scale.x;
+		rotation._21 = axisY.x / scale.y; rotation._22 = axisY.y / scale.y; rotation._23 = axisY.z / scale.y;
+		rotation._31 = axisZ.x / scale.z; rotation._32 = axisZ.y / scale.z; rotation._33 = axisZ.z / scale.z;
+		mBindPose.positions[i] = { m._41, m._42, m._43 };
+		mBindPose.rotations[i] = Math::Normalize(Math::Quaternion::RotationMatrix(rotation));
+		mBindPose.scales[i] = scale;
+	}
+	mPose = mBindPose;
+	mBlendPose = mBindPose;
+
+	mCurrent = {};
+	mPrevious = {};
+	mCurrent.cursors.resize(boneCount);
+	mPrevious.cursors.resize(boneCount);
+	mBlendTime = 0.0f;
+	mBlendDuration = 0.0f;
+
+	mBoneTransforms.resize(boneCount);
+	mSkinTransforms.resize(boneCount);
+	BuildPalette();
+}
+
+void Animator::Terminate()
+{
+	mModel = nullptr;
+	mCurrent = {};
+	mPrevious = {};
+	mBoneTransforms.clear();
+	mSkinTransforms.clear();
+}
+
+void Animator::PlayClip(uint32_t clipIndex, bool looping, float blendDuration)
+{
+	ASSERT(clipIndex < GetClipCount(), "Animator: clip %u out of range", clipIndex);
+	if (clipIndex >= GetClipCount())
+	{
+		return;
+	}
+
+	if (blendDuration > 0.0f && mCurrent.clip != nullptr)
+	{
+		std::swap(mPrevious, mCurrent);
+		mBlendTime = 0.0f;
+		mBlendDuration = blendDuration;
+	}
+	else
+	{
+		mPrevious.clip = nullptr;
+		mBlendDuration = 0.0f;
+	}
+	StartLayer(mCurrent, clipIndex, looping);
+}
+
+void Animator::Stop()
+{
+	mCurrent.clip = nullptr;
+	mPrevious.clip = nullptr;
+	mBlendDuration = 0.0f;
+	if (mModel != nullptr)
+	{
+		mPose = mBindPose;
+		BuildPalette();
+	}
+}
+
+void Animator::Update(float deltaTime)
+{
+	if (mCurrent.clip == nullptr)
+	{
+		return;
+	}
+
+	const float step = deltaTime * playbackSpeed;
+	AdvanceLayer(mCurrent, step);
+	SampleLayer(mCurrent, mPose);
+
+	if (mPrevious.clip != nullptr)
+	{
+		mBlendTime += deltaTime;
+		if (mBlendTime >= mBlendDuration)
+		{
+			mPrevious.clip = nullptr;
+		}
+		else
+		{
+			AdvanceLayer(mPrevious, step);
+			SampleLayer(mPrevious, mBlendPose);
+
+			// Pull the outgoing pose towards the new one as the fade goes on
+			const float t = mBlendTime / mBlendDuration;
+			const size_t boneCount = mPose.positions.size();
+			for (size_t i = 0; i < boneCount; ++i)
+			{
+				mPose.positions[i] = mBlendPose.positions[i] + ((mPose.positions[i] - mBlendPose.positions[i]) * t);
+				mPose.scales[i] = mBlendPose.scales[i] + ((mPose.scales[i] - mBlendPose.scales[i]) * t);
+			}
+			Math::NlerpQuaternions(mBlendPose.rotations.data(), mPose.rotations.data(), t, mPose.rotations.data(), boneCount);
+		}
+	}
+
+	BuildPalette();
+}
+
+bool Animator::IsPlaying() const
+{
+	return mCurrent.clip != nullptr && !IsFinished();
+}
+
+bool Animator::IsFinished() const
+{
+	return mCurrent.clip == nullptr || (!mCurrent.looping && mCurrent.time >= mCurrent.clip->duration);
+}
+
+uint32_t Animator::GetClipCount() const
+{
+	return (mModel != nullptr) ? static_cast<uint32_t>(mModel->animationClips.size()) : 0;
+}
+
+const AnimationClip* Animator::GetClip(uint32_t clipIndex) const
+{
+	return (clipIndex < GetClipCount()) ? &mModel->animationClips[clipIndex] : nullptr;
+}
+
+uint32_t Animator::GetBoneCount() const
+{
+	return static_cast<uint32_t>(mBoneTransforms.size());
+}
+
+void Animator::StartLayer(Layer& layer, uint32_t clipIndex, bool looping)
+{
+	layer.clip = &mModel->animationClips[clipIndex];
+	layer.time = 0.0f;
+	layer.looping = looping;
+	layer.cursors.assign(layer.cursors.size(), {});
+	ASSERT(layer.clip->boneAnimations.size() <= layer.cursors.size(), "Animator: clip %s has more bones than the skeleton", layer.clip->name.c_str());
+}
+
+void Animator::AdvanceLayer(Layer& layer, float deltaTime)
+{
+	const float duration = layer.clip->duration;
+	layer.time += deltaTime;
+	if (duration <= 0.0f)
+	{
+		layer.time = 0.0f;
+	}
+	else if (layer.looping)
+	{
+		layer.time = fmodf(layer.time, duration);
+		if (layer.time < 0.0f)
+		{
+			layer.time += duration;
+		}
+	}
+	else
+	{
+		layer.time = Math::Clamp(layer.time, 0.0f, duration);
+	}
+}
+
+void Animator::SampleLayer(Layer& layer, Pose& pose)
+{
+	const std::vector<BoneAnimation>& boneAnimations = layer.clip->boneAnimations;
+	const size_t boneCount = pose.positions.size();
+	const size_t trackCount = Math::Min(boneAnimations.size(), boneCount);
+	for (size_t i = 0; i < trackCount; ++i)
+	{
+		const BoneAnimation& boneAnimation = boneAnimations[i];
+		KeyCursor& cursor = layer.cursors[i];
+		pose.positions[i] = boneAnimation.positionKeys.empty() ? mBindPose.positions[i] : Sample(boneAnimation.positionKeys, layer.time, cursor.position);
+		pose.rotations[i] = boneAnimation.rotationKeys.empty() ? mBindPose.rotations[i] : Sample(boneAnimation.rotationKeys, layer.time, cursor.rotation);
+		pose.scales[i] = boneAnimation.scaleKeys.empty() ? mBindPose.scales[i] : Sample(boneAnimation.scaleKeys, layer.time, cursor.scale);
+	}
+	for (size_t i = trackCount; i < boneCount; ++i)
+	{
+		pose.positions[i] = mBindPose.positions[i];
+		pose.rotations[i] = mBindPose.rotations[i];
+		pose.scales[i] = mBindPose.scales[i];
+	}
+}
+
+void Animator::BuildPalette()
+{
+	// Bones are stored parent first, so every parent is finished before its children
+	const std::vector<Bone>& bones = mModel->skeleton.bones;
+	for (size_t i = 0; i < bones.size(); ++i)
+	{
+		const Math::Matrix4 local =
+			Math::Matrix4::Scaling(mPose.scales[i]) *
+			Math::Matrix4::MatrixRotationQuaternion(mPose.rotations[i]) *
+			Math::Matrix4::Translation(mPose.positions[i]);
+		const int parentIndex = bones[i].parentIndex;
+		mBoneTransforms[i] = (parentIndex >= 0) ? local * mBoneTransforms[parentIndex] : local;
+		mSkinTransforms[i] = bones[i].offsetTransform * mBoneTransforms[i];
+	}
+	++mPoseVersion;
+}
\ No newline at end of file
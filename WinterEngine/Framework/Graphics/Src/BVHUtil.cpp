@@ -0,0 +1,91 @@
+#include "Precompile.h"
+#include "BVHUtil.h"
+
+using namespace WinterEngine;
+using namespace WinterEngine::Graphics;
+
+namespace
+{
+	constexpr uint32_t BinCount = 16;
+
+	inline float GetAxis(const Math::Vector3& v, uint32_t axis)
+	{
+		return (axis == 0) ? v.x : (axis == 1) ? v.y : v.z;
+	}
+}
+
+uint32_t BVHUtil::PartitionBinnedSAH(BuildEntry* entries, uint32_t count, float& splitCost)
+{
+	Math::AABB centroidBounds;
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		centroidBounds = Math::Merge(centroidBounds, { entries[i].centroid, entries[i].centroid });
+	}
+
+	const uint32_t binCount = Math::Min(count, BinCount);
+	uint32_t bestAxis = 0;
+	uint32_t bestSplit = binCount;
+	float bestCost = FLT_MAX;
+	for (uint32_t axis = 0; axis < 3 && count > 1; ++axis)
+	{
+		const float axisMin = GetAxis(centroidBounds.min, axis);
+		const float extent = GetAxis(centroidBounds.max, axis) - axisMin;
+		if (extent <= 0.0f)
+		{
+			continue;
+		}
+
+		Math::AABB binAABBs[BinCount];
+		uint32_t binCounts[BinCount] = {};
+		const float scale = binCount * 0.9999f / extent;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const uint32_t bin = Math::Min(static_cast<uint32_t>((GetAxis(entries[i].centroid, axis) - axisMin) * scale), binCount - 1);
+			binAABBs[bin] = Math::Merge(binAABBs[bin], entries[i].aabb);
+			++binCounts[bin];
+		}
+
+		float rightAreas[BinCount];
+		Math::AABB rightAABB;
+		for (uint32_t bin = binCount - 1; bin > 0; --bin)
+		{
+			rightAABB = Math::Merge(rightAABB, binAABBs[bin]);
+			rightAreas[bin] = rightAABB.IsEmpty() ? 0.0f : rightAABB.GetHalfArea();
+		}
+
+		Math::AABB leftAABB;
+		uint32_t leftCount = 0;
+		for (uint32_t split = 0; split + 1 < binCount; ++split)
+		{
+			leftAABB = Math::Merge(leftAABB, binAABBs[split]);
+			leftCount += binCounts[split];
+			if (leftCount == 0 || leftCount == count)
+			{
+				continue;
+			}
+
+			const float cost = (leftAABB.GetHalfArea() * leftCount) + (rightAreas[split + 1] * (count - leftCount));
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				bestAxis = axis;
+				bestSplit = split;
+			}
+		}
+	}
+
+	splitCost = bestCost;
+	if (bestSplit == binCount)
+	{
+		// All centroids in one spot, any split is as good as another
+		return count / 2;
+	}
+
+	const float axisMin = GetAxis(centroidBounds.min, bestAxis);
+	const float scale = binCount * 0.9999f / (GetAxis(centroidBounds.max, bestAxis) - axisMin);
+	BuildEntry* middle = std::partition(entries, entries + count, [=](const BuildEntry& entry)
+	{
+		return Math::Min(static_cast<uint32_t>((GetAxis(entry.centroid, bestAxis) - axisMin) * scale), binCount - 1) <= bestSplit;
+	});
+	return static_cast<uint32_t>(middle - entries);
+}
\ No newline at end of file
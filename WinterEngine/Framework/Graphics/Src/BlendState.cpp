@@ -43,7 +43,13 @@ namespace
 
 void BlendState::ClearState()
 {
-	auto context = GraphicsSystem::Get()->GetContext();
+	GraphicsSystem* gs = GraphicsSystem::Get();
+	gs->RecordBind(BindPoint::BlendState, 0, nullptr);
+	if (gs->IsHeadless())
+	{
+		return;
+	}
+	auto context = gs->GetContext();
 	context->OMSetBlendState(nullptr, nullptr, UINT_MAX);
 }
 
@@ -54,6 +60,13 @@ BlendState::~BlendState()
 
 void BlendState::Initialize(Mode mode)
 {
+	GraphicsSystem* gs = GraphicsSystem::Get();
+	gs->RecordResourceCreated(0);
+	if (gs->IsHeadless())
+	{
+		return;
+	}
+
 	D3D11_BLEND srcBlend = GetSrcBlend(mode);
 	D3D11_BLEND destBlend = GetDestBlend(mode);
 
@@ -64,7 +77,7 @@ void BlendState::Initialize(Mode mode)
 	desc.RenderTarget[0].BlendOp = desc.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
 	desc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
 
-	auto device = GraphicsSystem::Get()->GetDevice();
+	auto device = gs->GetDevice();
 	HRESULT hr = device->CreateBlendState(&desc, &mBlendState);
 	ASSERT(SUCCEEDED(hr), "BlendState: failed to create blend state");
 }
@@ -76,6 +89,12 @@ void BlendState::Terminate()
 
 void BlendState::Set()
 {
-	auto context = GraphicsSystem::Get()->GetContext();
+	GraphicsSystem* gs = GraphicsSystem::Get();
+	gs->RecordBind(BindPoint::BlendState, 0, this);
+	if (gs->IsHeadless())
+	{
+		return;
+	}
+	auto context = gs->GetContext();
 	context->OMSetBlendState(mBlendState, nullptr, UINT_MAX);
 }
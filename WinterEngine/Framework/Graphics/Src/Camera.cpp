@@ -144,6 +144,27 @@ Math::Matrix4 Camera::GetPerspectiveMatrix() const
 	};
 }
 
+Math::Frustum Camera::GetFrustum() const
+{
+	return Math::Frustum::FromMatrix(GetViewMatrix() * GetProjectionMatrix());
+}
+
+float Camera::GetScreenSize(const Math::Vector3& center, float radius) const
+{
+	if (mProjectionMode == ProjectionMode::Orthographic)
+	{
+		const float h = (mHeight == 0.0f) ? GraphicsSystem::Get()->GetBackBufferHeight() : mHeight;
+		return Math::Min(2.0f * radius / h, 1.0f);
+	}
+
+	const float distance = Math::Magnitude(center - mPosition);
+	if (distance <= radius)
+	{
+		return 1.0f;
+	}
+	return Math::Min(radius / (distance * std::tan(mFov * 0.5f)), 1.0f);
+}
+
 Math::Matrix4 Camera::GetOrthographicMatrix() const
 {
 	const float w = (mWidth == 0.0f) ? GraphicsSystem::Get()->GetBackBufferWidth() : mWidth;
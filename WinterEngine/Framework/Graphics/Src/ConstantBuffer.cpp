@@ -13,6 +13,14 @@ ConstantBuffer::~ConstantBuffer()
 
 void ConstantBuffer::Initialize(uint32_t bufferSize)
 {
+	mBufferSize = bufferSize;
+	GraphicsSystem* gs = GraphicsSystem::Get();
+	gs->RecordResourceCreated(0);
+	if (gs->IsHeadless())
+	{
+		return;
+	}
+
 	D3D11_BUFFER_DESC desc{};
 	desc.ByteWidth = bufferSize;
 	desc.Usage = D3D11_USAGE_DEFAULT;
@@ -21,7 +29,7 @@ void ConstantBuffer::Initialize(uint32_t bufferSize)
 	desc.MiscFlags = 0;
 	desc.StructureByteStride = 0;
 
-	auto device = GraphicsSystem::Get()->GetDevice();
+	auto device = gs->GetDevice();
 	HRESULT hr = device->CreateBuffer(&desc, nullptr, &mConstantBuffer);
 	ASSERT(SUCCEEDED(hr), "ConstantBuffer: failed to create buffer");
 }
@@ -29,22 +37,41 @@ void ConstantBuffer::Initialize(uint32_t bufferSize)
 void ConstantBuffer::Terminate()
 {
 	SafeRelease(mConstantBuffer);
+	mBufferSize = 0;
 }
 
 void ConstantBuffer::Update(const void* data) const
 {
-	auto context = GraphicsSystem::Get()->GetContext();
+	GraphicsSystem* gs = GraphicsSystem::Get();
+	gs->RecordUpload(mBufferSize);
+	if (gs->IsHeadless())
+	{
+		return;
+	}
+	auto context = gs->GetContext();
 	context->UpdateSubresource(mConstantBuffer, 0, nullptr, data, 0, 0);
 }
 
 void ConstantBuffer::BindVS(uint32_t slot) const
 {
-	auto context = GraphicsSystem::Get()->GetContext();
+	GraphicsSystem* gs = GraphicsSystem::Get();
+	gs->RecordBind(BindPoint::VSConstantBuffer, slot, this);
+	if (gs->IsHeadless())
+	{
+		return;
+	}
+	auto context = gs->GetContext();
 	context->VSSetConstantBuffers(slot, 1, &mConstantBuffer);
 }
 
 void ConstantBuffer::BindPS(uint32_t slot) const
 {
-	auto context = GraphicsSystem::Get()->GetContext();
+	GraphicsSystem* gs = GraphicsSystem::Get();
+	gs->RecordBind(BindPoint::PSConstantBuffer, slot, this);
+	if (gs->IsHeadless())
+	{
+		return;
+	}
+	auto context = gs->GetContext();
 	context->PSSetConstantBuffers(slot, 1, &mConstantBuffer);
 }
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include "Precompile.h"
+#include "CullingPass.h"
+
+#include "Animator.h"
+#include "Camera.h"
+#include "RenderObject.h"
+
+using namespace WinterEngine;
+using namespace WinterEngine::Graphics;
+
+void CullingPass::Clear()
+{
+	mRenderObjects.clear();
+	mRenderGroups.clear();
+	mVisibleObjects.clear();
+	mVisibleGroups.clear();
+	mStats = {};
+}
+
+void CullingPass::Add(const RenderObject& renderObject)
+{
+	mRenderObjects.push_back(&renderObject);
+}
+
+void CullingPass::Add(const RenderGroup& renderGroup)
+{
+	mRenderGroups.push_back({ &renderGroup, nullptr, 0.0f });
+}
+
+void CullingPass::Add(const RenderGroup& renderGroup, const Animator& animator, float padding)
+{
+	mRenderGroups.push_back({ &renderGroup, &animator, padding });
+}
+
+void CullingPass::Cull(const Camera& camera)
+{
+	Cull(camera.GetFrustum());
+}
+
+void CullingPass::Cull(const Math::Frustum& frustum)
+{
+	const auto startTime = std::chrono::steady_clock::now();
+	mVisibleObjects.clear();
+	mVisibleGroups.clear();
+	mStats = {};
+
+	// Standalone objects and whole groups go through one batch
+	const size_t objectCount = mRenderObjects.size();
+	const size_t groupCount = mRenderGroups.size();
+	mBoxes.resize(objectCount + groupCount);
+	mVisible.resize(objectCount + groupCount);
+	for (size_t i = 0; i < objectCount; ++i)
+	{
+		mBoxes[i] = mRenderObjects[i]->GetWorldAABB();
+	}
+	for (size_t i = 0; i < groupCount; ++i)
+	{
+		const GroupEntry& entry = mRenderGroups[i];
+		if (entry.animator == nullptr || entry.animator->GetBoneTransforms().empty())
+		{
+			mBoxes[objectCount + i] = entry.renderGroup->GetWorldAABB();
+			continue;
+		}
+
+		// Bone origins are the translation rows of the model space bone transforms
+		const std::vector<Math::Matrix4>& boneTransforms = entry.animator->GetBoneTransforms();
+		Math::AABB posedBox = Math::ComputeAABB(reinterpret_cast<const Math::Vector3*>(&boneTransforms[0]._41), sizeof(Math::Matrix4), boneTransforms.size());
+		posedBox.min -= Math::Vector3(entry.padding);
+		posedBox.max += Math::Vector3(entry.padding);
+		mBoxes[objectCount + i] = Math::TransformAABB(Math::Merge(entry.renderGroup->aabb, posedBox), entry.renderGroup->GetWorldMatrix());
+	}
+	Math::CullAABBs(frustum, mBoxes.data(), mBoxes.size(), mVisible.data());
+
+	for (size_t i = 0; i < objectCount; ++i)
+	{
+		if (mVisible[i] != 0)
+		{
+			mVisibleObjects.push_back(mRenderObjects[i]);
+		}
+	}
+	mStats.testedObjects = static_cast<uint32_t>(objectCount);
+	mStats.visibleObjects = static_cast<uint32_t>(mVisibleObjects.size());
+	mStats.testedGroups = static_cast<uint32_t>(groupCount);
+
+	// Masks are written into one buffer and pointed at once it stops growing
+	std::vector<size_t> maskOffsets;
+	mObjectMasks.clear();
+	for (size_t i = 0; i < groupCount; ++i)
+	{
+		const GroupEntry& entry = mRenderGroups[i];
+		const RenderGroup& renderGroup = *entry.renderGroup;
+		const size_t renderObjectCount = renderGroup.renderObjects.size();
+		mStats.testedObjects += static_cast<uint32_t>(renderObjectCount);
+		if (mVisible[objectCount + i] == 0)
+		{
+			continue;
+		}
+
+		// Bind-pose boxes of skinned render objects say nothing about the pose, draw them all
+		if (entry.animator != nullptr)
+		{
+			const size_t maskOffset = mObjectMasks.size();
+			mObjectMasks.resize(maskOffset + renderObjectCount, 1);
+			mVisibleGroups.push_back({ &renderGroup, entry.animator, nullptr });
+			maskOffsets.push_back(maskOffset);
+			mStats.visibleObjects += static_cast<uint32_t>(renderObjectCount);
+			continue;
+		}
+
+		// Render objects of a group sit in the group's model space
+		const Math::Matrix4 world = renderGroup.GetWorldMatrix();
+		mBoxes.resize(renderObjectCount);
+		for (size_t r = 0; r < renderObjectCount; ++r)
+		{
+			mBoxes[r] = Math::TransformAABB(renderGroup.renderObjects[r].aabb, world);
+		}
+		const size_t maskOffset = mObjectMasks.size();
+		mObjectMasks.resize(maskOffset + renderObjectCount);
+		const size_t visibleCount = Math::CullAABBs(frustum, mBoxes.data(), renderObjectCount, mObjectMasks.data() + maskOffset);
+		if (visibleCount > 0)
+		{
+			mVisibleGroups.push_back({ &renderGroup, nullptr, nullptr });
+			maskOffsets.push_back(maskOffset);
+			mStats.visibleObjects += static_cast<uint32_t>(visibleCount);
+		}
+	}
+	for (size_t i = 0; i < mVisibleGroups.size(); ++i)
+	{
+		mVisibleGroups[i].objectMask = mObjectMasks.data() + maskOffsets[i];
+	}
+	mStats.visibleGroups = static_cast<uint32_t>(mVisibleGroups.size());
+	mStats.cullTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void CullingPass::DebugUI(const char* name)
+{
+	if (ImGui::CollapsingHeader(name, ImGuiTreeNodeFlags_DefaultOpen))
+	{
+		ImGui::Text("Objects: %u visible, %u culled", mStats.visibleObjects, mStats.testedObjects - mStats.visibleObjects);
+		ImGui::Text("Groups: %u visible, %u culled", mStats.visibleGroups, mStats.testedGroups - mStats.visibleGroups);
+		ImGui::Text("Cull time: %.3f ms", mStats.cullTime);
+	}
+}
\ No newline at end of file
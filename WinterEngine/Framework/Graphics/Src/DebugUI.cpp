@@ -94,6 +94,7 @@ void DebugUI::StaticInitialize(HWND window, bool docking, bool multiViewport)
 		io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;
 	}
 
+	ASSERT(!GraphicsSystem::Get()->IsHeadless(), "DebugUI: needs a device, skip it when running headless");
 	auto device = GraphicsSystem::Get()->GetDevice();
 	auto context = GraphicsSystem::Get()->GetContext();
 	ImGui_ImplWin32_Init(window);
@@ -38,6 +38,13 @@ void GraphicsSystem::StaticInitialize(HWND window, bool fullscreen)
 	sGraphicsSystem->Initialize(window, fullscreen);
 }
 
+void GraphicsSystem::StaticInitializeHeadless(uint32_t width, uint32_t height)
+{
+	ASSERT(sGraphicsSystem == nullptr, "GraphicsSystem: is already initialized");
+	sGraphicsSystem = std::make_unique<GraphicsSystem>();
+	sGraphicsSystem->InitializeHeadless(width, height);
+}
+
 void GraphicsSystem::StaticTerminate()
 {
 	if (sGraphicsSystem != nullptr)
@@ -104,8 +111,25 @@ void GraphicsSystem::Initialize(HWND window, bool fullscreen)
 	sWindowMessageHandler.Hook(window, GraphicsSystemMessageHandler);
 }
 
+void GraphicsSystem::InitializeHeadless(uint32_t width, uint32_t height)
+{
+	mHeadless = true;
+	mSwapChainDesc.BufferDesc.Width = width;
+	mSwapChainDesc.BufferDesc.Height = height;
+
+	mViewPort.Width = static_cast<float>(width);
+	mViewPort.Height = static_cast<float>(height);
+	mViewPort.MinDepth = 0.0f;
+	mViewPort.MaxDepth = 1.0f;
+	LOG("GraphicsSystem: running headless at %ux%u", width, height);
+}
+
 void GraphicsSystem::Terminate()
 {
+	if (mHeadless)
+	{
+		return;
+	}
 	sWindowMessageHandler.Unhook();
 
 	SafeRelease(mDepthStencilView);
@@ -118,6 +142,19 @@ void GraphicsSystem::Terminate()
 
 void GraphicsSystem::BeginRender()
 {
+	mRenderStartTime = TimeUtil::GetTime();
+	for (auto& pointBindings : mBindings)
+	{
+		for (Binding& binding : pointBindings)
+		{
+			binding = {};
+		}
+	}
+	RecordBind(BindPoint::RenderTarget, 0, this);
+	if (mHeadless)
+	{
+		return;
+	}
 	mImmediateContext->OMSetRenderTargets(1, &mRenderTargetView, mDepthStencilView);
 	mImmediateContext->ClearRenderTargetView(mRenderTargetView, (FLOAT*)&mClearColor);
 	mImmediateContext->ClearDepthStencilView(mDepthStencilView, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0.0f);
@@ -125,11 +162,21 @@ void GraphicsSystem::BeginRender()
 
 void GraphicsSystem::EndRender()
 {
-	mSwapChain->Present(mVSync, 0);
+	if (!mHeadless)
+	{
+		mSwapChain->Present(mVSync, 0);
+	}
+	mFrameStats.renderTime = TimeUtil::GetTime() - mRenderStartTime;
+	mLastFrameStats = mFrameStats;
+	mFrameStats = {};
 }
 
 void GraphicsSystem::ToggleFullScreen()
 {
+	if (mHeadless)
+	{
+		return;
+	}
 	BOOL fullscreen;
 	mSwapChain->GetFullscreenState(&fullscreen, nullptr);
 	mSwapChain->SetFullscreenState(!fullscreen, nullptr);
@@ -137,6 +184,14 @@ void GraphicsSystem::ToggleFullScreen()
 
 void GraphicsSystem::Resize(uint32_t width, uint32_t height)
 {
+	if (mHeadless)
+	{
+		mSwapChainDesc.BufferDesc.Width = width;
+		mSwapChainDesc.BufferDesc.Height = height;
+		mViewPort.Width = static_cast<float>(width);
+		mViewPort.Height = static_cast<float>(height);
+		return;
+	}
 	mImmediateContext->OMSetRenderTargets(0, nullptr, nullptr);
 
 	SafeRelease(mRenderTargetView);
@@ -195,11 +250,21 @@ void GraphicsSystem::Resize(uint32_t width, uint32_t height)
 
 void GraphicsSystem::ResetRenderTarget()
 {
+	RecordBind(BindPoint::RenderTarget, 0, this);
+	if (mHeadless)
+	{
+		return;
+	}
 	mImmediateContext->OMSetRenderTargets(1, &mRenderTargetView, mDepthStencilView);
 }
 
 void GraphicsSystem::ResetViewport()
 {
+	RecordBind(BindPoint::Viewport, 0, this);
+	if (mHeadless)
+	{
+		return;
+	}
 	mImmediateContext->RSSetViewports(1, &mViewPort);
 }
 
@@ -213,6 +278,53 @@ void GraphicsSystem::SetVsync(bool vSync)
 	mVSync = vSync ? 1 : 0;
 }
 
+void GraphicsSystem::RecordDraw(uint32_t vertexCount)
+{
+	++mFrameStats.drawCalls;
+	mFrameStats.verticesSubmitted += vertexCount;
+}
+
+void GraphicsSystem::RecordBind(BindPoint point, uint32_t slot, const void* object)
+{
+	ASSERT(slot < MaxBindSlots, "GraphicsSystem: bind slot %u is past the %u tracked", slot, MaxBindSlots);
+	Binding& binding = mBindings[static_cast<uint32_t>(point)][slot];
+	if (!binding.known || binding.object != object)
+	{
+		binding.object = object;
+		binding.known = true;
+		++mFrameStats.stateChanges;
+	}
+}
+
+const void* GraphicsSystem::GetBoundObject(BindPoint point, uint32_t slot) const
+{
+	ASSERT(slot < MaxBindSlots, "GraphicsSystem: bind slot %u is past the %u tracked", slot, MaxBindSlots);
+	return mBindings[static_cast<uint32_t>(point)][slot].object;
+}
+
+void GraphicsSystem::RecordUpload(size_t byteCount)
+{
+	mFrameStats.bytesUploaded += byteCount;
+}
+
+void GraphicsSystem::RecordResourceCreated(size_t byteCount)
+{
+	++mFrameStats.resourcesCreated;
+	mFrameStats.bytesUploaded += byteCount;
+}
+
+void GraphicsSystem::DebugUI()
+{
+	if (ImGui::CollapsingHeader("GraphicsSystem", ImGuiTreeNodeFlags_DefaultOpen))
+	{
+		const GraphicsStats& stats = mLastFrameStats;
+		ImGui::Text("Draw calls: %u, vertices: %u", stats.drawCalls, stats.verticesSubmitted);
+		ImGui::Text("State changes: %u", stats.stateChanges);
+		ImGui::Text("Uploaded: %.1f KB, resources created: %u", static_cast<float>(stats.bytesUploaded) / 1024.0f, stats.resourcesCreated);
+		ImGui::Text("Render time: %.3f ms", stats.renderTime * 1000.0f);
+	}
+}
+
 uint32_t GraphicsSystem::GetBackBufferWidth() const
 {
 	return mSwapChainDesc.BufferDesc.Width;
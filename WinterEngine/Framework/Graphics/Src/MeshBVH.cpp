@@ -0,0 +1,211 @@
+#include "Precompile.h"
+#include "MeshBVH.h"
+
+using namespace WinterEngine;
+using namespace WinterEngine::Graphics;
+
+namespace
+{
+	constexpr uint32_t MaxLeafSize = 8;
+	constexpr uint32_t ParallelThreshold = 64;
+	constexpr uint32_t BatchSize = 16;
+}
+
+void MeshBVH::Initialize(const Math::Vector3* positions, size_t stride, const uint32_t* indices, size_t indexCount)
+{
+	Terminate();
+	const uint32_t triangleCount = static_cast<uint32_t>(indexCount / 3);
+	if (triangleCount == 0)
+	{
+		return;
+	}
+
+	auto position = [positions, stride](uint32_t index) -> const Math::Vector3&
+	{
+		return *reinterpret_cast<const Math::Vector3*>(reinterpret_cast<const uint8_t*>(positions) + (index * stride));
+	};
+
+	std::vector<Triangle> triangles(triangleCount);
+	std::vector<BVHUtil::BuildEntry> entries(triangleCount);
+	for (uint32_t i = 0; i < triangleCount; ++i)
+	{
+		const Math::Vector3& a = position(indices[(i * 3) + 0]);
+		const Math::Vector3& b = position(indices[(i * 3) + 1]);
+		const Math::Vector3& c = position(indices[(i * 3) + 2]);
+		triangles[i] = { a, b, c, i };
+
+		BVHUtil::BuildEntry& entry = entries[i];
+		entry.aabb = Math::Merge(Math::Merge({ a, a }, { b, b }), { c, c });
+		entry.centroid = entry.aabb.GetCenter();
+		entry.index = i;
+	}
+
+	mNodes.reserve((triangleCount * 2) - 1);
+	mNodes.emplace_back();
+	BuildNode(0, entries.data(), 0, triangleCount);
+	mNodes.shrink_to_fit();
+
+	// Triangles move into leaf order so each leaf reads one contiguous run
+	mTriangles.resize(triangleCount);
+	for (uint32_t i = 0; i < triangleCount; ++i)
+	{
+		mTriangles[i] = triangles[entries[i].index];
+	}
+}
+
+void MeshBVH::Terminate()
+{
+	mNodes.clear();
+	mTriangles.clear();
+}
+
+bool MeshBVH::RayCast(const Math::Ray& ray, float maxDistance, RayHit& hit) const
+{
+	std::vector<uint32_t> stack;
+	return RayCast(ray, maxDistance, hit, stack);
+}
+
+void MeshBVH::RayCasts(const Math::Ray* rays, size_t count, float maxDistance, RayHit* hits) const
+{
+	auto castRange = [this, rays, maxDistance, hits](uint32_t begin, uint32_t end)
+	{
+		std::vector<uint32_t> stack;
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			hits[i] = {};
+			RayCast(rays[i], maxDistance, hits[i], stack);
+		}
+	};
+	const uint32_t rayCount = static_cast<uint32_t>(count);
+	if (rayCount >= ParallelThreshold)
+	{
+		Core::JobSystem::Get()->ParallelFor(rayCount, BatchSize, castRange);
+	}
+	else
+	{
+		castRange(0, rayCount);
+	}
+}
+
+const Math::AABB& MeshBVH::GetAABB() const
+{
+	static const Math::AABB empty;
+	return mNodes.empty() ? empty : mNodes[0].aabb;
+}
+
+void MeshBVH::BuildNode(uint32_t nodeIndex, BVHUtil::BuildEntry* entries, uint32_t first, uint32_t count)
+{
+	Math::AABB aabb;
+	for (uint32_t i = first; i < first + count; ++i)
+	{
+		aabb = Math::Merge(aabb, entries[i].aabb);
+	}
+	mNodes[nodeIndex].aabb = aabb;
+
+	// A traversal step costs as much as one triangle test, so a split has to beat testing
+	// every triangle here. Ranges over MaxLeafSize are split regardless
+	float sahCost = FLT_MAX;
+	const uint32_t leftCount = BVHUtil::PartitionBinnedSAH(entries + first, count, sahCost);
+	const float leafCost = aabb.GetHalfArea() * count;
+	const float splitCost = aabb.GetHalfArea() + sahCost;
+	if (count == 1 || (count <= MaxLeafSize && leafCost <= splitCost))
+	{
+		mNodes[nodeIndex].first = first;
+		mNodes[nodeIndex].count = count;
+		return;
+	}
+
+	// Left child right after its parent, the right one after the whole left subtree
+	const uint32_t left = static_cast<uint32_t>(mNodes.size());
+	mNodes.emplace_back();
+	BuildNode(left, entries, first, leftCount);
+	const uint32_t right = static_cast<uint32_t>(mNodes.size());
+	mNodes.emplace_back();
+	BuildNode(right, entries, first + leftCount, count - leftCount);
+	mNodes[nodeIndex].first = right;
+}
+
+bool MeshBVH::RayCast(const Math::Ray& ray, float maxDistance, RayHit& hit, std::vector<uint32_t>& stack) const
+{
+	if (mNodes.empty())
+	{
+		return false;
+	}
+
+	const Math::InverseRay inverseRay = Math::MakeInverseRay(ray);
+	float bestDistance = maxDistance;
+	bool found = false;
+	float distance = 0.0f;
+	if (!Math::Intersect(inverseRay, mNodes[0].aabb, bestDistance, distance))
+	{
+		return false;
+	}
+
+	// Nearer child first, the farther one waits on the stack and is dropped if a hit
+	// closer than its box turns up in the meantime
+	stack.clear();
+	uint32_t index = 0;
+	while (true)
+	{
+		const Node& node = mNodes[index];
+		if (node.count > 0)
+		{
+			for (uint32_t i = node.first; i < node.first + node.count; ++i)
+			{
+				const Triangle& triangle = mTriangles[i];
+				float t = 0.0f;
+				float u = 0.0f;
+				float v = 0.0f;
+				if (!Math::Intersect(ray, triangle.a, triangle.b, triangle.c, bestDistance, t, u, v))
+				{
+					continue;
+				}
+				bestDistance = t;
+				hit = { triangle.index, t, u, v };
+				found = true;
+			}
+		}
+		else
+		{
+			const uint32_t children[2] = { index + 1, node.first };
+			float distances[2];
+			const bool hits[2] = {
+				Math::Intersect(inverseRay, mNodes[children[0]].aabb, bestDistance, distances[0]),
+				Math::Intersect(inverseRay, mNodes[children[1]].aabb, bestDistance, distances[1])
+			};
+			if (hits[0] && hits[1])
+			{
+				const uint32_t nearChild = (distances[1] < distances[0]) ? 1 : 0;
+				stack.push_back(children[1 - nearChild]);
+				stack.push_back(BVHUtil::FloatBits(distances[1 - nearChild]));
+				index = children[nearChild];
+				continue;
+			}
+			if (hits[0] || hits[1])
+			{
+				index = hits[0] ? children[0] : children[1];
+				continue;
+			}
+		}
+
+		// Next waiting node that can still hold something closer
+		bool next = false;
+		while (!stack.empty())
+		{
+			const float entryDistance = BVHUtil::BitsFloat(stack.back());
+			stack.pop_back();
+			index = stack.back();
+			stack.pop_back();
+			if (entryDistance <= bestDistance)
+			{
+				next = true;
+				break;
+			}
+		}
+		if (!next)
+		{
+			break;
+		}
+	}
+	return found;
+}
\ No newline at end of file
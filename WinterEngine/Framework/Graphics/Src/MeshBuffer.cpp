@@ -22,6 +22,8 @@ void MeshBuffer::Terminate()
 {
 	SafeRelease(mIndexBuffer);
 	SafeRelease(mVertexBuffer);
+	mVertexCount = 0;
+	mIndexCount = 0;
 }
 
 void MeshBuffer::SetTopology(Topology topology)
@@ -45,7 +47,13 @@ void MeshBuffer::SetTopology(Topology topology)
 void MeshBuffer::Update(const void* vertices, uint32_t vertexCount)
 {
 	mVertexCount = vertexCount;
-	auto context = GraphicsSystem::Get()->GetContext();
+	GraphicsSystem* gs = GraphicsSystem::Get();
+	gs->RecordUpload(static_cast<size_t>(vertexCount) * mVertexSize);
+	if (gs->IsHeadless())
+	{
+		return;
+	}
+	auto context = gs->GetContext();
 
 	D3D11_MAPPED_SUBRESOURCE resource;
 	context->Map(mVertexBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &resource);
@@ -55,7 +63,14 @@ void MeshBuffer::Update(const void* vertices, uint32_t vertexCount)
 
 void MeshBuffer::Render() const
 {
-	auto context = GraphicsSystem::Get()->GetContext();
+	GraphicsSystem* gs = GraphicsSystem::Get();
+	gs->RecordBind(BindPoint::MeshBuffer, 0, this);
+	gs->RecordDraw(mIndexCount > 0 ? mIndexCount : mVertexCount);
+	if (gs->IsHeadless())
+	{
+		return;
+	}
+	auto context = gs->GetContext();
 
 	context->IASetPrimitiveTopology(mTopology);
 
@@ -72,13 +87,39 @@ void MeshBuffer::Render() const
 	}
 }
 
+void MeshBuffer::Render(uint32_t startIndex, uint32_t indexCount, int32_t baseVertex) const
+{
+	ASSERT(mIndexCount > 0, "MeshBuffer: index range render requires an index buffer");
+	GraphicsSystem* gs = GraphicsSystem::Get();
+	gs->RecordBind(BindPoint::MeshBuffer, 0, this);
+	gs->RecordDraw(indexCount);
+	if (gs->IsHeadless())
+	{
+		return;
+	}
+	auto context = gs->GetContext();
+
+	context->IASetPrimitiveTopology(mTopology);
+
+	UINT offset = 0;
+	context->IASetVertexBuffers(0, 1, &mVertexBuffer, &mVertexSize, &offset);
+	context->IASetIndexBuffer(mIndexBuffer, DXGI_FORMAT_R32_UINT, 0);
+	context->DrawIndexed(static_cast<UINT>(indexCount), static_cast<UINT>(startIndex), static_cast<INT>(baseVertex));
+}
+
 void MeshBuffer::CreateVertexBuffer(const void* vertices, uint32_t vertexSize, uint32_t vertexCount)
 {
 	mVertexSize = vertexSize;
 	mVertexCount = vertexCount;
 
 	const bool isDynamic = (vertices == nullptr);
-	auto device = GraphicsSystem::Get()->GetDevice();
+	GraphicsSystem* gs = GraphicsSystem::Get();
+	gs->RecordResourceCreated(isDynamic ? 0 : static_cast<size_t>(vertexCount) * vertexSize);
+	if (gs->IsHeadless())
+	{
+		return;
+	}
+	auto device = gs->GetDevice();
 	//create a way to send data to gpu
 	//we need a vertex buffer
 	D3D11_BUFFER_DESC bufferDesc = {};
@@ -103,7 +144,13 @@ void MeshBuffer::CreateIndexBuffer(const void* indices, uint32_t indexCount)
 		return;
 	}
 	mIndexCount = indexCount;
-	auto device = GraphicsSystem::Get()->GetDevice();
+	GraphicsSystem* gs = GraphicsSystem::Get();
+	gs->RecordResourceCreated(static_cast<size_t>(indexCount) * sizeof(uint32_t));
+	if (gs->IsHeadless())
+	{
+		return;
+	}
+	auto device = gs->GetDevice();
 	//index buffer
 	D3D11_BUFFER_DESC bufferDesc = {};
 	bufferDesc.ByteWidth = static_cast<UINT>(indexCount) * sizeof(uint32_t);
@@ -104,6 +104,7 @@ MeshPC MeshBuilder::CreatePyramidPC(float size)
 		0, 4, 3
 	};
 
+	mesh.ComputeBounds();
 	return mesh;
 }
 
@@ -128,6 +129,7 @@ MeshPC MeshBuilder::CreateCubePC(float size)
 
 	CreateCubeIndices(mesh.indices);
 
+	mesh.ComputeBounds();
 	return mesh;
 }
 
@@ -154,6 +156,7 @@ MeshPC MeshBuilder::CreateRectPC(float width, float height, float depth)
 
 	CreateCubeIndices(mesh.indices);
 
+	mesh.ComputeBounds();
 	return mesh;
 }
 
@@ -182,6 +185,7 @@ MeshPC MeshBuilder::CreateVerticalPlanePC(uint32_t numRows, uint32_t numCols, fl
 
 	CreatePlaneIndicies(mesh.indices, numRows, numCols);
 
+	mesh.ComputeBounds();
 	return mesh;
 }
 
@@ -214,6 +218,7 @@ MeshPX WinterEngine::Graphics::MeshBuilder::CreateVerticalPlanePX(uint32_t numRo
 
 	CreatePlaneIndicies(mesh.indices, numRows, numCols);
 
+	mesh.ComputeBounds();
 	return mesh;
 }
 
@@ -242,6 +247,7 @@ MeshPC MeshBuilder::CreateHorizontalPlanePC(uint32_t numRows, uint32_t numCols,
 
 	CreatePlaneIndicies(mesh.indices, numRows, numCols);
 
+	mesh.ComputeBounds();
 	return mesh;
 }
 
@@ -274,6 +280,7 @@ MeshPX MeshBuilder::CreateHorizontalPlanePX(uint32_t numRows, uint32_t numCols,
 
 	CreatePlaneIndicies(mesh.indices, numRows, numCols);
 
+	mesh.ComputeBounds();
 	return mesh;
 }
 
@@ -306,6 +313,7 @@ Mesh WinterEngine::Graphics::MeshBuilder::CreateGroundPlane(int numRows, int num
 
 	CreatePlaneIndicies(mesh.indices, numRows, numCols);
 
+	mesh.ComputeBounds();
 	return mesh;
 }
 
@@ -357,6 +365,7 @@ MeshPC MeshBuilder::CreateCylinderPC(uint32_t slices, uint32_t rings)
 	}
 
 
+	mesh.ComputeBounds();
 	return mesh;
 }
 
@@ -389,6 +398,7 @@ MeshPC MeshBuilder::CreateSpherePC(uint32_t slices, uint32_t rings, float radius
 
 	CreatePlaneIndicies(mesh.indices, rings, slices);
 
+	mesh.ComputeBounds();
 	return mesh;
 }
 
@@ -426,6 +436,7 @@ MeshPX MeshBuilder::CreateSpherePX(uint32_t slices, uint32_t rings, float radius
 
 	CreatePlaneIndicies(mesh.indices, rings, slices);
 
+	mesh.ComputeBounds();
 	return mesh;
 }
 
@@ -466,6 +477,7 @@ Mesh MeshBuilder::CreateSphere(uint32_t slices, uint32_t rings, float radius)
 
 	CreatePlaneIndicies(mesh.indices, rings, slices);
 
+	mesh.ComputeBounds();
 	return mesh;
 }
 
@@ -503,6 +515,7 @@ MeshPX MeshBuilder::CreateSkySpherePX(uint32_t slices, uint32_t rings, float rad
 
 	CreatePlaneIndicies(mesh.indices, rings, slices);
 
+	mesh.ComputeBounds();
 	return mesh;
 }
 
@@ -573,6 +586,7 @@ MeshPX MeshBuilder::CreateSkyBoxPX(float size)
 		22, 20, 23
 	};
 
+	mesh.ComputeBounds();
 	return mesh;
 }
 
@@ -585,5 +599,6 @@ MeshPX MeshBuilder::CreateScreenQuad()
 	mesh.vertices.push_back({ { 1.0f, -1.0f, 0.0f}, {1.0f, 1.0f} });
 	mesh.indices = { 0, 1, 2, 0, 2, 3 };
 
+	mesh.ComputeBounds();
 	return mesh;
 }
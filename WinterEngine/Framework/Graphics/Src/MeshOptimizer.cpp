@@ -0,0 +1,657 @@
+#include "Precompile.h"
+#include "MeshOptimizer.h"
+
+using namespace WinterEngine;
+using namespace WinterEngine::Graphics;
+
+namespace
+{
+	constexpr uint32_t CacheLineSize = 64;
+	constexpr uint32_t FetchCacheLines = 32;
+
+	// Forsyth scoring constants
+	constexpr int32_t OptimizerCacheSize = 32;
+	constexpr float CacheDecayPower = 1.5f;
+	constexpr float LastTriangleScore = 0.75f;
+	constexpr float ValenceBoostScale = 2.0f;
+	constexpr float ValenceBoostPower = 0.5f;
+
+	float VertexScore(int32_t cachePosition, uint32_t remainingTriangles)
+	{
+		if (remainingTriangles == 0)
+		{
+			return -1.0f;
+		}
+
+		float score = 0.0f;
+		if (cachePosition >= 0)
+		{
+			if (cachePosition < 3)
+			{
+				score = LastTriangleScore;
+			}
+			else
+			{
+				const float scaler = 1.0f / (OptimizerCacheSize - 3);
+				score = std::pow(1.0f - ((cachePosition - 3) * scaler), CacheDecayPower);
+			}
+		}
+
+		score += ValenceBoostScale * std::pow(static_cast<float>(remainingTriangles), -ValenceBoostPower);
+		return score;
+	}
+
+	// Symmetric 4x4 plane quadric, accumulated in double to keep large meshes stable
+	struct Quadric
+	{
+		double a00 = 0.0, a01 = 0.0, a02 = 0.0, a03 = 0.0;
+		double a11 = 0.0, a12 = 0.0, a13 = 0.0;
+		double a22 = 0.0, a23 = 0.0;
+		double a33 = 0.0;
+
+		void AddPlane(double a, double b, double c, double d, double weight)
+		{
+			a00 += weight * a * a; a01 += weight * a * b; a02 += weight * a * c; a03 += weight * a * d;
+			a11 += weight * b * b; a12 += weight * b * c; a13 += weight * b * d;
+			a22 += weight * c * c; a23 += weight * c * d;
+			a33 += weight * d * d;
+		}
+
+		void Add(const Quadric& q)
+		{
+			a00 += q.a00; a01 += q.a01; a02 += q.a02; a03 += q.a03;
+			a11 += q.a11; a12 += q.a12; a13 += q.a13;
+			a22 += q.a22; a23 += q.a23;
+			a33 += q.a33;
+		}
+
+		double Evaluate(const Math::Vector3& p) const
+		{
+			const double x = p.x, y = p.y, z = p.z;
+			const double error =
+				(a00 * x * x) + (2.0 * a01 * x * y) + (2.0 * a02 * x * z) + (2.0 * a03 * x) +
+				(a11 * y * y) + (2.0 * a12 * y * z) + (2.0 * a13 * y) +
+				(a22 * z * z) + (2.0 * a23 * z) +
+				a33;
+			return (error > 0.0) ? error : 0.0;
+		}
+	};
+
+	struct Collapse
+	{
+		double cost = 0.0;
+		uint32_t from = 0;
+		uint32_t to = 0;
+		uint32_t fromVersion = 0;
+		uint32_t toVersion = 0;
+
+		bool operator>(const Collapse& other) const { return cost > other.cost; }
+	};
+
+	struct VertexHasher
+	{
+		const std::vector<Vertex>* vertices = nullptr;
+		size_t operator()(uint32_t index) const
+		{
+			// FNV-1a over the raw vertex bytes
+			const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&(*vertices)[index]);
+			size_t hash = 14695981039346656037ull;
+			for (size_t i = 0; i < sizeof(Vertex); ++i)
+			{
+				hash = (hash ^ bytes[i]) * 1099511628211ull;
+			}
+			return hash;
+		}
+	};
+
+	struct VertexEqual
+	{
+		const std::vector<Vertex>* vertices = nullptr;
+		bool operator()(uint32_t a, uint32_t b) const
+		{
+			return memcmp(&(*vertices)[a], &(*vertices)[b], sizeof(Vertex)) == 0;
+		}
+	};
+}
+
+MeshOptimizer::VertexCacheStats MeshOptimizer::AnalyzeVertexCache(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize)
+{
+	VertexCacheStats stats;
+	const size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0 || vertexCount == 0)
+	{
+		return stats;
+	}
+
+	// Each vertex remembers when it entered the FIFO, it is still cached while fewer than cacheSize misses followed
+	std::vector<uint32_t> cacheTimestamps(vertexCount, 0);
+	uint32_t timestamp = cacheSize + 1;
+	uint32_t misses = 0;
+	for (uint32_t index : indices)
+	{
+		if (timestamp - cacheTimestamps[index] > cacheSize)
+		{
+			cacheTimestamps[index] = timestamp++;
+			++misses;
+		}
+	}
+
+	stats.acmr = static_cast<float>(misses) / static_cast<float>(triangleCount);
+	stats.atvr = static_cast<float>(misses) / static_cast<float>(vertexCount);
+	return stats;
+}
+
+MeshOptimizer::VertexFetchStats MeshOptimizer::AnalyzeVertexFetch(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t vertexSize)
+{
+	VertexFetchStats stats;
+	if (indices.empty() || vertexCount == 0 || vertexSize == 0)
+	{
+		return stats;
+	}
+
+	// Small LRU of cache lines, most recently used at the back
+	std::vector<uint64_t> cacheLines;
+	cacheLines.reserve(FetchCacheLines);
+	for (uint32_t index : indices)
+	{
+		const uint64_t firstLine = (static_cast<uint64_t>(index) * vertexSize) / CacheLineSize;
+		const uint64_t lastLine = ((static_cast<uint64_t>(index) * vertexSize) + vertexSize - 1) / CacheLineSize;
+		for (uint64_t line = firstLine; line <= lastLine; ++line)
+		{
+			auto iter = std::find(cacheLines.begin(), cacheLines.end(), line);
+			if (iter != cacheLines.end())
+			{
+				cacheLines.erase(iter);
+			}
+			else
+			{
+				stats.bytesFetched += CacheLineSize;
+				if (cacheLines.size() == FetchCacheLines)
+				{
+					cacheLines.erase(cacheLines.begin());
+				}
+			}
+			cacheLines.push_back(line);
+		}
+	}
+
+	stats.overfetch = static_cast<float>(stats.bytesFetched) / static_cast<float>(static_cast<uint64_t>(vertexCount) * vertexSize);
+	return stats;
+}
+
+uint32_t MeshOptimizer::WeldVertices(Mesh& mesh)
+{
+	const uint32_t vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+	std::unordered_map<uint32_t, uint32_t, VertexHasher, VertexEqual> uniqueVertices(
+		vertexCount, VertexHasher{ &mesh.vertices }, VertexEqual{ &mesh.vertices });
+
+	std::vector<uint32_t> remap(vertexCount);
+	std::vector<Vertex> weldedVertices;
+	weldedVertices.reserve(vertexCount);
+	for (uint32_t v = 0; v < vertexCount; ++v)
+	{
+		auto [iter, inserted] = uniqueVertices.emplace(v, static_cast<uint32_t>(weldedVertices.size()));
+		if (inserted)
+		{
+			weldedVertices.push_back(mesh.vertices[v]);
+		}
+		remap[v] = iter->second;
+	}
+
+	for (uint32_t& index : mesh.indices)
+	{
+		index = remap[index];
+	}
+
+	const uint32_t removed = vertexCount - static_cast<uint32_t>(weldedVertices.size());
+	mesh.vertices = std::move(weldedVertices);
+	return removed;
+}
+
+void MeshOptimizer::OptimizeVertexCache(Mesh& mesh)
+{
+	OptimizeVertexCache(mesh.indices, static_cast<uint32_t>(mesh.vertices.size()));
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount)
+{
+	const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+	if (triangleCount == 0)
+	{
+		return;
+	}
+
+	// Vertex to triangle adjacency
+	std::vector<uint32_t> remainingTriangles(vertexCount, 0);
+	for (uint32_t i = 0; i < triangleCount * 3; ++i)
+	{
+		++remainingTriangles[indices[i]];
+	}
+
+	std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+	for (uint32_t v = 0; v < vertexCount; ++v)
+	{
+		adjacencyOffsets[v + 1] = adjacencyOffsets[v] + remainingTriangles[v];
+	}
+
+	std::vector<uint32_t> adjacency(adjacencyOffsets.back());
+	std::vector<uint32_t> adjacencyFill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+	for (uint32_t t = 0; t < triangleCount; ++t)
+	{
+		for (uint32_t i = 0; i < 3; ++i)
+		{
+			const uint32_t v = indices[(t * 3) + i];
+			adjacency[adjacencyFill[v]++] = t;
+		}
+	}
+
+	std::vector<int32_t> cachePositions(vertexCount, -1);
+	std::vector<float> vertexScores(vertexCount);
+	for (uint32_t v = 0; v < vertexCount; ++v)
+	{
+		vertexScores[v] = VertexScore(-1, remainingTriangles[v]);
+	}
+
+	std::vector<bool> emitted(triangleCount, false);
+
+	std::vector<uint32_t> cache;
+	std::vector<uint32_t> newCache;
+	cache.reserve(OptimizerCacheSize + 3);
+	newCache.reserve(OptimizerCacheSize + 3);
+
+	std::vector<uint32_t> newIndices;
+	newIndices.reserve(triangleCount * 3);
+
+	uint32_t nextUnemitted = 0;
+	int64_t bestTriangle = -1;
+	while (newIndices.size() < triangleCount * 3)
+	{
+		if (bestTriangle < 0)
+		{
+			// Nothing in the cache touches a pending triangle, restart from the next one in input order
+			while (emitted[nextUnemitted])
+			{
+				++nextUnemitted;
+			}
+			bestTriangle = nextUnemitted;
+		}
+
+		const uint32_t t = static_cast<uint32_t>(bestTriangle);
+		const uint32_t tri[3] = { indices[t * 3], indices[(t * 3) + 1], indices[(t * 3) + 2] };
+		emitted[t] = true;
+		newIndices.insert(newIndices.end(), tri, tri + 3);
+
+		for (uint32_t v : tri)
+		{
+			--remainingTriangles[v];
+		}
+
+		// Emitted vertices move to the front of the cache
+		newCache.assign(tri, tri + 3);
+		for (uint32_t v : cache)
+		{
+			if (v != tri[0] && v != tri[1] && v != tri[2])
+			{
+				newCache.push_back(v);
+			}
+		}
+		for (size_t i = OptimizerCacheSize; i < newCache.size(); ++i)
+		{
+			cachePositions[newCache[i]] = -1;
+			vertexScores[newCache[i]] = VertexScore(-1, remainingTriangles[newCache[i]]);
+		}
+		if (newCache.size() > OptimizerCacheSize)
+		{
+			newCache.resize(OptimizerCacheSize);
+		}
+		std::swap(cache, newCache);
+
+		for (size_t i = 0; i < cache.size(); ++i)
+		{
+			cachePositions[cache[i]] = static_cast<int32_t>(i);
+			vertexScores[cache[i]] = VertexScore(static_cast<int32_t>(i), remainingTriangles[cache[i]]);
+		}
+
+		// Only triangles touching the cache changed score
+		bestTriangle = -1;
+		float bestScore = -1.0f;
+		for (uint32_t v : cache)
+		{
+			for (uint32_t a = adjacencyOffsets[v]; a < adjacencyOffsets[v + 1]; ++a)
+			{
+				const uint32_t adjacent = adjacency[a];
+				if (emitted[adjacent])
+				{
+					continue;
+				}
+
+				const uint32_t* adjacentTri = &indices[adjacent * 3];
+				const float score = vertexScores[adjacentTri[0]] + vertexScores[adjacentTri[1]] + vertexScores[adjacentTri[2]];
+				if (score > bestScore)
+				{
+					bestScore = score;
+					bestTriangle = adjacent;
+				}
+			}
+		}
+	}
+
+	indices = std::move(newIndices);
+}
+
+void MeshOptimizer::OptimizeVertexFetch(Mesh& mesh)
+{
+	constexpr uint32_t Unused = std::numeric_limits<uint32_t>::max();
+	std::vector<uint32_t> remap(mesh.vertices.size(), Unused);
+	std::vector<Vertex> orderedVertices;
+	orderedVertices.reserve(mesh.vertices.size());
+	for (uint32_t& index : mesh.indices)
+	{
+		if (remap[index] == Unused)
+		{
+			remap[index] = static_cast<uint32_t>(orderedVertices.size());
+			orderedVertices.push_back(mesh.vertices[index]);
+		}
+		index = remap[index];
+	}
+	mesh.vertices = std::move(orderedVertices);
+}
+
+void MeshOptimizer::Optimize(Mesh& mesh)
+{
+	WeldVertices(mesh);
+	OptimizeVertexCache(mesh);
+	OptimizeVertexFetch(mesh);
+}
+
+std::vector<uint32_t> MeshOptimizer::Simplify(const Mesh& mesh, uint32_t targetIndexCount, float targetError, float* outError)
+{
+	const uint32_t vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+	const uint32_t triangleCount = static_cast<uint32_t>(mesh.indices.size() / 3);
+	std::vector<uint32_t> triangles(mesh.indices.begin(), mesh.indices.begin() + (triangleCount * 3));
+	if (outError != nullptr)
+	{
+		*outError = 0.0f;
+	}
+	if (triangles.size() <= targetIndexCount)
+	{
+		return triangles;
+	}
+
+	// Collapses work on positions, each position owns one or more vertices (wedges) that differ in attributes
+	std::vector<uint32_t> positionIds(vertexCount);
+	std::vector<uint32_t> positionWedge;
+	{
+		std::map<std::tuple<float, float, float>, uint32_t> uniquePositions;
+		for (uint32_t v = 0; v < vertexCount; ++v)
+		{
+			const Math::Vector3& p = mesh.vertices[v].position;
+			auto [iter, inserted] = uniquePositions.emplace(std::make_tuple(p.x, p.y, p.z), static_cast<uint32_t>(positionWedge.size()));
+			if (inserted)
+			{
+				positionWedge.push_back(v);
+			}
+			positionIds[v] = iter->second;
+		}
+	}
+	const uint32_t positionCount = static_cast<uint32_t>(positionWedge.size());
+	auto GetPosition = [&](uint32_t positionId) -> const Math::Vector3& { return mesh.vertices[positionWedge[positionId]].position; };
+
+	// Open borders are locked so the silhouette holds together
+	std::vector<bool> locked(positionCount, false);
+
+	std::map<std::pair<uint32_t, uint32_t>, uint32_t> edgeUses;
+	std::vector<std::vector<uint32_t>> positionTriangles(positionCount);
+	std::vector<Quadric> quadrics(positionCount);
+	Math::Vector3 boundsMin = GetPosition(0);
+	Math::Vector3 boundsMax = GetPosition(0);
+	for (uint32_t t = 0; t < triangleCount; ++t)
+	{
+		const uint32_t p0 = positionIds[triangles[(t * 3) + 0]];
+		const uint32_t p1 = positionIds[triangles[(t * 3) + 1]];
+		const uint32_t p2 = positionIds[triangles[(t * 3) + 2]];
+		const uint32_t ids[3] = { p0, p1, p2 };
+		for (uint32_t i = 0; i < 3; ++i)
+		{
+			const uint32_t a = ids[i];
+			const uint32_t b = ids[(i + 1) % 3];
+			++edgeUses[{ std::min(a, b), std::max(a, b) }];
+			positionTriangles[a].push_back(t);
+
+			const Math::Vector3& p = GetPosition(a);
+			boundsMin = { std::min(boundsMin.x, p.x), std::min(boundsMin.y, p.y), std::min(boundsMin.z, p.z) };
+			boundsMax = { std::max(boundsMax.x, p.x), std::max(boundsMax.y, p.y), std::max(boundsMax.z, p.z) };
+		}
+
+		const Math::Vector3 e0 = GetPosition(p1) - GetPosition(p0);
+		const Math::Vector3 e1 = GetPosition(p2) - GetPosition(p0);
+		const Math::Vector3 n = Math::Cross(e0, e1);
+		const float length = Math::Magnitude(n);
+		if (length > 0.0f)
+		{
+			const Math::Vector3 normal = n / length;
+			const double d = -Math::Dot(normal, GetPosition(p0));
+			const double area = length * 0.5;
+			Quadric q;
+			q.AddPlane(normal.x, normal.y, normal.z, d, area);
+			quadrics[p0].Add(q);
+			quadrics[p1].Add(q);
+			quadrics[p2].Add(q);
+		}
+	}
+	for (const auto& [edge, uses] : edgeUses)
+	{
+		if (uses == 1)
+		{
+			locked[edge.first] = true;
+			locked[edge.second] = true;
+		}
+	}
+
+	const Math::Vector3 extent = boundsMax - boundsMin;
+	const double scale = std::max({ extent.x, extent.y, extent.z, std::numeric_limits<float>::epsilon() });
+	const double maxCost = (static_cast<double>(targetError) * scale) * (static_cast<double>(targetError) * scale);
+
+	std::vector<uint32_t> versions(positionCount, 0);
+	std::vector<bool> removed(positionCount, false);
+	std::vector<bool> alive(triangleCount, true);
+	std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> collapses;
+	auto PushCollapse = [&](uint32_t from, uint32_t to)
+	{
+		if (locked[from])
+		{
+			return;
+		}
+
+		Quadric q = quadrics[from];
+		q.Add(quadrics[to]);
+		collapses.push({ q.Evaluate(GetPosition(to)), from, to, versions[from], versions[to] });
+	};
+	for (const auto& [edge, uses] : edgeUses)
+	{
+		PushCollapse(edge.first, edge.second);
+		PushCollapse(edge.second, edge.first);
+	}
+
+	uint32_t indexCount = triangleCount * 3;
+	double acceptedCost = 0.0;
+	std::vector<uint32_t> neighbors;
+	std::vector<std::pair<uint32_t, uint32_t>> wedgeMap;
+	auto FindWedge = [&](uint32_t fromVertex) -> const std::pair<uint32_t, uint32_t>*
+	{
+		for (const auto& entry : wedgeMap)
+		{
+			if (entry.first == fromVertex)
+			{
+				return &entry;
+			}
+		}
+		return nullptr;
+	};
+	while (indexCount > targetIndexCount && !collapses.empty())
+	{
+		const Collapse collapse = collapses.top();
+		collapses.pop();
+		if (removed[collapse.from] || removed[collapse.to] ||
+			versions[collapse.from] != collapse.fromVersion || versions[collapse.to] != collapse.toVersion)
+		{
+			continue;
+		}
+		if (collapse.cost > maxCost)
+		{
+			break;
+		}
+
+		// Each wedge of 'from' takes the wedge of 'to' used by the triangles on the collapsed edge.
+		// A wedge with no match means the edge crosses a UV/normal seam, so the collapse is skipped.
+		wedgeMap.clear();
+		bool valid = true;
+		for (uint32_t t : positionTriangles[collapse.from])
+		{
+			const uint32_t* tri = &triangles[t * 3];
+			if (!alive[t] || (positionIds[tri[0]] != collapse.to && positionIds[tri[1]] != collapse.to && positionIds[tri[2]] != collapse.to))
+			{
+				continue;
+			}
+
+			uint32_t fromVertex = 0;
+			uint32_t toVertex = 0;
+			for (uint32_t i = 0; i < 3; ++i)
+			{
+				fromVertex = (positionIds[tri[i]] == collapse.from) ? tri[i] : fromVertex;
+				toVertex = (positionIds[tri[i]] == collapse.to) ? tri[i] : toVertex;
+			}
+
+			const auto* entry = FindWedge(fromVertex);
+			if (entry == nullptr)
+			{
+				wedgeMap.emplace_back(fromVertex, toVertex);
+			}
+			else if (entry->second != toVertex)
+			{
+				valid = false;
+			}
+		}
+
+		// Reject collapses that leave a wedge behind or flip a surviving triangle
+		const Math::Vector3& target = GetPosition(collapse.to);
+		for (uint32_t t : positionTriangles[collapse.from])
+		{
+			if (!valid)
+			{
+				break;
+			}
+			if (!alive[t])
+			{
+				continue;
+			}
+
+			const uint32_t* tri = &triangles[t * 3];
+			const uint32_t ids[3] = { positionIds[tri[0]], positionIds[tri[1]], positionIds[tri[2]] };
+			if (ids[0] == collapse.to || ids[1] == collapse.to || ids[2] == collapse.to)
+			{
+				continue;
+			}
+
+			for (uint32_t i = 0; i < 3; ++i)
+			{
+				if (ids[i] == collapse.from && FindWedge(tri[i]) == nullptr)
+				{
+					valid = false;
+				}
+			}
+
+			const Math::Vector3 before = Math::Cross(GetPosition(ids[1]) - GetPosition(ids[0]), GetPosition(ids[2]) - GetPosition(ids[0]));
+			const Math::Vector3 p0 = (ids[0] == collapse.from) ? target : GetPosition(ids[0]);
+			const Math::Vector3 p1 = (ids[1] == collapse.from) ? target : GetPosition(ids[1]);
+			const Math::Vector3 p2 = (ids[2] == collapse.from) ? target : GetPosition(ids[2]);
+			const Math::Vector3 after = Math::Cross(p1 - p0, p2 - p0);
+			if (Math::Dot(before, after) <= 0.0f)
+			{
+				valid = false;
+			}
+		}
+		if (!valid || wedgeMap.empty())
+		{
+			continue;
+		}
+
+		removed[collapse.from] = true;
+		quadrics[collapse.to].Add(quadrics[collapse.from]);
+		++versions[collapse.to];
+		acceptedCost = std::max(acceptedCost, collapse.cost);
+
+		for (uint32_t t : positionTriangles[collapse.from])
+		{
+			if (!alive[t])
+			{
+				continue;
+			}
+
+			uint32_t* tri = &triangles[t * 3];
+			bool degenerate = false;
+			for (uint32_t i = 0; i < 3; ++i)
+			{
+				degenerate = degenerate || positionIds[tri[i]] == collapse.to;
+			}
+
+			if (degenerate)
+			{
+				alive[t] = false;
+				indexCount -= 3;
+				continue;
+			}
+
+			for (uint32_t i = 0; i < 3; ++i)
+			{
+				if (positionIds[tri[i]] == collapse.from)
+				{
+					tri[i] = FindWedge(tri[i])->second;
+				}
+			}
+			positionTriangles[collapse.to].push_back(t);
+		}
+		positionTriangles[collapse.from].clear();
+
+		// Only the merged quadric changed, re-queue the edges around it
+		neighbors.clear();
+		for (uint32_t t : positionTriangles[collapse.to])
+		{
+			if (!alive[t])
+			{
+				continue;
+			}
+			for (uint32_t i = 0; i < 3; ++i)
+			{
+				const uint32_t neighbor = positionIds[triangles[(t * 3) + i]];
+				if (neighbor != collapse.to)
+				{
+					neighbors.push_back(neighbor);
+				}
+			}
+		}
+		std::sort(neighbors.begin(), neighbors.end());
+		neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+		for (uint32_t neighbor : neighbors)
+		{
+			PushCollapse(collapse.to, neighbor);
+			PushCollapse(neighbor, collapse.to);
+		}
+	}
+
+	std::vector<uint32_t> simplified;
+	simplified.reserve(indexCount);
+	for (uint32_t t = 0; t < triangleCount; ++t)
+	{
+		if (alive[t])
+		{
+			simplified.insert(simplified.end(), &triangles[t * 3], &triangles[t * 3] + 3);
+		}
+	}
+
+	if (outError != nullptr)
+	{
+		*outError = static_cast<float>(std::sqrt(acceptedCost) / scale);
+	}
+	return simplified;
+}
\ No newline at end of file
@@ -9,6 +9,18 @@ using namespace WinterEngine::Graphics;
 namespace
 {
 	std::unique_ptr<ModelCache> sModelCache;
+
+	void ReadModel(const std::filesystem::path& filePath, Model& model)
+	{
+		if (!ModelIO::LoadModelBinary(filePath, model))
+		{
+			ModelIO::LoadModel(filePath, model);
+		}
+		ModelIO::LoadMaterial(filePath, model);
+		ModelIO::LoadSkeleton(filePath, model);
+		ModelIO::LoadAnimations(filePath, model);
+		ASSERT(ModelIO::ValidateSkinWeights(model), "ModelCache: %s has invalid skin weights", filePath.u8string().c_str());
+	}
 }
 
 void ModelCache::StaticInitialize()
@@ -41,12 +53,133 @@ ModelId ModelCache::LoadModel(const std::filesystem::path& filePath)
 	{
 		auto& modelPtr = iter->second;
 		modelPtr = std::make_unique<Model>();
-		ModelIO::LoadModel(filePath, *modelPtr);
+		ReadModel(filePath, *modelPtr);
+	}
+	else if (auto pending = mPendingModels.find(modelId); pending != mPendingModels.end())
+	{
+		// Finish a streamed load now that the caller needs the whole model
+		Model& model = *iter->second;
+		while (pending->second.reader->ReadNextMesh(model, pending->second.callback));
+		mPendingModels.erase(pending);
+	}
+	return modelId;
+}
+
+ModelId ModelCache::LoadModelStreamed(const std::filesystem::path& filePath, MeshLoadedCallback callback)
+{
+	const ModelId modelId = GetModelId(filePath);
+	auto [iter, success] = mInventory.insert({ modelId, nullptr });
+	if (success)
+	{
+		auto& modelPtr = iter->second;
+		modelPtr = std::make_unique<Model>();
 		ModelIO::LoadMaterial(filePath, *modelPtr);
+		ModelIO::LoadSkeleton(filePath, *modelPtr);
+		ModelIO::LoadAnimations(filePath, *modelPtr);
+
+		auto reader = std::make_unique<ModelIO::ModelReader>();
+		if (!reader->Open(filePath))
+		{
+			// Same as a failed async load, nothing in the inventory and a Failed state
+			LOG("ModelCache: failed to open %s", filePath.u8string().c_str());
+			mInventory.erase(iter);
+			mAsyncLoadStates[modelId] = LoadState::Failed;
+			return modelId;
+		}
+		modelPtr->meshData.reserve(reader->GetMeshCount());
+		mPendingModels[modelId] = { std::move(reader), std::move(callback) };
 	}
 	return modelId;
 }
 
+ModelId ModelCache::LoadModelAsync(const std::filesystem::path& filePath)
+{
+	const ModelId modelId = GetModelId(filePath);
+	if (mInventory.find(modelId) != mInventory.end() || mAsyncLoadStates.find(modelId) != mAsyncLoadStates.end())
+	{
+		return modelId;
+	}
+
+	mAsyncLoadStates[modelId] = LoadState::Pending;
+	Core::JobSystem::Get()->Submit([this, modelId, filePath]()
+	{
+		LoadedModel loaded;
+		loaded.id = modelId;
+		loaded.model = std::make_unique<Model>();
+		ReadModel(filePath, *loaded.model);
+		if (loaded.model->meshData.empty())
+		{
+			LOG("ModelCache: failed to load %s", filePath.u8string().c_str());
+			loaded.model.reset();
+		}
+
+		std::lock_guard<std::mutex> lock(mLoadedMutex);
+		mLoadedModels.push_back(std::move(loaded));
+	});
+	return modelId;
+}
+
+LoadState ModelCache::GetLoadState(ModelId id) const
+{
+	if (mPendingModels.find(id) != mPendingModels.end())
+	{
+		return LoadState::Pending;
+	}
+	if (mInventory.find(id) != mInventory.end())
+	{
+		return LoadState::Ready;
+	}
+	auto iter = mAsyncLoadStates.find(id);
+	if (iter != mAsyncLoadStates.end())
+	{
+		return iter->second;
+	}
+	return LoadState::Failed;
+}
+
+bool ModelCache::IsModelLoaded(ModelId id) const
+{
+	return GetLoadState(id) == LoadState::Ready;
+}
+
+void ModelCache::Update(uint32_t meshBudget)
+{
+	std::vector<LoadedModel> loadedModels;
+	{
+		std::lock_guard<std::mutex> lock(mLoadedMutex);
+		loadedModels.swap(mLoadedModels);
+	}
+
+	for (LoadedModel& loaded : loadedModels)
+	{
+		if (loaded.model == nullptr)
+		{
+			mAsyncLoadStates[loaded.id] = LoadState::Failed;
+			continue;
+		}
+
+		// A synchronous or streamed load of the same file may have won the race
+		mInventory.insert({ loaded.id, std::move(loaded.model) });
+		mAsyncLoadStates.erase(loaded.id);
+	}
+
+	auto iter = mPendingModels.begin();
+	while (iter != mPendingModels.end() && meshBudget > 0)
+	{
+		PendingModel& pending = iter->second;
+		Model& model = *mInventory[iter->first];
+		if (pending.reader->ReadNextMesh(model, pending.callback))
+		{
+			--meshBudget;
+		}
+
+		if (pending.reader->IsDone())
+		{
+			iter = mPendingModels.erase(iter);
+		}
+	}
+}
+
 const Model* ModelCache::GetModel(ModelId id)
 {
 	auto model = mInventory.find(id);
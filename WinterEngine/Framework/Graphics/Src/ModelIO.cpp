@@ -1,15 +1,242 @@
 #include "Precompile.h"
 #include "ModelIO.h"
 #include "Model.h"
+#include "VertexCompression.h"
 
 using namespace WinterEngine;
 using namespace WinterEngine::Graphics;
 
-void ModelIO::SaveModel(std::filesystem::path filePath, const Model& model)
+namespace
+{
+	// .modelbin layout:
+	//   BinaryHeader
+	//   BinaryMeshEntry[meshCount] (including the mesh bounds)
+	//   per mesh: Vertex or CompactVertex[vertexCount], CompactSkin[vertexCount] (compact skinned meshes),
+	//             uint32_t[indexCount], BinaryLODEntry[lodCount], uint32_t[lod indexCount] per LOD
+	//             (each blob 16 byte aligned)
+	// The file is read in place, so every table has to sit at a multiple of its alignment and
+	// the structs below are laid out without implicit padding
+	constexpr uint32_t BinaryMagic = 0x4C444D57; // "WMDL"
+	constexpr uint32_t BinaryVersion = 6;
+	constexpr uint64_t BinaryAlignment = 16;
+
+	struct BinaryHeader
+	{
+		uint32_t magic = BinaryMagic;
+		uint32_t version = BinaryVersion;
+		uint32_t vertexStride = sizeof(Vertex);
+		uint32_t compactVertexStride = sizeof(CompactVertex);
+		uint32_t meshCount = 0;
+		uint32_t padding[3] = {};
+	};
+
+	struct BinaryMeshEntry
+	{
+		uint64_t vertexOffset = 0;
+		uint64_t indexOffset = 0;
+		uint64_t lodOffset = 0;
+		uint64_t skinOffset = 0;
+		uint32_t materialIndex = 0;
+		uint32_t vertexCount = 0;
+		uint32_t indexCount = 0;
+		ModelIO::VertexStorage vertexStorage = ModelIO::VertexStorage::Full;
+		uint32_t lodCount = 0;
+		uint32_t hasSkin = 0;
+		Math::Vector3 boundsMin;
+		Math::Vector3 boundsExtent;
+		Math::AABB aabb;
+		Math::Sphere boundingSphere;
+	};
+
+	struct BinaryLODEntry
+	{
+		uint32_t indexCount = 0;
+		float error = 0.0f;
+		uint64_t indexOffset = 0;
+	};
+
+	static_assert(sizeof(BinaryHeader) == 32 && alignof(BinaryHeader) == 4, "BinaryHeader layout changed, bump BinaryVersion");
+	static_assert(sizeof(BinaryMeshEntry) == 120 && alignof(BinaryMeshEntry) == 8, "BinaryMeshEntry layout changed, bump BinaryVersion");
+	static_assert(sizeof(BinaryLODEntry) == 16 && alignof(BinaryLODEntry) == 8, "BinaryLODEntry layout changed, bump BinaryVersion");
+	static_assert(sizeof(CompactVertex) == 18 && sizeof(CompactSkin) == 12, "Compact vertex layout changed, bump BinaryVersion");
+	static_assert(alignof(Vertex) <= BinaryAlignment && alignof(CompactVertex) <= BinaryAlignment && alignof(CompactSkin) <= BinaryAlignment &&
+		alignof(BinaryMeshEntry) <= BinaryAlignment && alignof(BinaryLODEntry) <= BinaryAlignment, "Blobs are only aligned to BinaryAlignment");
+
+	// The mesh table starts right after the header
+	constexpr uint64_t BinaryEntriesOffset = sizeof(BinaryHeader);
+	static_assert(BinaryEntriesOffset % alignof(BinaryMeshEntry) == 0, "Mesh table is misaligned");
+
+	uint64_t GetVertexStride(const BinaryMeshEntry& entry)
+	{
+		return (entry.vertexStorage == ModelIO::VertexStorage::Compact) ? sizeof(CompactVertex) : sizeof(Vertex);
+	}
+
+	uint64_t AlignOffset(uint64_t offset)
+	{
+		return (offset + BinaryAlignment - 1) & ~(BinaryAlignment - 1);
+	}
+
+	bool IsAligned(uint64_t offset, uint64_t alignment)
+	{
+		return (offset % alignment) == 0;
+	}
+
+	void ReadTextMesh(FILE* file, Model::MeshData& meshData)
+	{
+		fscanf_s(file, "MaterialIndex: %d\n", &meshData.materialIndex);
+
+		// Files written before skinning existed have no Skinned line
+		int skinned = 0;
+		fscanf_s(file, "Skinned: %d\n", &skinned);
+
+		Mesh& mesh = meshData.mesh;
+		uint32_t vertexCount = 0;
+		fscanf_s(file, "VertexCount: %d\n", &vertexCount);
+		mesh.vertices.resize(vertexCount);
+		for (Vertex& v : mesh.vertices)
+		{
+			fscanf_s(file, "%f %f %f %f %f %f %f %f %f %f %f",
+				&v.position.x, &v.position.y, &v.position.z,
+				&v.normal.x,   &v.normal.y,   &v.normal.z,
+				&v.tangent.x,  &v.tangent.y,  &v.tangent.z,
+				&v.uvCoord.x,  &v.uvCoord.y);
+			if (skinned != 0)
+			{
+				fscanf_s(file, " %d %d %d %d %f %f %f %f",
+					&v.boneIndices[0], &v.boneIndices[1], &v.boneIndices[2], &v.boneIndices[3],
+					&v.boneWeights[0], &v.boneWeights[1], &v.boneWeights[2], &v.boneWeights[3]);
+			}
+			fscanf_s(file, "\n");
+		}
+
+		uint32_t indexCount = 0;
+		fscanf_s(file, "IndexCount: %d\n", &indexCount);
+		mesh.indices.resize(indexCount);
+		for (uint32_t i = 2; i < indexCount; i += 3)
+		{
+			fscanf_s(file, "%d %d %d\n", &mesh.indices[i - 2], &mesh.indices[i - 1], &mesh.indices[i]);
+		}
+
+		// Files written before LODs existed simply don't match here
+		uint32_t lodCount = 0;
+		fscanf_s(file, "LODCount: %d\n", &lodCount);
+		meshData.lods.resize(lodCount);
+		for (Model::LOD& lod : meshData.lods)
+		{
+			uint32_t lodIndexCount = 0;
+			fscanf_s(file, "LODError: %f\n", &lod.error);
+			fscanf_s(file, "IndexCount: %d\n", &lodIndexCount);
+			lod.indices.resize(lodIndexCount);
+			for (uint32_t i = 2; i < lodIndexCount; i += 3)
+			{
+				fscanf_s(file, "%d %d %d\n", &lod.indices[i - 2], &lod.indices[i - 1], &lod.indices[i]);
+			}
+		}
+
+		// Older files have no bounds, work them out from the vertices instead
+		const int boundsRead = fscanf_s(file, "Bounds: %f %f %f %f %f %f %f %f %f %f\n",
+			&mesh.aabb.min.x, &mesh.aabb.min.y, &mesh.aabb.min.z,
+			&mesh.aabb.max.x, &mesh.aabb.max.y, &mesh.aabb.max.z,
+			&mesh.boundingSphere.center.x, &mesh.boundingSphere.center.y, &mesh.boundingSphere.center.z,
+			&mesh.boundingSphere.radius);
+		if (boundsRead != 10)
+		{
+			mesh.ComputeBounds();
+		}
+	}
+
+	// Returns the header if the mapped file is a complete binary model this build can read
+	const BinaryHeader* GetBinaryHeader(const Core::MappedFile& mappedFile)
+	{
+		const uint8_t* data = mappedFile.GetData();
+		const uint64_t fileSize = mappedFile.GetSize();
+		if (fileSize < sizeof(BinaryHeader))
+		{
+			return nullptr;
+		}
+
+		const BinaryHeader* header = reinterpret_cast<const BinaryHeader*>(data);
+		if (header->magic != BinaryMagic ||
+			header->version != BinaryVersion ||
+			header->vertexStride != sizeof(Vertex) ||
+			header->compactVertexStride != sizeof(CompactVertex) ||
+			fileSize < BinaryEntriesOffset + (sizeof(BinaryMeshEntry) * header->meshCount))
+		{
+			return nullptr;
+		}
+
+		const BinaryMeshEntry* entries = reinterpret_cast<const BinaryMeshEntry*>(data + BinaryEntriesOffset);
+		for (uint32_t m = 0; m < header->meshCount; ++m)
+		{
+			const BinaryMeshEntry& entry = entries[m];
+			if ((entry.vertexStorage != ModelIO::VertexStorage::Full && entry.vertexStorage != ModelIO::VertexStorage::Compact) ||
+				!IsAligned(entry.vertexOffset, BinaryAlignment) || !IsAligned(entry.indexOffset, alignof(uint32_t)) ||
+				!IsAligned(entry.lodOffset, alignof(BinaryLODEntry)) || !IsAligned(entry.skinOffset, alignof(CompactSkin)) ||
+				entry.vertexOffset + (GetVertexStride(entry) * entry.vertexCount) > fileSize ||
+				entry.indexOffset + (sizeof(uint32_t) * entry.indexCount) > fileSize ||
+				entry.lodOffset + (sizeof(BinaryLODEntry) * entry.lodCount) > fileSize ||
+				(entry.hasSkin != 0 && entry.skinOffset + (sizeof(CompactSkin) * entry.vertexCount) > fileSize))
+			{
+				return nullptr;
+			}
+
+			const BinaryLODEntry* lodEntries = reinterpret_cast<const BinaryLODEntry*>(data + entry.lodOffset);
+			for (uint32_t l = 0; l < entry.lodCount; ++l)
+			{
+				if (!IsAligned(lodEntries[l].indexOffset, alignof(uint32_t)) ||
+					lodEntries[l].indexOffset + (sizeof(uint32_t) * lodEntries[l].indexCount) > fileSize)
+				{
+					return nullptr;
+				}
+			}
+		}
+		return header;
+	}
+
+	void CopyBinaryMesh(const Core::MappedFile& mappedFile, uint32_t meshIndex, Model::MeshData& meshData)
+	{
+		const uint8_t* data = mappedFile.GetData();
+		const BinaryMeshEntry& entry = reinterpret_cast<const BinaryMeshEntry*>(data + BinaryEntriesOffset)[meshIndex];
+		meshData.materialIndex = entry.materialIndex;
+
+		if (entry.vertexStorage == ModelIO::VertexStorage::Compact)
+		{
+			const CompactVertex* vertices = reinterpret_cast<const CompactVertex*>(data + entry.vertexOffset);
+			const VertexCompression::Bounds bounds = { entry.boundsMin, entry.boundsExtent };
+			VertexCompression::Decode(vertices, entry.vertexCount, bounds, meshData.mesh.vertices);
+			if (entry.hasSkin != 0)
+			{
+				const CompactSkin* skin = reinterpret_cast<const CompactSkin*>(data + entry.skinOffset);
+				VertexCompression::DecodeSkin(skin, entry.vertexCount, meshData.mesh.vertices);
+			}
+		}
+		else
+		{
+			const Vertex* vertices = reinterpret_cast<const Vertex*>(data + entry.vertexOffset);
+			meshData.mesh.vertices.assign(vertices, vertices + entry.vertexCount);
+		}
+
+		const uint32_t* indices = reinterpret_cast<const uint32_t*>(data + entry.indexOffset);
+		meshData.mesh.indices.assign(indices, indices + entry.indexCount);
+
+		const BinaryLODEntry* lodEntries = reinterpret_cast<const BinaryLODEntry*>(data + entry.lodOffset);
+		meshData.lods.resize(entry.lodCount);
+		for (uint32_t l = 0; l < entry.lodCount; ++l)
+		{
+			const uint32_t* lodIndices = reinterpret_cast<const uint32_t*>(data + lodEntries[l].indexOffset);
+			meshData.lods[l].indices.assign(lodIndices, lodIndices + lodEntries[l].indexCount);
+			meshData.lods[l].error = lodEntries[l].error;
+		}
+		meshData.mesh.aabb = entry.aabb;
+		meshData.mesh.boundingSphere = entry.boundingSphere;
+	}
+}
+
+bool ModelIO::SaveModel(std::filesystem::path filePath, const Model& model)
 {
 	if (model.meshData.empty())
 	{
-		return;
+		return false;
 	}
 
 	filePath.replace_extension("model");
@@ -18,7 +245,7 @@ void ModelIO::SaveModel(std::filesystem::path filePath, const Model& model)
 	fopen_s(&file, filePath.u8string().c_str(), "w");
 	if (file == nullptr)
 	{
-		return;
+		return false;
 	}
 
 	const uint32_t meshCount = static_cast<uint32_t>(model.meshData.size());
@@ -29,15 +256,25 @@ void ModelIO::SaveModel(std::filesystem::path filePath, const Model& model)
 		fprintf_s(file, "MaterialIndex: %d\n", meshData.materialIndex);
 
 		const Mesh& mesh = meshData.mesh;
+		const bool skinned = VertexCompression::HasSkin(mesh.vertices);
+		fprintf_s(file, "Skinned: %d\n", skinned ? 1 : 0);
+
 		const uint32_t vertexCount = static_cast<uint32_t>(mesh.vertices.size());
 		fprintf_s(file, "VertexCount: %d\n", vertexCount);
 		for (const Vertex& v : mesh.vertices)
 		{
-			fprintf_s(file, "%f %f %f %f %f %f %f %f %f %f %f\n",
+			fprintf_s(file, "%f %f %f %f %f %f %f %f %f %f %f",
 				v.position.x, v.position.y, v.position.z,
 				v.normal.x, v.normal.y, v.normal.z,
 				v.tangent.x, v.tangent.y, v.tangent.z,
 				v.uvCoord.x, v.uvCoord.y);
+			if (skinned)
+			{
+				fprintf_s(file, " %d %d %d %d %f %f %f %f",
+					v.boneIndices[0], v.boneIndices[1], v.boneIndices[2], v.boneIndices[3],
+					v.boneWeights[0], v.boneWeights[1], v.boneWeights[2], v.boneWeights[3]);
+			}
+			fprintf_s(file, "\n");
 		}
 
 		const uint32_t indexCount = static_cast<uint32_t>(mesh.indices.size());
@@ -46,8 +283,27 @@ void ModelIO::SaveModel(std::filesystem::path filePath, const Model& model)
 		{
 			fprintf_s(file, "%d %d %d\n", mesh.indices[i - 2], mesh.indices[i - 1], mesh.indices[i]);
 		}
+
+		fprintf_s(file, "LODCount: %d\n", static_cast<uint32_t>(meshData.lods.size()));
+		for (const Model::LOD& lod : meshData.lods)
+		{
+			const uint32_t lodIndexCount = static_cast<uint32_t>(lod.indices.size());
+			fprintf_s(file, "LODError: %f\n", lod.error);
+			fprintf_s(file, "IndexCount: %d\n", lodIndexCount);
+			for (uint32_t i = 2; i < lodIndexCount; i += 3)
+			{
+				fprintf_s(file, "%d %d %d\n", lod.indices[i - 2], lod.indices[i - 1], lod.indices[i]);
+			}
+		}
+
+		const Math::AABB& aabb = mesh.aabb;
+		const Math::Sphere& sphere = mesh.boundingSphere;
+		fprintf_s(file, "Bounds: %f %f %f %f %f %f %f %f %f %f\n",
+			aabb.min.x, aabb.min.y, aabb.min.z, aabb.max.x, aabb.max.y, aabb.max.z,
+			sphere.center.x, sphere.center.y, sphere.center.z, sphere.radius);
 	}
 	fclose(file);
+	return true;
 }
 
 void ModelIO::LoadModel(std::filesystem::path filePath, Model& model)
@@ -64,40 +320,238 @@ void ModelIO::LoadModel(std::filesystem::path filePath, Model& model)
 	uint32_t meshCount = 0;
 	fscanf_s(file, "MeshCount: %d\n", &meshCount);
 	model.meshData.resize(meshCount);
-	for (uint32_t m = 0; m < meshCount; ++m)
+	for (Model::MeshData& meshData : model.meshData)
 	{
-		Model::MeshData& meshData = model.meshData[m];
-		fscanf_s(file, "MaterialIndex: %d\n", &meshData.materialIndex);
+		ReadTextMesh(file, meshData);
+	}
+	fclose(file);
+}
 
-		Mesh& mesh = meshData.mesh;
-		uint32_t vertexCount = 0;
-		fscanf_s(file, "VertexCount: %d\n", &vertexCount);
-		mesh.vertices.resize(vertexCount);
-		for (Vertex& v : mesh.vertices)
+ModelIO::BinaryReport ModelIO::SaveModelBinary(std::filesystem::path filePath, const Model& model, VertexStorage vertexStorage)
+{
+	BinaryReport report;
+	if (model.meshData.empty())
+	{
+		return report;
+	}
+
+	filePath = GetBinaryModelPath(filePath);
+
+	FILE* file = nullptr;
+	fopen_s(&file, filePath.u8string().c_str(), "wb");
+	if (file == nullptr)
+	{
+		return report;
+	}
+
+	BinaryHeader header;
+	header.meshCount = static_cast<uint32_t>(model.meshData.size());
+
+	std::vector<BinaryMeshEntry> entries(header.meshCount);
+	std::vector<std::vector<CompactVertex>> compactVertices(header.meshCount);
+	std::vector<std::vector<CompactSkin>> compactSkin(header.meshCount);
+	std::vector<std::vector<BinaryLODEntry>> lodEntries(header.meshCount);
+	uint64_t offset = BinaryEntriesOffset + (sizeof(BinaryMeshEntry) * entries.size());
+	for (uint32_t m = 0; m < header.meshCount; ++m)
+	{
+		const Model::MeshData& meshData = model.meshData[m];
+		BinaryMeshEntry& entry = entries[m];
+		entry.materialIndex = meshData.materialIndex;
+		entry.vertexCount = static_cast<uint32_t>(meshData.mesh.vertices.size());
+		entry.indexCount = static_cast<uint32_t>(meshData.mesh.indices.size());
+		entry.aabb = meshData.mesh.aabb;
+		entry.boundingSphere = meshData.mesh.boundingSphere;
+
+		if (vertexStorage == VertexStorage::Compact)
 		{
-			fscanf_s(file, "%f %f %f %f %f %f %f %f %f %f %f\n",
-				&v.position.x, &v.position.y, &v.position.z,
-				&v.normal.x,   &v.normal.y,   &v.normal.z,
-				&v.tangent.x,  &v.tangent.y,  &v.tangent.z,
-				&v.uvCoord.x,  &v.uvCoord.y);
+			const VertexCompression::Bounds bounds = VertexCompression::ComputeBounds(meshData.mesh.vertices);
+			VertexCompression::Encode(meshData.mesh.vertices, bounds, compactVertices[m]);
+			entry.vertexStorage = VertexStorage::Compact;
+			entry.boundsMin = bounds.min;
+			entry.boundsExtent = bounds.extent;
+			++report.compactMeshCount;
+
+			// The compact vertex has no bone data, skinned meshes add a skin stream
+			if (VertexCompression::HasSkin(meshData.mesh.vertices))
+			{
+				VertexCompression::EncodeSkin(meshData.mesh.vertices, compactSkin[m]);
+				entry.hasSkin = 1;
+			}
 		}
 
-		uint32_t indexCount = 0;
-		fscanf_s(file, "IndexCount: %d\n", &indexCount);
-		mesh.indices.resize(indexCount);
-		for (uint32_t i = 2; i < indexCount; i += 3)
+		entry.vertexOffset = AlignOffset(offset);
+		offset = entry.vertexOffset + (GetVertexStride(entry) * entry.vertexCount);
+		if (entry.hasSkin != 0)
 		{
-			fscanf_s(file, "%d %d %d\n", &mesh.indices[i - 2], &mesh.indices[i - 1], &mesh.indices[i]);
+			entry.skinOffset = AlignOffset(offset);
+			offset = entry.skinOffset + (sizeof(CompactSkin) * entry.vertexCount);
+		}
+
+		report.fullVertexBytes += sizeof(Vertex) * entry.vertexCount;
+		report.storedVertexBytes += (GetVertexStride(entry) + (entry.hasSkin != 0 ? sizeof(CompactSkin) : 0)) * entry.vertexCount;
+		report.indexBytes += sizeof(uint32_t) * entry.indexCount;
+		entry.indexOffset = AlignOffset(offset);
+		offset = entry.indexOffset + (sizeof(uint32_t) * entry.indexCount);
+
+		entry.lodCount = static_cast<uint32_t>(meshData.lods.size());
+		entry.lodOffset = AlignOffset(offset);
+		offset = entry.lodOffset + (sizeof(BinaryLODEntry) * entry.lodCount);
+		lodEntries[m].resize(entry.lodCount);
+		for (uint32_t l = 0; l < entry.lodCount; ++l)
+		{
+			BinaryLODEntry& lodEntry = lodEntries[m][l];
+			lodEntry.indexCount = static_cast<uint32_t>(meshData.lods[l].indices.size());
+			lodEntry.error = meshData.lods[l].error;
+			lodEntry.indexOffset = AlignOffset(offset);
+			offset = lodEntry.indexOffset + (sizeof(uint32_t) * lodEntry.indexCount);
+			report.indexBytes += sizeof(uint32_t) * lodEntry.indexCount;
+		}
+	}
+
+	fwrite(&header, sizeof(BinaryHeader), 1, file);
+	fwrite(entries.data(), sizeof(BinaryMeshEntry), entries.size(), file);
+
+	const uint8_t zeros[BinaryAlignment] = {};
+	uint64_t written = BinaryEntriesOffset + (sizeof(BinaryMeshEntry) * entries.size());
+	auto WriteBlob = [&](uint64_t blobOffset, const void* data, uint64_t size)
+	{
+		fwrite(zeros, 1, static_cast<size_t>(blobOffset - written), file);
+		fwrite(data, 1, static_cast<size_t>(size), file);
+		written = blobOffset + size;
+	};
+
+	for (uint32_t m = 0; m < header.meshCount; ++m)
+	{
+		const Mesh& mesh = model.meshData[m].mesh;
+		const BinaryMeshEntry& entry = entries[m];
+		const void* vertexData = (entry.vertexStorage == VertexStorage::Compact) ? static_cast<const void*>(compactVertices[m].data()) : mesh.vertices.data();
+		WriteBlob(entry.vertexOffset, vertexData, GetVertexStride(entry) * entry.vertexCount);
+		if (entry.hasSkin != 0)
+		{
+			WriteBlob(entry.skinOffset, compactSkin[m].data(), sizeof(CompactSkin) * entry.vertexCount);
+		}
+		WriteBlob(entry.indexOffset, mesh.indices.data(), sizeof(uint32_t) * entry.indexCount);
+		WriteBlob(entry.lodOffset, lodEntries[m].data(), sizeof(BinaryLODEntry) * entry.lodCount);
+		for (uint32_t l = 0; l < entry.lodCount; ++l)
+		{
+			const std::vector<uint32_t>& lodIndices = model.meshData[m].lods[l].indices;
+			WriteBlob(lodEntries[m][l].indexOffset, lodIndices.data(), sizeof(uint32_t) * lodEntries[m][l].indexCount);
 		}
 	}
 	fclose(file);
+
+	report.meshCount = header.meshCount;
+	report.fileBytes = written;
+	return report;
+}
+
+bool ModelIO::LoadModelBinary(std::filesystem::path filePath, Model& model)
+{
+	filePath = GetBinaryModelPath(filePath);
+
+	Core::MappedFile mappedFile;
+	if (!mappedFile.Initialize(filePath))
+	{
+		return false;
+	}
+
+	const BinaryHeader* header = GetBinaryHeader(mappedFile);
+	if (header == nullptr)
+	{
+		LOG("ModelIO: %s is not a compatible binary model", filePath.u8string().c_str());
+		return false;
+	}
+
+	model.meshData.resize(header->meshCount);
+	for (uint32_t m = 0; m < header->meshCount; ++m)
+	{
+		CopyBinaryMesh(mappedFile, m, model.meshData[m]);
+	}
+	return true;
+}
+
+std::filesystem::path ModelIO::GetBinaryModelPath(std::filesystem::path filePath)
+{
+	return filePath.replace_extension("modelbin");
+}
+
+ModelIO::ModelReader::~ModelReader()
+{
+	Close();
+}
+
+bool ModelIO::ModelReader::Open(std::filesystem::path filePath)
+{
+	Close();
+
+	if (mMappedFile.Initialize(GetBinaryModelPath(filePath)))
+	{
+		const BinaryHeader* header = GetBinaryHeader(mMappedFile);
+		if (header != nullptr)
+		{
+			mMeshCount = header->meshCount;
+			return true;
+		}
+		mMappedFile.Terminate();
+	}
+
+	filePath.replace_extension("model");
+	fopen_s(&mFile, filePath.u8string().c_str(), "r");
+	if (mFile == nullptr)
+	{
+		return false;
+	}
+	fscanf_s(mFile, "MeshCount: %d\n", &mMeshCount);
+	return true;
+}
+
+void ModelIO::ModelReader::Close()
+{
+	mMappedFile.Terminate();
+	if (mFile != nullptr)
+	{
+		fclose(mFile);
+		mFile = nullptr;
+	}
+	mMeshCount = 0;
+	mMeshesRead = 0;
+}
+
+bool ModelIO::ModelReader::ReadNextMesh(Model& model, const MeshCallback& callback)
+{
+	if (IsDone())
+	{
+		return false;
+	}
+
+	const uint32_t meshIndex = mMeshesRead++;
+	Model::MeshData& meshData = model.meshData.emplace_back();
+	if (mMappedFile.IsValid())
+	{
+		CopyBinaryMesh(mMappedFile, meshIndex, meshData);
+	}
+	else
+	{
+		ReadTextMesh(mFile, meshData);
+	}
+
+	if (callback)
+	{
+		callback(meshData, meshIndex, mMeshCount);
+	}
+	return true;
+}
+
+bool ModelIO::ModelReader::IsDone() const
+{
+	return mMeshesRead >= mMeshCount;
 }
 
-void ModelIO::SaveMaterial(std::filesystem::path filePath, const Model & model)
+bool ModelIO::SaveMaterial(std::filesystem::path filePath, const Model & model)
 {
 	if (model.materialData.empty())
 	{
-		return;
+		return false;
 	}
 	filePath.replace_extension("material");
 
@@ -105,7 +559,7 @@ void ModelIO::SaveMaterial(std::filesystem::path filePath, const Model & model)
 	fopen_s(&file, filePath.u8string().c_str(), "w");
 	if (file == nullptr)
 	{
-		return;
+		return false;
 	}
 
 	uint32_t materialCount = static_cast<uint32_t>(model.materialData.size());
@@ -125,6 +579,7 @@ void ModelIO::SaveMaterial(std::filesystem::path filePath, const Model & model)
 		fprintf_s(file, "%s\n", materialData.bumpMapName.empty() ? "<none>" : materialData.bumpMapName.c_str());
 	}
 	fclose(file);
+	return true;
 }
 
 void ModelIO::LoadMaterial(std::filesystem::path filePath, Model& model)
@@ -166,4 +621,244 @@ void ModelIO::LoadMaterial(std::filesystem::path filePath, Model& model)
 		TryReadTextureName(materialData.bumpMapName);
 	}
 	fclose(file);
+}
+
+bool ModelIO::SaveSkeleton(std::filesystem::path filePath, const Model& model)
+{
+	if (model.skeleton.bones.empty())
+	{
+		return false;
+	}
+	filePath.replace_extension("skeleton");
+
+	FILE* file = nullptr;
+	fopen_s(&file, filePath.u8string().c_str(), "w");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	auto WriteMatrix = [&](const char* label, const Math::Matrix4& m)
+	{
+		fprintf_s(file, "%s:", label);
+		for (float value : m.v)
+		{
+			fprintf_s(file, " %f", value);
+		}
+		fprintf_s(file, "\n");
+	};
+
+	const Skeleton& skeleton = model.skeleton;
+	fprintf_s(file, "BoneCount: %d\n", static_cast<uint32_t>(skeleton.bones.size()));
+	fprintf_s(file, "RootIndex: %d\n", skeleton.rootIndex);
+	for (const Bone& bone : skeleton.bones)
+	{
+		fprintf_s(file, "Name: %s\n", bone.name.c_str());
+		fprintf_s(file, "ParentIndex: %d\n", bone.parentIndex);
+		WriteMatrix("ToParent", bone.toParentTransform);
+		WriteMatrix("Offset", bone.offsetTransform);
+	}
+	fclose(file);
+	return true;
+}
+
+void ModelIO::LoadSkeleton(std::filesystem::path filePath, Model& model)
+{
+	filePath.replace_extension("skeleton");
+
+	FILE* file = nullptr;
+	fopen_s(&file, filePath.u8string().c_str(), "r");
+	if (file == nullptr)
+	{
+		return;
+	}
+
+	auto ReadMatrix = [&](const char* format, Math::Matrix4& m)
+	{
+		fscanf_s(file, format);
+		for (float& value : m.v)
+		{
+			fscanf_s(file, " %f", &value);
+		}
+		fscanf_s(file, "\n");
+	};
+
+	Skeleton& skeleton = model.skeleton;
+	uint32_t boneCount = 0;
+	fscanf_s(file, "BoneCount: %d\n", &boneCount);
+	fscanf_s(file, "RootIndex: %d\n", &skeleton.rootIndex);
+	skeleton.bones.resize(boneCount);
+	for (uint32_t i = 0; i < boneCount; ++i)
+	{
+		// Names can contain spaces, read the rest of the line
+		char buffer[MAX_PATH] = {};
+		Bone& bone = skeleton.bones[i];
+		bone.index = static_cast<int>(i);
+		fscanf_s(file, "Name: %[^\n]\n", buffer, (uint32_t)sizeof(buffer));
+		bone.name = buffer;
+		fscanf_s(file, "ParentIndex: %d\n", &bone.parentIndex);
+		ReadMatrix("ToParent:", bone.toParentTransform);
+		ReadMatrix("Offset:", bone.offsetTransform);
+	}
+	fclose(file);
+
+	for (Bone& bone : skeleton.bones)
+	{
+		if (bone.parentIndex >= 0 && bone.parentIndex < static_cast<int>(boneCount))
+		{
+			skeleton.bones[bone.parentIndex].childIndices.push_back(bone.index);
+		}
+	}
+}
+
+bool ModelIO::SaveAnimations(std::filesystem::path filePath, const Model& model)
+{
+	if (model.animationClips.empty())
+	{
+		return false;
+	}
+	filePath.replace_extension("animset");
+
+	FILE* file = nullptr;
+	fopen_s(&file, filePath.u8string().c_str(), "w");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	auto WriteKeys = [&](const char* label, const auto& keys, auto&& writeValue)
+	{
+		fprintf_s(file, "%s: %d\n", label, keys.size());
+		for (uint32_t k = 0; k < keys.size(); ++k)
+		{
+			fprintf_s(file, "%f", keys.times[k]);
+			writeValue(keys.values[k]);
+			fprintf_s(file, "\n");
+		}
+	};
+	auto WriteVector3 = [&](const Math::Vector3& v) { fprintf_s(file, " %f %f %f", v.x, v.y, v.z); };
+	auto WriteQuaternion = [&](const Math::Quaternion& q) { fprintf_s(file, " %f %f %f %f", q.x, q.y, q.z, q.w); };
+
+	fprintf_s(file, "ClipCount: %d\n", static_cast<uint32_t>(model.animationClips.size()));
+	for (const AnimationClip& clip : model.animationClips)
+	{
+		uint32_t trackCount = 0;
+		for (const BoneAnimation& boneAnimation : clip.boneAnimations)
+		{
+			trackCount += boneAnimation.empty() ? 0 : 1;
+		}
+
+		fprintf_s(file, "Name: %s\n", clip.name.c_str());
+		fprintf_s(file, "Duration: %f\n", clip.duration);
+		fprintf_s(file, "BoneCount: %d\n", static_cast<uint32_t>(clip.boneAnimations.size()));
+		fprintf_s(file, "TrackCount: %d\n", trackCount);
+		for (uint32_t b = 0; b < clip.boneAnimations.size(); ++b)
+		{
+			const BoneAnimation& boneAnimation = clip.boneAnimations[b];
+			if (boneAnimation.empty())
+			{
+				continue;
+			}
+
+			fprintf_s(file, "Bone: %d\n", b);
+			WriteKeys("PositionKeys", boneAnimation.positionKeys, WriteVector3);
+			WriteKeys("RotationKeys", boneAnimation.rotationKeys, WriteQuaternion);
+			WriteKeys("ScaleKeys", boneAnimation.scaleKeys, WriteVector3);
+		}
+	}
+	fclose(file);
+	return true;
+}
+
+void ModelIO::LoadAnimations(std::filesystem::path filePath, Model& model)
+{
+	filePath.replace_extension("animset");
+
+	FILE* file = nullptr;
+	fopen_s(&file, filePath.u8string().c_str(), "r");
+	if (file == nullptr)
+	{
+		return;
+	}
+
+	auto ReadKeys = [&](const char* format, auto& keys, auto&& readValue)
+	{
+		uint32_t keyCount = 0;
+		fscanf_s(file, format, &keyCount);
+		keys.times.resize(keyCount);
+		keys.values.resize(keyCount);
+		for (uint32_t k = 0; k < keyCount; ++k)
+		{
+			fscanf_s(file, "%f", &keys.times[k]);
+			readValue(keys.values[k]);
+			fscanf_s(file, "\n");
+		}
+	};
+	auto ReadVector3 = [&](Math::Vector3& v) { fscanf_s(file, " %f %f %f", &v.x, &v.y, &v.z); };
+	auto ReadQuaternion = [&](Math::Quaternion& q) { fscanf_s(file, " %f %f %f %f", &q.x, &q.y, &q.z, &q.w); };
+
+	uint32_t clipCount = 0;
+	fscanf_s(file, "ClipCount: %d\n", &clipCount);
+	model.animationClips.resize(clipCount);
+	for (AnimationClip& clip : model.animationClips)
+	{
+		char buffer[MAX_PATH] = {};
+		fscanf_s(file, "Name: %[^\n]\n", buffer, (uint32_t)sizeof(buffer));
+		clip.name = buffer;
+		fscanf_s(file, "Duration: %f\n", &clip.duration);
+
+		uint32_t boneCount = 0;
+		uint32_t trackCount = 0;
+		fscanf_s(file, "BoneCount: %d\n", &boneCount);
+		fscanf_s(file, "TrackCount: %d\n", &trackCount);
+		clip.boneAnimations.resize(boneCount);
+		for (uint32_t t = 0; t < trackCount; ++t)
+		{
+			uint32_t boneIndex = 0;
+			fscanf_s(file, "Bone: %d\n", &boneIndex);
+			ASSERT(boneIndex < boneCount, "ModelIO: animation %s has a track for bone %u of %u", clip.name.c_str(), boneIndex, boneCount);
+			// A track for a bone the clip doesn't have is still read, so the next one starts in
+			// the right place, and then dropped
+			BoneAnimation skippedAnimation;
+			BoneAnimation& boneAnimation = (boneIndex < boneCount) ? clip.boneAnimations[boneIndex] : skippedAnimation;
+			ReadKeys("PositionKeys: %d\n", boneAnimation.positionKeys, ReadVector3);
+			ReadKeys("RotationKeys: %d\n", boneAnimation.rotationKeys, ReadQuaternion);
+			ReadKeys("ScaleKeys: %d\n", boneAnimation.scaleKeys, ReadVector3);
+		}
+	}
+	fclose(file);
+}
+
+bool ModelIO::ValidateSkinWeights(const Model& model, float tolerance)
+{
+	const int boneCount = static_cast<int>(model.skeleton.bones.size());
+	for (uint32_t m = 0; m < model.meshData.size(); ++m)
+	{
+		const std::vector<Vertex>& vertices = model.meshData[m].mesh.vertices;
+		if (!VertexCompression::HasSkin(vertices))
+		{
+			continue;
+		}
+
+		for (uint32_t v = 0; v < vertices.size(); ++v)
+		{
+			const Vertex& vertex = vertices[v];
+			float weightSum = 0.0f;
+			for (int i = 0; i < Vertex::MaxBoneWeights; ++i)
+			{
+				weightSum += vertex.boneWeights[i];
+				if (vertex.boneWeights[i] > 0.0f && (vertex.boneIndices[i] < 0 || vertex.boneIndices[i] >= boneCount))
+				{
+					LOG("ModelIO: mesh %u vertex %u uses bone %d, skeleton has %d bones", m, v, vertex.boneIndices[i], boneCount);
+					return false;
+				}
+			}
+			if (Math::Abs(weightSum - 1.0f) > tolerance)
+			{
+				LOG("ModelIO: mesh %u vertex %u bone weights sum to %f", m, v, weightSum);
+				return false;
+			}
+		}
+	}
+	return true;
 }
\ No newline at end of file
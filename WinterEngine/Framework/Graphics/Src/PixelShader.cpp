@@ -8,7 +8,14 @@ using namespace WinterEngine::Graphics;
 
 void WinterEngine::Graphics::PixelShader::Initialize(const std::filesystem::path& filePath, const char* entryPoint)
 {
-	auto device = GraphicsSystem::Get()->GetDevice();
+	GraphicsSystem* gs = GraphicsSystem::Get();
+	gs->RecordResourceCreated(0);
+	if (gs->IsHeadless())
+	{
+		ASSERT(std::filesystem::exists(filePath), "PixelShader: %ls not found", filePath.c_str());
+		return;
+	}
+	auto device = gs->GetDevice();
 
 	DWORD shaderFlags = D3DCOMPILE_ENABLE_STRICTNESS | D3DCOMPILE_DEBUG;
 	ID3DBlob* shaderBlob = nullptr;
@@ -47,6 +54,12 @@ void WinterEngine::Graphics::PixelShader::Terminate()
 
 void WinterEngine::Graphics::PixelShader::Bind()
 {
-	auto context = GraphicsSystem::Get()->GetContext();
+	GraphicsSystem* gs = GraphicsSystem::Get();
+	gs->RecordBind(BindPoint::PixelShader, 0, this);
+	if (gs->IsHeadless())
+	{
+		return;
+	}
+	auto context = gs->GetContext();
 	context->PSSetShader(mPixelShader, nullptr, 0);
 }
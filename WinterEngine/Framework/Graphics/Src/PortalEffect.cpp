@@ -47,7 +47,7 @@ void PortalEffect::Render(const RenderObject& renderObject)
 {
 	//Screen space vs world space
 
-	const Math::Matrix4 matWorld = renderObject.transform.GetMatrix4();
+	const Math::Matrix4 matWorld = renderObject.GetWorldMatrix();
 	const Math::Matrix4 matView = mGameCamera->GetViewMatrix();
 	const Math::Matrix4 matProj = mGameCamera->GetProjectionMatrix();
 
@@ -132,7 +132,7 @@ void PortalEffect::SetPortalObject(RenderObject& renderObject)
 void PortalEffect::UpdatePortalCamera()
 {
 	//ASSERT(mDirectionalLight != nullptr, "ShadowEffect: no light set");
-	Math::Matrix4 portalMat = mLinkedPortalObject->transform.GetMatrix4();
+	Math::Matrix4 portalMat = mLinkedPortalObject->GetWorldMatrix();
 	//Math::Vector3 direction = { -portalMat._31, -portalMat._32, -portalMat._33 }; //static portal image
 	//Math::Vector3 direction = (mGameCamera->GetPosition() - mLinkedPortalCamera->GetPosition()); //Adjusts based on position, needs improving
 	Math::Vector3 dirToPortal = mGameCamera->GetDirection(); //testing based on the portal object, puts both cameras in the same position
@@ -165,20 +165,23 @@ void PortalEffect::UpdatePortalUV()
 		0.0f, 0.0f, 1.0f, 0.0f,
 		  hw,   hh, 0.0f, 1.0f
 	};
-	Math::Matrix4 matWorld = mPortalObject->transform.GetMatrix4();
+	Math::Matrix4 matWorld = mPortalObject->GetWorldMatrix();
 	const Math::Matrix4 matView = mGameCamera->GetViewMatrix();
 	const Math::Matrix4 matProj = mGameCamera->GetProjectionMatrix();
 	Math::Matrix4 matFinal = matWorld * matView * matProj * matScreenSpace;
 
+	// Screen space positions of the linked portal's vertices, divided by w, become this portal's uvs
+	const std::vector<VertexPX>& linkedVertices = mLinkedPortalMesh->vertices;
+	mProjectedPositions.resize(linkedVertices.size());
+	if (!linkedVertices.empty())
+	{
+		Math::ProjectCoords(&linkedVertices[0].position, sizeof(VertexPX), mProjectedPositions.data(), sizeof(Math::Vector3), linkedVertices.size(), matFinal);
+	}
 	for (size_t i = 0; i < mPortalMesh.vertices.size(); ++i)
 	{
-		Math::Matrix4 ndcSpacePos = Math::Matrix4::Translation(mLinkedPortalMesh->vertices[i].position);// = Math::TransformCoord(mLinkedPortalMesh->vertices[i].position, matFinal);
-		ndcSpacePos = ndcSpacePos * matFinal;
 		Math::Vector2 newUV;
-		newUV.x = (ndcSpacePos._41 / ndcSpacePos._44) / width;
-		newUV.y = (ndcSpacePos._42 / ndcSpacePos._44) / height;
-		//newUV.x = ndcSpacePos.x / width;
-		//newUV.y = ndcSpacePos.y / height;
+		newUV.x = mProjectedPositions[i].x / width;
+		newUV.y = mProjectedPositions[i].y / height;
 		mPortalMesh.vertices[i].uvCoord = newUV;
 	}
 	mPortalObject->meshBuffer.Update(mPortalMesh.vertices.data(), mPortalMesh.vertices.size());
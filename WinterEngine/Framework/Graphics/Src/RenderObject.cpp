@@ -1,15 +1,64 @@
 #include "Precompile.h"
 #include "RenderObject.h"
 
+#include "Camera.h"
+
 using namespace WinterEngine;
 using namespace WinterEngine::Graphics;
 
+void WorldBounds::Update(const Math::AABB& aabb, const Math::Sphere& sphere, const Math::Matrix4& world) const
+{
+	if (mValid &&
+		memcmp(&mWorld, &world, sizeof(Math::Matrix4)) == 0 &&
+		memcmp(&mLocalAABB, &aabb, sizeof(Math::AABB)) == 0 &&
+		memcmp(&mLocalSphere, &sphere, sizeof(Math::Sphere)) == 0)
+	{
+		return;
+	}
+
+	mWorld = world;
+	mLocalAABB = aabb;
+	mLocalSphere = sphere;
+	mWorldAABB = Math::TransformAABB(aabb, world);
+	mWorldSphere = Math::TransformSphere(sphere, world);
+	mValid = true;
+}
+
 void RenderObject::Terminate()
 {
 	meshBuffer.Terminate();
 
 }
 
+void RenderObject::Render(uint32_t lodLevel) const
+{
+	if (lodRanges.empty())
+	{
+		meshBuffer.Render();
+		return;
+	}
+
+	const LODRange& range = lodRanges[Math::Min(lodLevel, static_cast<uint32_t>(lodRanges.size()) - 1)];
+	meshBuffer.Render(range.startIndex, range.indexCount);
+}
+
+Math::Matrix4 RenderObject::GetWorldMatrix() const
+{
+	return (transformId != 0) ? TransformSystem::Get()->GetWorldMatrix(transformId) : transform.GetMatrix4();
+}
+
+const Math::AABB& RenderObject::GetWorldAABB() const
+{
+	mWorldBounds.Update(aabb, boundingSphere, GetWorldMatrix());
+	return mWorldBounds.GetAABB();
+}
+
+const Math::Sphere& RenderObject::GetWorldSphere() const
+{
+	mWorldBounds.Update(aabb, boundingSphere, GetWorldMatrix());
+	return mWorldBounds.GetSphere();
+}
+
 void RenderGroup::Initialize(const std::filesystem::path& modelFilePath)
 {
 	modelId = ModelCache::Get()->LoadModel(modelFilePath);
@@ -20,29 +69,138 @@ void RenderGroup::Initialize(const std::filesystem::path& modelFilePath)
 
 void RenderGroup::Initialize(const Model& model)
 {
-	auto TryLoadTexture = [](const auto& textureName)->TextureId
+	for (const Model::MeshData& meshData : model.meshData)
+	{
+		AddRenderObject(model, meshData, false);
+	}
+}
+
+void RenderGroup::InitializeStreamed(const std::filesystem::path& modelFilePath)
+{
+	modelId = ModelCache::Get()->LoadModelStreamed(modelFilePath);
+	StreamMeshes();
+}
+
+void RenderGroup::InitializeAsync(const std::filesystem::path& modelFilePath)
+{
+	modelId = ModelCache::Get()->LoadModelAsync(modelFilePath);
+	StreamMeshes();
+}
+
+void RenderGroup::StreamMeshes()
+{
+	const Model* model = ModelCache::Get()->GetModel(modelId);
+	if (model == nullptr)
+	{
+		return;
+	}
+
+	while (renderObjects.size() < model->meshData.size())
+	{
+		AddRenderObject(*model, model->meshData[renderObjects.size()], true);
+	}
+}
+
+bool RenderGroup::IsFullyLoaded() const
+{
+	const Model* model = ModelCache::Get()->GetModel(modelId);
+	return model != nullptr && ModelCache::Get()->IsModelLoaded(modelId) && renderObjects.size() == model->meshData.size();
+}
+
+Math::Matrix4 RenderGroup::GetWorldMatrix() const
+{
+	return (transformId != 0) ? TransformSystem::Get()->GetWorldMatrix(transformId) : transform.GetMatrix4();
+}
+
+const Math::AABB& RenderGroup::GetWorldAABB() const
+{
+	mWorldBounds.Update(aabb, boundingSphere, GetWorldMatrix());
+	return mWorldBounds.GetAABB();
+}
+
+const Math::Sphere& RenderGroup::GetWorldSphere() const
+{
+	mWorldBounds.Update(aabb, boundingSphere, GetWorldMatrix());
+	return mWorldBounds.GetSphere();
+}
+
+uint32_t RenderGroup::GetLODLevel(const Camera& camera) const
+{
+	if (lodCount <= 1)
+	{
+		return 0;
+	}
+
+	// Largest axis of the world matrix covers parent scale as well as our own
+	const Math::Matrix4 world = GetWorldMatrix();
+	const float scale = Math::Max(Math::Magnitude({ world._11, world._12, world._13 }),
+		Math::Max(Math::Magnitude({ world._21, world._22, world._23 }), Math::Magnitude({ world._31, world._32, world._33 })));
+	const float screenSize = camera.GetScreenSize({ world._41, world._42, world._43 }, boundingRadius * scale);
+	uint32_t lodLevel = 0;
+	for (float threshold = lodScreenSize; screenSize < threshold && lodLevel + 1 < lodCount; threshold *= 0.5f)
+	{
+		++lodLevel;
+	}
+	return lodLevel;
+}
+
+void RenderGroup::AddRenderObject(const Model& model, const Model::MeshData& meshData, bool loadTexturesAsync)
+{
+	auto TryLoadTexture = [loadTexturesAsync](const auto& textureName)->TextureId
 	{
 		if (textureName.empty())
 		{
 			return 0;
 		}
 
-		return TextureCache::Get()->LoadTexture(textureName, false);
+		// Only the streamed/async setups may leave a texture to arrive in a later frame
+		TextureCache* textureCache = TextureCache::Get();
+		return loadTexturesAsync ? textureCache->LoadTextureAsync(textureName, false) : textureCache->LoadTexture(textureName, false);
 	};
 
-	for (const Model::MeshData& meshData : model.meshData)
+	RenderObject& renderObject = renderObjects.emplace_back();
+	renderObject.aabb = meshData.mesh.aabb;
+	renderObject.boundingSphere = meshData.mesh.boundingSphere;
+	if (renderObject.boundingSphere.IsEmpty())
+	{
+		// Meshes put together in code may never have had their bounds computed
+		const std::vector<Vertex>& vertices = meshData.mesh.vertices;
+		const Math::Vector3* positions = vertices.empty() ? nullptr : &vertices[0].position;
+		renderObject.aabb = Math::ComputeAABB(positions, sizeof(Vertex), vertices.size());
+		renderObject.boundingSphere = Math::ComputeBoundingSphere(positions, sizeof(Vertex), vertices.size(), renderObject.aabb);
+	}
+	aabb = Math::Merge(aabb, renderObject.aabb);
+	boundingSphere = Math::Merge(boundingSphere, renderObject.boundingSphere);
+	if (!renderObject.boundingSphere.IsEmpty())
+	{
+		boundingRadius = Math::Max(boundingRadius, Math::Magnitude(renderObject.boundingSphere.center) + renderObject.boundingSphere.radius);
+	}
+	if (meshData.lods.empty())
 	{
-		RenderObject& renderObject = renderObjects.emplace_back();
 		renderObject.meshBuffer.Initialize(meshData.mesh);
-		if (meshData.materialIndex < model.materialData.size())
+	}
+	else
+	{
+		// All levels share the vertex buffer, their index lists are appended after the full mesh
+		std::vector<uint32_t> indices = meshData.mesh.indices;
+		renderObject.lodRanges.push_back({ 0, static_cast<uint32_t>(indices.size()) });
+		for (const Model::LOD& lod : meshData.lods)
 		{
-			const Model::MaterialData& materialData = model.materialData[meshData.materialIndex];
-			renderObject.material = materialData.material;
-			renderObject.diffuseMapId = TryLoadTexture(materialData.diffuseMapName);
-			renderObject.normalMapId = TryLoadTexture(materialData.normalMapName);
-			renderObject.specMapId = TryLoadTexture(materialData.specMapName);
-			renderObject.bumpMapId = TryLoadTexture(materialData.bumpMapName);
+			renderObject.lodRanges.push_back({ static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(lod.indices.size()) });
+			indices.insert(indices.end(), lod.indices.begin(), lod.indices.end());
 		}
+		renderObject.meshBuffer.Initialize(meshData.mesh.vertices.data(), static_cast<uint32_t>(sizeof(Vertex)),
+			static_cast<uint32_t>(meshData.mesh.vertices.size()), indices.data(), static_cast<uint32_t>(indices.size()));
+		lodCount = Math::Max(lodCount, static_cast<uint32_t>(renderObject.lodRanges.size()));
+	}
+	if (meshData.materialIndex < model.materialData.size())
+	{
+		const Model::MaterialData& materialData = model.materialData[meshData.materialIndex];
+		renderObject.material = materialData.material;
+		renderObject.diffuseMapId = TryLoadTexture(materialData.diffuseMapName);
+		renderObject.normalMapId = TryLoadTexture(materialData.normalMapName);
+		renderObject.specMapId = TryLoadTexture(materialData.specMapName);
+		renderObject.bumpMapId = TryLoadTexture(materialData.bumpMapName);
 	}
 }
 
@@ -16,6 +16,20 @@ void RenderTarget::Initialize(const std::filesystem::path& fileName)
 
 void RenderTarget::Initialize(uint32_t width, uint32_t height, Format format)
 {
+	mViewPort.TopLeftX = 0.0f;
+	mViewPort.TopLeftY = 0.0f;
+	mViewPort.Width = static_cast<float>(width);
+	mViewPort.Height = static_cast<float>(height);
+	mViewPort.MinDepth = 0.0f;
+	mViewPort.MaxDepth = 1.0f;
+
+	GraphicsSystem* gs = GraphicsSystem::Get();
+	gs->RecordResourceCreated(0);
+	if (gs->IsHeadless())
+	{
+		return;
+	}
+
 	D3D11_TEXTURE2D_DESC desc{};
 	desc.Width = width;
 	desc.Height = height;
@@ -29,7 +43,7 @@ void RenderTarget::Initialize(uint32_t width, uint32_t height, Format format)
 	desc.CPUAccessFlags = 0;
 	desc.MiscFlags = 0;
 
-	auto device = GraphicsSystem::Get()->GetDevice();
+	auto device = gs->GetDevice();
 	ID3D11Texture2D* texture = nullptr;
 	HRESULT hr = device->CreateTexture2D(&desc, nullptr, &texture);
 	ASSERT(SUCCEEDED(hr), "RenderTarget: failed to create texture");
@@ -51,13 +65,6 @@ void RenderTarget::Initialize(uint32_t width, uint32_t height, Format format)
 	ASSERT(SUCCEEDED(hr), "RenderTarget: failed to create depth stencil");
 
 	SafeRelease(texture);
-
-	mViewPort.TopLeftX = 0.0f;
-	mViewPort.TopLeftY = 0.0f;
-	mViewPort.Width = static_cast<float>(width);
-	mViewPort.Height = static_cast<float>(height);
-	mViewPort.MinDepth = 0.0f;
-	mViewPort.MaxDepth = 1.0f;
 }
 
 void RenderTarget::Terminate()
@@ -70,7 +77,16 @@ void RenderTarget::Terminate()
 
 void RenderTarget::BeginRender(Color clearColor)
 {
-	auto context = GraphicsSystem::Get()->GetContext();
+	GraphicsSystem* gs = GraphicsSystem::Get();
+	mOldRenderTarget = gs->GetBoundObject(BindPoint::RenderTarget, 0);
+	mOldViewport = gs->GetBoundObject(BindPoint::Viewport, 0);
+	gs->RecordBind(BindPoint::RenderTarget, 0, this);
+	gs->RecordBind(BindPoint::Viewport, 0, this);
+	if (gs->IsHeadless())
+	{
+		return;
+	}
+	auto context = gs->GetContext();
 
 	//store the current versions
 	UINT numViewports = 1;
@@ -86,7 +102,14 @@ void RenderTarget::BeginRender(Color clearColor)
 
 void RenderTarget::EndRender()
 {
-	auto context = GraphicsSystem::Get()->GetContext();
+	GraphicsSystem* gs = GraphicsSystem::Get();
+	gs->RecordBind(BindPoint::RenderTarget, 0, mOldRenderTarget);
+	gs->RecordBind(BindPoint::Viewport, 0, mOldViewport);
+	if (gs->IsHeadless())
+	{
+		return;
+	}
+	auto context = gs->GetContext();
 	context->OMSetRenderTargets(1, &mOldRenderTargetView, mOldDepthStencilView);
 	context->RSSetViewports(1, &mOldViewPort);
 
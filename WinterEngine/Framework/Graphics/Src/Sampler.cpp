@@ -46,6 +46,13 @@ Sampler::~Sampler()
 
 void Sampler::Initialize(Filter filter, AddressMode addressMode)
 {
+	GraphicsSystem* gs = GraphicsSystem::Get();
+	gs->RecordResourceCreated(0);
+	if (gs->IsHeadless())
+	{
+		return;
+	}
+
 	auto d3dFilter = GetFilter(filter);
 	auto d3dAddressMode = GetAddressMode(addressMode);
 
@@ -62,7 +69,7 @@ void Sampler::Initialize(Filter filter, AddressMode addressMode)
 	desc.MinLOD = 0;
 	desc.MaxLOD = D3D11_FLOAT32_MAX;
 
-	auto device = GraphicsSystem::Get()->GetDevice();
+	auto device = gs->GetDevice();
 	HRESULT hr = device->CreateSamplerState(&desc, &mSampler);
 	ASSERT(SUCCEEDED(hr), "Sampler: failted to initialize");
 }
@@ -74,12 +81,24 @@ void Sampler::Terminate()
 
 void Sampler::BindVS(uint32_t slot)
 {
-	auto context = GraphicsSystem::Get()->GetContext();
+	GraphicsSystem* gs = GraphicsSystem::Get();
+	gs->RecordBind(BindPoint::VSSampler, slot, this);
+	if (gs->IsHeadless())
+	{
+		return;
+	}
+	auto context = gs->GetContext();
 	context->VSSetSamplers(slot, 1, &mSampler);
 }
 
 void Sampler::BindPS(uint32_t slot)
 {
-	auto context = GraphicsSystem::Get()->GetContext();
+	GraphicsSystem* gs = GraphicsSystem::Get();
+	gs->RecordBind(BindPoint::PSSampler, slot, this);
+	if (gs->IsHeadless())
+	{
+		return;
+	}
+	auto context = gs->GetContext();
 	context->PSSetSamplers(slot, 1, &mSampler);
 }
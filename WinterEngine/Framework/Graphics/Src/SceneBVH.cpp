@@ -0,0 +1,748 @@
+#include "Precompile.h"
+#include "SceneBVH.h"
+
+#include "RenderObject.h"
+
+using namespace WinterEngine;
+using namespace WinterEngine::Graphics;
+
+namespace
+{
+	constexpr uint32_t ParallelThreshold = 64;
+	constexpr uint32_t BatchSize = 16;
+	constexpr uint32_t AllPlanes = (1u << Math::Frustum::Count) - 1;
+
+	inline bool Contains(const Math::AABB& outer, const Math::AABB& inner)
+	{
+		return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+			outer.max.x >= inner.max.x && outer.max.y >= inner.max.y && outer.max.z >= inner.max.z;
+	}
+
+	inline bool Overlaps(const Math::AABB& a, const Math::AABB& b)
+	{
+		return a.min.x <= b.max.x && a.min.y <= b.max.y && a.min.z <= b.max.z &&
+			a.max.x >= b.min.x && a.max.y >= b.min.y && a.max.z >= b.min.z;
+	}
+
+	// Planes set up once per query. Classify drops the planes the box is fully inside of from the
+	// mask and returns false once the box is fully outside any of them
+#if defined(WINTER_MATH_SSE)
+	// Planes transposed four to a register, the two spare lanes of the second group always pass
+	struct FrustumSetup
+	{
+		__m128 normalX[2], normalY[2], normalZ[2], d[2];
+		__m128 absX[2], absY[2], absZ[2];
+	};
+
+	FrustumSetup MakeFrustumSetup(const Math::Frustum& frustum)
+	{
+		float values[7][8] = {};
+		for (uint32_t i = 0; i < 8; ++i)
+		{
+			const Math::Plane plane = (i < Math::Frustum::Count) ? frustum.planes[i] : Math::Plane{ Math::Vector3::Zero, 1.0f };
+			const float planeValues[7] = { plane.normal.x, plane.normal.y, plane.normal.z, plane.d, Math::Abs(plane.normal.x), Math::Abs(plane.normal.y), Math::Abs(plane.normal.z) };
+			for (uint32_t v = 0; v < 7; ++v)
+			{
+				values[v][i] = planeValues[v];
+			}
+		}
+
+		FrustumSetup setup;
+		__m128* targets[7] = { setup.normalX, setup.normalY, setup.normalZ, setup.d, setup.absX, setup.absY, setup.absZ };
+		for (uint32_t v = 0; v < 7; ++v)
+		{
+			targets[v][0] = _mm_loadu_ps(values[v]);
+			targets[v][1] = _mm_loadu_ps(values[v] + 4);
+		}
+		return setup;
+	}
+
+	// Same operation order as Math::IsVisible so both agree on boxes touching a plane
+	inline bool ClassifyAABB(const FrustumSetup& setup, const Math::AABB& aabb, uint32_t& planeMask)
+	{
+		const __m128 half = _mm_set1_ps(0.5f);
+		const __m128 boxMin = _mm_loadu_ps(&aabb.min.x);
+		const __m128 upper = _mm_loadu_ps(&aabb.min.z);
+		const __m128 boxMax = _mm_shuffle_ps(upper, upper, _MM_SHUFFLE(3, 3, 2, 1));
+		const __m128 center = _mm_mul_ps(_mm_add_ps(boxMin, boxMax), half);
+		const __m128 extents = _mm_mul_ps(_mm_sub_ps(boxMax, boxMin), half);
+		const __m128 cx = _mm_shuffle_ps(center, center, _MM_SHUFFLE(0, 0, 0, 0));
+		const __m128 cy = _mm_shuffle_ps(center, center, _MM_SHUFFLE(1, 1, 1, 1));
+		const __m128 cz = _mm_shuffle_ps(center, center, _MM_SHUFFLE(2, 2, 2, 2));
+		const __m128 ex = _mm_shuffle_ps(extents, extents, _MM_SHUFFLE(0, 0, 0, 0));
+		const __m128 ey = _mm_shuffle_ps(extents, extents, _MM_SHUFFLE(1, 1, 1, 1));
+		const __m128 ez = _mm_shuffle_ps(extents, extents, _MM_SHUFFLE(2, 2, 2, 2));
+
+		uint32_t outsideMask = 0;
+		uint32_t insideMask = 0;
+		for (uint32_t group = 0; group < 2; ++group)
+		{
+			__m128 distance = _mm_add_ps(_mm_mul_ps(setup.normalX[group], cx), _mm_mul_ps(setup.normalY[group], cy));
+			distance = _mm_add_ps(_mm_add_ps(distance, _mm_mul_ps(setup.normalZ[group], cz)), setup.d[group]);
+			__m128 reach = _mm_add_ps(_mm_mul_ps(setup.absX[group], ex), _mm_mul_ps(setup.absY[group], ey));
+			reach = _mm_add_ps(reach, _mm_mul_ps(setup.absZ[group], ez));
+			outsideMask |= static_cast<uint32_t>(_mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(distance, reach), _mm_setzero_ps()))) << (group * 4);
+			insideMask |= static_cast<uint32_t>(_mm_movemask_ps(_mm_cmpge_ps(_mm_sub_ps(distance, reach), _mm_setzero_ps()))) << (group * 4);
+		}
+		if ((outsideMask & planeMask) != 0)
+		{
+			return false;
+		}
+		planeMask &= ~insideMask;
+		return true;
+	}
+#else
+	struct FrustumSetup
+	{
+		const Math::Frustum* frustum;
+	};
+
+	FrustumSetup MakeFrustumSetup(const Math::Frustum& frustum)
+	{
+		return { &frustum };
+	}
+
+	inline bool ClassifyAABB(const FrustumSetup& setup, const Math::AABB& aabb, uint32_t& planeMask)
+	{
+		const Math::Vector3 center = aabb.GetCenter();
+		const Math::Vector3 extents = aabb.GetExtents();
+		for (uint32_t i = 0; i < Math::Frustum::Count; ++i)
+		{
+			const uint32_t bit = 1u << i;
+			if ((planeMask & bit) == 0)
+			{
+				continue;
+			}
+
+			const Math::Plane& plane = setup.frustum->planes[i];
+			const float reach = (Math::Abs(plane.normal.x) * extents.x) + (Math::Abs(plane.normal.y) * extents.y) + (Math::Abs(plane.normal.z) * extents.z);
+			const float distance = Math::Dot(plane.normal, center) + plane.d;
+			if (distance + reach < 0.0f)
+			{
+				return false;
+			}
+			if (distance - reach >= 0.0f)
+			{
+				planeMask &= ~bit;
+			}
+		}
+		return true;
+	}
+#endif
+
+	inline bool OverlapsSphere(const Math::AABB& aabb, const Math::Sphere& sphere)
+	{
+		const Math::Vector3 closest = {
+			Math::Clamp(sphere.center.x, aabb.min.x, aabb.max.x),
+			Math::Clamp(sphere.center.y, aabb.min.y, aabb.max.y),
+			Math::Clamp(sphere.center.z, aabb.min.z, aabb.max.z)
+		};
+		return Math::MagnitudeSqr(closest - sphere.center) <= sphere.radius * sphere.radius;
+	}
+}
+
+void SceneBVH::Clear()
+{
+	mNodes.clear();
+	mFreeNodes.clear();
+	mProxies.clear();
+	mFreeProxies.clear();
+	mRoot = InvalidNode;
+}
+
+SceneBVH::ProxyId SceneBVH::Insert(const Math::AABB& aabb, const void* userData)
+{
+	ASSERT(!aabb.IsEmpty(), "SceneBVH: proxies need a non empty box");
+
+	ProxyId proxy;
+	if (!mFreeProxies.empty())
+	{
+		proxy = mFreeProxies.back();
+		mFreeProxies.pop_back();
+	}
+	else
+	{
+		proxy = static_cast<ProxyId>(mProxies.size());
+		mProxies.emplace_back();
+	}
+
+	const uint32_t leaf = AllocateNode();
+	mNodes[leaf].aabb = aabb;
+	mNodes[leaf].proxy = proxy;
+	mProxies[proxy] = { Fatten(aabb), userData, leaf };
+	InsertLeaf(leaf);
+	return proxy;
+}
+
+SceneBVH::ProxyId SceneBVH::Insert(const RenderObject& renderObject)
+{
+	return Insert(renderObject.GetWorldAABB(), &renderObject);
+}
+
+SceneBVH::ProxyId SceneBVH::Insert(const RenderGroup& renderGroup)
+{
+	return Insert(renderGroup.GetWorldAABB(), &renderGroup);
+}
+
+void SceneBVH::Remove(ProxyId proxy)
+{
+	ASSERT(proxy < mProxies.size() && mProxies[proxy].node != InvalidNode, "SceneBVH: invalid proxy");
+	const uint32_t leaf = mProxies[proxy].node;
+	RemoveLeaf(leaf);
+	FreeNode(leaf);
+	mProxies[proxy] = {};
+	mFreeProxies.push_back(proxy);
+}
+
+bool SceneBVH::Update(ProxyId proxy, const Math::AABB& aabb)
+{
+	ASSERT(proxy < mProxies.size() && mProxies[proxy].node != InvalidNode, "SceneBVH: invalid proxy");
+	ASSERT(!aabb.IsEmpty(), "SceneBVH: proxies need a non empty box");
+
+	Proxy& entry = mProxies[proxy];
+	const uint32_t leaf = entry.node;
+	mNodes[leaf].aabb = aabb;
+	if (Contains(entry.fatAABB, aabb))
+	{
+		return false;
+	}
+
+	// Still near its old spot, resizing the ancestors keeps the tree as good as it was.
+	// Anything farther and the leaf's old siblings are the wrong neighbours
+	const Math::AABB fatAABB = Fatten(aabb);
+	if (Overlaps(entry.fatAABB, fatAABB))
+	{
+		entry.fatAABB = fatAABB;
+		RefitAncestors(mNodes[leaf].parent);
+	}
+	else
+	{
+		RemoveLeaf(leaf);
+		entry.fatAABB = fatAABB;
+		InsertLeaf(leaf);
+	}
+	return true;
+}
+
+void SceneBVH::Build()
+{
+	// Every node is rebuilt in depth first order, so a subtree sits together in memory
+	mBuildEntries.clear();
+	for (ProxyId proxy = 0; proxy < mProxies.size(); ++proxy)
+	{
+		const uint32_t node = mProxies[proxy].node;
+		if (node != InvalidNode)
+		{
+			const Math::AABB& aabb = mNodes[node].aabb;
+			mBuildEntries.push_back({ aabb, aabb.GetCenter(), proxy });
+		}
+	}
+
+	mNodes.clear();
+	mFreeNodes.clear();
+	mRoot = InvalidNode;
+	if (mBuildEntries.empty())
+	{
+		return;
+	}
+
+	mNodes.reserve((mBuildEntries.size() * 2) - 1);
+	mRoot = BuildRange(mBuildEntries.data(), static_cast<uint32_t>(mBuildEntries.size()));
+}
+
+void SceneBVH::Refit()
+{
+	if (mRoot == InvalidNode)
+	{
+		return;
+	}
+
+	// Leaves shrink back to their proxy, parents are merged after both children are done
+	std::vector<std::pair<uint32_t, bool>> stack;
+	stack.push_back({ mRoot, false });
+	while (!stack.empty())
+	{
+		const auto [index, childrenDone] = stack.back();
+		stack.pop_back();
+		Node& node = mNodes[index];
+		if (node.IsLeaf())
+		{
+			mProxies[node.proxy].fatAABB = Fatten(node.aabb);
+		}
+		else if (childrenDone)
+		{
+			node.aabb = Math::Merge(GetTreeAABB(node.children[0]), GetTreeAABB(node.children[1]));
+		}
+		else
+		{
+			stack.push_back({ index, true });
+			stack.push_back({ node.children[0], false });
+			stack.push_back({ node.children[1], false });
+		}
+	}
+}
+
+void SceneBVH::QueryFrustum(const Math::Frustum& frustum, std::vector<ProxyId>& results) const
+{
+	std::vector<uint32_t> stack;
+	QueryFrustum(frustum, results, stack);
+}
+
+void SceneBVH::QuerySphere(const Math::Sphere& sphere, std::vector<ProxyId>& results) const
+{
+	std::vector<uint32_t> stack;
+	QuerySphere(sphere, results, stack);
+}
+
+bool SceneBVH::RayCast(const Math::Ray& ray, float maxDistance, RayHit& hit, const RayCallback& callback) const
+{
+	std::vector<uint32_t> stack;
+	return RayCast(ray, maxDistance, hit, callback, stack);
+}
+
+void SceneBVH::QueryFrustums(const Math::Frustum* frustums, size_t count, std::vector<std::vector<ProxyId>>& results) const
+{
+	if (results.size() < count)
+	{
+		results.resize(count);
+	}
+
+	auto queryRange = [this, frustums, &results](uint32_t begin, uint32_t end)
+	{
+		std::vector<uint32_t> stack;
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			results[i].clear();
+			QueryFrustum(frustums[i], results[i], stack);
+		}
+	};
+	const uint32_t queryCount = static_cast<uint32_t>(count);
+	if (queryCount >= ParallelThreshold)
+	{
+		Core::JobSystem::Get()->ParallelFor(queryCount, BatchSize, queryRange);
+	}
+	else
+	{
+		queryRange(0, queryCount);
+	}
+}
+
+void SceneBVH::QuerySpheres(const Math::Sphere* spheres, size_t count, std::vector<std::vector<ProxyId>>& results) const
+{
+	if (results.size() < count)
+	{
+		results.resize(count);
+	}
+
+	auto queryRange = [this, spheres, &results](uint32_t begin, uint32_t end)
+	{
+		std::vector<uint32_t> stack;
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			results[i].clear();
+			QuerySphere(spheres[i], results[i], stack);
+		}
+	};
+	const uint32_t queryCount = static_cast<uint32_t>(count);
+	if (queryCount >= ParallelThreshold)
+	{
+		Core::JobSystem::Get()->ParallelFor(queryCount, BatchSize, queryRange);
+	}
+	else
+	{
+		queryRange(0, queryCount);
+	}
+}
+
+void SceneBVH::RayCasts(const Math::Ray* rays, size_t count, float maxDistance, RayHit* hits, const RayCallback& callback) const
+{
+	auto queryRange = [this, rays, maxDistance, hits, &callback](uint32_t begin, uint32_t end)
+	{
+		std::vector<uint32_t> stack;
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			hits[i] = {};
+			RayCast(rays[i], maxDistance, hits[i], callback, stack);
+		}
+	};
+	const uint32_t queryCount = static_cast<uint32_t>(count);
+	if (queryCount >= ParallelThreshold)
+	{
+		Core::JobSystem::Get()->ParallelFor(queryCount, BatchSize, queryRange);
+	}
+	else
+	{
+		queryRange(0, queryCount);
+	}
+}
+
+const void* SceneBVH::GetUserData(ProxyId proxy) const
+{
+	ASSERT(proxy < mProxies.size() && mProxies[proxy].node != InvalidNode, "SceneBVH: invalid proxy");
+	return mProxies[proxy].userData;
+}
+
+const Math::AABB& SceneBVH::GetAABB(ProxyId proxy) const
+{
+	ASSERT(proxy < mProxies.size() && mProxies[proxy].node != InvalidNode, "SceneBVH: invalid proxy");
+	return mNodes[mProxies[proxy].node].aabb;
+}
+
+uint32_t SceneBVH::GetProxyCount() const
+{
+	return static_cast<uint32_t>(mProxies.size() - mFreeProxies.size());
+}
+
+uint32_t SceneBVH::GetHeight() const
+{
+	if (mRoot == InvalidNode)
+	{
+		return 0;
+	}
+
+	uint32_t height = 0;
+	std::vector<std::pair<uint32_t, uint32_t>> stack;
+	stack.push_back({ mRoot, 1 });
+	while (!stack.empty())
+	{
+		const auto [index, depth] = stack.back();
+		stack.pop_back();
+		height = Math::Max(height, depth);
+		const Node& node = mNodes[index];
+		if (!node.IsLeaf())
+		{
+			stack.push_back({ node.children[0], depth + 1 });
+			stack.push_back({ node.children[1], depth + 1 });
+		}
+	}
+	return height;
+}
+
+float SceneBVH::GetCost() const
+{
+	if (mRoot == InvalidNode || mNodes[mRoot].IsLeaf())
+	{
+		return 0.0f;
+	}
+
+	float area = 0.0f;
+	for (const Node& node : mNodes)
+	{
+		if (!node.IsLeaf())
+		{
+			area += node.aabb.GetHalfArea();
+		}
+	}
+	const float rootArea = mNodes[mRoot].aabb.GetHalfArea();
+	return (rootArea > 0.0f) ? area / rootArea : 0.0f;
+}
+
+uint32_t SceneBVH::AllocateNode()
+{
+	if (!mFreeNodes.empty())
+	{
+		const uint32_t node = mFreeNodes.back();
+		mFreeNodes.pop_back();
+		return node;
+	}
+	mNodes.emplace_back();
+	return static_cast<uint32_t>(mNodes.size() - 1);
+}
+
+void SceneBVH::FreeNode(uint32_t node)
+{
+	// A leaf without a proxy is a free node, GetCost skips it that way
+	mNodes[node] = {};
+	mFreeNodes.push_back(node);
+}
+
+Math::AABB SceneBVH::Fatten(const Math::AABB& aabb) const
+{
+	const Math::Vector3 margin = { mMargin, mMargin, mMargin };
+	return { aabb.min - margin, aabb.max + margin };
+}
+
+const Math::AABB& SceneBVH::GetTreeAABB(uint32_t node) const
+{
+	const Node& current = mNodes[node];
+	return current.IsLeaf() ? mProxies[current.proxy].fatAABB : current.aabb;
+}
+
+void SceneBVH::InsertLeaf(uint32_t leaf)
+{
+	if (mRoot == InvalidNode)
+	{
+		mRoot = leaf;
+		mNodes[leaf].parent = InvalidNode;
+		return;
+	}
+
+	// Branch and bound for the sibling that adds the least area to the tree. A candidate costs
+	// the area of its merged box plus how much every ancestor grows on the way down, children
+	// are only visited while that growth alone still beats the best cost found
+	const Math::AABB leafAABB = GetTreeAABB(leaf);
+	const float leafArea = leafAABB.GetHalfArea();
+	uint32_t bestSibling = mRoot;
+	float bestCost = Math::Merge(leafAABB, GetTreeAABB(mRoot)).GetHalfArea();
+
+	auto byCost = [](const std::pair<float, uint32_t>& a, const std::pair<float, uint32_t>& b) { return a.first > b.first; };
+	mInsertQueue.clear();
+	mInsertQueue.push_back({ 0.0f, mRoot });
+	while (!mInsertQueue.empty())
+	{
+		std::pop_heap(mInsertQueue.begin(), mInsertQueue.end(), byCost);
+		const auto [inheritedCost, index] = mInsertQueue.back();
+		mInsertQueue.pop_back();
+		if (inheritedCost + leafArea >= bestCost)
+		{
+			break;
+		}
+
+		const Node& node = mNodes[index];
+		const float mergedArea = Math::Merge(leafAABB, GetTreeAABB(index)).GetHalfArea();
+		const float cost = mergedArea + inheritedCost;
+		if (cost < bestCost)
+		{
+			bestCost = cost;
+			bestSibling = index;
+		}
+
+		if (!node.IsLeaf())
+		{
+			const float childInheritedCost = inheritedCost + mergedArea - node.aabb.GetHalfArea();
+			if (childInheritedCost + leafArea < bestCost)
+			{
+				mInsertQueue.push_back({ childInheritedCost, node.children[0] });
+				std::push_heap(mInsertQueue.begin(), mInsertQueue.end(), byCost);
+				mInsertQueue.push_back({ childInheritedCost, node.children[1] });
+				std::push_heap(mInsertQueue.begin(), mInsertQueue.end(), byCost);
+			}
+		}
+	}
+
+	// New parent takes the sibling's place, with the sibling and the leaf under it
+	const uint32_t oldParent = mNodes[bestSibling].parent;
+	const uint32_t newParent = AllocateNode();
+	Node& parentNode = mNodes[newParent];
+	parentNode.parent = oldParent;
+	parentNode.children[0] = bestSibling;
+	parentNode.children[1] = leaf;
+	parentNode.aabb = Math::Merge(leafAABB, GetTreeAABB(bestSibling));
+	mNodes[bestSibling].parent = newParent;
+	mNodes[leaf].parent = newParent;
+
+	if (oldParent == InvalidNode)
+	{
+		mRoot = newParent;
+		return;
+	}
+
+	Node& grandParent = mNodes[oldParent];
+	grandParent.children[grandParent.children[0] == bestSibling ? 0 : 1] = newParent;
+	RefitAncestors(oldParent);
+}
+
+void SceneBVH::RemoveLeaf(uint32_t leaf)
+{
+	if (leaf == mRoot)
+	{
+		mRoot = InvalidNode;
+		return;
+	}
+
+	// The sibling takes the parent's place
+	const uint32_t parent = mNodes[leaf].parent;
+	const uint32_t grandParent = mNodes[parent].parent;
+	const uint32_t sibling = (mNodes[parent].children[0] == leaf) ? mNodes[parent].children[1] : mNodes[parent].children[0];
+	mNodes[sibling].parent = grandParent;
+	mNodes[leaf].parent = InvalidNode;
+	FreeNode(parent);
+
+	if (grandParent == InvalidNode)
+	{
+		mRoot = sibling;
+		return;
+	}
+
+	Node& grandParentNode = mNodes[grandParent];
+	grandParentNode.children[grandParentNode.children[0] == parent ? 0 : 1] = sibling;
+	RefitAncestors(grandParent);
+}
+
+void SceneBVH::RefitAncestors(uint32_t node)
+{
+	// Stops as soon as a box comes out unchanged, nothing above it can change either
+	while (node != InvalidNode)
+	{
+		Node& current = mNodes[node];
+		const Math::AABB merged = Math::Merge(GetTreeAABB(current.children[0]), GetTreeAABB(current.children[1]));
+		if (memcmp(&merged, &current.aabb, sizeof(Math::AABB)) == 0)
+		{
+			return;
+		}
+		current.aabb = merged;
+		node = current.parent;
+	}
+}
+
+uint32_t SceneBVH::BuildRange(BVHUtil::BuildEntry* entries, uint32_t count)
+{
+	const uint32_t index = AllocateNode();
+	if (count == 1)
+	{
+		Proxy& proxy = mProxies[entries[0].index];
+		proxy.node = index;
+		proxy.fatAABB = Fatten(entries[0].aabb);
+		mNodes[index].aabb = entries[0].aabb;
+		mNodes[index].proxy = entries[0].index;
+		return index;
+	}
+
+	float sahCost = 0.0f;
+	const uint32_t leftCount = BVHUtil::PartitionBinnedSAH(entries, count, sahCost);
+	const uint32_t left = BuildRange(entries, leftCount);
+	const uint32_t right = BuildRange(entries + leftCount, count - leftCount);
+
+	Node& node = mNodes[index];
+	node.children[0] = left;
+	node.children[1] = right;
+	node.aabb = Math::Merge(GetTreeAABB(left), GetTreeAABB(right));
+	mNodes[left].parent = index;
+	mNodes[right].parent = index;
+	return index;
+}
+
+void SceneBVH::QueryFrustum(const Math::Frustum& frustum, std::vector<ProxyId>& results, std::vector<uint32_t>& stack) const
+{
+	if (mRoot == InvalidNode)
+	{
+		return;
+	}
+
+	// Entries are node and plane mask pairs. Planes a box is fully inside of are dropped for its
+	// whole subtree, a subtree inside all of them is gathered without a single test
+	const FrustumSetup setup = MakeFrustumSetup(frustum);
+	stack.clear();
+	stack.push_back(mRoot);
+	stack.push_back(AllPlanes);
+	while (!stack.empty())
+	{
+		uint32_t planeMask = stack.back();
+		stack.pop_back();
+		const Node& node = mNodes[stack.back()];
+		stack.pop_back();
+
+		if (planeMask != 0 && !ClassifyAABB(setup, node.aabb, planeMask))
+		{
+			continue;
+		}
+		if (node.IsLeaf())
+		{
+			results.push_back(node.proxy);
+			continue;
+		}
+		stack.push_back(node.children[1]);
+		stack.push_back(planeMask);
+		stack.push_back(node.children[0]);
+		stack.push_back(planeMask);
+	}
+}
+
+void SceneBVH::QuerySphere(const Math::Sphere& sphere, std::vector<ProxyId>& results, std::vector<uint32_t>& stack) const
+{
+	if (mRoot == InvalidNode || sphere.IsEmpty())
+	{
+		return;
+	}
+
+	stack.clear();
+	stack.push_back(mRoot);
+	while (!stack.empty())
+	{
+		const Node& node = mNodes[stack.back()];
+		stack.pop_back();
+
+		if (!OverlapsSphere(node.aabb, sphere))
+		{
+			continue;
+		}
+		if (node.IsLeaf())
+		{
+			results.push_back(node.proxy);
+		}
+		else
+		{
+			stack.push_back(node.children[1]);
+			stack.push_back(node.children[0]);
+		}
+	}
+}
+
+bool SceneBVH::RayCast(const Math::Ray& ray, float maxDistance, RayHit& hit, const RayCallback& callback, std::vector<uint32_t>& stack) const
+{
+	if (mRoot == InvalidNode)
+	{
+		return false;
+	}
+
+	const Math::InverseRay inverseRay = Math::MakeInverseRay(ray);
+
+	// Entries are node and entry distance pairs, nearer children are popped first so the best
+	// distance shrinks early and prunes the rest
+	float bestDistance = maxDistance;
+	bool found = false;
+	float distance = 0.0f;
+	stack.clear();
+	if (Math::Intersect(inverseRay, mNodes[mRoot].aabb, bestDistance, distance))
+	{
+		stack.push_back(mRoot);
+		stack.push_back(BVHUtil::FloatBits(distance));
+	}
+	while (!stack.empty())
+	{
+		const float entryDistance = BVHUtil::BitsFloat(stack.back());
+		stack.pop_back();
+		const uint32_t index = stack.back();
+		stack.pop_back();
+		if (entryDistance > bestDistance || (found && entryDistance == bestDistance))
+		{
+			continue;
+		}
+
+		const Node& node = mNodes[index];
+		if (node.IsLeaf())
+		{
+			float hitDistance = entryDistance;
+			if (callback)
+			{
+				hitDistance = callback(node.proxy, ray, bestDistance);
+				if (hitDistance < 0.0f || hitDistance > bestDistance)
+				{
+					continue;
+				}
+			}
+			bestDistance = hitDistance;
+			hit.proxy = node.proxy;
+			hit.distance = hitDistance;
+			found = true;
+			continue;
+		}
+
+		float distances[2];
+		const bool hits[2] = {
+			Math::Intersect(inverseRay, mNodes[node.children[0]].aabb, bestDistance, distances[0]),
+			Math::Intersect(inverseRay, mNodes[node.children[1]].aabb, bestDistance, distances[1])
+		};
+		const uint32_t nearChild = (hits[0] && hits[1] && distances[1] < distances[0]) ? 1 : 0;
+		for (uint32_t i = 0; i < 2; ++i)
+		{
+			const uint32_t child = (i == 0) ? 1 - nearChild : nearChild;
+			if (hits[child])
+			{
+				stack.push_back(node.children[child]);
+				stack.push_back(BVHUtil::FloatBits(distances[child]));
+			}
+		}
+	}
+	return found;
+}
\ No newline at end of file
@@ -1,7 +1,10 @@
 #include "Precompile.h"
 #include "ShadowEffect.h"
 
+#include "Animator.h"
+#include "CullingPass.h"
 #include "RenderObject.h"
+#include "SkinnedMesh.h"
 #include "VertexTypes.h"
 
 using namespace WinterEngine;
@@ -13,6 +16,7 @@ void ShadowEffect::Initialize()
 	mVertexShader.Initialize<Vertex>(shaderFile);
 	mPixelShader.Initialize(shaderFile);
 	mTransformBuffer.Initialize();
+	mBoneTransformBuffer.Initialize();
 	mLightCamera.SetMode(Camera::ProjectionMode::Orthographic);
 	mLightCamera.SetNearPlane(1.0f);
 	mLightCamera.SetFarPlane(1000.0f);
@@ -24,6 +28,7 @@ void ShadowEffect::Initialize()
 void ShadowEffect::Terminate()
 {
 	mDepthMapRenderTarget.Terminate();
+	mBoneTransformBuffer.Terminate();
 	mTransformBuffer.Terminate();
 	mPixelShader.Terminate();
 	mVertexShader.Terminate();
@@ -36,6 +41,7 @@ void ShadowEffect::Begin()
 	mVertexShader.Bind();
 	mPixelShader.Bind();
 	mTransformBuffer.BindVS(0);
+	mBoneTransformBuffer.BindVS(4);
 
 	mDepthMapRenderTarget.BeginRender();
 }
@@ -47,7 +53,7 @@ void ShadowEffect::End()
 
 void ShadowEffect::Render(const RenderObject& renderObject)
 {
-	const Math::Matrix4 matWorld = renderObject.transform.GetMatrix4();
+	const Math::Matrix4 matWorld = renderObject.GetWorldMatrix();
 	const Math::Matrix4 matView = mLightCamera.GetViewMatrix();
 	const Math::Matrix4 matProj = mLightCamera.GetProjectionMatrix();
 
@@ -59,16 +65,39 @@ void ShadowEffect::Render(const RenderObject& renderObject)
 
 void ShadowEffect::Render(const RenderGroup& renderGroup)
 {
-	const Math::Matrix4 matWorld = renderGroup.transform.GetMatrix4();
+	DrawGroup(renderGroup, nullptr, nullptr);
+}
+
+void ShadowEffect::Render(const RenderGroup& renderGroup, const Animator& animator)
+{
+	DrawGroup(renderGroup, &animator, nullptr);
+}
+
+void ShadowEffect::Render(const RenderGroup& renderGroup, const SkinnedMesh& skinnedMesh)
+{
+	const Math::Matrix4 matWorld = renderGroup.GetWorldMatrix();
 	const Math::Matrix4 matView = mLightCamera.GetViewMatrix();
 	const Math::Matrix4 matProj = mLightCamera.GetProjectionMatrix();
 
 	TransformData data;
 	data.wvp = Math::Transpose(matWorld * matView * matProj);
 	mTransformBuffer.Update(data);
-	for (const RenderObject& renderObject : renderGroup.renderObjects)
+	const uint32_t lodLevel = renderGroup.GetLODLevel(mLightCamera);
+	for (uint32_t i = 0; i < skinnedMesh.GetMeshCount(); ++i)
 	{
-		renderObject.meshBuffer.Render();
+		skinnedMesh.Render(i, lodLevel);
+	}
+}
+
+void ShadowEffect::Render(const CullingPass& cullingPass)
+{
+	for (const RenderObject* renderObject : cullingPass.GetVisibleObjects())
+	{
+		Render(*renderObject);
+	}
+	for (const CullingPass::VisibleGroup& visibleGroup : cullingPass.GetVisibleGroups())
+	{
+		DrawGroup(*visibleGroup.renderGroup, visibleGroup.animator, visibleGroup.objectMask);
 	}
 }
 
@@ -103,6 +132,21 @@ void ShadowEffect::SetSize(float size)
 	mSize = size;
 }
 
+void ShadowEffect::FitToBounds(const Math::Sphere& worldBounds)
+{
+	if (worldBounds.IsEmpty())
+	{
+		return;
+	}
+
+	// The camera sits just outside the sphere so the near plane never clips a caster
+	const float nearPlane = 1.0f;
+	mFocusPoint = worldBounds.center;
+	mSize = Math::Max(worldBounds.radius * 2.0f, 1.0f);
+	mFocusDistance = worldBounds.radius + nearPlane;
+	mLightCamera.SetFarPlane(mFocusDistance + worldBounds.radius + nearPlane);
+}
+
 const Camera& ShadowEffect::GetLightCamera() const
 {
 	return mLightCamera;
@@ -113,11 +157,44 @@ const Texture& ShadowEffect::GetDepthMap() const
 	return mDepthMapRenderTarget;
 }
 
+void ShadowEffect::DrawGroup(const RenderGroup& renderGroup, const Animator* animator, const uint8_t* objectMask)
+{
+	const Math::Matrix4 matWorld = renderGroup.GetWorldMatrix();
+	const Math::Matrix4 matView = mLightCamera.GetViewMatrix();
+	const Math::Matrix4 matProj = mLightCamera.GetProjectionMatrix();
+
+	TransformData data;
+	data.wvp = Math::Transpose(matWorld * matView * matProj);
+
+	// Groups without a skeleton, or animators that never got one, cast unskinned
+	if (animator != nullptr && animator->GetBoneCount() > 0)
+	{
+		const std::vector<Math::Matrix4>& skinTransforms = animator->GetSkinTransforms();
+		ASSERT(skinTransforms.size() <= MaxBoneCount, "ShadowEffect: %zu bones, the palette holds %u", skinTransforms.size(), MaxBoneCount);
+		const size_t boneCount = Math::Min(skinTransforms.size(), static_cast<size_t>(MaxBoneCount));
+		for (size_t i = 0; i < boneCount; ++i)
+		{
+			mBoneTransformData.boneTransforms[i] = Math::Transpose(skinTransforms[i]);
+		}
+		mBoneTransformBuffer.Update(mBoneTransformData);
+		data.useSkinning = 1;
+	}
+	mTransformBuffer.Update(data);
+	const uint32_t lodLevel = renderGroup.GetLODLevel(mLightCamera);
+	for (size_t i = 0; i < renderGroup.renderObjects.size(); ++i)
+	{
+		if (objectMask == nullptr || objectMask[i] != 0)
+		{
+			renderGroup.renderObjects[i].Render(lodLevel);
+		}
+	}
+}
+
 void ShadowEffect::UpdateLightCamera()
 {
 	ASSERT(mDirectionalLight != nullptr, "ShadowEffect: no light set");
 	const Math::Vector3& direction = mDirectionalLight->direction;
 	mLightCamera.SetDirection(direction);
-	mLightCamera.SetPosition(mFocusPoint - (direction * 100.0f));
+	mLightCamera.SetPosition(mFocusPoint - (direction * mFocusDistance));
 	mLightCamera.SetSize(mSize, mSize);
 }
@@ -0,0 +1,122 @@
+#include "Precompile.h"
+#include "SkinnedMesh.h"
+
+#include "Animator.h"
+#include "ModelCache.h"
+#include "Skinning.h"
+
+using namespace WinterEngine;
+using namespace WinterEngine::Graphics;
+
+namespace
+{
+	// Small meshes are not worth waking the workers for
+	constexpr uint32_t ParallelThreshold = 4096;
+	constexpr uint32_t BatchSize = 1024;
+}
+
+void SkinnedMesh::Initialize(ModelId modelId)
+{
+	const Model* model = ModelCache::Get()->GetModel(modelId);
+	ASSERT(model != nullptr, "SkinnedMesh: model is not loaded");
+	Initialize(*model);
+}
+
+void SkinnedMesh::Initialize(const Model& model)
+{
+	mMeshes.resize(model.meshData.size());
+	for (size_t i = 0; i < model.meshData.size(); ++i)
+	{
+		const Model::MeshData& meshData = model.meshData[i];
+		SkinnedMeshData& skinnedMesh = mMeshes[i];
+		skinnedMesh.bindMesh = &meshData.mesh;
+		skinnedMesh.vertices = meshData.mesh.vertices;
+
+		// Index layout matches RenderGroup, the full mesh followed by each LOD
+		std::vector<uint32_t> indices = meshData.mesh.indices;
+		if (!meshData.lods.empty())
+		{
+			skinnedMesh.lodRanges.push_back({ 0, static_cast<uint32_t>(indices.size()) });
+			for (const Model::LOD& lod : meshData.lods)
+			{
+				skinnedMesh.lodRanges.push_back({ static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(lod.indices.size()) });
+				indices.insert(indices.end(), lod.indices.begin(), lod.indices.end());
+			}
+		}
+		const uint32_t vertexCount = static_cast<uint32_t>(skinnedMesh.vertices.size());
+		skinnedMesh.meshBuffer.Initialize(nullptr, static_cast<uint32_t>(sizeof(Vertex)), vertexCount, indices.data(), static_cast<uint32_t>(indices.size()));
+		skinnedMesh.meshBuffer.Update(skinnedMesh.vertices.data(), vertexCount);
+	}
+	mAnimator = nullptr;
+	mPoseVersion = 0;
+}
+
+void SkinnedMesh::Terminate()
+{
+	for (SkinnedMeshData& skinnedMesh : mMeshes)
+	{
+		skinnedMesh.meshBuffer.Terminate();
+	}
+	mMeshes.clear();
+	mAnimator = nullptr;
+}
+
+bool SkinnedMesh::Update(const Animator& animator)
+{
+	if (mAnimator == &animator && mPoseVersion == animator.GetPoseVersion())
+	{
+		return false;
+	}
+	mAnimator = &animator;
+	mPoseVersion = animator.GetPoseVersion();
+
+	const std::vector<Math::Matrix4>& palette = animator.GetSkinTransforms();
+	if (palette.empty())
+	{
+		return false;
+	}
+
+	for (SkinnedMeshData& skinnedMesh : mMeshes)
+	{
+		const Vertex* input = skinnedMesh.bindMesh->vertices.data();
+		Vertex* output = skinnedMesh.vertices.data();
+		const uint32_t vertexCount = static_cast<uint32_t>(skinnedMesh.vertices.size());
+		if (vertexCount >= ParallelThreshold)
+		{
+			Core::JobSystem::Get()->ParallelFor(vertexCount, BatchSize, [input, output, &palette](uint32_t begin, uint32_t end)
+			{
+				SkinVertices(input + begin, output + begin, end - begin, palette.data(), palette.size());
+			});
+		}
+		else
+		{
+			SkinVertices(input, output, vertexCount, palette.data(), palette.size());
+		}
+		skinnedMesh.meshBuffer.Update(output, vertexCount);
+	}
+	return true;
+}
+
+void SkinnedMesh::Render(uint32_t meshIndex, uint32_t lodLevel) const
+{
+	ASSERT(meshIndex < mMeshes.size(), "SkinnedMesh: invalid mesh index %u", meshIndex);
+	const SkinnedMeshData& skinnedMesh = mMeshes[meshIndex];
+	if (skinnedMesh.lodRanges.empty())
+	{
+		skinnedMesh.meshBuffer.Render();
+		return;
+	}
+
+	const RenderObject::LODRange& range = skinnedMesh.lodRanges[Math::Min(lodLevel, static_cast<uint32_t>(skinnedMesh.lodRanges.size()) - 1)];
+	skinnedMesh.meshBuffer.Render(range.startIndex, range.indexCount);
+}
+
+uint32_t SkinnedMesh::GetMeshCount() const
+{
+	return static_cast<uint32_t>(mMeshes.size());
+}
+
+const std::vector<Vertex>& SkinnedMesh::GetVertices(uint32_t meshIndex) const
+{
+	return mMeshes[meshIndex].vertices;
+}
\ No newline at end of file
@@ -0,0 +1,113 @@
+#include "Precompile.h"
+#include "Skinning.h"
+
+using namespace WinterEngine;
+using namespace WinterEngine::Graphics;
+
+#if defined(WINTER_MATH_SSE)
+namespace
+{
+	inline void StoreVector3(Math::Vector3& out, __m128 r)
+	{
+		_mm_storel_pi(reinterpret_cast<__m64*>(&out.x), r);
+		_mm_store_ss(&out.z, _mm_movehl_ps(r, r));
+	}
+
+	// Rows of the blended matrix, only the upper 3x4 matter for an affine palette
+	struct BlendedRows
+	{
+		__m128 r0;
+		__m128 r1;
+		__m128 r2;
+		__m128 r3;
+	};
+
+	// Weights of zero are skipped, most vertices only use one or two bones
+	inline BlendedRows BlendPalette(const Vertex& vertex, const Math::Matrix4* palette)
+	{
+#if defined(WINTER_MATH_AVX)
+		// Two rows per register halves the multiply-adds of the blend
+		const Math::Matrix4& first = palette[vertex.boneIndices[0]];
+		__m256 weight = _mm256_set1_ps(vertex.boneWeights[0]);
+		__m256 r01 = _mm256_mul_ps(weight, _mm256_loadu_ps(&first._11));
+		__m256 r23 = _mm256_mul_ps(weight, _mm256_loadu_ps(&first._31));
+		for (int i = 1; i < Vertex::MaxBoneWeights; ++i)
+		{
+			if (vertex.boneWeights[i] != 0.0f)
+			{
+				const Math::Matrix4& m = palette[vertex.boneIndices[i]];
+				weight = _mm256_set1_ps(vertex.boneWeights[i]);
+				r01 = _mm256_add_ps(r01, _mm256_mul_ps(weight, _mm256_loadu_ps(&m._11)));
+				r23 = _mm256_add_ps(r23, _mm256_mul_ps(weight, _mm256_loadu_ps(&m._31)));
+			}
+		}
+		return {
+			_mm256_castps256_ps128(r01),
+			_mm256_extractf128_ps(r01, 1),
+			_mm256_castps256_ps128(r23),
+			_mm256_extractf128_ps(r23, 1) };
+#else
+		const Math::Matrix4& first = palette[vertex.boneIndices[0]];
+		__m128 weight = _mm_set1_ps(vertex.boneWeights[0]);
+		BlendedRows rows = {
+			_mm_mul_ps(weight, _mm_loadu_ps(&first._11)),
+			_mm_mul_ps(weight, _mm_loadu_ps(&first._21)),
+			_mm_mul_ps(weight, _mm_loadu_ps(&first._31)),
+			_mm_mul_ps(weight, _mm_loadu_ps(&first._41)) };
+		for (int i = 1; i < Vertex::MaxBoneWeights; ++i)
+		{
+			if (vertex.boneWeights[i] != 0.0f)
+			{
+				const Math::Matrix4& m = palette[vertex.boneIndices[i]];
+				weight = _mm_set1_ps(vertex.boneWeights[i]);
+				rows.r0 = _mm_add_ps(rows.r0, _mm_mul_ps(weight, _mm_loadu_ps(&m._11)));
+				rows.r1 = _mm_add_ps(rows.r1, _mm_mul_ps(weight, _mm_loadu_ps(&m._21)));
+				rows.r2 = _mm_add_ps(rows.r2, _mm_mul_ps(weight, _mm_loadu_ps(&m._31)));
+				rows.r3 = _mm_add_ps(rows.r3, _mm_mul_ps(weight, _mm_loadu_ps(&m._41)));
+			}
+		}
+		return rows;
+#endif
+	}
+
+	inline __m128 TransformNormal(const Math::Vector3& v, const BlendedRows& rows)
+	{
+		__m128 r = _mm_mul_ps(_mm_load1_ps(&v.x), rows.r0);
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_load1_ps(&v.y), rows.r1));
+		return _mm_add_ps(r, _mm_mul_ps(_mm_load1_ps(&v.z), rows.r2));
+	}
+}
+#endif
+
+void WinterEngine::Graphics::SkinVertices(const Vertex* input, Vertex* output, size_t count, const Math::Matrix4* palette, size_t boneCount)
+{
+	ASSERT(boneCount > 0 || count == 0, "SkinVertices: empty palette");
+#if defined(WINTER_MATH_SSE)
+	for (size_t i = 0; i < count; ++i)
+	{
+		const Vertex& vertex = input[i];
+		const BlendedRows rows = BlendPalette(vertex, palette);
+		Vertex& out = output[i];
+		StoreVector3(out.position, _mm_add_ps(TransformNormal(vertex.position, rows), rows.r3));
+		StoreVector3(out.normal, TransformNormal(vertex.normal, rows));
+		StoreVector3(out.tangent, TransformNormal(vertex.tangent, rows));
+	}
+#else
+	for (size_t i = 0; i < count; ++i)
+	{
+		const Vertex& vertex = input[i];
+		Math::Matrix4 skin = palette[vertex.boneIndices[0]] * vertex.boneWeights[0];
+		for (int b = 1; b < Vertex::MaxBoneWeights; ++b)
+		{
+			if (vertex.boneWeights[b] != 0.0f)
+			{
+				skin = skin + (palette[vertex.boneIndices[b]] * vertex.boneWeights[b]);
+			}
+		}
+		Vertex& out = output[i];
+		out.position = Math::TransformCoord(vertex.position, skin);
+		out.normal = Math::TransformNormal(vertex.normal, skin);
+		out.tangent = Math::TransformNormal(vertex.tangent, skin);
+	}
+#endif
+}
\ No newline at end of file
@@ -3,6 +3,9 @@
 #include "VertexTypes.h"
 #include "Camera.h"
 #include "RenderObject.h"
+#include "Animator.h"
+#include "CullingPass.h"
+#include "SkinnedMesh.h"
 
 using namespace WinterEngine;
 using namespace WinterEngine::Graphics;
@@ -17,10 +20,12 @@ void StandardEffect::Initialize(const std::filesystem::path& path)
 	mLightBuffer.Initialize();
 	mMaterialBuffer.Initialize();
 	mSettingsBuffer.Initialize();
+	mBoneTransformBuffer.Initialize();
 }	 
 	 
 void StandardEffect::Terminate()
 {	 
+	mBoneTransformBuffer.Terminate();
 	mSettingsBuffer.Terminate();
 	mMaterialBuffer.Terminate();
 	mLightBuffer.Terminate();
@@ -45,6 +50,8 @@ void StandardEffect::Begin()
 
 	mSettingsBuffer.BindVS(3);
 	mSettingsBuffer.BindPS(3);
+
+	mBoneTransformBuffer.BindVS(4);
 }
 	 
 void StandardEffect::End()
@@ -59,16 +66,18 @@ void StandardEffect::Render(const RenderObject& renderObject)
 {	 
 	ASSERT(mCamera != nullptr, "StandardEffect: must have a camera");
 
+	// Textures still loading in the background are skipped until they are ready
+	TextureCache* tc = TextureCache::Get();
 	SettingsData settingsData;
-	settingsData.useDiffuseMap = mSettingsData.useDiffuseMap > 0 && renderObject.diffuseMapId > 0;
-	settingsData.useNormalMap = mSettingsData.useNormalMap > 0 && renderObject.normalMapId > 0;
-	settingsData.useSpecMap = mSettingsData.useSpecMap > 0 && renderObject.specMapId > 0;
-	settingsData.useBumpMap = mSettingsData.useBumpMap > 0 && renderObject.bumpMapId > 0;
+	settingsData.useDiffuseMap = mSettingsData.useDiffuseMap > 0 && tc->IsReady(renderObject.diffuseMapId);
+	settingsData.useNormalMap = mSettingsData.useNormalMap > 0 && tc->IsReady(renderObject.normalMapId);
+	settingsData.useSpecMap = mSettingsData.useSpecMap > 0 && tc->IsReady(renderObject.specMapId);
+	settingsData.useBumpMap = mSettingsData.useBumpMap > 0 && tc->IsReady(renderObject.bumpMapId);
 	settingsData.bumpWeight = mSettingsData.bumpWeight;
 	settingsData.useShadowMap = mSettingsData.useShadowMap > 0 && mShadowMap != nullptr;
 	settingsData.depthBias = mSettingsData.depthBias;
 
-	const Math::Matrix4 matWorld = renderObject.transform.GetMatrix4();
+	const Math::Matrix4 matWorld = renderObject.GetWorldMatrix();
 	const Math::Matrix4 matView = mCamera->GetViewMatrix();
 	const Math::Matrix4 matProj = mCamera->GetProjectionMatrix();
 
@@ -91,7 +100,6 @@ void StandardEffect::Render(const RenderObject& renderObject)
 	mLightBuffer.Update(*mDirectionalLight);
 	mMaterialBuffer.Update(renderObject.material);
 
-	TextureCache* tc = TextureCache::Get();
 	tc->BindPS(renderObject.diffuseMapId, 0);
 	tc->BindPS(renderObject.normalMapId, 1);
 	tc->BindPS(renderObject.specMapId, 2);
@@ -101,10 +109,37 @@ void StandardEffect::Render(const RenderObject& renderObject)
 }
 
 void StandardEffect::Render(const RenderGroup& renderGroup)
+{
+	DrawGroup(renderGroup, nullptr, nullptr, nullptr);
+}
+
+void StandardEffect::Render(const RenderGroup& renderGroup, const Animator& animator)
+{
+	DrawGroup(renderGroup, &animator, nullptr, nullptr);
+}
+
+void StandardEffect::Render(const RenderGroup& renderGroup, const SkinnedMesh& skinnedMesh)
+{
+	DrawGroup(renderGroup, nullptr, &skinnedMesh, nullptr);
+}
+
+void StandardEffect::Render(const CullingPass& cullingPass)
+{
+	for (const RenderObject* renderObject : cullingPass.GetVisibleObjects())
+	{
+		Render(*renderObject);
+	}
+	for (const CullingPass::VisibleGroup& visibleGroup : cullingPass.GetVisibleGroups())
+	{
+		DrawGroup(*visibleGroup.renderGroup, visibleGroup.animator, nullptr, visibleGroup.objectMask);
+	}
+}
+
+void StandardEffect::DrawGroup(const RenderGroup& renderGroup, const Animator* animator, const SkinnedMesh* skinnedMesh, const uint8_t* objectMask)
 {
 	ASSERT(mCamera != nullptr, "StandardEffect: must have a camera");
 
-	const Math::Matrix4 matWorld = renderGroup.transform.GetMatrix4();
+	const Math::Matrix4 matWorld = renderGroup.GetWorldMatrix();
 	const Math::Matrix4 matView = mCamera->GetViewMatrix();
 	const Math::Matrix4 matProj = mCamera->GetProjectionMatrix();
 
@@ -115,6 +150,20 @@ void StandardEffect::Render(const RenderGroup& renderGroup)
 	settingsData.depthBias = mSettingsData.depthBias;
 	settingsData.bumpWeight = mSettingsData.bumpWeight;
 
+	// Groups without a skeleton, or animators that never got one, draw unskinned
+	if (animator != nullptr && animator->GetBoneCount() > 0)
+	{
+		const std::vector<Math::Matrix4>& skinTransforms = animator->GetSkinTransforms();
+		ASSERT(skinTransforms.size() <= MaxBoneCount, "StandardEffect: %zu bones, the palette holds %u", skinTransforms.size(), MaxBoneCount);
+		const size_t boneCount = Math::Min(skinTransforms.size(), static_cast<size_t>(MaxBoneCount));
+		for (size_t i = 0; i < boneCount; ++i)
+		{
+			mBoneTransformData.boneTransforms[i] = Transpose(skinTransforms[i]);
+		}
+		mBoneTransformBuffer.Update(mBoneTransformData);
+		settingsData.useSkinning = 1;
+	}
+
 	TransformData transformData;
 	transformData.wvp = Transpose(matFinal);
 	transformData.world = Transpose(matWorld);
@@ -129,23 +178,37 @@ void StandardEffect::Render(const RenderGroup& renderGroup)
 
 	mTransformBuffer.Update(transformData);
 	mLightBuffer.Update(*mDirectionalLight);
-	for (const RenderObject& renderObject : renderGroup.renderObjects)
+	TextureCache* tc = TextureCache::Get();
+	const uint32_t lodLevel = renderGroup.GetLODLevel(*mCamera);
+	for (uint32_t i = 0; i < renderGroup.renderObjects.size(); ++i)
 	{
+		if (objectMask != nullptr && objectMask[i] == 0)
+		{
+			continue;
+		}
+
+		const RenderObject& renderObject = renderGroup.renderObjects[i];
 		mMaterialBuffer.Update(renderObject.material);
 
-		settingsData.useDiffuseMap = mSettingsData.useDiffuseMap > 0 && renderObject.diffuseMapId > 0;
-		settingsData.useNormalMap = mSettingsData.useNormalMap > 0 && renderObject.normalMapId > 0;
-		settingsData.useSpecMap = mSettingsData.useSpecMap > 0 && renderObject.specMapId > 0;
-		settingsData.useBumpMap = mSettingsData.useBumpMap > 0 && renderObject.bumpMapId > 0;
+		settingsData.useDiffuseMap = mSettingsData.useDiffuseMap > 0 && tc->IsReady(renderObject.diffuseMapId);
+		settingsData.useNormalMap = mSettingsData.useNormalMap > 0 && tc->IsReady(renderObject.normalMapId);
+		settingsData.useSpecMap = mSettingsData.useSpecMap > 0 && tc->IsReady(renderObject.specMapId);
+		settingsData.useBumpMap = mSettingsData.useBumpMap > 0 && tc->IsReady(renderObject.bumpMapId);
 		mSettingsBuffer.Update(settingsData);
 
-		TextureCache* tc = TextureCache::Get();
 		tc->BindPS(renderObject.diffuseMapId, 0);
 		tc->BindPS(renderObject.normalMapId, 1);
 		tc->BindPS(renderObject.specMapId, 2);
 		tc->BindVS(renderObject.bumpMapId, 3);
 
-		renderObject.meshBuffer.Render();
+		if (skinnedMesh != nullptr && i < skinnedMesh->GetMeshCount())
+		{
+			skinnedMesh->Render(i, lodLevel);
+		}
+		else
+		{
+			renderObject.Render(lodLevel);
+		}
 	}
 }
 	 
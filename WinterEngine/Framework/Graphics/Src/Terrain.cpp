@@ -1,65 +1,369 @@
 #include "Precompile.h"
 #include "Terrain.h"
 
+#include "VertexCompression.h"
+
 using namespace WinterEngine;
 using namespace WinterEngine::Graphics;
 
-void Terrain::Initialize(const std::filesystem::path& fileName, float maxHeight, float tileCount)
+namespace
 {
-	FILE* file = nullptr;
-	fopen_s(&file, fileName.u8string().c_str(), "rb");
-	ASSERT(file != nullptr, "Terrain: file was not found %s", fileName.u8string().c_str());
+	constexpr uint32_t BlockSize = 16;	// cells per side of a height block
+	constexpr uint32_t ParallelThreshold = 64;
+	constexpr uint32_t BatchSize = 16;
+
+	// Amanatides-Woo walk over square cells of cellSize in XZ, limited to cells [minX, maxX) x
+	// [minZ, maxZ). Calls visit(x, z, tEnter, tExit) for each cell the ray crosses between
+	// tStart and tEnd, in order, until visit returns true
+	template<class Visit>
+	bool WalkGrid(const Math::Ray& ray, float cellSize, int minX, int minZ, int maxX, int maxZ, float tStart, float tEnd, Visit&& visit)
+	{
+		const Math::Vector3 start = ray.origin + (ray.direction * tStart);
+		int x = Math::Clamp(static_cast<int>(floorf(start.x / cellSize)), minX, maxX - 1);
+		int z = Math::Clamp(static_cast<int>(floorf(start.z / cellSize)), minZ, maxZ - 1);
+
+		const int stepX = (ray.direction.x > 0.0f) ? 1 : -1;
+		const int stepZ = (ray.direction.z > 0.0f) ? 1 : -1;
+		float tMaxX = FLT_MAX;
+		float tMaxZ = FLT_MAX;
+		float tDeltaX = FLT_MAX;
+		float tDeltaZ = FLT_MAX;
+		if (ray.direction.x != 0.0f)
+		{
+			tMaxX = ((static_cast<float>(x + (stepX > 0 ? 1 : 0)) * cellSize) - ray.origin.x) / ray.direction.x;
+			tDeltaX = cellSize / Math::Abs(ray.direction.x);
+		}
+		if (ray.direction.z != 0.0f)
+		{
+			tMaxZ = ((static_cast<float>(z + (stepZ > 0 ? 1 : 0)) * cellSize) - ray.origin.z) / ray.direction.z;
+			tDeltaZ = cellSize / Math::Abs(ray.direction.z);
+		}
+
+		float t = tStart;
+		while (true)
+		{
+			const float tNext = Math::Min(Math::Min(tMaxX, tMaxZ), tEnd);
+			if (visit(x, z, t, tNext))
+			{
+				return true;
+			}
+			if (tNext >= tEnd)
+			{
+				return false;
+			}
+
+			if (tMaxX < tMaxZ)
+			{
+				x += stepX;
+				t = tMaxX;
+				tMaxX += tDeltaX;
+			}
+			else
+			{
+				z += stepZ;
+				t = tMaxZ;
+				tMaxZ += tDeltaZ;
+			}
+			if (x < minX || x >= maxX || z < minZ || z >= maxZ)
+			{
+				return false;
+			}
+		}
+	}
+
+	// Whether the ray's height over [t0, t1] overlaps [minHeight, maxHeight]
+	inline bool CrossesHeights(const Math::Ray& ray, float t0, float t1, float minHeight, float maxHeight)
+	{
+		const float y0 = ray.origin.y + (ray.direction.y * t0);
+		const float y1 = ray.origin.y + (ray.direction.y * t1);
+		return Math::Min(y0, y1) <= maxHeight && Math::Max(y0, y1) >= minHeight;
+	}
+
+	struct StitchEdges
+	{
+		bool left = false;
+		bool right = false;
+		bool bottom = false;
+		bool top = false;
+	};
+
+	// Sample offsets along one side of a chunk at a cell step, the far edge is always included
+	void GetChunkOffsets(uint32_t cellCount, uint32_t step, std::vector<uint32_t>& offsets)
+	{
+		offsets.clear();
+		for (uint32_t offset = 0; offset < cellCount; offset += step)
+		{
+			offsets.push_back(offset);
+		}
+		offsets.push_back(cellCount);
+	}
+
+	// Every other sample of an edge is missing on the neighbour one LOD coarser, except the far end
+	inline bool IsStitched(size_t index, size_t count)
+	{
+		return (index % 2) == 1 && index + 1 < count;
+	}
+
+	// Triangles of one chunk LOD with indices relative to the chunk's first vertex. A stitched
+	// edge moves its odd vertices onto the previous even one, the cells along it collapse into
+	// the neighbour's longer edge and the triangles that became degenerate are left out
+	void AppendChunkIndices(uint32_t cellColumns, uint32_t cellRows, uint32_t step, const StitchEdges& stitch, uint32_t stride, std::vector<uint32_t>& indices)
+	{
+		std::vector<uint32_t> xOffsets;
+		std::vector<uint32_t> zOffsets;
+		GetChunkOffsets(cellColumns, step, xOffsets);
+		GetChunkOffsets(cellRows, step, zOffsets);
+		const size_t lastX = xOffsets.size() - 1;
+		const size_t lastZ = zOffsets.size() - 1;
+
+		auto vertex = [&](size_t x, size_t z)
+		{
+			if ((x == 0 && stitch.left) || (x == lastX && stitch.right))
+			{
+				z -= IsStitched(z, zOffsets.size()) ? 1 : 0;
+			}
+			else if ((z == 0 && stitch.bottom) || (z == lastZ && stitch.top))
+			{
+				x -= IsStitched(x, xOffsets.size()) ? 1 : 0;
+			}
+			return xOffsets[x] + (zOffsets[z] * stride);
+		};
+		auto triangle = [&indices](uint32_t a, uint32_t b, uint32_t c)
+		{
+			if (a != b && b != c && c != a)
+			{
+				indices.push_back(a);
+				indices.push_back(b);
+				indices.push_back(c);
+			}
+		};
+
+		for (size_t z = 0; z < lastZ; ++z)
+		{
+			for (size_t x = 0; x < lastX; ++x)
+			{
+				const uint32_t bl = vertex(x, z);
+				const uint32_t tl = vertex(x, z + 1);
+				const uint32_t br = vertex(x + 1, z);
+				const uint32_t tr = vertex(x + 1, z + 1);
+				triangle(bl, tl, tr);
+				triangle(bl, tr, br);
+			}
+		}
+	}
 
-	fseek(file, 0L, SEEK_END);
-	const uint32_t fileSize = ftell(file);
-	const uint32_t dimensions = static_cast<uint32_t>(sqrt(static_cast<float>(fileSize)));
-	fseek(file, 0L, SEEK_SET);
+	constexpr uint32_t RowBatchSize = 8;	// sample rows per job while building the mesh
 
-	mRows = dimensions;
-	mColumns = dimensions;
+	// Splits the rows of the grid across the JobSystem, small grids are not worth the hand-off
+	void ForEachRow(uint32_t rowCount, const Core::JobSystem::RangeJob& job)
+	{
+		if (rowCount >= ParallelThreshold)
+		{
+			Core::JobSystem::Get()->ParallelFor(rowCount, RowBatchSize, job);
+		}
+		else
+		{
+			job(0, rowCount);
+		}
+	}
 
-	mMesh.vertices.resize(mRows * mColumns);
-	for (uint32_t z = 0; z < mRows; ++z)
+	// (sample / 255) * maxHeight in the same order as the scalar tail, so every build of the
+	// engine loads the same heights
+	void ConvertRow(const uint8_t* samples, uint32_t count, float maxHeight, float* heights)
 	{
-		for (uint32_t x = 0; x < mColumns; ++x)
+		uint32_t x = 0;
+#if defined(WINTER_MATH_SSE)
+		const __m128i zero = _mm_setzero_si128();
+		const __m128 maxSample = _mm_set1_ps(255.0f);
+		const __m128 scale = _mm_set1_ps(maxHeight);
+		for (; x + 16 <= count; x += 16)
+		{
+			const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + x));
+			const __m128i low = _mm_unpacklo_epi8(bytes, zero);
+			const __m128i high = _mm_unpackhi_epi8(bytes, zero);
+			const __m128i words[4] = {
+				_mm_unpacklo_epi16(low, zero),
+				_mm_unpackhi_epi16(low, zero),
+				_mm_unpacklo_epi16(high, zero),
+				_mm_unpackhi_epi16(high, zero) };
+			for (int i = 0; i < 4; ++i)
+			{
+				const __m128 height = _mm_mul_ps(_mm_div_ps(_mm_cvtepi32_ps(words[i]), maxSample), scale);
+				_mm_storeu_ps(heights + x + (i * 4), height);
+			}
+		}
+#endif
+		for (; x < count; ++x)
 		{
-			const auto c = fgetc(file);
-			const float height = (c / 255.0f) * maxHeight;
-			const uint32_t index = x + (z * mColumns);
+			heights[x] = (samples[x] / 255.0f) * maxHeight;
+		}
+	}
 
-			Vertex& v = mMesh.vertices[index];
-			const float posX = static_cast<float>(x);
-			const float posZ = static_cast<float>(z);
-			v.position = { posX, height, posZ };
-			v.normal = Math::Vector3::YAxis;
-			v.tangent = Math::Vector3::XAxis;
-			v.uvCoord.x = (static_cast<float>(x) / mColumns) * tileCount;
-			v.uvCoord.y = (static_cast<float>(z) / mRows) * tileCount;
+	// Samples are read as they are in memory, the RAW files are little endian like the targets
+	void ConvertRow(const uint16_t* samples, uint32_t count, float maxHeight, float* heights)
+	{
+		uint32_t x = 0;
+#if defined(WINTER_MATH_SSE)
+		const __m128i zero = _mm_setzero_si128();
+		const __m128 maxSample = _mm_set1_ps(65535.0f);
+		const __m128 scale = _mm_set1_ps(maxHeight);
+		for (; x + 8 <= count; x += 8)
+		{
+			const __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + x));
+			const __m128 low = _mm_cvtepi32_ps(_mm_unpacklo_epi16(words, zero));
+			const __m128 high = _mm_cvtepi32_ps(_mm_unpackhi_epi16(words, zero));
+			_mm_storeu_ps(heights + x, _mm_mul_ps(_mm_div_ps(low, maxSample), scale));
+			_mm_storeu_ps(heights + x + 4, _mm_mul_ps(_mm_div_ps(high, maxSample), scale));
+		}
+#endif
+		for (; x < count; ++x)
+		{
+			heights[x] = (samples[x] / 65535.0f) * maxHeight;
 		}
 	}
-	fclose(file);
 
-	const uint32_t cells = (mRows - 1) * (mColumns - 1);
-	mMesh.indices.reserve(cells * 6);
+	constexpr float NormalScale = 32767.0f;	// snorm16
+	static_assert(sizeof(TerrainVertex) == 8, "Terrain: the SSE path writes two vertices per register");
 
-	for (uint32_t z = 0; z < mRows - 1; ++z)
+	// Rounds half away from zero, the SSE path does the same with a truncate
+	inline int16_t ToNormalSNorm(float value)
 	{
-		for (uint32_t x = 0; x < mColumns - 1; ++x)
+		const float scaled = value * NormalScale;
+		return static_cast<int16_t>(scaled + ((scaled >= 0.0f) ? 0.5f : -0.5f));
+	}
+
+	// Octahedral encoding of the height field normal (-dhdx, 1, -dhdz). The encoding does not
+	// care about length, so the normal is never normalized. Same layout as
+	// VertexCompression::EncodeOctahedral, y is always above zero so only x needs a sign
+	inline void EncodeSlopeNormal(float dhdx, float dhdz, int16_t out[2])
+	{
+		const float l1 = (Math::Abs(dhdx) + 1.0f) + Math::Abs(dhdz);
+		float x = -dhdx / l1;
+		float y = 1.0f / l1;
+		if (dhdz > 0.0f)
 		{
-			const uint32_t bl = x + (z * mColumns);
-			const uint32_t tl = x + ((z + 1) * mColumns);
-			const uint32_t br = (x + 1) + (z * mColumns);
-			const uint32_t tr = (x + 1) + ((z + 1) * mColumns);
+			const float foldX = (1.0f - y) * ((x < 0.0f) ? -1.0f : 1.0f);
+			const float foldY = 1.0f - Math::Abs(x);
+			x = foldX;
+			y = foldY;
+		}
+		out[0] = ToNormalSNorm(x);
+		out[1] = ToNormalSNorm(y);
+	}
 
-			mMesh.indices.push_back(bl);
-			mMesh.indices.push_back(tl);
-			mMesh.indices.push_back(tr);
+	// One row of vertices from the heights. Slopes are central differences over the neighbouring
+	// samples, one sided on the border of the map where a neighbour is missing
+	void BuildVertexRow(const float* heights, uint32_t rows, uint32_t columns, uint32_t z, TerrainVertex* vertices)
+	{
+		const float* row = heights + (static_cast<size_t>(z) * columns);
+		const float* below = heights + (static_cast<size_t>((z > 0) ? z - 1 : z) * columns);
+		const float* above = heights + (static_cast<size_t>((z + 1 < rows) ? z + 1 : z) * columns);
+		const float zScale = (z > 0 && z + 1 < rows) ? 0.5f : 1.0f;
 
-			mMesh.indices.push_back(bl);
-			mMesh.indices.push_back(tr);
-			mMesh.indices.push_back(br);
+		auto buildVertex = [&](uint32_t x)
+		{
+			const uint32_t left = (x > 0) ? x - 1 : x;
+			const uint32_t right = (x + 1 < columns) ? x + 1 : x;
+			const float xScale = (x > 0 && x + 1 < columns) ? 0.5f : 1.0f;
+			const float dhdx = (row[right] - row[left]) * xScale;
+			const float dhdz = (above[x] - below[x]) * zScale;
+			vertices[x].height = row[x];
+			EncodeSlopeNormal(dhdx, dhdz, vertices[x].normal);
+		};
+
+		buildVertex(0);
+		uint32_t x = 1;
+#if defined(WINTER_MATH_SSE)
+		// Four interior vertices at a time, the first and last column take the one sided path
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 half = _mm_set1_ps(0.5f);
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 zScales = _mm_set1_ps(zScale);
+		const __m128 normalScale = _mm_set1_ps(NormalScale);
+		auto toSNorm = [&](__m128 value)
+		{
+			const __m128 scaled = _mm_mul_ps(value, normalScale);
+			return _mm_cvttps_epi32(_mm_add_ps(scaled, _mm_or_ps(half, _mm_and_ps(scaled, signMask))));
+		};
+		for (; x + 4 < columns; x += 4)
+		{
+			const __m128 height = _mm_loadu_ps(row + x);
+			const __m128 dhdx = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(row + x + 1), _mm_loadu_ps(row + x - 1)), half);
+			const __m128 dhdz = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(above + x), _mm_loadu_ps(below + x)), zScales);
+
+			const __m128 l1 = _mm_add_ps(_mm_add_ps(_mm_andnot_ps(signMask, dhdx), one), _mm_andnot_ps(signMask, dhdz));
+			const __m128 octX = _mm_div_ps(_mm_xor_ps(dhdx, signMask), l1);
+			const __m128 octY = _mm_div_ps(one, l1);
+			const __m128 signX = _mm_or_ps(_mm_and_ps(_mm_cmplt_ps(octX, zero), signMask), one);
+			const __m128 foldX = _mm_mul_ps(_mm_sub_ps(one, octY), signX);
+			const __m128 foldY = _mm_sub_ps(one, _mm_andnot_ps(signMask, octX));
+			const __m128 fold = _mm_cmpgt_ps(dhdz, zero);
+			const __m128i encodedX = toSNorm(_mm_or_ps(_mm_and_ps(fold, foldX), _mm_andnot_ps(fold, octX)));
+			const __m128i encodedY = toSNorm(_mm_or_ps(_mm_and_ps(fold, foldY), _mm_andnot_ps(fold, octY)));
+
+			// x0 y0 x1 y1 x2 y2 x3 y3 as int16, then each lane's normal next to its height
+			const __m128i normals = _mm_packs_epi32(_mm_unpacklo_epi32(encodedX, encodedY), _mm_unpackhi_epi32(encodedX, encodedY));
+			const __m128i heightBits = _mm_castps_si128(height);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(vertices + x), _mm_unpacklo_epi32(heightBits, normals));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(vertices + x + 2), _mm_unpackhi_epi32(heightBits, normals));
 		}
+#endif
+		for (; x < columns; ++x)
+		{
+			buildVertex(x);
+		}
+	}
+
+	// Normal of a sample as the shader decodes it, the tangent follows u along x
+	void DecodeNormal(const TerrainVertex& vertex, Math::Vector3& normal, Math::Vector3& tangent)
+	{
+		normal = VertexCompression::DecodeOctahedral(vertex.normal);
+		tangent = Math::Normalize(Math::Vector3{ normal.y, -normal.x, 0.0f });
+	}
+
+	constexpr uint32_t GroundBatchSize = 1024;	// positions per job, a query is only a few loads
+	constexpr uint32_t GroundParallelThreshold = GroundBatchSize * 4;
+
+#if defined(WINTER_MATH_SSE)
+	// a where mask is set, b elsewhere
+	inline __m128 Select(__m128 mask, __m128 a, __m128 b)
+	{
+		return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
 	}
+#endif
+}
+
+void Terrain::Initialize(const std::filesystem::path& fileName, float maxHeight, float tileCount, SampleFormat format)
+{
+	Core::MappedFile file;
+	const bool opened = file.Initialize(fileName);
+	ASSERT(opened, "Terrain: file was not found %s", fileName.u8string().c_str());
+	if (!opened)
+	{
+		return;
+	}
+
+	const size_t sampleSize = (format == SampleFormat::UInt16) ? sizeof(uint16_t) : sizeof(uint8_t);
+	const uint32_t dimensions = static_cast<uint32_t>(sqrt(static_cast<double>(file.GetSize() / sampleSize)));
+	if (format == SampleFormat::UInt16)
+	{
+		Initialize(reinterpret_cast<const uint16_t*>(file.GetData()), dimensions, dimensions, maxHeight, tileCount);
+	}
+	else
+	{
+		Initialize(file.GetData(), dimensions, dimensions, maxHeight, tileCount);
+	}
+}
+
+void Terrain::Initialize(const uint8_t* samples, uint32_t rows, uint32_t columns, float maxHeight, float tileCount)
+{
+	BuildVertices(samples, rows, columns, maxHeight, tileCount);
+}
+
+void Terrain::Initialize(const uint16_t* samples, uint32_t rows, uint32_t columns, float maxHeight, float tileCount)
+{
+	BuildVertices(samples, rows, columns, maxHeight, tileCount);
 }
 
 float Terrain::GetHeight(const Math::Vector3& position) const
@@ -82,29 +386,202 @@ float Terrain::GetHeight(const Math::Vector3& position) const
 	float height = 0.0f;
 	if (u > v)
 	{
-		const Vertex& a = mMesh.vertices[br];
-		const Vertex& b = mMesh.vertices[tr];
-		const Vertex& c = mMesh.vertices[bl];
-		const float deltaAB = b.position.y - a.position.y;
-		const float deltaAC = c.position.y - a.position.y;
-		height = a.position.y + (deltaAB * v) + (deltaAC * (1.0f - u));
+		const float a = mVertices[br].height;
+		const float b = mVertices[tr].height;
+		const float c = mVertices[bl].height;
+		const float deltaAB = b - a;
+		const float deltaAC = c - a;
+		height = a + (deltaAB * v) + (deltaAC * (1.0f - u));
 	}
 	else
 	{
-		const Vertex& a = mMesh.vertices[tl];
-		const Vertex& b = mMesh.vertices[tr];
-		const Vertex& c = mMesh.vertices[bl];
-		const float deltaAB = b.position.y - a.position.y;
-		const float deltaAC = c.position.y - a.position.y;
-		height = a.position.y + (deltaAB * u) + (deltaAC * (1.0f - v));
+		const float a = mVertices[tl].height;
+		const float b = mVertices[tr].height;
+		const float c = mVertices[bl].height;
+		const float deltaAB = b - a;
+		const float deltaAC = c - a;
+		height = a + (deltaAB * u) + (deltaAC * (1.0f - v));
 	}
 
 	return height;
 }
 
-const Mesh& Terrain::GetMesh() const
+size_t Terrain::GetGround(const Math::Vector3* positions, size_t count, const GroundQuery& query, GroundSample* samples) const
+{
+	ASSERT(!mVertices.empty() || count == 0, "Terrain: GetGround before Initialize");
+	const uint32_t positionCount = static_cast<uint32_t>(count);
+	if (positionCount < GroundParallelThreshold)
+	{
+		return SampleGrounds(positions, count, query, samples);
+	}
+
+	std::atomic<size_t> insideCount = 0;
+	Core::JobSystem::Get()->ParallelFor(positionCount, GroundBatchSize, [&](uint32_t begin, uint32_t end)
+	{
+		insideCount += SampleGrounds(positions + begin, end - begin, query, samples + begin);
+	});
+	return insideCount;
+}
+
+const std::vector<TerrainVertex>& Terrain::GetVertices() const
+{
+	return mVertices;
+}
+
+const std::vector<uint32_t>& Terrain::GetChunkIndices() const
+{
+	return mChunkIndices;
+}
+
+void Terrain::SelectChunks(const Math::Frustum& frustum, const Math::Vector3& viewPosition, ChunkSelection& selection) const
+{
+	const uint32_t chunkCount = static_cast<uint32_t>(mChunks.size());
+	selection.draws.clear();
+	selection.lods.resize(chunkCount);
+	selection.visible.resize(chunkCount);
+	selection.visibleChunks = static_cast<uint32_t>(Math::CullAABBs(frustum, mChunkBoxes.data(), chunkCount, selection.visible.data()));
+	selection.triangleCount = 0;
+
+	// Distance to the closest point of the bounds, the chunk under the camera is always LOD 0
+	for (uint32_t i = 0; i < chunkCount; ++i)
+	{
+		const Math::AABB& aabb = mChunkBoxes[i];
+		const Math::Vector3 closest = {
+			Math::Clamp(viewPosition.x, aabb.min.x, aabb.max.x),
+			Math::Clamp(viewPosition.y, aabb.min.y, aabb.max.y),
+			Math::Clamp(viewPosition.z, aabb.min.z, aabb.max.z) };
+		const float distance = Math::Magnitude(viewPosition - closest);
+		uint8_t lod = 0;
+		for (float limit = mLodDistance; distance > limit && lod + 1 < ChunkLodCount; limit *= 2.0f)
+		{
+			++lod;
+		}
+		selection.lods[i] = lod;
+	}
+
+	// Stitching only bridges one LOD. Passes only ever lower a LOD, so this settles quickly
+	uint8_t* lods = selection.lods.data();
+	bool changed = true;
+	while (changed)
+	{
+		changed = false;
+		for (uint32_t z = 0; z < mChunkRows; ++z)
+		{
+			for (uint32_t x = 0; x < mChunkColumns; ++x)
+			{
+				const uint32_t index = x + (z * mChunkColumns);
+				uint32_t limit = lods[index];
+				limit = (x > 0) ? Math::Min(limit, lods[index - 1] + 1u) : limit;
+				limit = (x + 1 < mChunkColumns) ? Math::Min(limit, lods[index + 1] + 1u) : limit;
+				limit = (z > 0) ? Math::Min(limit, lods[index - mChunkColumns] + 1u) : limit;
+				limit = (z + 1 < mChunkRows) ? Math::Min(limit, lods[index + mChunkColumns] + 1u) : limit;
+				if (limit < lods[index])
+				{
+					lods[index] = static_cast<uint8_t>(limit);
+					changed = true;
+				}
+			}
+		}
+	}
+
+	for (uint32_t z = 0; z < mChunkRows; ++z)
+	{
+		for (uint32_t x = 0; x < mChunkColumns; ++x)
+		{
+			const uint32_t index = x + (z * mChunkColumns);
+			if (selection.visible[index] == 0)
+			{
+				continue;
+			}
+
+			const uint32_t lod = lods[index];
+			uint32_t edges = 0;
+			edges |= (x > 0 && lods[index - 1] > lod) ? Left : 0;
+			edges |= (x + 1 < mChunkColumns && lods[index + 1] > lod) ? Right : 0;
+			edges |= (z > 0 && lods[index - mChunkColumns] > lod) ? Bottom : 0;
+			edges |= (z + 1 < mChunkRows && lods[index + mChunkColumns] > lod) ? Top : 0;
+
+			const Chunk& chunk = mChunks[index];
+			const IndexRange& range = mChunkShapes[chunk.shape].ranges[lod][edges];
+			selection.draws.push_back({ range.startIndex, range.indexCount, static_cast<int32_t>(chunk.baseVertex) });
+			selection.triangleCount += range.indexCount / 3;
+		}
+	}
+}
+
+void Terrain::SetLodDistance(float distance)
+{
+	mLodDistance = distance;
+}
+
+float Terrain::GetLodDistance() const
 {
-	return mMesh;
+	return mLodDistance;
+}
+
+uint32_t Terrain::GetChunkCount() const
+{
+	return static_cast<uint32_t>(mChunks.size());
+}
+
+const Math::AABB& Terrain::GetChunkAABB(uint32_t chunk) const
+{
+	return mChunkBoxes[chunk];
+}
+
+void Terrain::ExpandMesh(Mesh& mesh) const
+{
+	mesh = {};
+	if (mVertices.empty())
+	{
+		return;
+	}
+
+	mesh.vertices.resize(mVertices.size());
+	ForEachRow(mRows, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t z = begin; z < end; ++z)
+		{
+			for (uint32_t x = 0; x < mColumns; ++x)
+			{
+				const uint32_t index = x + (z * mColumns);
+				Vertex& vertex = mesh.vertices[index];
+				vertex.position = { static_cast<float>(x), mVertices[index].height, static_cast<float>(z) };
+				DecodeNormal(mVertices[index], vertex.normal, vertex.tangent);
+				vertex.uvCoord.x = (static_cast<float>(x) / mColumns) * mTileCount;
+				vertex.uvCoord.y = (static_cast<float>(z) / mRows) * mTileCount;
+			}
+		}
+	});
+
+	// Every cell writes its own six indices, so rows fill in independently
+	const uint32_t cellColumns = mColumns - 1;
+	mesh.indices.resize(static_cast<size_t>(mRows - 1) * cellColumns * 6);
+	ForEachRow(mRows - 1, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t z = begin; z < end; ++z)
+		{
+			uint32_t* indices = mesh.indices.data() + (static_cast<size_t>(z) * cellColumns * 6);
+			for (uint32_t x = 0; x < cellColumns; ++x)
+			{
+				const uint32_t bl = x + (z * mColumns);
+				const uint32_t tl = x + ((z + 1) * mColumns);
+				const uint32_t br = (x + 1) + (z * mColumns);
+				const uint32_t tr = (x + 1) + ((z + 1) * mColumns);
+
+				*indices++ = bl;
+				*indices++ = tl;
+				*indices++ = tr;
+
+				*indices++ = bl;
+				*indices++ = tr;
+				*indices++ = br;
+			}
+		}
+	});
+
+	mesh.aabb = mAABB;
+	mesh.boundingSphere = Math::ComputeBoundingSphere(&mesh.vertices[0].position, sizeof(Vertex), mesh.vertices.size(), mAABB);
 }
 
 float Terrain::GetWidth() const
@@ -116,3 +593,463 @@ float Terrain::GetHeight() const
 {
 	return static_cast<float>(mRows);
 }
+
+uint32_t Terrain::GetRows() const
+{
+	return mRows;
+}
+
+uint32_t Terrain::GetColumns() const
+{
+	return mColumns;
+}
+
+uint32_t Terrain::GetTriangleCount() const
+{
+	return (mRows - 1) * (mColumns - 1) * 2;
+}
+
+float Terrain::GetTileCount() const
+{
+	return mTileCount;
+}
+
+const Math::AABB& Terrain::GetAABB() const
+{
+	return mAABB;
+}
+
+
+bool Terrain::RayCast(const Math::Ray& ray, float maxDistance, RayHit& hit) const
+{
+	float tEnter = 0.0f;
+	float tExit = 0.0f;
+	if (mHeightBlocks.empty() || !Math::Intersect(ray, mAABB, maxDistance, tEnter, tExit))
+	{
+		return false;
+	}
+
+	return WalkGrid(ray, static_cast<float>(BlockSize), 0, 0, mBlockColumns, mBlockRows, tEnter, tExit, [&](int blockX, int blockZ, float t0, float t1)
+	{
+		const HeightRange& range = mHeightBlocks[blockX + (blockZ * mBlockColumns)];
+		return CrossesHeights(ray, t0, t1, range.minHeight, range.maxHeight) &&
+			RayCastBlock(ray, blockX, blockZ, t0, t1, hit);
+	});
+}
+
+void Terrain::RayCasts(const Math::Ray* rays, size_t count, float maxDistance, RayHit* hits) const
+{
+	auto castRange = [this, rays, maxDistance, hits](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			hits[i] = {};
+			RayCast(rays[i], maxDistance, hits[i]);
+		}
+	};
+	const uint32_t rayCount = static_cast<uint32_t>(count);
+	if (rayCount >= ParallelThreshold)
+	{
+		Core::JobSystem::Get()->ParallelFor(rayCount, BatchSize, castRange);
+	}
+	else
+	{
+		castRange(0, rayCount);
+	}
+}
+
+template<class Sample>
+void Terrain::BuildVertices(const Sample* samples, uint32_t rows, uint32_t columns, float maxHeight, float tileCount)
+{
+	ASSERT(rows > 1 && columns > 1, "Terrain: need at least 2x2 samples");
+	mRows = rows;
+	mColumns = columns;
+	mTileCount = tileCount;
+
+	// Heights first, the normals of a row need the rows on either side of it
+	std::vector<float> heights(static_cast<size_t>(mRows) * mColumns);
+	ForEachRow(mRows, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t z = begin; z < end; ++z)
+		{
+			const size_t offset = static_cast<size_t>(z) * mColumns;
+			ConvertRow(samples + offset, mColumns, maxHeight, heights.data() + offset);
+		}
+	});
+
+	mVertices.resize(static_cast<size_t>(mRows) * mColumns);
+	ForEachRow(mRows, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t z = begin; z < end; ++z)
+		{
+			BuildVertexRow(heights.data(), mRows, mColumns, z, mVertices.data() + (static_cast<size_t>(z) * mColumns));
+		}
+	});
+
+	BuildHeightBlocks();
+
+	// Bounds from the height blocks, between them they hold every sample
+	mAABB.min = { 0.0f, FLT_MAX, 0.0f };
+	mAABB.max = { static_cast<float>(mColumns - 1), -FLT_MAX, static_cast<float>(mRows - 1) };
+	for (const HeightRange& range : mHeightBlocks)
+	{
+		mAABB.min.y = Math::Min(mAABB.min.y, range.minHeight);
+		mAABB.max.y = Math::Max(mAABB.max.y, range.maxHeight);
+	}
+
+	BuildChunks();
+}
+
+void Terrain::BuildHeightBlocks()
+{
+	// Cells are between samples, a block's range includes the samples on its far edges
+	const uint32_t cellColumns = mColumns - 1;
+	const uint32_t cellRows = mRows - 1;
+	mBlockColumns = (cellColumns + BlockSize - 1) / BlockSize;
+	mBlockRows = (cellRows + BlockSize - 1) / BlockSize;
+	mHeightBlocks.resize(mBlockColumns * mBlockRows);
+	ForEachRow(mBlockRows, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t blockZ = begin; blockZ < end; ++blockZ)
+		{
+			for (uint32_t blockX = 0; blockX < mBlockColumns; ++blockX)
+			{
+				HeightRange range = { FLT_MAX, -FLT_MAX };
+				const uint32_t endZ = Math::Min((blockZ + 1) * BlockSize, cellRows);
+				const uint32_t endX = Math::Min((blockX + 1) * BlockSize, cellColumns);
+				for (uint32_t z = blockZ * BlockSize; z <= endZ; ++z)
+				{
+					for (uint32_t x = blockX * BlockSize; x <= endX; ++x)
+					{
+						const float height = GetVertexHeight(x, z);
+						range.minHeight = Math::Min(range.minHeight, height);
+						range.maxHeight = Math::Max(range.maxHeight, height);
+					}
+				}
+				mHeightBlocks[blockX + (blockZ * mBlockColumns)] = range;
+			}
+		}
+	});
+}
+
+void Terrain::BuildChunks()
+{
+	static_assert((ChunkSize % BlockSize) == 0, "Terrain: chunks must be made of whole height blocks");
+	static_assert((1u << (ChunkLodCount - 1)) == ChunkSize, "Terrain: the last LOD must step over the whole chunk");
+	constexpr uint32_t ChunkBlocks = ChunkSize / BlockSize;
+
+	const uint32_t cellColumns = mColumns - 1;
+	const uint32_t cellRows = mRows - 1;
+	mChunkColumns = (cellColumns + ChunkSize - 1) / ChunkSize;
+	mChunkRows = (cellRows + ChunkSize - 1) / ChunkSize;
+	mChunks.resize(mChunkColumns * mChunkRows);
+	mChunkBoxes.resize(mChunks.size());
+	mChunkShapes.clear();
+	mChunkIndices.clear();
+
+	for (uint32_t chunkZ = 0; chunkZ < mChunkRows; ++chunkZ)
+	{
+		for (uint32_t chunkX = 0; chunkX < mChunkColumns; ++chunkX)
+		{
+			const uint32_t index = chunkX + (chunkZ * mChunkColumns);
+			const uint32_t startX = chunkX * ChunkSize;
+			const uint32_t startZ = chunkZ * ChunkSize;
+			const uint32_t chunkColumns = Math::Min(ChunkSize, cellColumns - startX);
+			const uint32_t chunkRows = Math::Min(ChunkSize, cellRows - startZ);
+
+			Chunk& chunk = mChunks[index];
+			chunk.baseVertex = startX + (startZ * mColumns);
+			chunk.shape = FindChunkShape(chunkColumns, chunkRows);
+
+			// Height range from the blocks the chunk is made of
+			Math::AABB& aabb = mChunkBoxes[index];
+			aabb.min = { static_cast<float>(startX), FLT_MAX, static_cast<float>(startZ) };
+			aabb.max = { static_cast<float>(startX + chunkColumns), -FLT_MAX, static_cast<float>(startZ + chunkRows) };
+			const uint32_t endBlockX = Math::Min((chunkX + 1) * ChunkBlocks, mBlockColumns);
+			const uint32_t endBlockZ = Math::Min((chunkZ + 1) * ChunkBlocks, mBlockRows);
+			for (uint32_t blockZ = chunkZ * ChunkBlocks; blockZ < endBlockZ; ++blockZ)
+			{
+				for (uint32_t blockX = chunkX * ChunkBlocks; blockX < endBlockX; ++blockX)
+				{
+					const HeightRange& range = mHeightBlocks[blockX + (blockZ * mBlockColumns)];
+					aabb.min.y = Math::Min(aabb.min.y, range.minHeight);
+					aabb.max.y = Math::Max(aabb.max.y, range.maxHeight);
+				}
+			}
+		}
+	}
+}
+
+uint32_t Terrain::FindChunkShape(uint32_t cellColumns, uint32_t cellRows)
+{
+	for (uint32_t i = 0; i < mChunkShapes.size(); ++i)
+	{
+		if (mChunkShapes[i].cellColumns == cellColumns && mChunkShapes[i].cellRows == cellRows)
+		{
+			return i;
+		}
+	}
+
+	// At most four of these: full chunks and the shorter ones along the far edges
+	ChunkShape& shape = mChunkShapes.emplace_back();
+	shape.cellColumns = cellColumns;
+	shape.cellRows = cellRows;
+	for (uint32_t lod = 0; lod < ChunkLodCount; ++lod)
+	{
+		for (uint32_t edges = 0; edges < EdgeCombinations; ++edges)
+		{
+			// Nothing is coarser than the last LOD, it never stitches
+			if (lod + 1 == ChunkLodCount && edges != 0)
+			{
+				shape.ranges[lod][edges] = shape.ranges[lod][0];
+				continue;
+			}
+
+			StitchEdges stitch;
+			stitch.left = (edges & Left) != 0;
+			stitch.right = (edges & Right) != 0;
+			stitch.bottom = (edges & Bottom) != 0;
+			stitch.top = (edges & Top) != 0;
+
+			IndexRange& range = shape.ranges[lod][edges];
+			range.startIndex = static_cast<uint32_t>(mChunkIndices.size());
+			AppendChunkIndices(cellColumns, cellRows, 1u << lod, stitch, mColumns, mChunkIndices);
+			range.indexCount = static_cast<uint32_t>(mChunkIndices.size()) - range.startIndex;
+		}
+	}
+	return static_cast<uint32_t>(mChunkShapes.size() - 1);
+}
+
+float Terrain::GetVertexHeight(uint32_t x, uint32_t z) const
+{
+	return mVertices[x + (z * mColumns)].height;
+}
+
+Terrain::GroundSample Terrain::SampleGround(float x, float z, const GroundQuery& query) const
+{
+	const float maxX = static_cast<float>(mColumns - 1);
+	const float maxZ = static_cast<float>(mRows - 1);
+	GroundSample sample;
+	sample.inside = x >= 0.0f && x <= maxX && z >= 0.0f && z <= maxZ;
+	if (!sample.inside && query.outOfBounds == OutOfBounds::Fallback)
+	{
+		sample.height = query.fallbackHeight;
+		return sample;
+	}
+
+	// A NaN clamps to 0 like it does in _mm_max_ps, the far edge samples the last cell at u/v 1
+	x = (x > 0.0f) ? Math::Min(x, maxX) : 0.0f;
+	z = (z > 0.0f) ? Math::Min(z, maxZ) : 0.0f;
+	const uint32_t cellX = Math::Min(static_cast<uint32_t>(x), mColumns - 2);
+	const uint32_t cellZ = Math::Min(static_cast<uint32_t>(z), mRows - 2);
+	const float u = x - static_cast<float>(cellX);
+	const float v = z - static_cast<float>(cellZ);
+	const TerrainVertex* cell = mVertices.data() + cellX + (static_cast<size_t>(cellZ) * mColumns);
+	const float bl = cell[0].height;
+	const float br = cell[1].height;
+	const float tl = cell[mColumns].height;
+	const float tr = cell[mColumns + 1].height;
+
+	float dhdx = 0.0f;
+	float dhdz = 0.0f;
+	if (query.interpolation == Interpolation::Triangle)
+	{
+		// Same split and arithmetic as GetHeight
+		if (u > v)
+		{
+			const float deltaAB = tr - br;
+			const float deltaAC = bl - br;
+			sample.height = br + (deltaAB * v) + (deltaAC * (1.0f - u));
+			dhdx = -deltaAC;
+			dhdz = deltaAB;
+		}
+		else
+		{
+			const float deltaAB = tr - tl;
+			const float deltaAC = bl - tl;
+			sample.height = tl + (deltaAB * u) + (deltaAC * (1.0f - v));
+			dhdx = deltaAB;
+			dhdz = -deltaAC;
+		}
+	}
+	else
+	{
+		const float bottom = bl + ((br - bl) * u);
+		const float top = tl + ((tr - tl) * u);
+		sample.height = bottom + ((top - bottom) * v);
+		dhdx = ((br - bl) * (1.0f - v)) + ((tr - tl) * v);
+		dhdz = top - bottom;
+	}
+
+	const float slopeSqr = (dhdx * dhdx) + (dhdz * dhdz);
+	const float invNormalLength = 1.0f / sqrtf(slopeSqr + 1.0f);
+	sample.normal = { -dhdx * invNormalLength, invNormalLength, -dhdz * invNormalLength };
+	sample.slope = sqrtf(slopeSqr);
+	return sample;
+}
+
+size_t Terrain::SampleGrounds(const Math::Vector3* positions, size_t count, const GroundQuery& query, GroundSample* samples) const
+{
+	size_t insideCount = 0;
+	size_t i = 0;
+#if defined(WINTER_MATH_SSE)
+	// Four positions at a time, only the sixteen height loads are done lane by lane
+	const bool triangle = query.interpolation == Interpolation::Triangle;
+	const bool fallback = query.outOfBounds == OutOfBounds::Fallback;
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 signMask = _mm_set1_ps(-0.0f);
+	const __m128 maxX = _mm_set1_ps(static_cast<float>(mColumns - 1));
+	const __m128 maxZ = _mm_set1_ps(static_cast<float>(mRows - 1));
+	const __m128 lastCellX = _mm_set1_ps(static_cast<float>(mColumns - 2));
+	const __m128 lastCellZ = _mm_set1_ps(static_cast<float>(mRows - 2));
+	const __m128 fallbackHeight = _mm_set1_ps(query.fallbackHeight);
+	alignas(16) int32_t cellX[4];
+	alignas(16) int32_t cellZ[4];
+	alignas(16) float heights[4][4];	// bl, br, tl, tr
+	alignas(16) float results[5][4];	// height, normal x/y/z, slope
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m128 px = _mm_setr_ps(positions[i].x, positions[i + 1].x, positions[i + 2].x, positions[i + 3].x);
+		const __m128 pz = _mm_setr_ps(positions[i].z, positions[i + 1].z, positions[i + 2].z, positions[i + 3].z);
+		const __m128 inside = _mm_and_ps(
+			_mm_and_ps(_mm_cmpge_ps(px, zero), _mm_cmple_ps(px, maxX)),
+			_mm_and_ps(_mm_cmpge_ps(pz, zero), _mm_cmple_ps(pz, maxZ)));
+
+		const __m128 x = _mm_min_ps(_mm_max_ps(px, zero), maxX);
+		const __m128 z = _mm_min_ps(_mm_max_ps(pz, zero), maxZ);
+		const __m128i cellXs = _mm_cvttps_epi32(_mm_min_ps(x, lastCellX));
+		const __m128i cellZs = _mm_cvttps_epi32(_mm_min_ps(z, lastCellZ));
+		const __m128 u = _mm_sub_ps(x, _mm_cvtepi32_ps(cellXs));
+		const __m128 v = _mm_sub_ps(z, _mm_cvtepi32_ps(cellZs));
+		_mm_store_si128(reinterpret_cast<__m128i*>(cellX), cellXs);
+		_mm_store_si128(reinterpret_cast<__m128i*>(cellZ), cellZs);
+		for (int lane = 0; lane < 4; ++lane)
+		{
+			const TerrainVertex* cell = mVertices.data() + cellX[lane] + (static_cast<size_t>(cellZ[lane]) * mColumns);
+			heights[0][lane] = cell[0].height;
+			heights[1][lane] = cell[1].height;
+			heights[2][lane] = cell[mColumns].height;
+			heights[3][lane] = cell[mColumns + 1].height;
+		}
+		const __m128 bl = _mm_load_ps(heights[0]);
+		const __m128 br = _mm_load_ps(heights[1]);
+		const __m128 tl = _mm_load_ps(heights[2]);
+		const __m128 tr = _mm_load_ps(heights[3]);
+
+		__m128 height;
+		__m128 dhdx;
+		__m128 dhdz;
+		if (triangle)
+		{
+			const __m128 lower = _mm_cmpgt_ps(u, v);
+			const __m128 a = Select(lower, br, tl);
+			const __m128 deltaAB = _mm_sub_ps(tr, a);
+			const __m128 deltaAC = _mm_sub_ps(bl, a);
+			const __m128 alongAB = Select(lower, v, u);
+			const __m128 alongAC = Select(lower, _mm_sub_ps(one, u), _mm_sub_ps(one, v));
+			height = _mm_add_ps(_mm_add_ps(a, _mm_mul_ps(deltaAB, alongAB)), _mm_mul_ps(deltaAC, alongAC));
+			const __m128 negatedAC = _mm_xor_ps(deltaAC, signMask);
+			dhdx = Select(lower, negatedAC, deltaAB);
+			dhdz = Select(lower, deltaAB, negatedAC);
+		}
+		else
+		{
+			const __m128 deltaBottom = _mm_sub_ps(br, bl);
+			const __m128 deltaTop = _mm_sub_ps(tr, tl);
+			const __m128 bottom = _mm_add_ps(bl, _mm_mul_ps(deltaBottom, u));
+			const __m128 top = _mm_add_ps(tl, _mm_mul_ps(deltaTop, u));
+			dhdz = _mm_sub_ps(top, bottom);
+			height = _mm_add_ps(bottom, _mm_mul_ps(dhdz, v));
+			dhdx = _mm_add_ps(_mm_mul_ps(deltaBottom, _mm_sub_ps(one, v)), _mm_mul_ps(deltaTop, v));
+		}
+
+		const __m128 slopeSqr = _mm_add_ps(_mm_mul_ps(dhdx, dhdx), _mm_mul_ps(dhdz, dhdz));
+		const __m128 invNormalLength = _mm_div_ps(one, _mm_sqrt_ps(_mm_add_ps(slopeSqr, one)));
+		__m128 normalX = _mm_mul_ps(_mm_xor_ps(dhdx, signMask), invNormalLength);
+		__m128 normalY = invNormalLength;
+		__m128 normalZ = _mm_mul_ps(_mm_xor_ps(dhdz, signMask), invNormalLength);
+		__m128 slope = _mm_sqrt_ps(slopeSqr);
+		if (fallback)
+		{
+			height = Select(inside, height, fallbackHeight);
+			normalX = Select(inside, normalX, zero);
+			normalY = Select(inside, normalY, one);
+			normalZ = Select(inside, normalZ, zero);
+			slope = Select(inside, slope, zero);
+		}
+
+		_mm_store_ps(results[0], height);
+		_mm_store_ps(results[1], normalX);
+		_mm_store_ps(results[2], normalY);
+		_mm_store_ps(results[3], normalZ);
+		_mm_store_ps(results[4], slope);
+		const int insideMask = _mm_movemask_ps(inside);
+		for (int lane = 0; lane < 4; ++lane)
+		{
+			GroundSample& sample = samples[i + lane];
+			sample.height = results[0][lane];
+			sample.normal = { results[1][lane], results[2][lane], results[3][lane] };
+			sample.slope = results[4][lane];
+			sample.inside = ((insideMask >> lane) & 1) != 0;
+			insideCount += sample.inside ? 1 : 0;
+		}
+	}
+#endif
+	for (; i < count; ++i)
+	{
+		samples[i] = SampleGround(positions[i].x, positions[i].z, query);
+		insideCount += samples[i].inside ? 1 : 0;
+	}
+	return insideCount;
+}
+
+bool Terrain::RayCastBlock(const Math::Ray& ray, uint32_t blockX, uint32_t blockZ, float tStart, float tEnd, RayHit& hit) const
+{
+	const int minX = static_cast<int>(blockX * BlockSize);
+	const int minZ = static_cast<int>(blockZ * BlockSize);
+	const int maxX = static_cast<int>(Math::Min((blockX + 1) * BlockSize, mColumns - 1));
+	const int maxZ = static_cast<int>(Math::Min((blockZ + 1) * BlockSize, mRows - 1));
+	return WalkGrid(ray, 1.0f, minX, minZ, maxX, maxZ, tStart, tEnd, [&](int x, int z, float t0, float t1)
+	{
+		const float left = static_cast<float>(x);
+		const float right = static_cast<float>(x + 1);
+		const float bottom = static_cast<float>(z);
+		const float top = static_cast<float>(z + 1);
+		const Math::Vector3 bl = { left, mVertices[x + (z * mColumns)].height, bottom };
+		const Math::Vector3 br = { right, mVertices[(x + 1) + (z * mColumns)].height, bottom };
+		const Math::Vector3 tl = { left, mVertices[x + ((z + 1) * mColumns)].height, top };
+		const Math::Vector3 tr = { right, mVertices[(x + 1) + ((z + 1) * mColumns)].height, top };
+		const float minHeight = Math::Min(Math::Min(bl.y, br.y), Math::Min(tl.y, tr.y));
+		const float maxHeight = Math::Max(Math::Max(bl.y, br.y), Math::Max(tl.y, tr.y));
+		if (!CrossesHeights(ray, t0, t1, minHeight, maxHeight))
+		{
+			return false;
+		}
+
+		// Same split as the index buffer and GetHeight. Both triangles lie inside this cell,
+		// so the nearer of their hits is the closest hit of the whole ray
+		float distance = FLT_MAX;
+		float triangleDistance = 0.0f;
+		Math::Vector3 normal = Math::Vector3::YAxis;
+		if (Math::Intersect(ray, bl, tl, tr, distance, triangleDistance))
+		{
+			distance = triangleDistance;
+			normal = Math::Cross(tl - bl, tr - bl);
+		}
+		if (Math::Intersect(ray, bl, tr, br, distance, triangleDistance))
+		{
+			distance = triangleDistance;
+			normal = Math::Cross(tr - bl, br - bl);
+		}
+		if (distance == FLT_MAX)
+		{
+			return false;
+		}
+
+		hit.position = ray.origin + (ray.direction * distance);
+		hit.normal = Math::Normalize(normal);
+		hit.distance = distance;
+		return true;
+	});
+}
\ No newline at end of file
@@ -12,19 +12,21 @@ using namespace WinterEngine::Graphics;
 void TerrainEffect::Initialize()
 {
 	std::filesystem::path shaderFile = L"../../Assets/Shaders/Terrain.fx";
-	mVertexShader.Initialize<Vertex>(shaderFile);
+	mVertexShader.Initialize<TerrainVertex>(shaderFile);
 	mPixelShader.Initialize(shaderFile);
 
 	mTransformBuffer.Initialize();
 	mLightBuffer.Initialize();
 	mMaterialBuffer.Initialize();
 	mSettingsBuffer.Initialize();
+	mGridBuffer.Initialize();
 	mSampler.Initialize(Sampler::Filter::Linear, Sampler::AddressMode::Wrap);
 }
 
 void TerrainEffect::Terminate()
 {
 	mSampler.Terminate();
+	mGridBuffer.Terminate();
 	mSettingsBuffer.Terminate();
 	mMaterialBuffer.Terminate();
 	mLightBuffer.Terminate();
@@ -48,6 +50,8 @@ void TerrainEffect::Begin()
 	mSettingsBuffer.BindVS(3);
 	mSettingsBuffer.BindPS(3);
 
+	mGridBuffer.BindVS(4);
+
 	mSampler.BindPS(0);
 	mSampler.BindVS(0);
 }
@@ -58,10 +62,27 @@ void TerrainEffect::End()
 }
 
 void TerrainEffect::Render(const RenderObject& renderObject)
+{
+	UpdateBuffers(renderObject);
+	UpdateGrid(0);
+	renderObject.meshBuffer.Render();
+}
+
+void TerrainEffect::Render(const RenderObject& renderObject, const Terrain::ChunkSelection& selection)
+{
+	UpdateBuffers(renderObject);
+	for (const Terrain::ChunkDraw& draw : selection.draws)
+	{
+		UpdateGrid(draw.baseVertex);
+		renderObject.meshBuffer.Render(draw.startIndex, draw.indexCount, draw.baseVertex);
+	}
+}
+
+void TerrainEffect::UpdateBuffers(const RenderObject& renderObject)
 {
 	ASSERT(mCamera != nullptr, "TerrainEffect: must have a camera");
 
-	const Math::Matrix4 matWorld = renderObject.transform.GetMatrix4();
+	const Math::Matrix4 matWorld = renderObject.GetWorldMatrix();
 	const Math::Matrix4 matView = mCamera->GetViewMatrix();
 	const Math::Matrix4 matProj = mCamera->GetProjectionMatrix();
 
@@ -80,8 +101,18 @@ void TerrainEffect::Render(const RenderObject& renderObject)
 	TextureCache* tc = TextureCache::Get();
 	tc->BindPS(renderObject.diffuseMapId, 0);
 	tc->BindPS(renderObject.normalMapId, 1);
+}
 
-	renderObject.meshBuffer.Render();
+void TerrainEffect::UpdateGrid(int32_t baseVertex)
+{
+	ASSERT(mTerrain != nullptr, "TerrainEffect: must have a terrain");
+
+	GridData gridData;
+	gridData.columns = mTerrain->GetColumns();
+	gridData.rows = mTerrain->GetRows();
+	gridData.tileCount = mTerrain->GetTileCount();
+	gridData.baseVertex = baseVertex;
+	mGridBuffer.Update(gridData);
 }
 
 void TerrainEffect::DebugUI()
@@ -107,3 +138,8 @@ void TerrainEffect::SetDirectionalLight(const DirectionalLight& directionalLight
 {
 	mDirectionalLight = &directionalLight;
 }
+
+void TerrainEffect::SetTerrain(const Terrain& terrain)
+{
+	mTerrain = &terrain;
+}
@@ -0,0 +1,610 @@
+#include "Precompile.h"
+#include "TerrainStreamer.h"
+
+using namespace WinterEngine;
+using namespace WinterEngine::Graphics;
+
+namespace
+{
+	constexpr uint32_t TileMagic = 0x4C545457; // "WTTL"
+	constexpr uint32_t TileVersion = 3;
+	constexpr uint32_t Apron = 1;	// samples around a tile's own, for the central differences on its edges
+
+	struct TileHeader
+	{
+		uint32_t magic = TileMagic;
+		uint32_t version = TileVersion;
+		uint32_t rows = 0;	// samples of the whole map
+		uint32_t columns = 0;
+		uint32_t tileSize = 0;	// cells per side of a tile
+		uint32_t tileRows = 0;
+		uint32_t tileColumns = 0;
+		uint32_t sampleFormat = 0;	// Terrain::SampleFormat
+		float maxHeight = 0.0f;
+		uint64_t dataOffset = 0;
+	};
+
+	size_t GetSampleBytes(Terrain::SampleFormat format)
+	{
+		return (format == Terrain::SampleFormat::UInt16) ? sizeof(uint16_t) : sizeof(uint8_t);
+	}
+
+	// Samples per side of a tile in the file, apron included
+	uint64_t GetTileSamples(uint32_t tileSize)
+	{
+		return static_cast<uint64_t>(tileSize) + 1 + (2 * Apron);
+	}
+
+	size_t GetTileFileBytes(uint32_t tileSize, Terrain::SampleFormat format)
+	{
+		const size_t tileSamples = static_cast<size_t>(GetTileSamples(tileSize));
+		return tileSamples * tileSamples * GetSampleBytes(format);
+	}
+
+	// Tiles along one side of a map with this many samples, in 64 bits so a bad tileSize can't wrap
+	uint64_t GetTileCount(uint32_t samples, uint32_t tileSize)
+	{
+		return (static_cast<uint64_t>(samples) - 1 + tileSize - 1) / tileSize;
+	}
+
+	bool IsValidHeader(const TileHeader& header, size_t fileSize)
+	{
+		if (header.magic != TileMagic ||
+			header.version != TileVersion ||
+			header.rows < 2 || header.columns < 2 ||
+			header.tileSize == 0 ||
+			header.sampleFormat > static_cast<uint32_t>(Terrain::SampleFormat::UInt16) ||
+			header.dataOffset < sizeof(TileHeader) || header.dataOffset > fileSize)
+		{
+			return false;
+		}
+
+		// Exactly the tiles that cover the map, LoadTile and GetHeight index them without checks
+		if (header.tileRows != GetTileCount(header.rows, header.tileSize) ||
+			header.tileColumns != GetTileCount(header.columns, header.tileSize))
+		{
+			return false;
+		}
+
+		// The tile table has to fit behind the data offset. Dividing the room down instead of
+		// multiplying the table up, so no header can overflow its way past the check
+		const uint64_t tileSamples = GetTileSamples(header.tileSize);
+		const uint64_t tileCount = static_cast<uint64_t>(header.tileRows) * header.tileColumns;
+		const uint64_t sampleBytes = GetSampleBytes(static_cast<Terrain::SampleFormat>(header.sampleFormat));
+		const uint64_t room = fileSize - header.dataOffset;
+		return tileSamples <= room / tileCount / sampleBytes / tileSamples;
+	}
+
+	// Same scale as Terrain, so streamed heights match a Terrain made from the same samples
+	inline float ToHeight(uint8_t sample, float maxHeight)
+	{
+		return (sample / 255.0f) * maxHeight;
+	}
+
+	inline float ToHeight(uint16_t sample, float maxHeight)
+	{
+		return (sample / 65535.0f) * maxHeight;
+	}
+
+	template<class Sample>
+	bool WriteTileFile(const std::filesystem::path& tilePath, const Sample* samples, uint32_t rows, uint32_t columns, float maxHeight, uint32_t tileSize, Terrain::SampleFormat format)
+	{
+		if (rows < 2 || columns < 2 || tileSize == 0)
+		{
+			LOG("TerrainStreamer: can't tile %u x %u samples into tiles of %u", rows, columns, tileSize);
+			return false;
+		}
+
+		FILE* file = nullptr;
+		fopen_s(&file, tilePath.u8string().c_str(), "wb");
+		if (file == nullptr)
+		{
+			LOG("TerrainStreamer: failed to create %s", tilePath.u8string().c_str());
+			return false;
+		}
+
+		TileHeader header;
+		header.rows = rows;
+		header.columns = columns;
+		header.tileSize = tileSize;
+		header.tileRows = static_cast<uint32_t>(GetTileCount(rows, tileSize));
+		header.tileColumns = static_cast<uint32_t>(GetTileCount(columns, tileSize));
+		header.sampleFormat = static_cast<uint32_t>(format);
+		header.maxHeight = maxHeight;
+		header.dataOffset = sizeof(TileHeader);
+		bool written = fwrite(&header, sizeof(TileHeader), 1, file) == 1;
+
+		// The apron and the padding past the far edges repeat the nearest sample of the map
+		const uint32_t tileSamples = static_cast<uint32_t>(GetTileSamples(tileSize));
+		auto clampSample = [](uint32_t start, uint32_t offset, uint32_t count)
+		{
+			const uint64_t sample = static_cast<uint64_t>(start) + offset;
+			return static_cast<uint32_t>(Math::Clamp<uint64_t>(sample, Apron, count - 1 + Apron) - Apron);
+		};
+		std::vector<Sample> tile(static_cast<size_t>(tileSamples) * tileSamples);
+		for (uint32_t tileZ = 0; tileZ < header.tileRows && written; ++tileZ)
+		{
+			for (uint32_t tileX = 0; tileX < header.tileColumns && written; ++tileX)
+			{
+				for (uint32_t z = 0; z < tileSamples; ++z)
+				{
+					const uint32_t sampleZ = clampSample(tileZ * tileSize, z, rows);
+					const Sample* row = samples + (static_cast<size_t>(sampleZ) * columns);
+					for (uint32_t x = 0; x < tileSamples; ++x)
+					{
+						tile[x + (z * tileSamples)] = row[clampSample(tileX * tileSize, x, columns)];
+					}
+				}
+				written = fwrite(tile.data(), sizeof(Sample), tile.size(), file) == tile.size();
+			}
+		}
+		fclose(file);
+
+		if (!written)
+		{
+			LOG("TerrainStreamer: failed to write %s", tilePath.u8string().c_str());
+		}
+		return written;
+	}
+
+	// Over the tile's own samples, the apron belongs to the neighbours' boxes
+	template<class Sample>
+	void GetHeightRange(const std::vector<uint8_t>& bytes, uint32_t tileSize, float maxHeight, float& low, float& high)
+	{
+		const Sample* samples = reinterpret_cast<const Sample*>(bytes.data());
+		const size_t stride = static_cast<size_t>(GetTileSamples(tileSize));
+		Sample minSample = std::numeric_limits<Sample>::max();
+		Sample maxSample = 0;
+		for (size_t z = Apron; z < stride - Apron; ++z)
+		{
+			const Sample* row = samples + (z * stride);
+			const auto [rowMin, rowMax] = std::minmax_element(row + Apron, row + stride - Apron);
+			minSample = Math::Min(minSample, *rowMin);
+			maxSample = Math::Max(maxSample, *rowMax);
+		}
+		low = ToHeight(minSample, maxHeight);
+		high = ToHeight(maxSample, maxHeight);
+	}
+}
+
+bool TerrainStreamer::WriteTiles(const std::filesystem::path& tilePath, const uint8_t* samples, uint32_t rows, uint32_t columns, float maxHeight, uint32_t tileSize)
+{
+	return WriteTileFile(tilePath, samples, rows, columns, maxHeight, tileSize, Terrain::SampleFormat::UInt8);
+}
+
+bool TerrainStreamer::WriteTiles(const std::filesystem::path& tilePath, const uint16_t* samples, uint32_t rows, uint32_t columns, float maxHeight, uint32_t tileSize)
+{
+	return WriteTileFile(tilePath, samples, rows, columns, maxHeight, tileSize, Terrain::SampleFormat::UInt16);
+}
+
+bool TerrainStreamer::ConvertRaw(const std::filesystem::path& rawPath, uint32_t rows, uint32_t columns, float maxHeight, uint32_t tileSize, const std::filesystem::path& tilePath,
+	Terrain::SampleFormat format)
+{
+	Core::MappedFile rawFile;
+	if (!rawFile.Initialize(rawPath))
+	{
+		LOG("TerrainStreamer: failed to open %s", rawPath.u8string().c_str());
+		return false;
+	}
+	if (rawFile.GetSize() < static_cast<size_t>(rows) * columns * GetSampleBytes(format))
+	{
+		LOG("TerrainStreamer: %s is smaller than %u x %u samples", rawPath.u8string().c_str(), rows, columns);
+		return false;
+	}
+	if (format == Terrain::SampleFormat::UInt16)
+	{
+		return WriteTiles(tilePath, reinterpret_cast<const uint16_t*>(rawFile.GetData()), rows, columns, maxHeight, tileSize);
+	}
+	return WriteTiles(tilePath, rawFile.GetData(), rows, columns, maxHeight, tileSize);
+}
+
+TerrainStreamer::~TerrainStreamer()
+{
+	Terminate();
+}
+
+bool TerrainStreamer::Initialize(const std::filesystem::path& tilePath, const Settings& settings)
+{
+	Terminate();
+
+	if (!mTileFile.Initialize(tilePath))
+	{
+		LOG("TerrainStreamer: failed to open %s", tilePath.u8string().c_str());
+		return false;
+	}
+
+	const TileHeader* header = reinterpret_cast<const TileHeader*>(mTileFile.GetData());
+	if (mTileFile.GetSize() < sizeof(TileHeader) || !IsValidHeader(*header, mTileFile.GetSize()))
+	{
+		LOG("TerrainStreamer: %s is not a tile file this build can read", tilePath.u8string().c_str());
+		mTileFile.Terminate();
+		return false;
+	}
+
+	mSettings = settings;
+	mRows = header->rows;
+	mColumns = header->columns;
+	mTileSize = header->tileSize;
+	mTileRows = header->tileRows;
+	mTileColumns = header->tileColumns;
+	mSampleFormat = static_cast<Terrain::SampleFormat>(header->sampleFormat);
+	mTileBytes = GetTileFileBytes(mTileSize, mSampleFormat);
+	mDataOffset = header->dataOffset;
+	mMaxHeight = header->maxHeight;
+
+	const size_t tileCount = static_cast<size_t>(mTileRows) * mTileColumns;
+	mTiles.resize(tileCount);
+	mTileStates.assign(tileCount, TileState::Unloaded);
+	mFrame = 0;
+	mStats = {};
+	mLoadWindowTime = 0.0f;
+	mLoadWindowCount = 0;
+	mTotalLoadTime = 0.0;
+	return true;
+}
+
+void TerrainStreamer::Terminate()
+{
+	{
+		std::unique_lock<std::mutex> lock(mLoadedMutex);
+		mLoadedCondition.wait(lock, [this]() { return mLoadsInFlight == 0; });
+		mLoadedTiles.clear();
+	}
+
+	while (!mResidentTiles.empty())
+	{
+		EvictTile(mResidentTiles.back());
+	}
+	mTiles.clear();
+	mTileStates.clear();
+	mTileFile.Terminate();
+}
+
+void TerrainStreamer::SetCallbacks(TileCallback onTileLoaded, TileCallback onTileEvicted)
+{
+	mOnTileLoaded = std::move(onTileLoaded);
+	mOnTileEvicted = std::move(onTileEvicted);
+}
+
+void TerrainStreamer::Update(const Math::Vector3& viewPosition, float deltaTime)
+{
+	const auto startTime = std::chrono::steady_clock::now();
+	++mFrame;
+
+	CollectLoads();
+	RequestTiles(viewPosition);
+	EvictTiles(viewPosition);
+
+	// A missing tile under the view is what shows up as a hole or a stall in game
+	float height = 0.0f;
+	const bool insideMap = viewPosition.x >= 0.0f && viewPosition.z >= 0.0f &&
+		viewPosition.x < static_cast<float>(mColumns - 1) && viewPosition.z < static_cast<float>(mRows - 1);
+	mStats.misses += (insideMap && !GetHeight(viewPosition, height)) ? 1 : 0;
+
+	mStats.residentTiles = static_cast<uint32_t>(mResidentTiles.size());
+	mStats.peakResidentBytes = Math::Max(mStats.peakResidentBytes, mStats.residentBytes);
+	mStats.loadsInFlight = mLoadsInFlight;
+	mStats.averageLoadTime = (mStats.totalLoads > 0) ? static_cast<float>(mTotalLoadTime / mStats.totalLoads) : 0.0f;
+
+	mLoadWindowTime += deltaTime;
+	if (mLoadWindowTime >= 1.0f)
+	{
+		mStats.loadsPerSecond = mLoadWindowCount / mLoadWindowTime;
+		mLoadWindowTime = 0.0f;
+		mLoadWindowCount = 0;
+	}
+
+	mStats.updateTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+	mStats.worstUpdateTime = Math::Max(mStats.worstUpdateTime, mStats.updateTime);
+	mStats.hitches += (mStats.updateTime > mSettings.hitchTime) ? 1 : 0;
+}
+
+bool TerrainStreamer::GetHeight(const Math::Vector3& position, float& height) const
+{
+	if (mTiles.empty() || position.x < 0.0f || position.z < 0.0f ||
+		position.x >= static_cast<float>(mColumns - 1) || position.z >= static_cast<float>(mRows - 1))
+	{
+		return false;
+	}
+
+	const uint32_t x = static_cast<uint32_t>(position.x);
+	const uint32_t z = static_cast<uint32_t>(position.z);
+	const uint32_t tileX = x / mTileSize;
+	const uint32_t tileZ = z / mTileSize;
+	const Tile* tile = mTiles[tileX + (tileZ * mTileColumns)].get();
+	if (tile == nullptr)
+	{
+		return false;
+	}
+
+	const int32_t localX = static_cast<int32_t>(x - (tileX * mTileSize));
+	const int32_t localZ = static_cast<int32_t>(z - (tileZ * mTileSize));
+	const float bl = GetSampleHeight(*tile, localX, localZ);
+	const float br = GetSampleHeight(*tile, localX + 1, localZ);
+	const float tl = GetSampleHeight(*tile, localX, localZ + 1);
+	const float tr = GetSampleHeight(*tile, localX + 1, localZ + 1);
+
+	// Same split as Terrain::GetHeight
+	const float u = position.x - x;
+	const float v = position.z - z;
+	if (u > v)
+	{
+		height = br + ((tr - br) * v) + ((bl - br) * (1.0f - u));
+	}
+	else
+	{
+		height = tl + ((tr - tl) * u) + ((bl - tl) * (1.0f - v));
+	}
+	return true;
+}
+
+const TerrainStreamer::Tile* TerrainStreamer::GetTile(uint32_t tileX, uint32_t tileZ) const
+{
+	if (tileX >= mTileColumns || tileZ >= mTileRows)
+	{
+		return nullptr;
+	}
+	return mTiles[tileX + (tileZ * mTileColumns)].get();
+}
+
+void TerrainStreamer::BuildTileMesh(const Tile& tile, Mesh& mesh) const
+{
+	const uint32_t vertexColumns = tile.cellColumns + 1;
+	const uint32_t vertexRows = tile.cellRows + 1;
+	const uint32_t startX = tile.tileX * mTileSize;
+	const uint32_t startZ = tile.tileZ * mTileSize;
+
+	mesh.vertices.resize(vertexColumns * vertexRows);
+	for (uint32_t z = 0; z < vertexRows; ++z)
+	{
+		for (uint32_t x = 0; x < vertexColumns; ++x)
+		{
+			const float posX = static_cast<float>(startX + x);
+			const float posZ = static_cast<float>(startZ + z);
+
+			// Central differences reach into the apron, so they agree with the neighbouring tile
+			// along the shared edge. One sided on the border of the map, like Terrain
+			const int32_t sampleX = static_cast<int32_t>(x);
+			const int32_t sampleZ = static_cast<int32_t>(z);
+			const float xScale = (startX + x > 0 && startX + x + 1 < mColumns) ? 0.5f : 1.0f;
+			const float zScale = (startZ + z > 0 && startZ + z + 1 < mRows) ? 0.5f : 1.0f;
+			const float dhdx = (GetSampleHeight(tile, sampleX + 1, sampleZ) - GetSampleHeight(tile, sampleX - 1, sampleZ)) * xScale;
+			const float dhdz = (GetSampleHeight(tile, sampleX, sampleZ + 1) - GetSampleHeight(tile, sampleX, sampleZ - 1)) * zScale;
+
+			Vertex& v = mesh.vertices[x + (z * vertexColumns)];
+			v.position = { posX, GetSampleHeight(tile, sampleX, sampleZ), posZ };
+			v.normal = Math::Normalize(Math::Vector3{ -dhdx, 1.0f, -dhdz });
+			v.tangent = Math::Normalize(Math::Vector3{ v.normal.y, -v.normal.x, 0.0f });
+			v.uvCoord.x = (posX / mColumns) * mSettings.textureRepeat;
+			v.uvCoord.y = (posZ / mRows) * mSettings.textureRepeat;
+		}
+	}
+
+	mesh.indices.clear();
+	mesh.indices.reserve(tile.cellColumns * tile.cellRows * 6);
+	for (uint32_t z = 0; z < tile.cellRows; ++z)
+	{
+		for (uint32_t x = 0; x < tile.cellColumns; ++x)
+		{
+			const uint32_t bl = x + (z * vertexColumns);
+			const uint32_t tl = x + ((z + 1) * vertexColumns);
+			const uint32_t br = (x + 1) + (z * vertexColumns);
+			const uint32_t tr = (x + 1) + ((z + 1) * vertexColumns);
+
+			mesh.indices.push_back(bl);
+			mesh.indices.push_back(tl);
+			mesh.indices.push_back(tr);
+
+			mesh.indices.push_back(bl);
+			mesh.indices.push_back(tr);
+			mesh.indices.push_back(br);
+		}
+	}
+	mesh.ComputeBounds();
+}
+
+void TerrainStreamer::DebugUI()
+{
+	if (ImGui::CollapsingHeader("TerrainStreamer", ImGuiTreeNodeFlags_DefaultOpen))
+	{
+		const float megabyte = 1024.0f * 1024.0f;
+		ImGui::Text("Resident: %u tiles, %.1f / %.1f MB (peak %.1f)", mStats.residentTiles,
+			mStats.residentBytes / megabyte, mSettings.residentBudget / megabyte, mStats.peakResidentBytes / megabyte);
+		ImGui::Text("Loads: %u total, %u in flight, %.1f per second, %.2f ms each", mStats.totalLoads, mStats.loadsInFlight,
+			mStats.loadsPerSecond, mStats.averageLoadTime);
+		ImGui::Text("Evictions: %u", mStats.totalEvictions);
+		ImGui::Text("Update: %.3f ms (worst %.3f), %u hitches, %u misses", mStats.updateTime, mStats.worstUpdateTime,
+			mStats.hitches, mStats.misses);
+		ImGui::DragFloat("LoadRadius", &mSettings.loadRadius, 1.0f, 0.0f, 10000.0f);
+	}
+}
+
+void TerrainStreamer::CollectLoads()
+{
+	std::vector<LoadedTile> loadedTiles;
+	{
+		std::lock_guard<std::mutex> lock(mLoadedMutex);
+		loadedTiles.swap(mLoadedTiles);
+	}
+
+	for (LoadedTile& loaded : loadedTiles)
+	{
+		loaded.tile->lastWantedFrame = mFrame;
+		mTiles[loaded.index] = std::move(loaded.tile);
+		mTileStates[loaded.index] = TileState::Resident;
+		mResidentTiles.push_back(loaded.index);
+		mStats.residentBytes += mTileBytes;
+		++mStats.totalLoads;
+		++mLoadWindowCount;
+		mTotalLoadTime += loaded.loadTime;
+		if (mOnTileLoaded)
+		{
+			mOnTileLoaded(*mTiles[loaded.index]);
+		}
+	}
+}
+
+void TerrainStreamer::RequestTiles(const Math::Vector3& viewPosition)
+{
+	const float tileSize = static_cast<float>(mTileSize);
+	const float radius = mSettings.loadRadius;
+	const int minX = Math::Max(static_cast<int>(floorf((viewPosition.x - radius) / tileSize)), 0);
+	const int minZ = Math::Max(static_cast<int>(floorf((viewPosition.z - radius) / tileSize)), 0);
+	const int maxX = Math::Min(static_cast<int>(floorf((viewPosition.x + radius) / tileSize)), static_cast<int>(mTileColumns) - 1);
+	const int maxZ = Math::Min(static_cast<int>(floorf((viewPosition.z + radius) / tileSize)), static_cast<int>(mTileRows) - 1);
+
+	mWantedTiles.clear();
+	for (int z = minZ; z <= maxZ; ++z)
+	{
+		for (int x = minX; x <= maxX; ++x)
+		{
+			const uint32_t index = x + (z * mTileColumns);
+			const float distance = GetTileDistance(index, viewPosition);
+			if (distance <= radius)
+			{
+				mWantedTiles.push_back({ distance, index });
+			}
+		}
+	}
+	std::sort(mWantedTiles.begin(), mWantedTiles.end());
+
+	// Nearest first and no more than the budget holds, so a radius that is too large for the
+	// budget drops the far tiles instead of evicting and reloading them every frame
+	const size_t budgetTiles = Math::Max<size_t>(mSettings.residentBudget / mTileBytes, 1);
+	const size_t wantedCount = Math::Min(mWantedTiles.size(), budgetTiles);
+	for (size_t i = 0; i < wantedCount; ++i)
+	{
+		const uint32_t index = mWantedTiles[i].second;
+		switch (mTileStates[index])
+		{
+		case TileState::Resident:
+			mTiles[index]->lastWantedFrame = mFrame;
+			break;
+		case TileState::Unloaded:
+			if (mLoadsInFlight < mSettings.maxLoadsInFlight)
+			{
+				mTileStates[index] = TileState::Loading;
+				++mLoadsInFlight;
+				Core::JobSystem::Get()->Submit([this, index]() { LoadTile(index); });
+			}
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+void TerrainStreamer::EvictTiles(const Math::Vector3& viewPosition)
+{
+	// Loads in flight already have their room set aside
+	const size_t reserved = mLoadsInFlight * mTileBytes;
+	if (mStats.residentBytes + reserved <= mSettings.residentBudget)
+	{
+		return;
+	}
+
+	// Least recently wanted first, the farthest first among tiles left behind on the same frame
+	mEvictionOrder.clear();
+	for (uint32_t index : mResidentTiles)
+	{
+		if (mTiles[index]->lastWantedFrame < mFrame)
+		{
+			mEvictionOrder.push_back(index);
+		}
+	}
+	std::sort(mEvictionOrder.begin(), mEvictionOrder.end(), [&](uint32_t a, uint32_t b)
+	{
+		const uint32_t frameA = mTiles[a]->lastWantedFrame;
+		const uint32_t frameB = mTiles[b]->lastWantedFrame;
+		if (frameA != frameB)
+		{
+			return frameA < frameB;
+		}
+		return GetTileDistance(a, viewPosition) > GetTileDistance(b, viewPosition);
+	});
+
+	for (uint32_t index : mEvictionOrder)
+	{
+		if (mStats.residentBytes + reserved <= mSettings.residentBudget)
+		{
+			break;
+		}
+		EvictTile(index);
+	}
+}
+
+void TerrainStreamer::EvictTile(uint32_t index)
+{
+	if (mOnTileEvicted)
+	{
+		mOnTileEvicted(*mTiles[index]);
+	}
+	mTiles[index].reset();
+	mTileStates[index] = TileState::Unloaded;
+	auto iter = std::find(mResidentTiles.begin(), mResidentTiles.end(), index);
+	*iter = mResidentTiles.back();
+	mResidentTiles.pop_back();
+	mStats.residentBytes -= mTileBytes;
+	++mStats.totalEvictions;
+}
+
+void TerrainStreamer::LoadTile(uint32_t index)
+{
+	const auto startTime = std::chrono::steady_clock::now();
+
+	LoadedTile loaded;
+	loaded.index = index;
+	loaded.tile = std::make_unique<Tile>();
+	Tile& tile = *loaded.tile;
+	tile.tileX = index % mTileColumns;
+	tile.tileZ = index / mTileColumns;
+	tile.cellColumns = Math::Min(mTileSize, (mColumns - 1) - (tile.tileX * mTileSize));
+	tile.cellRows = Math::Min(mTileSize, (mRows - 1) - (tile.tileZ * mTileSize));
+
+	// Copying out of the mapping is what pages the tile in, here rather than on the main thread
+	const uint8_t* source = mTileFile.GetData() + mDataOffset + (index * mTileBytes);
+	tile.samples.assign(source, source + mTileBytes);
+
+	float minHeight = 0.0f;
+	float maxHeight = 0.0f;
+	if (mSampleFormat == Terrain::SampleFormat::UInt16)
+	{
+		GetHeightRange<uint16_t>(tile.samples, mTileSize, mMaxHeight, minHeight, maxHeight);
+	}
+	else
+	{
+		GetHeightRange<uint8_t>(tile.samples, mTileSize, mMaxHeight, minHeight, maxHeight);
+	}
+	tile.aabb.min = { static_cast<float>(tile.tileX * mTileSize), minHeight, static_cast<float>(tile.tileZ * mTileSize) };
+	tile.aabb.max = { tile.aabb.min.x + tile.cellColumns, maxHeight, tile.aabb.min.z + tile.cellRows };
+	loaded.loadTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+	{
+		std::lock_guard<std::mutex> lock(mLoadedMutex);
+		mLoadedTiles.push_back(std::move(loaded));
+		--mLoadsInFlight;
+	}
+	mLoadedCondition.notify_all();
+}
+
+float TerrainStreamer::GetTileDistance(uint32_t index, const Math::Vector3& viewPosition) const
+{
+	// In XZ, to the closest point of the tile
+	const float tileSize = static_cast<float>(mTileSize);
+	const float minX = static_cast<float>(index % mTileColumns) * tileSize;
+	const float minZ = static_cast<float>(index / mTileColumns) * tileSize;
+	const float dx = viewPosition.x - Math::Clamp(viewPosition.x, minX, minX + tileSize);
+	const float dz = viewPosition.z - Math::Clamp(viewPosition.z, minZ, minZ + tileSize);
+	return sqrtf((dx * dx) + (dz * dz));
+}
+
+float TerrainStreamer::GetSampleHeight(const Tile& tile, int32_t x, int32_t z) const
+{
+	const size_t stride = static_cast<size_t>(GetTileSamples(mTileSize));
+	const size_t index = (x + Apron) + ((z + Apron) * stride);
+	if (mSampleFormat == Terrain::SampleFormat::UInt16)
+	{
+		return ToHeight(reinterpret_cast<const uint16_t*>(tile.samples.data())[index], mMaxHeight);
+	}
+	return ToHeight(tile.samples[index], mMaxHeight);
+}
\ No newline at end of file
@@ -3,6 +3,9 @@
 
 #include "GraphicsSystem.h"
 #include <DirectXTK/Inc/WICTextureLoader.h>
+#include <wincodec.h>
+
+#pragma comment(lib, "windowscodecs.lib")
 
 using namespace WinterEngine;
 using namespace WinterEngine::Graphics;
@@ -10,7 +13,65 @@ using namespace WinterEngine::Graphics;
 void WinterEngine::Graphics::Texture::UnbindPS(uint32_t slot)
 {
 	static ID3D11ShaderResourceView* dummy = nullptr;
-	GraphicsSystem::Get()->GetContext()->PSSetShaderResources(slot, 1, &dummy);
+	GraphicsSystem* gs = GraphicsSystem::Get();
+	gs->RecordBind(BindPoint::PSTexture, slot, nullptr);
+	if (gs->IsHeadless())
+	{
+		return;
+	}
+	gs->GetContext()->PSSetShaderResources(slot, 1, &dummy);
+}
+
+bool Texture::DecodeImage(const std::filesystem::path& fileName, ImageData& imageData)
+{
+	const HRESULT comResult = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+
+	IWICImagingFactory* factory = nullptr;
+	IWICBitmapDecoder* decoder = nullptr;
+	IWICBitmapFrameDecode* frame = nullptr;
+	IWICFormatConverter* converter = nullptr;
+	UINT width = 0;
+	UINT height = 0;
+
+	HRESULT hr = CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&factory));
+	if (SUCCEEDED(hr))
+	{
+		hr = factory->CreateDecoderFromFilename(fileName.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnDemand, &decoder);
+	}
+	if (SUCCEEDED(hr))
+	{
+		hr = decoder->GetFrame(0, &frame);
+	}
+	if (SUCCEEDED(hr))
+	{
+		hr = factory->CreateFormatConverter(&converter);
+	}
+	if (SUCCEEDED(hr))
+	{
+		hr = converter->Initialize(frame, GUID_WICPixelFormat32bppRGBA, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeCustom);
+	}
+	if (SUCCEEDED(hr))
+	{
+		hr = converter->GetSize(&width, &height);
+	}
+	if (SUCCEEDED(hr))
+	{
+		const UINT stride = width * 4;
+		imageData.width = width;
+		imageData.height = height;
+		imageData.pixels.resize(static_cast<size_t>(stride) * height);
+		hr = converter->CopyPixels(nullptr, stride, static_cast<UINT>(imageData.pixels.size()), imageData.pixels.data());
+	}
+
+	SafeRelease(converter);
+	SafeRelease(frame);
+	SafeRelease(decoder);
+	SafeRelease(factory);
+	if (SUCCEEDED(comResult))
+	{
+		CoUninitialize();
+	}
+	return SUCCEEDED(hr);
 }
 
 Texture::~Texture()
@@ -33,8 +94,18 @@ Texture& Texture::operator=(Texture&& rhs) noexcept
 
 void Texture::Initialize(const std::filesystem::path& fileName)
 {
-	auto device = GraphicsSystem::Get()->GetDevice();
-	auto context = GraphicsSystem::Get()->GetContext();
+	GraphicsSystem* gs = GraphicsSystem::Get();
+	if (gs->IsHeadless())
+	{
+		// Decode anyway so headless runs still pay for and validate the image
+		ImageData imageData;
+		const bool decoded = DecodeImage(fileName, imageData);
+		ASSERT(decoded, "Texture: failed to ceate texture %ls", fileName.c_str());
+		Initialize(imageData);
+		return;
+	}
+	auto device = gs->GetDevice();
+	auto context = gs->GetContext();
 	HRESULT hr = DirectX::CreateWICTextureFromFile(device, context, fileName.c_str(), nullptr, &mShaderResourceView);
 	ASSERT(SUCCEEDED(hr), "Texture: failed to ceate texture %ls", fileName.c_str());
 }
@@ -44,6 +115,44 @@ void Texture::Initialize(uint32_t width, uint32_t height, Format format)
 	ASSERT(false, "Texture: not yet implemented");
 }
 
+void Texture::Initialize(const ImageData& imageData)
+{
+	GraphicsSystem* gs = GraphicsSystem::Get();
+	gs->RecordResourceCreated(imageData.pixels.size());
+	if (gs->IsHeadless())
+	{
+		return;
+	}
+	auto device = gs->GetDevice();
+	auto context = gs->GetContext();
+
+	// Same setup the WIC loader uses when given a context: full mip chain generated on the GPU
+	D3D11_TEXTURE2D_DESC desc{};
+	desc.Width = imageData.width;
+	desc.Height = imageData.height;
+	desc.MipLevels = 0;
+	desc.ArraySize = 1;
+	desc.Format = GetDXGIFormat(Format::RGBA_U8);
+	desc.SampleDesc.Count = 1;
+	desc.SampleDesc.Quality = 0;
+	desc.Usage = D3D11_USAGE_DEFAULT;
+	desc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
+	desc.CPUAccessFlags = 0;
+	desc.MiscFlags = D3D11_RESOURCE_MISC_GENERATE_MIPS;
+
+	ID3D11Texture2D* texture = nullptr;
+	HRESULT hr = device->CreateTexture2D(&desc, nullptr, &texture);
+	ASSERT(SUCCEEDED(hr), "Texture: failed to create texture");
+
+	context->UpdateSubresource(texture, 0, nullptr, imageData.pixels.data(), imageData.width * 4, 0);
+
+	hr = device->CreateShaderResourceView(texture, nullptr, &mShaderResourceView);
+	ASSERT(SUCCEEDED(hr), "Texture: failed to create shader resource view");
+	SafeRelease(texture);
+
+	context->GenerateMips(mShaderResourceView);
+}
+
 void Texture::Terminate()
 {
 	SafeRelease(mShaderResourceView);
@@ -51,13 +160,25 @@ void Texture::Terminate()
 
 void Texture::BindVS(uint32_t slot) const
 {
-	auto context = GraphicsSystem::Get()->GetContext();
+	GraphicsSystem* gs = GraphicsSystem::Get();
+	gs->RecordBind(BindPoint::VSTexture, slot, this);
+	if (gs->IsHeadless())
+	{
+		return;
+	}
+	auto context = gs->GetContext();
 	context->VSSetShaderResources(slot, 1, &mShaderResourceView);
 }
 
 void Texture::BindPS(uint32_t slot) const
 {
-	auto context = GraphicsSystem::Get()->GetContext();
+	GraphicsSystem* gs = GraphicsSystem::Get();
+	gs->RecordBind(BindPoint::PSTexture, slot, this);
+	if (gs->IsHeadless())
+	{
+		return;
+	}
+	auto context = gs->GetContext();
 	context->PSSetShaderResources(slot, 1, &mShaderResourceView);
 }
 
@@ -50,6 +50,21 @@ TextureId TextureCache::LoadTexture(const std::filesystem::path& fileName, bool
 		auto& texturePtr = iter->second;
 		texturePtr = std::make_unique<Texture>();
 		texturePtr->Initialize((useRootDir) ? mRootDirectory / fileName : fileName);
+		mLoadStates[textureId] = LoadState::Ready;
+	}
+	else if (mLoadStates[textureId] == LoadState::Pending)
+	{
+		// Finish an async load now that the caller needs the texture, Update drops the worker's result
+		Texture::ImageData imageData;
+		if (Texture::DecodeImage((useRootDir) ? mRootDirectory / fileName : fileName, imageData))
+		{
+			iter->second->Initialize(imageData);
+			mLoadStates[textureId] = LoadState::Ready;
+		}
+		else
+		{
+			mLoadStates[textureId] = LoadState::Failed;
+		}
 	}
 	return textureId;
 }
@@ -64,6 +79,76 @@ const Texture* TextureCache::GetTexture(TextureId id) const
 	return nullptr;
 }
 
+TextureId TextureCache::LoadTextureAsync(const std::filesystem::path& fileName, bool useRootDir)
+{
+	TextureId textureId = std::filesystem::hash_value(fileName);
+	auto [iter, success] = mInventory.insert({ textureId, nullptr });
+	if (success)
+	{
+		iter->second = std::make_unique<Texture>();
+		mLoadStates[textureId] = LoadState::Pending;
+
+		std::filesystem::path filePath = (useRootDir) ? mRootDirectory / fileName : fileName;
+		Core::JobSystem::Get()->Submit([this, textureId, filePath]()
+		{
+			DecodedTexture decoded;
+			decoded.id = textureId;
+			decoded.success = Texture::DecodeImage(filePath, decoded.imageData);
+			if (!decoded.success)
+			{
+				LOG("TextureCache: failed to decode %ls", filePath.c_str());
+			}
+
+			std::lock_guard<std::mutex> lock(mDecodedMutex);
+			mDecodedTextures.push_back(std::move(decoded));
+		});
+	}
+	return textureId;
+}
+
+LoadState TextureCache::GetLoadState(TextureId id) const
+{
+	auto iter = mLoadStates.find(id);
+	if (iter != mLoadStates.end())
+	{
+		return iter->second;
+	}
+	return LoadState::Failed;
+}
+
+bool TextureCache::IsReady(TextureId id) const
+{
+	return GetLoadState(id) == LoadState::Ready;
+}
+
+void TextureCache::Update()
+{
+	std::vector<DecodedTexture> decodedTextures;
+	{
+		std::lock_guard<std::mutex> lock(mDecodedMutex);
+		decodedTextures.swap(mDecodedTextures);
+	}
+
+	for (DecodedTexture& decoded : decodedTextures)
+	{
+		auto iter = mInventory.find(decoded.id);
+		if (iter == mInventory.end() || mLoadStates[decoded.id] != LoadState::Pending)
+		{
+			continue;
+		}
+
+		if (decoded.success)
+		{
+			iter->second->Initialize(decoded.imageData);
+			mLoadStates[decoded.id] = LoadState::Ready;
+		}
+		else
+		{
+			mLoadStates[decoded.id] = LoadState::Failed;
+		}
+	}
+}
+
 void TextureCache::BindVS(TextureId id, uint32_t slot) const
 {
 	auto iter = mInventory.find(id);
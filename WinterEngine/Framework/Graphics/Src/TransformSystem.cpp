@@ -0,0 +1,317 @@
+#include "Precompile.h"
+#include "TransformSystem.h"
+
+using namespace WinterEngine;
+using namespace WinterEngine::Graphics;
+using namespace WinterEngine::Core;
+
+namespace
+{
+	std::unique_ptr<TransformSystem> sTransformSystem;
+
+	// Levels smaller than this are cheaper to run inline than to hand to the workers
+	constexpr uint32_t ParallelThreshold = 512;
+	constexpr uint32_t BatchSize = 128;
+}
+
+void TransformSystem::StaticInitialize()
+{
+	ASSERT(sTransformSystem == nullptr, "TransformSystem: is already initialized");
+	sTransformSystem = std::make_unique<TransformSystem>();
+}
+
+void TransformSystem::StaticTerminate()
+{
+	sTransformSystem.reset();
+}
+
+TransformSystem* TransformSystem::Get()
+{
+	ASSERT(sTransformSystem != nullptr, "TransformSystem: is not initialized");
+	return sTransformSystem.get();
+}
+
+TransformId TransformSystem::Create(const Transform& local, TransformId parent)
+{
+	uint32_t slot = 0;
+	if (!mFreeSlots.empty())
+	{
+		slot = mFreeSlots.back();
+		mFreeSlots.pop_back();
+	}
+	else
+	{
+		slot = static_cast<uint32_t>(mPositions.size());
+		if (slot == mGenerations.size())
+		{
+			mGenerations.emplace_back();
+		}
+		mPositions.emplace_back();
+		mRotations.emplace_back();
+		mScales.emplace_back();
+		mParents.emplace_back();
+		mWorldMatrices.emplace_back();
+		mLocalDirty.emplace_back();
+		mWorldChanged.emplace_back();
+		mAlive.emplace_back();
+	}
+
+	mPositions[slot] = local.position;
+	mRotations[slot] = local.rotation;
+	mScales[slot] = local.scale;
+	mParents[slot] = (parent != 0) ? static_cast<int>(GetSlot(parent)) : -1;
+	mWorldMatrices[slot] = local.GetMatrix4();
+	mLocalDirty[slot] = 1;
+	mWorldChanged[slot] = 0;
+	mAlive[slot] = 1;
+	mOrderDirty = true;
+	return GetId(slot);
+}
+
+void TransformSystem::Destroy(TransformId id)
+{
+	if (!IsValid(id))
+	{
+		return;
+	}
+
+	const uint32_t slot = GetSlot(id);
+	for (size_t i = 0; i < mParents.size(); ++i)
+	{
+		if (mAlive[i] && mParents[i] == static_cast<int>(slot))
+		{
+			mParents[i] = -1;
+			mLocalDirty[i] = 1;
+		}
+	}
+	mAlive[slot] = 0;
+	mParents[slot] = -1;
+	++mGenerations[slot];
+	mFreeSlots.push_back(slot);
+	mOrderDirty = true;
+}
+
+void TransformSystem::Clear()
+{
+	for (size_t slot = 0; slot < mAlive.size(); ++slot)
+	{
+		mGenerations[slot] += mAlive[slot];
+	}
+	mPositions.clear();
+	mRotations.clear();
+	mScales.clear();
+	mParents.clear();
+	mWorldMatrices.clear();
+	mLocalDirty.clear();
+	mWorldChanged.clear();
+	mAlive.clear();
+	mFreeSlots.clear();
+	mOrder.clear();
+	mLevelStarts.clear();
+	mOrderDirty = true;
+}
+
+bool TransformSystem::IsValid(TransformId id) const
+{
+	const uint64_t index = id & 0xFFFFFFFF;
+	return index != 0 && index <= mAlive.size() && mAlive[index - 1] && mGenerations[index - 1] == (id >> 32);
+}
+
+void TransformSystem::SetParent(TransformId id, TransformId parent)
+{
+	const uint32_t slot = GetSlot(id);
+	const int parentSlot = (parent != 0) ? static_cast<int>(GetSlot(parent)) : -1;
+	for (int ancestor = parentSlot; ancestor >= 0; ancestor = mParents[ancestor])
+	{
+		ASSERT(ancestor != static_cast<int>(slot), "TransformSystem: parenting would create a cycle");
+		if (ancestor == static_cast<int>(slot))
+		{
+			return;
+		}
+	}
+	mParents[slot] = parentSlot;
+	mLocalDirty[slot] = 1;
+	mOrderDirty = true;
+}
+
+TransformId TransformSystem::GetParent(TransformId id) const
+{
+	const int parentSlot = mParents[GetSlot(id)];
+	return (parentSlot >= 0) ? GetId(static_cast<uint32_t>(parentSlot)) : 0;
+}
+
+void TransformSystem::SetLocal(TransformId id, const Transform& local)
+{
+	const uint32_t slot = GetSlot(id);
+	mPositions[slot] = local.position;
+	mRotations[slot] = local.rotation;
+	mScales[slot] = local.scale;
+	mLocalDirty[slot] = 1;
+}
+
+void TransformSystem::SetPosition(TransformId id, const Math::Vector3& position)
+{
+	const uint32_t slot = GetSlot(id);
+	mPositions[slot] = position;
+	mLocalDirty[slot] = 1;
+}
+
+void TransformSystem::SetRotation(TransformId id, const Math::Quaternion& rotation)
+{
+	const uint32_t slot = GetSlot(id);
+	mRotations[slot] = rotation;
+	mLocalDirty[slot] = 1;
+}
+
+void TransformSystem::SetScale(TransformId id, const Math::Vector3& scale)
+{
+	const uint32_t slot = GetSlot(id);
+	mScales[slot] = scale;
+	mLocalDirty[slot] = 1;
+}
+
+Transform TransformSystem::GetLocal(TransformId id) const
+{
+	const uint32_t slot = GetSlot(id);
+	Transform local;
+	local.position = mPositions[slot];
+	local.rotation = mRotations[slot];
+	local.scale = mScales[slot];
+	return local;
+}
+
+const Math::Matrix4& TransformSystem::GetWorldMatrix(TransformId id) const
+{
+	return mWorldMatrices[GetSlot(id)];
+}
+
+Math::Vector3 TransformSystem::GetWorldPosition(TransformId id) const
+{
+	const Math::Matrix4& world = mWorldMatrices[GetSlot(id)];
+	return { world._41, world._42, world._43 };
+}
+
+void TransformSystem::Update()
+{
+	if (mOrderDirty)
+	{
+		RebuildOrder();
+	}
+
+	// A level only reads the level above it, so each level can be split freely across the workers
+	mUpdateCount = 0;
+	const uint32_t levelCount = static_cast<uint32_t>(mLevelStarts.size()) - 1;
+	for (uint32_t level = 0; level < levelCount; ++level)
+	{
+		const uint32_t* slots = mOrder.data() + mLevelStarts[level];
+		const uint32_t count = mLevelStarts[level + 1] - mLevelStarts[level];
+		if (count >= ParallelThreshold)
+		{
+			JobSystem::Get()->ParallelFor(count, BatchSize, [this, slots](uint32_t begin, uint32_t end)
+			{
+				UpdateRange(slots + begin, end - begin);
+			});
+		}
+		else
+		{
+			UpdateRange(slots, count);
+		}
+	}
+	mLastUpdateCount = mUpdateCount;
+}
+
+uint32_t TransformSystem::GetTransformCount() const
+{
+	return static_cast<uint32_t>(mOrder.size());
+}
+
+uint32_t TransformSystem::GetSlot(TransformId id) const
+{
+	ASSERT(IsValid(id), "TransformSystem: invalid or stale transform id %llx", static_cast<unsigned long long>(id));
+	return static_cast<uint32_t>((id & 0xFFFFFFFF) - 1);
+}
+
+TransformId TransformSystem::GetId(uint32_t slot) const
+{
+	return (static_cast<TransformId>(mGenerations[slot]) << 32) | (static_cast<TransformId>(slot) + 1);
+}
+
+void TransformSystem::RebuildOrder()
+{
+	// Depth of every live slot, walking up until a parent with a known depth is found
+	const uint32_t slotCount = static_cast<uint32_t>(mParents.size());
+	std::vector<int> depths(slotCount, -1);
+	std::vector<uint32_t> chain;
+	int maxDepth = -1;
+	for (uint32_t slot = 0; slot < slotCount; ++slot)
+	{
+		if (!mAlive[slot] || depths[slot] >= 0)
+		{
+			continue;
+		}
+
+		chain.clear();
+		int current = static_cast<int>(slot);
+		while (current >= 0 && depths[current] < 0)
+		{
+			chain.push_back(static_cast<uint32_t>(current));
+			current = mParents[current];
+		}
+		int depth = (current >= 0) ? depths[current] : -1;
+		for (auto iter = chain.rbegin(); iter != chain.rend(); ++iter)
+		{
+			depths[*iter] = ++depth;
+		}
+		maxDepth = Math::Max(maxDepth, depth);
+	}
+
+	// Counting sort by depth
+	mLevelStarts.assign(static_cast<size_t>(maxDepth) + 2, 0);
+	for (uint32_t slot = 0; slot < slotCount; ++slot)
+	{
+		if (mAlive[slot])
+		{
+			++mLevelStarts[depths[slot] + 1];
+		}
+	}
+	for (size_t level = 1; level < mLevelStarts.size(); ++level)
+	{
+		mLevelStarts[level] += mLevelStarts[level - 1];
+	}
+
+	mOrder.resize(mLevelStarts.back());
+	std::vector<uint32_t> cursors(mLevelStarts.begin(), mLevelStarts.end() - 1);
+	for (uint32_t slot = 0; slot < slotCount; ++slot)
+	{
+		if (mAlive[slot])
+		{
+			mOrder[cursors[depths[slot]]++] = slot;
+		}
+	}
+	mOrderDirty = false;
+}
+
+void TransformSystem::UpdateRange(const uint32_t* slots, uint32_t count)
+{
+	uint32_t updated = 0;
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		const uint32_t slot = slots[i];
+		const int parent = mParents[slot];
+		const bool changed = mLocalDirty[slot] || (parent >= 0 && mWorldChanged[parent]);
+		mWorldChanged[slot] = changed ? 1 : 0;
+		if (!changed)
+		{
+			continue;
+		}
+
+		const Math::Matrix4 local =
+			Math::Matrix4::Scaling(mScales[slot]) *
+			Math::Matrix4::MatrixRotationQuaternion(mRotations[slot]) *
+			Math::Matrix4::Translation(mPositions[slot]);
+		mWorldMatrices[slot] = (parent >= 0) ? local * mWorldMatrices[parent] : local;
+		mLocalDirty[slot] = 0;
+		++updated;
+	}
+	mUpdateCount += updated;
+}
\ No newline at end of file
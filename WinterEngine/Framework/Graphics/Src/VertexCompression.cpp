@@ -0,0 +1,295 @@
+#include "Precompile.h"
+#include "VertexCompression.h"
+
+using namespace WinterEngine;
+using namespace WinterEngine::Graphics;
+
+namespace
+{
+	constexpr float UNormScale = 65535.0f;
+	constexpr float SNormScale = 32767.0f;
+	// ToSNorm16 clamps to +-32767, so no unit vector ever encodes to this
+	constexpr int16_t ZeroVectorCode = -32768;
+
+	uint16_t ToUNorm16(float value)
+	{
+		return static_cast<uint16_t>(Math::Clamp(value, 0.0f, 1.0f) * UNormScale + 0.5f);
+	}
+
+	int16_t ToSNorm16(float value)
+	{
+		return static_cast<int16_t>(std::round(Math::Clamp(value, -1.0f, 1.0f) * SNormScale));
+	}
+
+	float SignNotZero(float value)
+	{
+		return (value >= 0.0f) ? 1.0f : -1.0f;
+	}
+}
+
+VertexCompression::Bounds VertexCompression::ComputeBounds(const std::vector<Vertex>& vertices)
+{
+	Bounds bounds;
+	if (vertices.empty())
+	{
+		return bounds;
+	}
+
+	Math::Vector3 min = vertices[0].position;
+	Math::Vector3 max = vertices[0].position;
+	for (const Vertex& v : vertices)
+	{
+		min = { Math::Min(min.x, v.position.x), Math::Min(min.y, v.position.y), Math::Min(min.z, v.position.z) };
+		max = { Math::Max(max.x, v.position.x), Math::Max(max.y, v.position.y), Math::Max(max.z, v.position.z) };
+	}
+	bounds.min = min;
+	bounds.extent = max - min;
+	return bounds;
+}
+
+bool VertexCompression::HasSkin(const std::vector<Vertex>& vertices)
+{
+	for (const Vertex& v : vertices)
+	{
+		for (int i = 0; i < Vertex::MaxBoneWeights; ++i)
+		{
+			if (v.boneWeights[i] != 0.0f)
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+CompactVertex VertexCompression::Encode(const Vertex& vertex, const Bounds& bounds)
+{
+	CompactVertex cv;
+	for (int i = 0; i < 3; ++i)
+	{
+		const float extent = bounds.extent.v[i];
+		cv.position[i] = (extent > 0.0f) ? ToUNorm16((vertex.position.v[i] - bounds.min.v[i]) / extent) : 0;
+	}
+	EncodeOctahedral(vertex.normal, cv.normal);
+	EncodeOctahedral(vertex.tangent, cv.tangent);
+	cv.uvCoord[0] = FloatToHalf(vertex.uvCoord.x);
+	cv.uvCoord[1] = FloatToHalf(vertex.uvCoord.y);
+	return cv;
+}
+
+Vertex VertexCompression::Decode(const CompactVertex& compactVertex, const Bounds& bounds)
+{
+	Vertex v;
+	for (int i = 0; i < 3; ++i)
+	{
+		v.position.v[i] = bounds.min.v[i] + (compactVertex.position[i] / UNormScale) * bounds.extent.v[i];
+	}
+	v.normal = DecodeOctahedral(compactVertex.normal);
+	v.tangent = DecodeOctahedral(compactVertex.tangent);
+	v.uvCoord.x = HalfToFloat(compactVertex.uvCoord[0]);
+	v.uvCoord.y = HalfToFloat(compactVertex.uvCoord[1]);
+	return v;
+}
+
+void VertexCompression::Encode(const std::vector<Vertex>& vertices, const Bounds& bounds, std::vector<CompactVertex>& outVertices)
+{
+	outVertices.resize(vertices.size());
+	for (size_t i = 0; i < vertices.size(); ++i)
+	{
+		outVertices[i] = Encode(vertices[i], bounds);
+	}
+}
+
+void VertexCompression::Decode(const CompactVertex* compactVertices, uint32_t vertexCount, const Bounds& bounds, std::vector<Vertex>& outVertices)
+{
+	outVertices.resize(vertexCount);
+	for (uint32_t i = 0; i < vertexCount; ++i)
+	{
+		outVertices[i] = Decode(compactVertices[i], bounds);
+	}
+}
+
+CompactSkin VertexCompression::EncodeSkin(const Vertex& vertex)
+{
+	CompactSkin cs;
+	float total = 0.0f;
+	for (int i = 0; i < Vertex::MaxBoneWeights; ++i)
+	{
+		cs.boneIndices[i] = static_cast<uint16_t>(vertex.boneIndices[i]);
+		total += Math::Max(vertex.boneWeights[i], 0.0f);
+	}
+	if (total <= 0.0f)
+	{
+		return cs;
+	}
+
+	// Largest remainder rounding so the quantized weights keep summing to one
+	float remainders[Vertex::MaxBoneWeights] = {};
+	int quantizedTotal = 0;
+	for (int i = 0; i < Vertex::MaxBoneWeights; ++i)
+	{
+		const float scaled = (Math::Max(vertex.boneWeights[i], 0.0f) / total) * 255.0f;
+		cs.boneWeights[i] = static_cast<uint8_t>(scaled);
+		remainders[i] = scaled - cs.boneWeights[i];
+		quantizedTotal += cs.boneWeights[i];
+	}
+	for (; quantizedTotal < 255; ++quantizedTotal)
+	{
+		const int largest = static_cast<int>(std::max_element(remainders, remainders + Vertex::MaxBoneWeights) - remainders);
+		++cs.boneWeights[largest];
+		remainders[largest] = -1.0f;
+	}
+	return cs;
+}
+
+void VertexCompression::DecodeSkin(const CompactSkin& compactSkin, Vertex& vertex)
+{
+	for (int i = 0; i < Vertex::MaxBoneWeights; ++i)
+	{
+		vertex.boneIndices[i] = compactSkin.boneIndices[i];
+		vertex.boneWeights[i] = compactSkin.boneWeights[i] / 255.0f;
+	}
+}
+
+void VertexCompression::EncodeSkin(const std::vector<Vertex>& vertices, std::vector<CompactSkin>& outSkin)
+{
+	outSkin.resize(vertices.size());
+	for (size_t i = 0; i < vertices.size(); ++i)
+	{
+		outSkin[i] = EncodeSkin(vertices[i]);
+	}
+}
+
+void VertexCompression::DecodeSkin(const CompactSkin* compactSkin, uint32_t vertexCount, std::vector<Vertex>& vertices)
+{
+	ASSERT(vertices.size() >= vertexCount, "VertexCompression: decode the vertices before their skin");
+	for (uint32_t i = 0; i < vertexCount; ++i)
+	{
+		DecodeSkin(compactSkin[i], vertices[i]);
+	}
+}
+
+uint16_t VertexCompression::FloatToHalf(float value)
+{
+	uint32_t bits = 0;
+	memcpy(&bits, &value, sizeof(bits));
+
+	const uint32_t sign = (bits >> 16) & 0x8000;
+	const int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xff) - 127 + 15;
+	uint32_t mantissa = bits & 0x007fffff;
+
+	if (((bits >> 23) & 0xff) == 0xff)
+	{
+		// Inf stays inf, NaN keeps a mantissa bit
+		return static_cast<uint16_t>(sign | 0x7c00 | (mantissa != 0 ? 0x0200 : 0));
+	}
+	if (exponent >= 31)
+	{
+		return static_cast<uint16_t>(sign | 0x7c00);
+	}
+	if (exponent <= 0)
+	{
+		if (exponent < -10)
+		{
+			return static_cast<uint16_t>(sign);
+		}
+		// Denormal: shift the implicit bit in and round to nearest
+		mantissa |= 0x00800000;
+		const uint32_t shift = static_cast<uint32_t>(14 - exponent);
+		uint32_t half = mantissa >> shift;
+		if ((mantissa >> (shift - 1)) & 1)
+		{
+			++half;
+		}
+		return static_cast<uint16_t>(sign | half);
+	}
+
+	uint32_t half = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+	if (mantissa & 0x00001000)
+	{
+		// Round to nearest, a carry into the exponent is still the correct result
+		++half;
+	}
+	return static_cast<uint16_t>(half);
+}
+
+float VertexCompression::HalfToFloat(uint16_t value)
+{
+	const uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+	uint32_t exponent = (value >> 10) & 0x1f;
+	uint32_t mantissa = value & 0x03ff;
+
+	uint32_t bits = 0;
+	if (exponent == 0)
+	{
+		if (mantissa == 0)
+		{
+			bits = sign;
+		}
+		else
+		{
+			// Renormalize the denormal
+			exponent = 127 - 15 + 1;
+			while ((mantissa & 0x0400) == 0)
+			{
+				mantissa <<= 1;
+				--exponent;
+			}
+			mantissa &= 0x03ff;
+			bits = sign | (exponent << 23) | (mantissa << 13);
+		}
+	}
+	else if (exponent == 0x1f)
+	{
+		bits = sign | 0x7f800000 | (mantissa << 13);
+	}
+	else
+	{
+		bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+	}
+
+	float result = 0.0f;
+	memcpy(&result, &bits, sizeof(result));
+	return result;
+}
+
+void VertexCompression::EncodeOctahedral(const Math::Vector3& v, int16_t out[2])
+{
+	const float l1 = Math::Abs(v.x) + Math::Abs(v.y) + Math::Abs(v.z);
+	if (l1 <= 0.0f)
+	{
+		out[0] = ZeroVectorCode;
+		out[1] = ZeroVectorCode;
+		return;
+	}
+
+	float x = v.x / l1;
+	float y = v.y / l1;
+	if (v.z < 0.0f)
+	{
+		const float foldX = (1.0f - Math::Abs(y)) * SignNotZero(x);
+		const float foldY = (1.0f - Math::Abs(x)) * SignNotZero(y);
+		x = foldX;
+		y = foldY;
+	}
+	out[0] = ToSNorm16(x);
+	out[1] = ToSNorm16(y);
+}
+
+Math::Vector3 VertexCompression::DecodeOctahedral(const int16_t in[2])
+{
+	if (in[0] == ZeroVectorCode && in[1] == ZeroVectorCode)
+	{
+		// A zero vector, e.g. a missing tangent
+		return Math::Vector3::Zero;
+	}
+
+	Math::Vector3 v;
+	v.x = Math::Max(in[0] / SNormScale, -1.0f);
+	v.y = Math::Max(in[1] / SNormScale, -1.0f);
+	v.z = 1.0f - Math::Abs(v.x) - Math::Abs(v.y);
+	const float t = Math::Max(-v.z, 0.0f);
+	v.x += (v.x >= 0.0f) ? -t : t;
+	v.y += (v.y >= 0.0f) ? -t : t;
+	return Math::Normalize(v);
+}
\ No newline at end of file
@@ -42,6 +42,14 @@ namespace
 		{
 			desc.push_back({ "BLENDWEIGHT", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 });
 		}
+		if (vertexFormat & VE_Height)
+		{
+			desc.push_back({ "HEIGHT", 0, DXGI_FORMAT_R32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 });
+		}
+		if (vertexFormat & VE_PackedNormal)
+		{
+			desc.push_back({ "PACKEDNORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 });
+		}
 
 		return desc;
 	}
@@ -49,8 +57,16 @@ namespace
 
 void VertexShader::Initialize(const std::filesystem::path& filePath, uint32_t format)
 {
+	GraphicsSystem* gs = GraphicsSystem::Get();
+	gs->RecordResourceCreated(0);
+	if (gs->IsHeadless())
+	{
+		ASSERT(std::filesystem::exists(filePath), "VertexShader: %ls not found", filePath.c_str());
+		return;
+	}
+
 	//Need to create a vertex shader
-	auto device = GraphicsSystem::Get()->GetDevice();
+	auto device = gs->GetDevice();
 
 	DWORD shaderFlags = D3DCOMPILE_ENABLE_STRICTNESS | D3DCOMPILE_DEBUG;
 	ID3DBlob* shaderBlob = nullptr;
@@ -101,7 +117,13 @@ void VertexShader::Terminate()
 
 void VertexShader::Bind()
 {
-	auto context = GraphicsSystem::Get()->GetContext();
+	GraphicsSystem* gs = GraphicsSystem::Get();
+	gs->RecordBind(BindPoint::VertexShader, 0, this);
+	if (gs->IsHeadless())
+	{
+		return;
+	}
+	auto context = gs->GetContext();
 	context->VSSetShader(mVertexShader, nullptr, 0);
 	context->IASetInputLayout(mInputLayout);
 }
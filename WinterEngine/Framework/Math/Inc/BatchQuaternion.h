@@ -0,0 +1,17 @@
+#pragma once
+
+namespace WinterEngine::Math
+{
+	// Bulk Nlerp/Slerp for sampling animation channels. out[i] blends a[i] towards b[i] by
+	// either one shared t or a t per element, always along the shorter arc. Output may
+	// alias either input.
+
+	void NlerpQuaternions(const Quaternion* a, const Quaternion* b, float t, Quaternion* out, size_t count);
+	void NlerpQuaternions(const Quaternion* a, const Quaternion* b, const float* t, Quaternion* out, size_t count);
+
+	// Polynomial slerp (Eberly, "A Fast and Accurate Algorithm for Computing SLERP"), no acos
+	// or sin per element. t must be in [0, 1]. Worst case is about 2e-5 off Slerp for keys
+	// 180 degrees apart, keys a few degrees apart match to float precision
+	void SlerpQuaternions(const Quaternion* a, const Quaternion* b, float t, Quaternion* out, size_t count);
+	void SlerpQuaternions(const Quaternion* a, const Quaternion* b, const float* t, Quaternion* out, size_t count);
+}
\ No newline at end of file
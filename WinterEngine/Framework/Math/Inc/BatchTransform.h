@@ -0,0 +1,29 @@
+#pragma once
+
+namespace WinterEngine::Math
+{
+	// Bulk versions of TransformCoord/TransformNormal. Strides are in bytes so the
+	// same calls work on Vector3 arrays and on the position/normal of vertex structs.
+	// Output may alias input as long as both use the same stride.
+
+	void TransformCoords(const Vector3* input, size_t inputStride, Vector3* output, size_t outputStride, size_t count, const Matrix4& m);
+	void TransformNormals(const Vector3* input, size_t inputStride, Vector3* output, size_t outputStride, size_t count, const Matrix4& m);
+
+	// TransformCoord followed by the divide by w, for projection matrices
+	void ProjectCoords(const Vector3* input, size_t inputStride, Vector3* output, size_t outputStride, size_t count, const Matrix4& m);
+
+	inline void TransformCoords(const Vector3* input, Vector3* output, size_t count, const Matrix4& m)
+	{
+		TransformCoords(input, sizeof(Vector3), output, sizeof(Vector3), count, m);
+	}
+
+	inline void TransformNormals(const Vector3* input, Vector3* output, size_t count, const Matrix4& m)
+	{
+		TransformNormals(input, sizeof(Vector3), output, sizeof(Vector3), count, m);
+	}
+
+	inline void ProjectCoords(const Vector3* input, Vector3* output, size_t count, const Matrix4& m)
+	{
+		ProjectCoords(input, sizeof(Vector3), output, sizeof(Vector3), count, m);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+namespace WinterEngine::Math
+{
+	// Axis aligned box. Default constructed boxes are empty (min above max), which makes
+	// them the starting value for Merge and lets callers tell "no bounds" from a point
+	struct AABB
+	{
+		Vector3 min = { FLT_MAX, FLT_MAX, FLT_MAX };
+		Vector3 max = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+		bool IsEmpty() const { return min.x > max.x || min.y > max.y || min.z > max.z; }
+		Vector3 GetCenter() const { return (min + max) * 0.5f; }
+		Vector3 GetExtents() const { return (max - min) * 0.5f; }
+		// Half the surface area, all a SAH cost needs to compare two boxes
+		float GetHalfArea() const
+		{
+			const Vector3 size = max - min;
+			return (size.x * size.y) + (size.y * size.z) + (size.z * size.x);
+		}
+	};
+
+	// Radius below zero marks an empty sphere
+	struct Sphere
+	{
+		Vector3 center = Vector3::Zero;
+		float radius = -1.0f;
+
+		bool IsEmpty() const { return radius < 0.0f; }
+	};
+
+	// Min/max reduction over the points. Stride is in bytes, so the positions of vertex
+	// structs can be passed directly
+	AABB ComputeAABB(const Vector3* points, size_t stride, size_t count);
+
+	// Centered on the box, radius from the farthest point. Not the minimal sphere, but
+	// never larger than the box's own bounding sphere and one extra pass to compute
+	Sphere ComputeBoundingSphere(const Vector3* points, size_t stride, size_t count, const AABB& aabb);
+
+	inline AABB ComputeAABB(const std::vector<Vector3>& points)
+	{
+		return ComputeAABB(points.data(), sizeof(Vector3), points.size());
+	}
+
+	// Box around the transformed box, the world space bounds of a local box
+	AABB TransformAABB(const AABB& aabb, const Matrix4& m);
+	// Center is transformed and the radius grows by the largest axis scale
+	Sphere TransformSphere(const Sphere& sphere, const Matrix4& m);
+
+	// Defined inline in WinterMath.h, BVH builds merge boxes in their innermost loops
+	AABB Merge(const AABB& a, const AABB& b);
+	// Smallest sphere around both
+	Sphere Merge(const Sphere& a, const Sphere& b);
+}
\ No newline at end of file
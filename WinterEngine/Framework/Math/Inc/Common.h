@@ -2,6 +2,7 @@
 
 #include <Core/Inc/Core.h>
 
+#include <cfloat>
 #include <cmath>
 #include <numeric>
 #include <random>
\ No newline at end of file
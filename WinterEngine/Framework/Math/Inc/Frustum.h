@@ -0,0 +1,30 @@
+#pragma once
+
+namespace WinterEngine::Math
+{
+	// Points with Dot(normal, p) + d >= 0 are on the inside
+	struct Plane
+	{
+		Vector3 normal = Vector3::YAxis;
+		float d = 0.0f;
+	};
+
+	struct Frustum
+	{
+		enum Side { Left, Right, Bottom, Top, Near, Far, Count };
+		Plane planes[Count];
+
+		// Planes of a view * projection matrix (D3D depth range 0..1, normals point inward).
+		// Works for perspective and orthographic projections alike, in whatever space the
+		// matrix starts from: pass view * proj for world space planes
+		static Frustum FromMatrix(const Matrix4& viewProjection);
+	};
+
+	bool IsVisible(const Frustum& frustum, const AABB& aabb);
+	bool IsVisible(const Frustum& frustum, const Sphere& sphere);
+
+	// Batch version, four boxes per plane test. visible[i] is 1 when box i touches the frustum,
+	// empty boxes count as visible (objects without bounds are never culled). Returns the
+	// number of visible boxes
+	size_t CullAABBs(const Frustum& frustum, const AABB* boxes, size_t count, uint8_t* visible);
+}
\ No newline at end of file
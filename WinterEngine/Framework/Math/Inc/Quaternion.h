@@ -2,6 +2,7 @@
 
 namespace WinterEngine::Math
 {
+    struct Vector3;
     struct Matrix4;
 
     //------------------------------------------------------------------------------
@@ -23,10 +24,27 @@ namespace WinterEngine::Math
         bool operator != (const Quaternion& q) const { return x != q.x || y != q.y || z != q.z || w != q.w; }
 
         // Unary operators		
+        Quaternion operator-() const { return Quaternion(-x, -y, -z, -w); }
         Quaternion operator+(const Quaternion& rhs) const { return Quaternion(x + rhs.x, y + rhs.y, z + rhs.z, w + rhs.w); }
+        Quaternion operator-(const Quaternion& rhs) const { return Quaternion(x - rhs.x, y - rhs.y, z - rhs.z, w - rhs.w); }
         Quaternion operator*(float s) const { return Quaternion(x * s, y * s, z * s, w * s); }
         Quaternion operator/(float s) const { return Quaternion(x / s, y / s, z / s, w / s); }
 
+        // Concatenation in the same order as Matrix4, a * b rotates by a first and then by b
+        Quaternion operator*(const Quaternion& rhs) const
+        {
+            return Quaternion(
+                (rhs.w * x) + (rhs.x * w) + (rhs.y * z) - (rhs.z * y),
+                (rhs.w * y) - (rhs.x * z) + (rhs.y * w) + (rhs.z * x),
+                (rhs.w * z) + (rhs.x * y) - (rhs.y * x) + (rhs.z * w),
+                (rhs.w * w) - (rhs.x * x) - (rhs.y * y) - (rhs.z * z));
+        }
+
+        // Construction, defined in WinterMath.h
+        static Quaternion RotationAxis(const Vector3& axis, float rad);
+        static Quaternion RotationEuler(const Vector3& rad);    // x pitch, y yaw, z roll, applied roll, then pitch, then yaw
+        static Quaternion RotationMatrix(const Matrix4& m);     // upper 3x3 must be a pure rotation
+
         // Constants
         static const Quaternion Identity;
         static const Quaternion Zero;
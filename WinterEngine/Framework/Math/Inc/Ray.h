@@ -0,0 +1,36 @@
+#pragma once
+
+namespace WinterEngine::Math
+{
+	// Hit distances are measured in multiples of direction, so a unit direction gives world units
+	struct Ray
+	{
+		Vector3 origin = Vector3::Zero;
+		Vector3 direction = Vector3::ZAxis;
+	};
+
+	// Reciprocal direction worked out once, for testing one ray against many boxes. Zero
+	// components use a huge finite reciprocal instead of inf so an origin on a slab plane
+	// never makes a NaN
+	struct InverseRay
+	{
+		Vector3 origin = Vector3::Zero;
+		Vector3 invDirection = Vector3::ZAxis;
+	};
+
+	// Defined inline in WinterMath.h, BVH traversal runs these for every node it visits
+	InverseRay MakeInverseRay(const Ray& ray);
+	// Same result as the Ray version without its per axis branches, for boxes known not to be empty
+	bool Intersect(const InverseRay& ray, const AABB& aabb, float maxDistance, float& distance);
+	// The triangle test above, also giving the barycentric weights u and v of b and c at the hit
+	bool Intersect(const Ray& ray, const Vector3& a, const Vector3& b, const Vector3& c, float maxDistance, float& distance, float& u, float& v);
+
+	// Distance to where the ray enters the shape, 0 when the origin is already inside.
+	// False for a miss or when the entry point is farther than maxDistance
+	bool Intersect(const Ray& ray, const AABB& aabb, float maxDistance, float& distance);
+	// Also where the ray leaves the box, clipped to maxDistance
+	bool Intersect(const Ray& ray, const AABB& aabb, float maxDistance, float& distance, float& exitDistance);
+	bool Intersect(const Ray& ray, const Sphere& sphere, float maxDistance, float& distance);
+	// Both sides of the triangle count
+	bool Intersect(const Ray& ray, const Vector3& a, const Vector3& b, const Vector3& c, float maxDistance, float& distance);
+}
\ No newline at end of file
@@ -0,0 +1,230 @@
+#pragma once
+
+// SSE is part of every x64 target, AVX only when the compiler is allowed to emit it (/arch:AVX, -mavx)
+// Define WINTER_MATH_NO_SIMD to force the scalar paths
+#if !defined(WINTER_MATH_NO_SIMD) && (defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define WINTER_MATH_SSE 1
+#include <immintrin.h>
+#if defined(__AVX__)
+#define WINTER_MATH_AVX 1
+#endif
+#endif
+
+namespace WinterEngine::Math
+{
+	// Plain C++ versions, the reference the vector kernels are measured against
+	namespace Scalar
+	{
+		inline Matrix4 Multiply(const Matrix4& a, const Matrix4& b)
+		{
+			return Matrix4(
+				(a._11 * b._11) + (a._12 * b._21) + (a._13 * b._31) + (a._14 * b._41),
+				(a._11 * b._12) + (a._12 * b._22) + (a._13 * b._32) + (a._14 * b._42),
+				(a._11 * b._13) + (a._12 * b._23) + (a._13 * b._33) + (a._14 * b._43),
+				(a._11 * b._14) + (a._12 * b._24) + (a._13 * b._34) + (a._14 * b._44),
+
+				(a._21 * b._11) + (a._22 * b._21) + (a._23 * b._31) + (a._24 * b._41),
+				(a._21 * b._12) + (a._22 * b._22) + (a._23 * b._32) + (a._24 * b._42),
+				(a._21 * b._13) + (a._22 * b._23) + (a._23 * b._33) + (a._24 * b._43),
+				(a._21 * b._14) + (a._22 * b._24) + (a._23 * b._34) + (a._24 * b._44),
+
+				(a._31 * b._11) + (a._32 * b._21) + (a._33 * b._31) + (a._34 * b._41),
+				(a._31 * b._12) + (a._32 * b._22) + (a._33 * b._32) + (a._34 * b._42),
+				(a._31 * b._13) + (a._32 * b._23) + (a._33 * b._33) + (a._34 * b._43),
+				(a._31 * b._14) + (a._32 * b._24) + (a._33 * b._34) + (a._34 * b._44),
+
+				(a._41 * b._11) + (a._42 * b._21) + (a._43 * b._31) + (a._44 * b._41),
+				(a._41 * b._12) + (a._42 * b._22) + (a._43 * b._32) + (a._44 * b._42),
+				(a._41 * b._13) + (a._42 * b._23) + (a._43 * b._33) + (a._44 * b._43),
+				(a._41 * b._14) + (a._42 * b._24) + (a._43 * b._34) + (a._44 * b._44));
+		}
+
+		inline Matrix4 Transpose(const Matrix4& m)
+		{
+			return Matrix4(
+				m._11, m._21, m._31, m._41,
+				m._12, m._22, m._32, m._42,
+				m._13, m._23, m._33, m._43,
+				m._14, m._24, m._34, m._44
+			);
+		}
+
+		inline Vector3 TransformCoord(const Vector3& v, const Matrix4& m)
+		{
+			float x = v.x * m._11 + v.y * m._21 + v.z * m._31 + m._41;
+			float y = v.x * m._12 + v.y * m._22 + v.z * m._32 + m._42;
+			float z = v.x * m._13 + v.y * m._23 + v.z * m._33 + m._43;
+
+			return { x, y, z };
+		}
+
+		inline Vector3 TransformNormal(const Vector3& v, const Matrix4& m)
+		{
+			float x = v.x * m._11 + v.y * m._21 + v.z * m._31;
+			float y = v.x * m._12 + v.y * m._22 + v.z * m._32;
+			float z = v.x * m._13 + v.y * m._23 + v.z * m._33;
+
+			return { x, y, z };
+		}
+
+		// Upper 3x3 inverted through its adjugate, translation moved into the inverted space
+		inline Matrix4 InverseAffine(const Matrix4& m)
+		{
+			const float c00 = m._22 * m._33 - m._23 * m._32;
+			const float c01 = m._23 * m._31 - m._21 * m._33;
+			const float c02 = m._21 * m._32 - m._22 * m._31;
+			const float det = m._11 * c00 + m._12 * c01 + m._13 * c02;
+			const float invDet = 1.0f / det;
+
+			const float i11 = c00 * invDet;
+			const float i21 = c01 * invDet;
+			const float i31 = c02 * invDet;
+			const float i12 = (m._13 * m._32 - m._12 * m._33) * invDet;
+			const float i22 = (m._11 * m._33 - m._13 * m._31) * invDet;
+			const float i32 = (m._12 * m._31 - m._11 * m._32) * invDet;
+			const float i13 = (m._12 * m._23 - m._13 * m._22) * invDet;
+			const float i23 = (m._13 * m._21 - m._11 * m._23) * invDet;
+			const float i33 = (m._11 * m._22 - m._12 * m._21) * invDet;
+
+			return Matrix4(
+				i11, i12, i13, 0.0f,
+				i21, i22, i23, 0.0f,
+				i31, i32, i33, 0.0f,
+				-(m._41 * i11 + m._42 * i21 + m._43 * i31),
+				-(m._41 * i12 + m._42 * i22 + m._43 * i32),
+				-(m._41 * i13 + m._42 * i23 + m._43 * i33),
+				1.0f);
+		}
+	}
+
+#if defined(WINTER_MATH_SSE)
+	// Rows are loaded unaligned so Matrix4 keeps its layout and alignment
+	namespace SIMD
+	{
+		// One row of a times b: each element of the row scales the matching row of b
+		inline __m128 MultiplyRow(__m128 row, __m128 b0, __m128 b1, __m128 b2, __m128 b3)
+		{
+			__m128 r = _mm_mul_ps(_mm_shuffle_ps(row, row, 0x00), b0);
+			r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(row, row, 0x55), b1));
+			r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(row, row, 0xAA), b2));
+			return _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(row, row, 0xFF), b3));
+		}
+
+		inline Matrix4 Multiply(const Matrix4& a, const Matrix4& b)
+		{
+			const __m128 b0 = _mm_loadu_ps(&b._11);
+			const __m128 b1 = _mm_loadu_ps(&b._21);
+			const __m128 b2 = _mm_loadu_ps(&b._31);
+			const __m128 b3 = _mm_loadu_ps(&b._41);
+
+			Matrix4 result;
+#if defined(WINTER_MATH_AVX)
+			// Two result rows per iteration, each 128 bit lane works on its own row of a
+			const __m256 bb0 = _mm256_set_m128(b0, b0);
+			const __m256 bb1 = _mm256_set_m128(b1, b1);
+			const __m256 bb2 = _mm256_set_m128(b2, b2);
+			const __m256 bb3 = _mm256_set_m128(b3, b3);
+			for (int row = 0; row < 16; row += 8)
+			{
+				const __m256 ar = _mm256_loadu_ps(&a.v[row]);
+				__m256 r = _mm256_mul_ps(_mm256_shuffle_ps(ar, ar, 0x00), bb0);
+				r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(ar, ar, 0x55), bb1));
+				r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(ar, ar, 0xAA), bb2));
+				r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(ar, ar, 0xFF), bb3));
+				_mm256_storeu_ps(&result.v[row], r);
+			}
+#else
+			_mm_storeu_ps(&result._11, MultiplyRow(_mm_loadu_ps(&a._11), b0, b1, b2, b3));
+			_mm_storeu_ps(&result._21, MultiplyRow(_mm_loadu_ps(&a._21), b0, b1, b2, b3));
+			_mm_storeu_ps(&result._31, MultiplyRow(_mm_loadu_ps(&a._31), b0, b1, b2, b3));
+			_mm_storeu_ps(&result._41, MultiplyRow(_mm_loadu_ps(&a._41), b0, b1, b2, b3));
+#endif
+			return result;
+		}
+
+		inline Matrix4 Transpose(const Matrix4& m)
+		{
+			__m128 r0 = _mm_loadu_ps(&m._11);
+			__m128 r1 = _mm_loadu_ps(&m._21);
+			__m128 r2 = _mm_loadu_ps(&m._31);
+			__m128 r3 = _mm_loadu_ps(&m._41);
+			_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+			Matrix4 result;
+			_mm_storeu_ps(&result._11, r0);
+			_mm_storeu_ps(&result._21, r1);
+			_mm_storeu_ps(&result._31, r2);
+			_mm_storeu_ps(&result._41, r3);
+			return result;
+		}
+
+		inline Vector3 StoreVector3(__m128 v)
+		{
+			alignas(16) float out[4];
+			_mm_store_ps(out, v);
+			return { out[0], out[1], out[2] };
+		}
+
+		inline Vector3 TransformCoord(const Vector3& v, const Matrix4& m)
+		{
+			__m128 r = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(v.x), _mm_loadu_ps(&m._11)), _mm_loadu_ps(&m._41));
+			r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(v.y), _mm_loadu_ps(&m._21)));
+			r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(v.z), _mm_loadu_ps(&m._31)));
+			return StoreVector3(r);
+		}
+
+		inline Vector3 TransformNormal(const Vector3& v, const Matrix4& m)
+		{
+			__m128 r = _mm_mul_ps(_mm_set1_ps(v.x), _mm_loadu_ps(&m._11));
+			r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(v.y), _mm_loadu_ps(&m._21)));
+			r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(v.z), _mm_loadu_ps(&m._31)));
+			return StoreVector3(r);
+		}
+
+		// (a.yzx * b.zxy) - (a.zxy * b.yzx), w ends up 0
+		inline __m128 Cross(__m128 a, __m128 b)
+		{
+			const __m128 aYZX = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+			const __m128 bYZX = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+			const __m128 c = _mm_sub_ps(_mm_mul_ps(a, bYZX), _mm_mul_ps(aYZX, b));
+			return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+		}
+
+		inline Matrix4 InverseAffine(const Matrix4& m)
+		{
+			const __m128 w0 = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+			const __m128 r0 = _mm_and_ps(_mm_loadu_ps(&m._11), w0);
+			const __m128 r1 = _mm_and_ps(_mm_loadu_ps(&m._21), w0);
+			const __m128 r2 = _mm_and_ps(_mm_loadu_ps(&m._31), w0);
+			const __m128 t = _mm_loadu_ps(&m._41);
+
+			// Columns of the inverse are the cross products of the other two rows over the determinant
+			__m128 c0 = Cross(r1, r2);
+			__m128 c1 = Cross(r2, r0);
+			__m128 c2 = Cross(r0, r1);
+			__m128 det = _mm_mul_ps(r0, c0);
+			det = _mm_add_ps(det, _mm_shuffle_ps(det, det, _MM_SHUFFLE(2, 3, 0, 1)));
+			det = _mm_add_ps(det, _mm_shuffle_ps(det, det, _MM_SHUFFLE(1, 0, 3, 2)));
+			const __m128 invDet = _mm_div_ps(_mm_set1_ps(1.0f), det);
+			c0 = _mm_mul_ps(c0, invDet);
+			c1 = _mm_mul_ps(c1, invDet);
+			c2 = _mm_mul_ps(c2, invDet);
+
+			__m128 c3 = _mm_setzero_ps();
+			_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+			__m128 translation = _mm_mul_ps(_mm_shuffle_ps(t, t, 0x00), c0);
+			translation = _mm_add_ps(translation, _mm_mul_ps(_mm_shuffle_ps(t, t, 0x55), c1));
+			translation = _mm_add_ps(translation, _mm_mul_ps(_mm_shuffle_ps(t, t, 0xAA), c2));
+			translation = _mm_sub_ps(_mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f), translation);
+
+			Matrix4 result;
+			_mm_storeu_ps(&result._11, c0);
+			_mm_storeu_ps(&result._21, c1);
+			_mm_storeu_ps(&result._31, c2);
+			_mm_storeu_ps(&result._41, translation);
+			return result;
+		}
+	}
+#endif
+}
\ No newline at end of file
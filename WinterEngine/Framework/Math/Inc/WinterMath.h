@@ -8,6 +8,12 @@
 #include "Vector4.h"
 #include "Quaternion.h"
 #include "Matrix4.h"
+#include "SIMD.h"
+#include "BatchTransform.h"
+#include "BatchQuaternion.h"
+#include "Bounds.h"
+#include "Frustum.h"
+#include "Ray.h"
 
 namespace WinterEngine::Math
 {
@@ -89,30 +95,48 @@ namespace WinterEngine::Math
 
 	inline Vector3 TransformCoord(const Vector3& v, const Matrix4& m)
 	{
-		float x = v.x * m._11 + v.y * m._21 + v.z * m._31 + m._41;
-		float y = v.x * m._12 + v.y * m._22 + v.z * m._32 + m._42;
-		float z = v.x * m._13 + v.y * m._23 + v.z * m._33 + m._43;
-
-		return { x, y, z };
+#if defined(WINTER_MATH_SSE)
+		return SIMD::TransformCoord(v, m);
+#else
+		return Scalar::TransformCoord(v, m);
+#endif
 	}
 
 	inline Vector3 TransformNormal(const Vector3& v, const Matrix4& m)
 	{
-		float x = v.x * m._11 + v.y * m._21 + v.z * m._31;
-		float y = v.x * m._12 + v.y * m._22 + v.z * m._32;
-		float z = v.x * m._13 + v.y * m._23 + v.z * m._33;
-
-		return { x, y, z };
+#if defined(WINTER_MATH_SSE)
+		return SIMD::TransformNormal(v, m);
+#else
+		return Scalar::TransformNormal(v, m);
+#endif
 	}
 
 	inline Matrix4 Transpose(const Matrix4& m)
 	{
-		return Matrix4(
-			m._11, m._21, m._31, m._41,
-			m._12, m._22, m._32, m._42,
-			m._13, m._23, m._33, m._43,
-			m._14, m._24, m._34, m._44
-		);
+#if defined(WINTER_MATH_SSE)
+		return SIMD::Transpose(m);
+#else
+		return Scalar::Transpose(m);
+#endif
+	}
+
+	// Only valid when the last column is (0, 0, 0, 1), cheaper than a general inverse
+	inline Matrix4 InverseAffine(const Matrix4& m)
+	{
+#if defined(WINTER_MATH_SSE)
+		return SIMD::InverseAffine(m);
+#else
+		return Scalar::InverseAffine(m);
+#endif
+	}
+
+	inline Matrix4 Matrix4::operator*(const Matrix4& rhs) const
+	{
+#if defined(WINTER_MATH_SSE)
+		return SIMD::Multiply(*this, rhs);
+#else
+		return Scalar::Multiply(*this, rhs);
+#endif
 	}
 
 	inline Matrix4 Matrix4::RotationAxis(const Vector3& axis, float rad)
@@ -143,4 +167,174 @@ namespace WinterEngine::Math
 			0.0f, 0.0f, 0.0f, 1.0f
 		};
 	}
+
+	constexpr float Dot(const Quaternion& a, const Quaternion& b)
+	{
+		return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+	}
+
+	constexpr float MagnitudeSqr(const Quaternion& q)
+	{
+		return q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w;
+	}
+
+	inline float Magnitude(const Quaternion& q)
+	{
+		return sqrtf(MagnitudeSqr(q));
+	}
+
+	inline Quaternion Normalize(const Quaternion& q)
+	{
+		return q / Magnitude(q);
+	}
+
+	constexpr Quaternion Conjugate(const Quaternion& q)
+	{
+		return { -q.x, -q.y, -q.z, q.w };
+	}
+
+	// Same as Conjugate for unit quaternions
+	inline Quaternion Inverse(const Quaternion& q)
+	{
+		const Quaternion c = Conjugate(q);
+		return c / MagnitudeSqr(q);
+	}
+
+	// Same result as TransformNormal(v, Matrix4::MatrixRotationQuaternion(q)), q must be unit length.
+	// Rotating more than a couple of vectors by the same q is cheaper through the matrix
+	inline Vector3 Rotate(const Vector3& v, const Quaternion& q)
+	{
+		const Vector3 u = { q.x, q.y, q.z };
+		const Vector3 uv = Cross(u, v) * 2.0f;
+		return v + (uv * q.w) + Cross(u, uv);
+	}
+
+	// Both interpolations take the shorter arc, flipping b when the quaternions are more than 180 degrees apart
+	inline Quaternion Nlerp(const Quaternion& a, const Quaternion& b, float t)
+	{
+		const Quaternion end = (Dot(a, b) < 0.0f) ? -b : b;
+		return Normalize(a + ((end - a) * t));
+	}
+
+	inline Quaternion Slerp(const Quaternion& a, const Quaternion& b, float t)
+	{
+		float cosTheta = Dot(a, b);
+		Quaternion end = b;
+		if (cosTheta < 0.0f)
+		{
+			cosTheta = -cosTheta;
+			end = -b;
+		}
+
+		// Nearly parallel, sin(theta) is too small to divide by and a straight line is just as good
+		if (cosTheta > 0.9995f)
+		{
+			return Normalize(a + ((end - a) * t));
+		}
+
+		const float theta = acosf(cosTheta);
+		const float sinTheta = sinf(theta);
+		return (a * (sinf((1.0f - t) * theta) / sinTheta)) + (end * (sinf(t * theta) / sinTheta));
+	}
+
+	inline Quaternion Quaternion::RotationAxis(const Vector3& axis, float rad)
+	{
+		const Vector3 u = Normalize(axis);
+		const float s = sinf(rad * 0.5f);
+		return { u.x * s, u.y * s, u.z * s, cosf(rad * 0.5f) };
+	}
+
+	inline Quaternion Quaternion::RotationEuler(const Vector3& rad)
+	{
+		return RotationAxis(Vector3::ZAxis, rad.z) * RotationAxis(Vector3::XAxis, rad.x) * RotationAxis(Vector3::YAxis, rad.y);
+	}
+
+	inline Quaternion Quaternion::RotationMatrix(const Matrix4& m)
+	{
+		// Divide by the largest component so the result stays accurate near 180 degrees
+		const float trace = m._11 + m._22 + m._33;
+		if (trace > 0.0f)
+		{
+			const float w = sqrtf(1.0f + trace) * 0.5f;
+			const float s = 0.25f / w;
+			return { (m._23 - m._32) * s, (m._31 - m._13) * s, (m._12 - m._21) * s, w };
+		}
+		if (m._11 > m._22 && m._11 > m._33)
+		{
+			const float x = sqrtf(1.0f + m._11 - m._22 - m._33) * 0.5f;
+			const float s = 0.25f / x;
+			return { x, (m._12 + m._21) * s, (m._13 + m._31) * s, (m._23 - m._32) * s };
+		}
+		if (m._22 > m._33)
+		{
+			const float y = sqrtf(1.0f - m._11 + m._22 - m._33) * 0.5f;
+			const float s = 0.25f / y;
+			return { (m._12 + m._21) * s, y, (m._23 + m._32) * s, (m._31 - m._13) * s };
+		}
+		const float z = sqrtf(1.0f - m._11 - m._22 + m._33) * 0.5f;
+		const float s = 0.25f / z;
+		return { (m._13 + m._31) * s, (m._23 + m._32) * s, z, (m._12 - m._21) * s };
+	}
+
+	inline AABB Merge(const AABB& a, const AABB& b)
+	{
+		return {
+			{ Min(a.min.x, b.min.x), Min(a.min.y, b.min.y), Min(a.min.z, b.min.z) },
+			{ Max(a.max.x, b.max.x), Max(a.max.y, b.max.y), Max(a.max.z, b.max.z) }
+		};
+	}
+
+	inline InverseRay MakeInverseRay(const Ray& ray)
+	{
+		const auto reciprocal = [](float value) { return (value != 0.0f) ? 1.0f / value : FLT_MAX; };
+		return { ray.origin, { reciprocal(ray.direction.x), reciprocal(ray.direction.y), reciprocal(ray.direction.z) } };
+	}
+
+	inline bool Intersect(const InverseRay& ray, const AABB& aabb, float maxDistance, float& distance)
+	{
+		const float tx0 = (aabb.min.x - ray.origin.x) * ray.invDirection.x;
+		const float tx1 = (aabb.max.x - ray.origin.x) * ray.invDirection.x;
+		const float ty0 = (aabb.min.y - ray.origin.y) * ray.invDirection.y;
+		const float ty1 = (aabb.max.y - ray.origin.y) * ray.invDirection.y;
+		const float tz0 = (aabb.min.z - ray.origin.z) * ray.invDirection.z;
+		const float tz1 = (aabb.max.z - ray.origin.z) * ray.invDirection.z;
+		const float tMin = Max(Max(Min(tx0, tx1), Min(ty0, ty1)), Max(Min(tz0, tz1), 0.0f));
+		const float tMax = Min(Min(Max(tx0, tx1), Max(ty0, ty1)), Min(Max(tz0, tz1), maxDistance));
+		distance = tMin;
+		return tMin <= tMax;
+	}
+
+	inline bool Intersect(const Ray& ray, const Vector3& a, const Vector3& b, const Vector3& c, float maxDistance, float& distance, float& u, float& v)
+	{
+		// Moller-Trumbore, barycentric u and v solved alongside the distance
+		const Vector3 edge1 = b - a;
+		const Vector3 edge2 = c - a;
+		const Vector3 p = Cross(ray.direction, edge2);
+		const float determinant = Dot(edge1, p);
+		if (Abs(determinant) < 1e-12f)
+		{
+			return false;
+		}
+
+		const float invDeterminant = 1.0f / determinant;
+		const Vector3 offset = ray.origin - a;
+		u = Dot(offset, p) * invDeterminant;
+		if (u < 0.0f || u > 1.0f)
+		{
+			return false;
+		}
+		const Vector3 q = Cross(offset, edge1);
+		v = Dot(ray.direction, q) * invDeterminant;
+		if (v < 0.0f || u + v > 1.0f)
+		{
+			return false;
+		}
+		const float t = Dot(edge2, q) * invDeterminant;
+		if (t < 0.0f || t > maxDistance)
+		{
+			return false;
+		}
+		distance = t;
+		return true;
+	}
 }
\ No newline at end of file
@@ -0,0 +1,181 @@
+#include "Precompile.h"
+#include "WinterMath.h"
+
+using namespace WinterEngine::Math;
+
+namespace
+{
+	enum class Mode
+	{
+		Nlerp,
+		Slerp
+	};
+
+	// Eberly's series for sin(t * theta) / sin(theta) in terms of cos(theta), the last term is
+	// scaled by mu to absorb the error of stopping after eight
+	constexpr int SlerpTerms = 8;
+	constexpr float SlerpMu = 1.85298109240830f;
+	constexpr float SlerpU[SlerpTerms] =
+	{
+		1.0f / (1 * 3), 1.0f / (2 * 5), 1.0f / (3 * 7), 1.0f / (4 * 9),
+		1.0f / (5 * 11), 1.0f / (6 * 13), 1.0f / (7 * 15), SlerpMu / (8 * 17)
+	};
+	constexpr float SlerpV[SlerpTerms] =
+	{
+		1.0f / 3, 2.0f / 5, 3.0f / 7, 4.0f / 9,
+		5.0f / 11, 6.0f / 13, 7.0f / 15, SlerpMu * 8 / 17
+	};
+
+	struct SharedT
+	{
+		float t;
+		float Get(size_t) const { return t; }
+#if defined(WINTER_MATH_SSE)
+		__m128 Load(size_t) const { return _mm_set1_ps(t); }
+#endif
+	};
+
+	struct ArrayT
+	{
+		const float* t;
+		float Get(size_t i) const { return t[i]; }
+#if defined(WINTER_MATH_SSE)
+		__m128 Load(size_t i) const { return _mm_loadu_ps(t + i); }
+#endif
+	};
+
+	// Matches the vector path lane for lane, used for the tail and for non SIMD builds
+	template<Mode mode>
+	Quaternion BlendOne(const Quaternion& a, const Quaternion& b, float t)
+	{
+		float cosTheta = Dot(a, b);
+		Quaternion end = b;
+		if (cosTheta < 0.0f)
+		{
+			cosTheta = -cosTheta;
+			end = -b;
+		}
+
+		if constexpr (mode == Mode::Nlerp)
+		{
+			return Normalize(a + ((end - a) * t));
+		}
+		else
+		{
+			const float xm1 = cosTheta - 1.0f;
+			const float d = 1.0f - t;
+			const float sqrT = t * t;
+			const float sqrD = d * d;
+			float cT = 1.0f;
+			float cD = 1.0f;
+			for (int i = SlerpTerms - 1; i >= 0; --i)
+			{
+				cT = 1.0f + ((SlerpU[i] * sqrT) - SlerpV[i]) * xm1 * cT;
+				cD = 1.0f + ((SlerpU[i] * sqrD) - SlerpV[i]) * xm1 * cD;
+			}
+			return (a * (cD * d)) + (end * (cT * t));
+		}
+	}
+
+	// Four quaternions per step, transposed so each register holds one component of all four.
+	// Everything is loaded before anything is stored, which keeps in place blends safe
+	template<Mode mode, class TSource>
+	void BlendBatch(const Quaternion* a, const Quaternion* b, const TSource& tSource, Quaternion* out, size_t count)
+	{
+		size_t i = 0;
+#if defined(WINTER_MATH_SSE)
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 ax = _mm_loadu_ps(&a[i].x);
+			__m128 ay = _mm_loadu_ps(&a[i + 1].x);
+			__m128 az = _mm_loadu_ps(&a[i + 2].x);
+			__m128 aw = _mm_loadu_ps(&a[i + 3].x);
+			_MM_TRANSPOSE4_PS(ax, ay, az, aw);
+			__m128 bx = _mm_loadu_ps(&b[i].x);
+			__m128 by = _mm_loadu_ps(&b[i + 1].x);
+			__m128 bz = _mm_loadu_ps(&b[i + 2].x);
+			__m128 bw = _mm_loadu_ps(&b[i + 3].x);
+			_MM_TRANSPOSE4_PS(bx, by, bz, bw);
+			const __m128 t = tSource.Load(i);
+
+			// Flip b wherever the dot product is negative
+			__m128 cosTheta = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_add_ps(_mm_mul_ps(az, bz), _mm_mul_ps(aw, bw)));
+			const __m128 sign = _mm_and_ps(cosTheta, signMask);
+			cosTheta = _mm_xor_ps(cosTheta, sign);
+			bx = _mm_xor_ps(bx, sign);
+			by = _mm_xor_ps(by, sign);
+			bz = _mm_xor_ps(bz, sign);
+			bw = _mm_xor_ps(bw, sign);
+
+			__m128 rx, ry, rz, rw;
+			if constexpr (mode == Mode::Nlerp)
+			{
+				rx = _mm_add_ps(ax, _mm_mul_ps(_mm_sub_ps(bx, ax), t));
+				ry = _mm_add_ps(ay, _mm_mul_ps(_mm_sub_ps(by, ay), t));
+				rz = _mm_add_ps(az, _mm_mul_ps(_mm_sub_ps(bz, az), t));
+				rw = _mm_add_ps(aw, _mm_mul_ps(_mm_sub_ps(bw, aw), t));
+				const __m128 lengthSqr = _mm_add_ps(_mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(ry, ry)), _mm_add_ps(_mm_mul_ps(rz, rz), _mm_mul_ps(rw, rw)));
+				const __m128 invLength = _mm_div_ps(one, _mm_sqrt_ps(lengthSqr));
+				rx = _mm_mul_ps(rx, invLength);
+				ry = _mm_mul_ps(ry, invLength);
+				rz = _mm_mul_ps(rz, invLength);
+				rw = _mm_mul_ps(rw, invLength);
+			}
+			else
+			{
+				const __m128 xm1 = _mm_sub_ps(cosTheta, one);
+				const __m128 d = _mm_sub_ps(one, t);
+				const __m128 sqrT = _mm_mul_ps(t, t);
+				const __m128 sqrD = _mm_mul_ps(d, d);
+				__m128 cT = one;
+				__m128 cD = one;
+				for (int term = SlerpTerms - 1; term >= 0; --term)
+				{
+					const __m128 u = _mm_set1_ps(SlerpU[term]);
+					const __m128 v = _mm_set1_ps(SlerpV[term]);
+					cT = _mm_add_ps(one, _mm_mul_ps(_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(u, sqrT), v), xm1), cT));
+					cD = _mm_add_ps(one, _mm_mul_ps(_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(u, sqrD), v), xm1), cD));
+				}
+				cT = _mm_mul_ps(cT, t);
+				cD = _mm_mul_ps(cD, d);
+				rx = _mm_add_ps(_mm_mul_ps(ax, cD), _mm_mul_ps(bx, cT));
+				ry = _mm_add_ps(_mm_mul_ps(ay, cD), _mm_mul_ps(by, cT));
+				rz = _mm_add_ps(_mm_mul_ps(az, cD), _mm_mul_ps(bz, cT));
+				rw = _mm_add_ps(_mm_mul_ps(aw, cD), _mm_mul_ps(bw, cT));
+			}
+
+			_MM_TRANSPOSE4_PS(rx, ry, rz, rw);
+			_mm_storeu_ps(&out[i].x, rx);
+			_mm_storeu_ps(&out[i + 1].x, ry);
+			_mm_storeu_ps(&out[i + 2].x, rz);
+			_mm_storeu_ps(&out[i + 3].x, rw);
+		}
+#endif
+		for (; i < count; ++i)
+		{
+			out[i] = BlendOne<mode>(a[i], b[i], tSource.Get(i));
+		}
+	}
+}
+
+void WinterEngine::Math::NlerpQuaternions(const Quaternion* a, const Quaternion* b, float t, Quaternion* out, size_t count)
+{
+	BlendBatch<Mode::Nlerp>(a, b, SharedT{ t }, out, count);
+}
+
+void WinterEngine::Math::NlerpQuaternions(const Quaternion* a, const Quaternion* b, const float* t, Quaternion* out, size_t count)
+{
+	BlendBatch<Mode::Nlerp>(a, b, ArrayT{ t }, out, count);
+}
+
+void WinterEngine::Math::SlerpQuaternions(const Quaternion* a, const Quaternion* b, float t, Quaternion* out, size_t count)
+{
+	BlendBatch<Mode::Slerp>(a, b, SharedT{ t }, out, count);
+}
+
+void WinterEngine::Math::SlerpQuaternions(const Quaternion* a, const Quaternion* b, const float* t, Quaternion* out, size_t count)
+{
+	BlendBatch<Mode::Slerp>(a, b, ArrayT{ t }, out, count);
+}
\ No newline at end of file
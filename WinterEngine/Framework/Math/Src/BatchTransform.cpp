@@ -0,0 +1,91 @@
+#include "Precompile.h"
+#include "WinterMath.h"
+
+using namespace WinterEngine::Math;
+
+namespace
+{
+	enum class Mode
+	{
+		Coord,
+		Normal,
+		Project
+	};
+
+	inline const Vector3& Read(const Vector3* base, size_t stride, size_t index)
+	{
+		return *reinterpret_cast<const Vector3*>(reinterpret_cast<const uint8_t*>(base) + (stride * index));
+	}
+
+	inline Vector3& Write(Vector3* base, size_t stride, size_t index)
+	{
+		return *reinterpret_cast<Vector3*>(reinterpret_cast<uint8_t*>(base) + (stride * index));
+	}
+
+	template<Mode mode>
+	Vector3 TransformOne(const Vector3& v, const Matrix4& m)
+	{
+		if constexpr (mode == Mode::Normal)
+		{
+			return Scalar::TransformNormal(v, m);
+		}
+		else if constexpr (mode == Mode::Project)
+		{
+			const float w = v.x * m._14 + v.y * m._24 + v.z * m._34 + m._44;
+			return Scalar::TransformCoord(v, m) / w;
+		}
+		else
+		{
+			return Scalar::TransformCoord(v, m);
+		}
+	}
+
+	// Matrix rows stay in registers for the whole batch, each point is three broadcasts and
+	// multiply-adds. Results go out as 8 + 4 byte stores so nothing past the Vector3 is touched,
+	// which keeps tightly packed and in place transforms safe
+	template<Mode mode>
+	void TransformBatch(const Vector3* input, size_t inputStride, Vector3* output, size_t outputStride, size_t count, const Matrix4& m)
+	{
+#if defined(WINTER_MATH_SSE)
+		const __m128 r0 = _mm_loadu_ps(&m._11);
+		const __m128 r1 = _mm_loadu_ps(&m._21);
+		const __m128 r2 = _mm_loadu_ps(&m._31);
+		const __m128 r3 = (mode == Mode::Normal) ? _mm_setzero_ps() : _mm_loadu_ps(&m._41);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const Vector3& v = Read(input, inputStride, i);
+			__m128 r = _mm_add_ps(_mm_mul_ps(_mm_load1_ps(&v.x), r0), r3);
+			r = _mm_add_ps(r, _mm_mul_ps(_mm_load1_ps(&v.y), r1));
+			r = _mm_add_ps(r, _mm_mul_ps(_mm_load1_ps(&v.z), r2));
+			if constexpr (mode == Mode::Project)
+			{
+				r = _mm_div_ps(r, _mm_shuffle_ps(r, r, _MM_SHUFFLE(3, 3, 3, 3)));
+			}
+
+			Vector3& out = Write(output, outputStride, i);
+			_mm_storel_pi(reinterpret_cast<__m64*>(&out.x), r);
+			_mm_store_ss(&out.z, _mm_movehl_ps(r, r));
+		}
+#else
+		for (size_t i = 0; i < count; ++i)
+		{
+			Write(output, outputStride, i) = TransformOne<mode>(Read(input, inputStride, i), m);
+		}
+#endif
+	}
+}
+
+void WinterEngine::Math::TransformCoords(const Vector3* input, size_t inputStride, Vector3* output, size_t outputStride, size_t count, const Matrix4& m)
+{
+	TransformBatch<Mode::Coord>(input, inputStride, output, outputStride, count, m);
+}
+
+void WinterEngine::Math::TransformNormals(const Vector3* input, size_t inputStride, Vector3* output, size_t outputStride, size_t count, const Matrix4& m)
+{
+	TransformBatch<Mode::Normal>(input, inputStride, output, outputStride, count, m);
+}
+
+void WinterEngine::Math::ProjectCoords(const Vector3* input, size_t inputStride, Vector3* output, size_t outputStride, size_t count, const Matrix4& m)
+{
+	TransformBatch<Mode::Project>(input, inputStride, output, outputStride, count, m);
+}
\ No newline at end of file
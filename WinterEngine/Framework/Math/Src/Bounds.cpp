@@ -0,0 +1,173 @@
+#include "Precompile.h"
+#include "WinterMath.h"
+
+using namespace WinterEngine::Math;
+
+namespace
+{
+	inline const Vector3& Read(const Vector3* base, size_t stride, size_t index)
+	{
+		return *reinterpret_cast<const Vector3*>(reinterpret_cast<const uint8_t*>(base) + (stride * index));
+	}
+
+#if defined(WINTER_MATH_SSE)
+	// x, y, z, 0 without reading past the Vector3
+	inline __m128 Load(const Vector3& v)
+	{
+		return _mm_movelh_ps(_mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(&v.x)), _mm_load_ss(&v.z));
+	}
+
+	inline Vector3 Store(__m128 r)
+	{
+		Vector3 v;
+		_mm_storel_pi(reinterpret_cast<__m64*>(&v.x), r);
+		_mm_store_ss(&v.z, _mm_movehl_ps(r, r));
+		return v;
+	}
+#endif
+}
+
+AABB WinterEngine::Math::ComputeAABB(const Vector3* points, size_t stride, size_t count)
+{
+	AABB aabb;
+	if (count == 0)
+	{
+		return aabb;
+	}
+
+#if defined(WINTER_MATH_SSE)
+	// Two independent min/max chains so consecutive points do not wait on each other
+	__m128 min0 = Load(Read(points, stride, 0));
+	__m128 max0 = min0;
+	__m128 min1 = min0;
+	__m128 max1 = min0;
+	size_t i = 1;
+	for (; i + 1 < count; i += 2)
+	{
+		const __m128 a = Load(Read(points, stride, i));
+		const __m128 b = Load(Read(points, stride, i + 1));
+		min0 = _mm_min_ps(min0, a);
+		max0 = _mm_max_ps(max0, a);
+		min1 = _mm_min_ps(min1, b);
+		max1 = _mm_max_ps(max1, b);
+	}
+	if (i < count)
+	{
+		const __m128 a = Load(Read(points, stride, i));
+		min0 = _mm_min_ps(min0, a);
+		max0 = _mm_max_ps(max0, a);
+	}
+	aabb.min = Store(_mm_min_ps(min0, min1));
+	aabb.max = Store(_mm_max_ps(max0, max1));
+#else
+	aabb.min = Read(points, stride, 0);
+	aabb.max = aabb.min;
+	for (size_t i = 1; i < count; ++i)
+	{
+		const Vector3& p = Read(points, stride, i);
+		aabb.min = { Min(aabb.min.x, p.x), Min(aabb.min.y, p.y), Min(aabb.min.z, p.z) };
+		aabb.max = { Max(aabb.max.x, p.x), Max(aabb.max.y, p.y), Max(aabb.max.z, p.z) };
+	}
+#endif
+	return aabb;
+}
+
+Sphere WinterEngine::Math::ComputeBoundingSphere(const Vector3* points, size_t stride, size_t count, const AABB& aabb)
+{
+	Sphere sphere;
+	if (count == 0 || aabb.IsEmpty())
+	{
+		return sphere;
+	}
+
+	sphere.center = aabb.GetCenter();
+	float maxDistanceSqr = 0.0f;
+	size_t i = 0;
+#if defined(WINTER_MATH_SSE)
+	// Four points at a time, transposed so each lane holds one point's squared distance
+	const __m128 cx = _mm_set1_ps(sphere.center.x);
+	const __m128 cy = _mm_set1_ps(sphere.center.y);
+	const __m128 cz = _mm_set1_ps(sphere.center.z);
+	__m128 maxSqr = _mm_setzero_ps();
+	for (; i + 3 < count; i += 4)
+	{
+		__m128 x = Load(Read(points, stride, i));
+		__m128 y = Load(Read(points, stride, i + 1));
+		__m128 z = Load(Read(points, stride, i + 2));
+		__m128 w = Load(Read(points, stride, i + 3));
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+		x = _mm_sub_ps(x, cx);
+		y = _mm_sub_ps(y, cy);
+		z = _mm_sub_ps(z, cz);
+		const __m128 distanceSqr = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+		maxSqr = _mm_max_ps(maxSqr, distanceSqr);
+	}
+	maxSqr = _mm_max_ps(maxSqr, _mm_movehl_ps(maxSqr, maxSqr));
+	maxSqr = _mm_max_ss(maxSqr, _mm_shuffle_ps(maxSqr, maxSqr, _MM_SHUFFLE(1, 1, 1, 1)));
+	maxDistanceSqr = _mm_cvtss_f32(maxSqr);
+#endif
+	for (; i < count; ++i)
+	{
+		maxDistanceSqr = Max(maxDistanceSqr, MagnitudeSqr(Read(points, stride, i) - sphere.center));
+	}
+	sphere.radius = sqrtf(maxDistanceSqr);
+	return sphere;
+}
+
+AABB WinterEngine::Math::TransformAABB(const AABB& aabb, const Matrix4& m)
+{
+	if (aabb.IsEmpty())
+	{
+		return aabb;
+	}
+
+	// Arvo: the new center is the transformed center, each new half extent is the sum of
+	// the old extents weighted by the absolute matrix entries of that column
+	const Vector3 center = TransformCoord(aabb.GetCenter(), m);
+	const Vector3 e = aabb.GetExtents();
+	const Vector3 extents = {
+		(Abs(m._11) * e.x) + (Abs(m._21) * e.y) + (Abs(m._31) * e.z),
+		(Abs(m._12) * e.x) + (Abs(m._22) * e.y) + (Abs(m._32) * e.z),
+		(Abs(m._13) * e.x) + (Abs(m._23) * e.y) + (Abs(m._33) * e.z)
+	};
+	return { center - extents, center + extents };
+}
+
+Sphere WinterEngine::Math::TransformSphere(const Sphere& sphere, const Matrix4& m)
+{
+	if (sphere.IsEmpty())
+	{
+		return sphere;
+	}
+
+	const float scaleSqr = Max(MagnitudeSqr({ m._11, m._12, m._13 }),
+		Max(MagnitudeSqr({ m._21, m._22, m._23 }), MagnitudeSqr({ m._31, m._32, m._33 })));
+	return { TransformCoord(sphere.center, m), sphere.radius * sqrtf(scaleSqr) };
+}
+
+Sphere WinterEngine::Math::Merge(const Sphere& a, const Sphere& b)
+{
+	if (a.IsEmpty())
+	{
+		return b;
+	}
+	if (b.IsEmpty())
+	{
+		return a;
+	}
+
+	const Vector3 offset = b.center - a.center;
+	const float distance = Magnitude(offset);
+	if (distance + b.radius <= a.radius)
+	{
+		return a;
+	}
+	if (distance + a.radius <= b.radius)
+	{
+		return b;
+	}
+
+	// Smallest sphere touching the far sides of both
+	const float radius = (distance + a.radius + b.radius) * 0.5f;
+	return { a.center + (offset * ((radius - a.radius) / distance)), radius };
+}
\ No newline at end of file
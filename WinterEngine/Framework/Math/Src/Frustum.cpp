@@ -0,0 +1,144 @@
+#include "Precompile.h"
+#include "WinterMath.h"
+
+using namespace WinterEngine::Math;
+
+namespace
+{
+	Plane MakePlane(float a, float b, float c, float d)
+	{
+		const float length = sqrtf((a * a) + (b * b) + (c * c));
+		const float invLength = (length > 0.0f) ? 1.0f / length : 0.0f;
+		return { { a * invLength, b * invLength, c * invLength }, d * invLength };
+	}
+
+	inline float SignedDistance(const Plane& plane, const Vector3& point)
+	{
+		return Dot(plane.normal, point) + plane.d;
+	}
+
+	// Distance from the center of the box to the plane minus how far the box reaches
+	// towards the plane's normal. Below zero means the box is fully outside
+	inline bool IsOutside(const Plane& plane, const Vector3& center, const Vector3& extents)
+	{
+		const float reach = (Abs(plane.normal.x) * extents.x) + (Abs(plane.normal.y) * extents.y) + (Abs(plane.normal.z) * extents.z);
+		return SignedDistance(plane, center) + reach < 0.0f;
+	}
+}
+
+Frustum Frustum::FromMatrix(const Matrix4& m)
+{
+	// Gribb/Hartmann, clip = v * m so each plane is a sum of matrix columns
+	Frustum frustum;
+	frustum.planes[Left] = MakePlane(m._14 + m._11, m._24 + m._21, m._34 + m._31, m._44 + m._41);
+	frustum.planes[Right] = MakePlane(m._14 - m._11, m._24 - m._21, m._34 - m._31, m._44 - m._41);
+	frustum.planes[Bottom] = MakePlane(m._14 + m._12, m._24 + m._22, m._34 + m._32, m._44 + m._42);
+	frustum.planes[Top] = MakePlane(m._14 - m._12, m._24 - m._22, m._34 - m._32, m._44 - m._42);
+	frustum.planes[Near] = MakePlane(m._13, m._23, m._33, m._43);
+	frustum.planes[Far] = MakePlane(m._14 - m._13, m._24 - m._23, m._34 - m._33, m._44 - m._43);
+	return frustum;
+}
+
+bool WinterEngine::Math::IsVisible(const Frustum& frustum, const AABB& aabb)
+{
+	if (aabb.IsEmpty())
+	{
+		return true;
+	}
+
+	const Vector3 center = aabb.GetCenter();
+	const Vector3 extents = aabb.GetExtents();
+	for (const Plane& plane : frustum.planes)
+	{
+		if (IsOutside(plane, center, extents))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool WinterEngine::Math::IsVisible(const Frustum& frustum, const Sphere& sphere)
+{
+	if (sphere.IsEmpty())
+	{
+		return true;
+	}
+
+	for (const Plane& plane : frustum.planes)
+	{
+		if (SignedDistance(plane, sphere.center) < -sphere.radius)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+size_t WinterEngine::Math::CullAABBs(const Frustum& frustum, const AABB* boxes, size_t count, uint8_t* visible)
+{
+	size_t visibleCount = 0;
+	size_t i = 0;
+#if defined(WINTER_MATH_SSE)
+	// Plane coefficients broadcast once, boxes go through four at a time in SoA form
+	__m128 nx[Frustum::Count], ny[Frustum::Count], nz[Frustum::Count], d[Frustum::Count];
+	__m128 ax[Frustum::Count], ay[Frustum::Count], az[Frustum::Count];
+	for (int p = 0; p < Frustum::Count; ++p)
+	{
+		const Plane& plane = frustum.planes[p];
+		nx[p] = _mm_set1_ps(plane.normal.x);
+		ny[p] = _mm_set1_ps(plane.normal.y);
+		nz[p] = _mm_set1_ps(plane.normal.z);
+		d[p] = _mm_set1_ps(plane.d);
+		ax[p] = _mm_set1_ps(Abs(plane.normal.x));
+		ay[p] = _mm_set1_ps(Abs(plane.normal.y));
+		az[p] = _mm_set1_ps(Abs(plane.normal.z));
+	}
+
+	const __m128 half = _mm_set1_ps(0.5f);
+	for (; i + 3 < count; i += 4)
+	{
+		const AABB* b = boxes + i;
+		const __m128 minX = _mm_setr_ps(b[0].min.x, b[1].min.x, b[2].min.x, b[3].min.x);
+		const __m128 minY = _mm_setr_ps(b[0].min.y, b[1].min.y, b[2].min.y, b[3].min.y);
+		const __m128 minZ = _mm_setr_ps(b[0].min.z, b[1].min.z, b[2].min.z, b[3].min.z);
+		const __m128 maxX = _mm_setr_ps(b[0].max.x, b[1].max.x, b[2].max.x, b[3].max.x);
+		const __m128 maxY = _mm_setr_ps(b[0].max.y, b[1].max.y, b[2].max.y, b[3].max.y);
+		const __m128 maxZ = _mm_setr_ps(b[0].max.z, b[1].max.z, b[2].max.z, b[3].max.z);
+		const __m128 cx = _mm_mul_ps(_mm_add_ps(minX, maxX), half);
+		const __m128 cy = _mm_mul_ps(_mm_add_ps(minY, maxY), half);
+		const __m128 cz = _mm_mul_ps(_mm_add_ps(minZ, maxZ), half);
+		const __m128 ex = _mm_mul_ps(_mm_sub_ps(maxX, minX), half);
+		const __m128 ey = _mm_mul_ps(_mm_sub_ps(maxY, minY), half);
+		const __m128 ez = _mm_mul_ps(_mm_sub_ps(maxZ, minZ), half);
+
+		// Empty boxes have min above max on some axis and are kept
+		const __m128 empty = _mm_or_ps(_mm_cmpgt_ps(minX, maxX), _mm_or_ps(_mm_cmpgt_ps(minY, maxY), _mm_cmpgt_ps(minZ, maxZ)));
+		__m128 outside = _mm_setzero_ps();
+		for (int p = 0; p < Frustum::Count; ++p)
+		{
+			__m128 distance = _mm_add_ps(_mm_mul_ps(nx[p], cx), d[p]);
+			distance = _mm_add_ps(distance, _mm_mul_ps(ny[p], cy));
+			distance = _mm_add_ps(distance, _mm_mul_ps(nz[p], cz));
+			__m128 reach = _mm_mul_ps(ax[p], ex);
+			reach = _mm_add_ps(reach, _mm_mul_ps(ay[p], ey));
+			reach = _mm_add_ps(reach, _mm_mul_ps(az[p], ez));
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, reach), _mm_setzero_ps()));
+		}
+
+		const int culledMask = _mm_movemask_ps(_mm_andnot_ps(empty, outside));
+		for (int lane = 0; lane < 4; ++lane)
+		{
+			const uint8_t isVisible = ((culledMask >> lane) & 1) ? 0 : 1;
+			visible[i + lane] = isVisible;
+			visibleCount += isVisible;
+		}
+	}
+#endif
+	for (; i < count; ++i)
+	{
+		visible[i] = IsVisible(frustum, boxes[i]) ? 1 : 0;
+		visibleCount += visible[i];
+	}
+	return visibleCount;
+}
\ No newline at end of file
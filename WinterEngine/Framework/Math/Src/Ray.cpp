@@ -0,0 +1,94 @@
+#include "Precompile.h"
+#include "WinterMath.h"
+
+using namespace WinterEngine::Math;
+
+bool WinterEngine::Math::Intersect(const Ray& ray, const AABB& aabb, float maxDistance, float& distance)
+{
+	float exitDistance = 0.0f;
+	return Intersect(ray, aabb, maxDistance, distance, exitDistance);
+}
+
+bool WinterEngine::Math::Intersect(const Ray& ray, const AABB& aabb, float maxDistance, float& distance, float& exitDistance)
+{
+	if (aabb.IsEmpty())
+	{
+		return false;
+	}
+
+	// Slab test, a zero direction component divides into +-inf which the min/max below handle
+	const float origin[3] = { ray.origin.x, ray.origin.y, ray.origin.z };
+	const float direction[3] = { ray.direction.x, ray.direction.y, ray.direction.z };
+	const float boxMin[3] = { aabb.min.x, aabb.min.y, aabb.min.z };
+	const float boxMax[3] = { aabb.max.x, aabb.max.y, aabb.max.z };
+	float tMin = 0.0f;
+	float tMax = maxDistance;
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		if (direction[axis] == 0.0f)
+		{
+			if (origin[axis] < boxMin[axis] || origin[axis] > boxMax[axis])
+			{
+				return false;
+			}
+			continue;
+		}
+
+		const float invDirection = 1.0f / direction[axis];
+		float t0 = (boxMin[axis] - origin[axis]) * invDirection;
+		float t1 = (boxMax[axis] - origin[axis]) * invDirection;
+		if (t0 > t1)
+		{
+			std::swap(t0, t1);
+		}
+		tMin = Max(tMin, t0);
+		tMax = Min(tMax, t1);
+		if (tMin > tMax)
+		{
+			return false;
+		}
+	}
+
+	distance = tMin;
+	exitDistance = tMax;
+	return true;
+}
+
+bool WinterEngine::Math::Intersect(const Ray& ray, const Sphere& sphere, float maxDistance, float& distance)
+{
+	if (sphere.IsEmpty())
+	{
+		return false;
+	}
+
+	// |o + d * t - c|^2 = r^2 solved for the smaller t
+	const Vector3 offset = ray.origin - sphere.center;
+	const float a = MagnitudeSqr(ray.direction);
+	const float b = Dot(offset, ray.direction);
+	const float c = MagnitudeSqr(offset) - (sphere.radius * sphere.radius);
+	if (c <= 0.0f)
+	{
+		distance = 0.0f;
+		return true;
+	}
+	const float discriminant = (b * b) - (a * c);
+	if (b > 0.0f || discriminant < 0.0f || a <= 0.0f)
+	{
+		return false;
+	}
+
+	const float t = (-b - sqrtf(discriminant)) / a;
+	if (t > maxDistance)
+	{
+		return false;
+	}
+	distance = t;
+	return true;
+}
+
+bool WinterEngine::Math::Intersect(const Ray& ray, const Vector3& a, const Vector3& b, const Vector3& c, float maxDistance, float& distance)
+{
+	float u = 0.0f;
+	float v = 0.0f;
+	return Intersect(ray, a, b, c, maxDistance, distance, u, v);
+}
\ No newline at end of file
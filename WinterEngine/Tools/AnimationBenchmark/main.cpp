@@ -0,0 +1,489 @@
+#include <WinterEngine/Inc/WinterEngine.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+using namespace WinterEngine;
+using namespace WinterEngine::Graphics;
+using namespace WinterEngine::Math;
+
+struct Arguments
+{
+	std::filesystem::path modelFileName;	// empty = generated skeleton and clips
+	uint32_t characterCount = 1000;
+	uint32_t boneCount = 64;
+	uint32_t keysPerSecond = 30;
+	uint32_t frameCount = 300;
+	uint32_t vertexCount = 100000;	// per generated skinned mesh
+	uint32_t skinPassCount = 100;
+	uint32_t threadCount = 0;
+	float tolerance = 1e-4f;
+};
+
+constexpr float FrameTime = 1.0f / 60.0f;
+
+std::optional<Arguments> parseArgs(int argc, char* argv[])
+{
+	Arguments args;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "-model") == 0 && i + 1 < argc)
+		{
+			args.modelFileName = argv[++i];
+		}
+		else if (strcmp(argv[i], "-characters") == 0 && i + 1 < argc)
+		{
+			args.characterCount = static_cast<uint32_t>(atoi(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-bones") == 0 && i + 1 < argc)
+		{
+			args.boneCount = static_cast<uint32_t>(atoi(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-keys") == 0 && i + 1 < argc)
+		{
+			args.keysPerSecond = static_cast<uint32_t>(atoi(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-frames") == 0 && i + 1 < argc)
+		{
+			args.frameCount = static_cast<uint32_t>(atoi(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-vertices") == 0 && i + 1 < argc)
+		{
+			args.vertexCount = static_cast<uint32_t>(atoi(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-passes") == 0 && i + 1 < argc)
+		{
+			args.skinPassCount = static_cast<uint32_t>(atoi(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-threads") == 0 && i + 1 < argc)
+		{
+			args.threadCount = static_cast<uint32_t>(atoi(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-tolerance") == 0 && i + 1 < argc)
+		{
+			args.tolerance = static_cast<float>(atof(argv[++i]));
+		}
+		else
+		{
+			return std::nullopt;
+		}
+	}
+	if (args.characterCount == 0 || args.boneCount == 0 || args.keysPerSecond == 0 || args.frameCount == 0 || args.skinPassCount == 0)
+	{
+		return std::nullopt;
+	}
+	return args;
+}
+
+// Binary tree of bones a unit apart, with two looping clips that swing every bone on a
+// different phase so no two channels hit their keys at the same time
+void GenerateModel(const Arguments& args, Model& model)
+{
+	Skeleton& skeleton = model.skeleton;
+	skeleton.rootIndex = 0;
+	skeleton.bones.resize(args.boneCount);
+	std::vector<Matrix4> bindTransforms(args.boneCount);
+	for (uint32_t i = 0; i < args.boneCount; ++i)
+	{
+		Bone& bone = skeleton.bones[i];
+		bone.index = static_cast<int>(i);
+		bone.name = "Bone" + std::to_string(i);
+		bone.parentIndex = (i == 0) ? -1 : static_cast<int>((i - 1) / 2);
+		bone.toParentTransform = Matrix4::Translation(0.0f, (i == 0) ? 0.0f : 1.0f, 0.0f);
+		bindTransforms[i] = (bone.parentIndex >= 0) ? bone.toParentTransform * bindTransforms[bone.parentIndex] : bone.toParentTransform;
+		bone.offsetTransform = InverseAffine(bindTransforms[i]);
+		if (bone.parentIndex >= 0)
+		{
+			skeleton.bones[bone.parentIndex].childIndices.push_back(bone.index);
+		}
+	}
+
+	const float durations[] = { 2.0f, 1.3f };
+	for (uint32_t c = 0; c < 2; ++c)
+	{
+		AnimationClip& clip = model.animationClips.emplace_back();
+		clip.name = "Clip" + std::to_string(c);
+		clip.duration = durations[c];
+		clip.boneAnimations.resize(args.boneCount);
+		const uint32_t keyCount = static_cast<uint32_t>(clip.duration * args.keysPerSecond) + 1;
+		for (uint32_t b = 0; b < args.boneCount; ++b)
+		{
+			BoneAnimation& boneAnimation = clip.boneAnimations[b];
+			const float phase = static_cast<float>(b) * 0.37f + static_cast<float>(c);
+			for (uint32_t k = 0; k < keyCount; ++k)
+			{
+				const float time = clip.duration * static_cast<float>(k) / static_cast<float>(keyCount - 1);
+				const float angle = 0.6f * sinf((Constants::TwoPi * time / clip.duration) + phase);
+				boneAnimation.rotationKeys.times.push_back(time);
+				boneAnimation.rotationKeys.values.push_back(Quaternion::RotationAxis({ 1.0f, 0.5f, 0.25f * static_cast<float>(c) }, angle));
+				if (b == 0)
+				{
+					boneAnimation.positionKeys.times.push_back(time);
+					boneAnimation.positionKeys.values.push_back({ 0.0f, 0.1f * sinf(angle), 0.0f });
+				}
+			}
+		}
+	}
+}
+
+// Vertices cycle through one to four influences, the mix a typical character has
+void GenerateSkinnedMesh(const Arguments& args, Model& model)
+{
+	const uint32_t boneCount = static_cast<uint32_t>(model.skeleton.bones.size());
+	Mesh& mesh = model.meshData.emplace_back().mesh;
+	mesh.vertices.resize(args.vertexCount);
+	uint32_t seed = 12345;
+	auto Random = [&seed]()
+	{
+		seed = (seed * 1664525u) + 1013904223u;
+		return static_cast<float>(seed >> 8) / static_cast<float>(1u << 24);
+	};
+	for (uint32_t i = 0; i < args.vertexCount; ++i)
+	{
+		Vertex& vertex = mesh.vertices[i];
+		vertex.position = { Random() * 4.0f - 2.0f, Random() * 8.0f, Random() * 4.0f - 2.0f };
+		vertex.normal = Normalize(Vector3{ Random() - 0.5f, Random() - 0.5f, Random() - 0.5f } + Vector3{ 0.0f, 0.01f, 0.0f });
+		vertex.tangent = Normalize(Cross(vertex.normal, { 0.36f, 0.48f, 0.8f }));
+		const int influenceCount = static_cast<int>(i % Vertex::MaxBoneWeights) + 1;
+		float weightSum = 0.0f;
+		for (int b = 0; b < influenceCount; ++b)
+		{
+			vertex.boneIndices[b] = static_cast<int>(Random() * static_cast<float>(boneCount)) % static_cast<int>(boneCount);
+			vertex.boneWeights[b] = 0.1f + Random();
+			weightSum += vertex.boneWeights[b];
+		}
+		for (int b = 0; b < influenceCount; ++b)
+		{
+			vertex.boneWeights[b] /= weightSum;
+		}
+	}
+	for (uint32_t i = 0; i + 2 < args.vertexCount; i += 3)
+	{
+		mesh.indices.insert(mesh.indices.end(), { i, i + 1, i + 2 });
+	}
+}
+
+bool LoadModel(const Arguments& args, Model& model)
+{
+	if (args.modelFileName.empty())
+	{
+		GenerateModel(args, model);
+		GenerateSkinnedMesh(args, model);
+		return true;
+	}
+
+	if (!ModelIO::LoadModelBinary(args.modelFileName, model))
+	{
+		ModelIO::LoadModel(args.modelFileName, model);
+	}
+	ModelIO::LoadSkeleton(args.modelFileName, model);
+	ModelIO::LoadAnimations(args.modelFileName, model);
+	if (model.skeleton.bones.empty() || model.animationClips.empty())
+	{
+		printf("%s has no skeleton or no animations\n", args.modelFileName.u8string().c_str());
+		return false;
+	}
+	if (model.meshData.empty())
+	{
+		GenerateSkinnedMesh(args, model);
+	}
+	return true;
+}
+
+// Straightforward evaluation with a binary search per channel, what the animator's cursors
+// have to agree with
+template<class T, class Blend>
+T SampleReference(const Keyframes<T>& keys, float time, Blend&& blend)
+{
+	const auto next = std::upper_bound(keys.times.begin(), keys.times.end(), time);
+	const uint32_t key = static_cast<uint32_t>(Max<ptrdiff_t>(0, (next - keys.times.begin()) - 1));
+	if (key + 1 >= keys.size())
+	{
+		return keys.values[key];
+	}
+
+	const float length = keys.times[key + 1] - keys.times[key];
+	const float t = (length > 0.0f) ? Clamp((time - keys.times[key]) / length, 0.0f, 1.0f) : 0.0f;
+	return blend(keys.values[key], keys.values[key + 1], t);
+}
+
+void EvaluateReference(const Model& model, uint32_t clipIndex, float time, std::vector<Matrix4>& skinTransforms)
+{
+	const std::vector<Bone>& bones = model.skeleton.bones;
+	const AnimationClip& clip = model.animationClips[clipIndex];
+	auto LerpVector = [](const Vector3& a, const Vector3& b, float t) { return a + ((b - a) * t); };
+
+	std::vector<Matrix4> boneTransforms(bones.size());
+	skinTransforms.resize(bones.size());
+	for (size_t i = 0; i < bones.size(); ++i)
+	{
+		Matrix4 local = bones[i].toParentTransform;
+		if (i < clip.boneAnimations.size() && !clip.boneAnimations[i].empty())
+		{
+			// Channels without keys keep the bind transform, the test skeletons carry no scale
+			const BoneAnimation& boneAnimation = clip.boneAnimations[i];
+			const Matrix4& bind = bones[i].toParentTransform;
+			Vector3 position = { bind._41, bind._42, bind._43 };
+			Quaternion rotation = Normalize(Quaternion::RotationMatrix(bind));
+			Vector3 scale = Vector3::One;
+			if (!boneAnimation.positionKeys.empty())
+			{
+				position = SampleReference(boneAnimation.positionKeys, time, LerpVector);
+			}
+			if (!boneAnimation.rotationKeys.empty())
+			{
+				rotation = SampleReference(boneAnimation.rotationKeys, time, Nlerp);
+			}
+			if (!boneAnimation.scaleKeys.empty())
+			{
+				scale = SampleReference(boneAnimation.scaleKeys, time, LerpVector);
+			}
+			local = Matrix4::Scaling(scale) * Matrix4::MatrixRotationQuaternion(rotation) * Matrix4::Translation(position);
+		}
+
+		const int parentIndex = bones[i].parentIndex;
+		boneTransforms[i] = (parentIndex >= 0) ? local * boneTransforms[parentIndex] : local;
+		skinTransforms[i] = bones[i].offsetTransform * boneTransforms[i];
+	}
+}
+
+float MaxError(const std::vector<Matrix4>& a, const std::vector<Matrix4>& b)
+{
+	float maxError = 0.0f;
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		for (size_t j = 0; j < a[i].v.size(); ++j)
+		{
+			maxError = Max(maxError, Abs(a[i].v[j] - b[i].v[j]));
+		}
+	}
+	return maxError;
+}
+
+void SkinReference(const std::vector<Vertex>& input, std::vector<Vertex>& output, const std::vector<Matrix4>& palette)
+{
+	for (size_t i = 0; i < input.size(); ++i)
+	{
+		const Vertex& vertex = input[i];
+		Matrix4 skin = Matrix4::Zero;
+		for (int b = 0; b < Vertex::MaxBoneWeights; ++b)
+		{
+			skin = skin + (palette[vertex.boneIndices[b]] * vertex.boneWeights[b]);
+		}
+		output[i].position = Scalar::TransformCoord(vertex.position, skin);
+		output[i].normal = Scalar::TransformNormal(vertex.normal, skin);
+		output[i].tangent = Scalar::TransformNormal(vertex.tangent, skin);
+	}
+}
+
+float MaxError(const std::vector<Vertex>& a, const std::vector<Vertex>& b)
+{
+	float maxError = 0.0f;
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		const Vector3 errors[] = { a[i].position - b[i].position, a[i].normal - b[i].normal, a[i].tangent - b[i].tangent };
+		for (const Vector3& error : errors)
+		{
+			maxError = Max(maxError, Max(Abs(error.x), Max(Abs(error.y), Abs(error.z))));
+		}
+	}
+	return maxError;
+}
+
+template<class Kernel>
+double MeasureSeconds(Kernel&& kernel)
+{
+	using Clock = std::chrono::steady_clock;
+	const auto start = Clock::now();
+	kernel();
+	return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void Report(const char* name, const Arguments& args, uint32_t boneCount, double seconds)
+{
+	const double poses = static_cast<double>(args.characterCount) * args.frameCount;
+	printf("%-22s %8.2f ms/frame  %10.0f poses/s  %7.2f M bones/s\n",
+		name, 1000.0 * seconds / args.frameCount, poses / seconds, poses * boneCount / seconds / 1000000.0);
+}
+
+void ReportVertices(const char* name, size_t vertexCount, uint32_t passCount, double seconds)
+{
+	const double vertices = static_cast<double>(vertexCount) * passCount;
+	printf("%-22s %8.3f ms/pass   %8.2f M vertices/s\n", name, 1000.0 * seconds / passCount, vertices / seconds / 1000000.0);
+}
+
+int main(int argc, char* argv[])
+{
+	const auto argOpt = parseArgs(argc, argv);
+	if (!argOpt.has_value())
+	{
+		printf("Usage: AnimationBenchmark [-model <file.model>] [-characters N] [-bones N] [-keys N] [-frames N] [-vertices N] [-passes N] [-threads N] [-tolerance T]\n");
+		return -1;
+	}
+	const Arguments& args = argOpt.value();
+
+	Model model;
+	if (!LoadModel(args, model))
+	{
+		return -1;
+	}
+
+	Core::JobSystem::StaticInitialize(args.threadCount);
+	const uint32_t boneCount = static_cast<uint32_t>(model.skeleton.bones.size());
+	const uint32_t clipCount = static_cast<uint32_t>(model.animationClips.size());
+	printf("%u characters, %u bones, %u clips, %u frames, %u worker threads\n",
+		args.characterCount, boneCount, clipCount, args.frameCount, Core::JobSystem::Get()->GetThreadCount());
+
+	// Characters start at different points of the clip so the cursors are not all in step
+	std::vector<Animator> animators(args.characterCount);
+	std::vector<Animator*> animatorPtrs(args.characterCount);
+	auto Restart = [&]()
+	{
+		for (uint32_t i = 0; i < args.characterCount; ++i)
+		{
+			animators[i].Initialize(model);
+			animators[i].PlayClip(i % clipCount, true);
+			animators[i].Update(FrameTime * static_cast<float>(i % 97));
+			animatorPtrs[i] = &animators[i];
+		}
+	};
+
+	bool passed = true;
+
+	// Playback has to match a search from scratch, across several loops of the clip
+	{
+		Animator animator;
+		animator.Initialize(model);
+		animator.PlayClip(0, true);
+		const float duration = model.animationClips[0].duration;
+		float time = 0.0f;
+		float maxError = 0.0f;
+		std::vector<Matrix4> reference;
+		for (uint32_t frame = 0; frame < args.frameCount; ++frame)
+		{
+			animator.Update(FrameTime);
+			time = fmodf(time + FrameTime, duration);
+			EvaluateReference(model, 0, time, reference);
+			maxError = Max(maxError, MaxError(animator.GetSkinTransforms(), reference));
+		}
+		const bool cursorPassed = maxError <= args.tolerance;
+		printf("%-22s max error %.2e %s\n", "Cursor vs search", maxError, cursorPassed ? "" : "FAILED");
+		passed &= cursorPassed;
+	}
+
+	Restart();
+	const double serialTime = MeasureSeconds([&]()
+	{
+		for (uint32_t frame = 0; frame < args.frameCount; ++frame)
+		{
+			for (Animator& animator : animators)
+			{
+				animator.Update(FrameTime);
+			}
+		}
+	});
+	Report("Single thread", args, boneCount, serialTime);
+
+	Restart();
+	const double parallelTime = MeasureSeconds([&]()
+	{
+		for (uint32_t frame = 0; frame < args.frameCount; ++frame)
+		{
+			Animator::UpdateAll(animatorPtrs.data(), args.characterCount, FrameTime);
+		}
+	});
+	Report("JobSystem", args, boneCount, parallelTime);
+
+	// Every character mid cross-fade, two clips sampled and blended per pose
+	Restart();
+	const float blendDuration = FrameTime * static_cast<float>(args.frameCount + 1);
+	for (uint32_t i = 0; i < args.characterCount; ++i)
+	{
+		animators[i].PlayClip((i + 1) % clipCount, true, blendDuration);
+	}
+	const double blendTime = MeasureSeconds([&]()
+	{
+		for (uint32_t frame = 0; frame < args.frameCount; ++frame)
+		{
+			Animator::UpdateAll(animatorPtrs.data(), args.characterCount, FrameTime);
+		}
+	});
+	Report("JobSystem cross-fade", args, boneCount, blendTime);
+	printf("Parallel speedup %.2fx\n", serialTime / parallelTime);
+
+	// Skinning, every mesh of the model with one character's palette per pass
+	Animator skinAnimator;
+	skinAnimator.Initialize(model);
+	skinAnimator.PlayClip(0, true);
+	skinAnimator.Update(0.25f);
+	const std::vector<Matrix4>& palette = skinAnimator.GetSkinTransforms();
+
+	size_t vertexCount = 0;
+	float skinError = 0.0f;
+	std::vector<std::vector<Vertex>> referenceVertices;
+	std::vector<std::vector<Vertex>> skinnedVertices;
+	for (const Model::MeshData& meshData : model.meshData)
+	{
+		vertexCount += meshData.mesh.vertices.size();
+		referenceVertices.push_back(meshData.mesh.vertices);
+		skinnedVertices.push_back(meshData.mesh.vertices);
+		SkinReference(meshData.mesh.vertices, referenceVertices.back(), palette);
+		SkinVertices(meshData.mesh.vertices, skinnedVertices.back(), palette);
+		skinError = Max(skinError, MaxError(referenceVertices.back(), skinnedVertices.back()));
+	}
+	const bool skinPassed = skinError <= args.tolerance;
+	printf("\n%zu vertices in %zu meshes, %u passes\n", vertexCount, model.meshData.size(), args.skinPassCount);
+	printf("%-22s max error %.2e %s\n", "SIMD vs reference", skinError, skinPassed ? "" : "FAILED");
+	passed &= skinPassed;
+
+	const double skinReferenceTime = MeasureSeconds([&]()
+	{
+		for (uint32_t pass = 0; pass < args.skinPassCount; ++pass)
+		{
+			for (size_t m = 0; m < model.meshData.size(); ++m)
+			{
+				SkinReference(model.meshData[m].mesh.vertices, referenceVertices[m], palette);
+			}
+		}
+	});
+	ReportVertices("Reference", vertexCount, args.skinPassCount, skinReferenceTime);
+
+	const double skinTime = MeasureSeconds([&]()
+	{
+		for (uint32_t pass = 0; pass < args.skinPassCount; ++pass)
+		{
+			for (size_t m = 0; m < model.meshData.size(); ++m)
+			{
+				SkinVertices(model.meshData[m].mesh.vertices, skinnedVertices[m], palette);
+			}
+		}
+	});
+	ReportVertices("SkinVertices", vertexCount, args.skinPassCount, skinTime);
+
+	// SkinnedMesh through the headless backend, split across the JobSystem and uploaded
+	// once per pose. The second Update stands in for the shadow pass and must be free
+	GraphicsSystem::StaticInitializeHeadless(1, 1);
+	SkinnedMesh skinnedMesh;
+	skinnedMesh.Initialize(model);
+	uint32_t skinCount = 0;
+	const double skinnedMeshTime = MeasureSeconds([&]()
+	{
+		for (uint32_t pass = 0; pass < args.skinPassCount; ++pass)
+		{
+			skinAnimator.Update(FrameTime);
+			skinCount += skinnedMesh.Update(skinAnimator) ? 1 : 0;
+			skinCount += skinnedMesh.Update(skinAnimator) ? 1 : 0;
+		}
+	});
+	ReportVertices("SkinnedMesh", vertexCount, args.skinPassCount, skinnedMeshTime);
+	const bool cachePassed = skinCount == args.skinPassCount;
+	printf("%-22s %u skins for %u poses %s\n", "Per pose cache", skinCount, args.skinPassCount, cachePassed ? "" : "FAILED");
+	passed &= cachePassed;
+	printf("SIMD speedup %.2fx\n", skinReferenceTime / skinTime);
+	skinnedMesh.Terminate();
+	GraphicsSystem::StaticTerminate();
+
+	Core::JobSystem::StaticTerminate();
+	return passed ? 0 : -1;
+}
\ No newline at end of file
@@ -0,0 +1,384 @@
+#include <Math/Inc/WinterMath.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+using namespace WinterEngine;
+using namespace WinterEngine::Math;
+
+struct Arguments
+{
+	uint32_t count = 4096;
+	uint32_t iterations = 200;
+	float tolerance = 1e-4f;
+};
+
+struct Inputs
+{
+	std::vector<Matrix4> matrices;
+	std::vector<Matrix4> affineMatrices;
+	std::vector<Vector3> vectors;
+	std::vector<Quaternion> rotations;
+	std::vector<Quaternion> otherRotations;
+	std::vector<Matrix4> rotationMatrices;	// same rotations as matrices
+	std::vector<float> weights;
+};
+
+// Kernels write complete results here so the compiler can't drop the parts nobody reads
+struct Outputs
+{
+	std::vector<Matrix4> matrices;
+	std::vector<Vector3> vectors;
+	std::vector<Quaternion> rotations;
+};
+
+std::optional<Arguments> parseArgs(int argc, char* argv[])
+{
+	Arguments args;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "-count") == 0 && i + 1 < argc)
+		{
+			args.count = static_cast<uint32_t>(atoi(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-iterations") == 0 && i + 1 < argc)
+		{
+			args.iterations = static_cast<uint32_t>(atoi(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-tolerance") == 0 && i + 1 < argc)
+		{
+			args.tolerance = static_cast<float>(atof(argv[++i]));
+		}
+		else
+		{
+			return std::nullopt;
+		}
+	}
+	if (args.count == 0 || args.iterations == 0)
+	{
+		return std::nullopt;
+	}
+	return args;
+}
+
+Inputs GenerateInputs(uint32_t count)
+{
+	std::mt19937 rng(330);
+	std::uniform_real_distribution<float> value(-2.0f, 2.0f);
+	std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+	std::uniform_real_distribution<float> weight(0.0f, 1.0f);
+
+	Inputs inputs;
+	inputs.matrices.resize(count);
+	inputs.affineMatrices.resize(count);
+	inputs.vectors.resize(count);
+	inputs.rotations.resize(count);
+	inputs.otherRotations.resize(count);
+	inputs.rotationMatrices.resize(count);
+	inputs.weights.resize(count);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		for (float& f : inputs.matrices[i].v)
+		{
+			f = value(rng);
+		}
+		inputs.affineMatrices[i] =
+			Matrix4::Scaling(scale(rng), scale(rng), scale(rng)) *
+			Matrix4::RotationAxis({ value(rng), value(rng), value(rng) }, value(rng)) *
+			Matrix4::Translation(value(rng), value(rng), value(rng));
+		inputs.vectors[i] = { value(rng), value(rng), value(rng) };
+		inputs.rotations[i] = Quaternion::RotationAxis({ value(rng), value(rng), value(rng) }, value(rng) * Constants::Pi);
+		inputs.otherRotations[i] = Quaternion::RotationAxis({ value(rng), value(rng), value(rng) }, value(rng) * Constants::Pi);
+		inputs.rotationMatrices[i] = Matrix4::MatrixRotationQuaternion(inputs.rotations[i]);
+		inputs.weights[i] = weight(rng);
+	}
+	return inputs;
+}
+
+float MaxError(const Matrix4& a, const Matrix4& b)
+{
+	float maxError = 0.0f;
+	for (size_t i = 0; i < a.v.size(); ++i)
+	{
+		maxError = Max(maxError, Abs(a.v[i] - b.v[i]));
+	}
+	return maxError;
+}
+
+float MaxError(const Vector3& a, const Vector3& b)
+{
+	return Max(Abs(a.x - b.x), Max(Abs(a.y - b.y), Abs(a.z - b.z)));
+}
+
+// q and -q are the same rotation
+float MaxError(const Quaternion& a, const Quaternion& b)
+{
+	const Quaternion c = (Dot(a, b) < 0.0f) ? -b : b;
+	return Max(Max(Abs(a.x - c.x), Abs(a.y - c.y)), Max(Abs(a.z - c.z), Abs(a.w - c.w)));
+}
+
+// Best of the iterations in nanoseconds per call
+template<class Kernel>
+double Measure(const Arguments& args, const Outputs& outputs, Kernel&& kernel)
+{
+	using Clock = std::chrono::steady_clock;
+	volatile float sink = 0.0f;
+	double best = std::numeric_limits<double>::max();
+	for (uint32_t iteration = 0; iteration < args.iterations; ++iteration)
+	{
+		const auto start = Clock::now();
+		for (uint32_t i = 0; i < args.count; ++i)
+		{
+			kernel(i);
+		}
+		const auto end = Clock::now();
+		sink = sink + outputs.matrices[iteration % args.count]._11 + outputs.vectors[iteration % args.count].x + outputs.rotations[iteration % args.count].w;
+		best = Min(best, std::chrono::duration<double, std::nano>(end - start).count() / args.count);
+	}
+	return best;
+}
+
+// Whole array per call, reported per element so it lines up with the single element kernels
+template<class Kernel>
+double MeasureBatch(const Arguments& args, const Outputs& outputs, Kernel&& kernel)
+{
+	using Clock = std::chrono::steady_clock;
+	volatile float sink = 0.0f;
+	double best = std::numeric_limits<double>::max();
+	for (uint32_t iteration = 0; iteration < args.iterations; ++iteration)
+	{
+		const auto start = Clock::now();
+		kernel();
+		const auto end = Clock::now();
+		sink = sink + outputs.vectors[iteration % args.count].x + outputs.rotations[iteration % args.count].w;
+		best = Min(best, std::chrono::duration<double, std::nano>(end - start).count() / args.count);
+	}
+	return best;
+}
+
+template<class ScalarKernel, class BatchKernel>
+bool RunBatchCase(const Arguments& args, Outputs& outputs, const char* name, ScalarKernel&& scalarKernel, BatchKernel&& batchKernel)
+{
+	std::vector<Vector3>& results = outputs.vectors;
+	std::vector<Vector3> reference(args.count);
+	for (uint32_t i = 0; i < args.count; ++i)
+	{
+		reference[i] = scalarKernel(i);
+	}
+	batchKernel();
+
+	float maxError = 0.0f;
+	for (uint32_t i = 0; i < args.count; ++i)
+	{
+		// Relative for projected points, w can get small
+		const float magnitude = Max(1.0f, Max(Abs(reference[i].x), Max(Abs(reference[i].y), Abs(reference[i].z))));
+		maxError = Max(maxError, MaxError(reference[i], results[i]) / magnitude);
+	}
+
+	const double scalarTime = MeasureBatch(args, outputs, [&]()
+	{
+		for (uint32_t i = 0; i < args.count; ++i)
+		{
+			results[i] = scalarKernel(i);
+		}
+	});
+	const double batchTime = MeasureBatch(args, outputs, batchKernel);
+	const bool passed = maxError <= args.tolerance;
+	printf("%-16s scalar %7.2f ns  batch %6.2f ns  speedup %5.2fx  max error %.2e %s\n",
+		name, scalarTime, batchTime, scalarTime / batchTime, maxError, passed ? "" : "FAILED");
+	return passed;
+}
+
+template<class ScalarKernel, class BatchKernel>
+bool RunBlendCase(const Arguments& args, Outputs& outputs, const char* name, ScalarKernel&& scalarKernel, BatchKernel&& batchKernel)
+{
+	std::vector<Quaternion>& results = outputs.rotations;
+	std::vector<Quaternion> reference(args.count);
+	for (uint32_t i = 0; i < args.count; ++i)
+	{
+		reference[i] = scalarKernel(i);
+	}
+	batchKernel();
+
+	float maxError = 0.0f;
+	for (uint32_t i = 0; i < args.count; ++i)
+	{
+		maxError = Max(maxError, MaxError(reference[i], results[i]));
+	}
+
+	const double scalarTime = MeasureBatch(args, outputs, [&]()
+	{
+		for (uint32_t i = 0; i < args.count; ++i)
+		{
+			results[i] = scalarKernel(i);
+		}
+	});
+	const double batchTime = MeasureBatch(args, outputs, batchKernel);
+	const bool passed = maxError <= args.tolerance;
+	printf("%-16s scalar %7.2f ns  batch %6.2f ns  speedup %5.2fx  max error %.2e %s\n",
+		name, scalarTime, batchTime, scalarTime / batchTime, maxError, passed ? "" : "FAILED");
+	return passed;
+}
+
+// Quaternion operations timed against the Matrix4 operation they replace
+template<class MatrixKernel, class QuaternionKernel, class Compare>
+bool RunQuaternionCase(const Arguments& args, const Outputs& outputs, const char* name, MatrixKernel&& matrixKernel, QuaternionKernel&& quaternionKernel, Compare&& compare)
+{
+	float maxError = 0.0f;
+	for (uint32_t i = 0; i < args.count; ++i)
+	{
+		maxError = Max(maxError, compare(i));
+	}
+
+	const double matrixTime = Measure(args, outputs, matrixKernel);
+	const double quaternionTime = Measure(args, outputs, quaternionKernel);
+	const bool passed = maxError <= args.tolerance;
+	printf("%-16s matrix %7.2f ns  quat %7.2f ns  speedup %5.2fx  max error %.2e %s\n",
+		name, matrixTime, quaternionTime, matrixTime / quaternionTime, maxError, passed ? "" : "FAILED");
+	return passed;
+}
+
+template<class ScalarKernel, class SIMDKernel, class Compare>
+bool RunCase(const Arguments& args, const Outputs& outputs, const char* name, ScalarKernel&& scalarKernel, SIMDKernel&& simdKernel, Compare&& compare)
+{
+	float maxError = 0.0f;
+	for (uint32_t i = 0; i < args.count; ++i)
+	{
+		maxError = Max(maxError, compare(i));
+	}
+
+	const double scalarTime = Measure(args, outputs, scalarKernel);
+	const double simdTime = Measure(args, outputs, simdKernel);
+	const bool passed = maxError <= args.tolerance;
+	printf("%-16s scalar %7.2f ns  simd %7.2f ns  speedup %5.2fx  max error %.2e %s\n",
+		name, scalarTime, simdTime, scalarTime / simdTime, maxError, passed ? "" : "FAILED");
+	return passed;
+}
+
+int main(int argc, char* argv[])
+{
+	const auto argOpt = parseArgs(argc, argv);
+	if (!argOpt.has_value())
+	{
+		printf("Usage: MathBenchmark [-count N] [-iterations N] [-tolerance T]\n");
+		return -1;
+	}
+
+#if !defined(WINTER_MATH_SSE)
+	printf("Math SIMD kernels are disabled in this build, nothing to compare\n");
+	return 0;
+#else
+	const Arguments& args = argOpt.value();
+	const Inputs inputs = GenerateInputs(args.count);
+	const auto& m = inputs.matrices;
+	const auto& affine = inputs.affineMatrices;
+	const auto& v = inputs.vectors;
+	const uint32_t last = args.count - 1;
+
+	Outputs outputs;
+	outputs.matrices.resize(args.count);
+	outputs.vectors.resize(args.count);
+	outputs.rotations.resize(args.count);
+	auto& outM = outputs.matrices;
+	auto& outV = outputs.vectors;
+	auto& outQ = outputs.rotations;
+
+#if defined(WINTER_MATH_AVX)
+	printf("Matrix4 kernels: AVX, %u inputs, best of %u runs\n", args.count, args.iterations);
+#else
+	printf("Matrix4 kernels: SSE, %u inputs, best of %u runs\n", args.count, args.iterations);
+#endif
+
+	bool passed = true;
+	passed &= RunCase(args, outputs, "Multiply",
+		[&](uint32_t i) { outM[i] = Scalar::Multiply(m[i], m[last - i]); },
+		[&](uint32_t i) { outM[i] = SIMD::Multiply(m[i], m[last - i]); },
+		[&](uint32_t i) { return MaxError(Scalar::Multiply(m[i], m[last - i]), SIMD::Multiply(m[i], m[last - i])); });
+	passed &= RunCase(args, outputs, "Transpose",
+		[&](uint32_t i) { outM[i] = Scalar::Transpose(m[i]); },
+		[&](uint32_t i) { outM[i] = SIMD::Transpose(m[i]); },
+		[&](uint32_t i) { return MaxError(Scalar::Transpose(m[i]), SIMD::Transpose(m[i])); });
+	passed &= RunCase(args, outputs, "TransformCoord",
+		[&](uint32_t i) { outV[i] = Scalar::TransformCoord(v[i], m[i]); },
+		[&](uint32_t i) { outV[i] = SIMD::TransformCoord(v[i], m[i]); },
+		[&](uint32_t i) { return MaxError(Scalar::TransformCoord(v[i], m[i]), SIMD::TransformCoord(v[i], m[i])); });
+	passed &= RunCase(args, outputs, "TransformNormal",
+		[&](uint32_t i) { outV[i] = Scalar::TransformNormal(v[i], m[i]); },
+		[&](uint32_t i) { outV[i] = SIMD::TransformNormal(v[i], m[i]); },
+		[&](uint32_t i) { return MaxError(Scalar::TransformNormal(v[i], m[i]), SIMD::TransformNormal(v[i], m[i])); });
+	passed &= RunCase(args, outputs, "InverseAffine",
+		[&](uint32_t i) { outM[i] = Scalar::InverseAffine(affine[i]); },
+		[&](uint32_t i) { outM[i] = SIMD::InverseAffine(affine[i]); },
+		[&](uint32_t i) { return MaxError(Scalar::InverseAffine(affine[i]), SIMD::InverseAffine(affine[i])); });
+
+	// Batch calls against a per element loop over the scalar reference
+	const Matrix4& batchMatrix = m[0];
+	passed &= RunBatchCase(args, outputs, "TransformCoords",
+		[&](uint32_t i) { return Scalar::TransformCoord(v[i], batchMatrix); },
+		[&]() { TransformCoords(v.data(), outV.data(), args.count, batchMatrix); });
+	passed &= RunBatchCase(args, outputs, "TransformNormals",
+		[&](uint32_t i) { return Scalar::TransformNormal(v[i], batchMatrix); },
+		[&]() { TransformNormals(v.data(), outV.data(), args.count, batchMatrix); });
+
+	// Random matrices can put w near zero, so projection is measured with a camera looking at the points
+	const float yScale = 1.0f / std::tan(Constants::Pi / 6.0f);
+	const float nearPlane = 0.1f;
+	const float farPlane = 100.0f;
+	const float zScale = farPlane / (farPlane - nearPlane);
+	const Matrix4 viewProjection = Matrix4::Translation(0.0f, 0.0f, 5.0f) * Matrix4(
+		yScale / 1.78f, 0.0f, 0.0f, 0.0f,
+		0.0f, yScale, 0.0f, 0.0f,
+		0.0f, 0.0f, zScale, 1.0f,
+		0.0f, 0.0f, -nearPlane * zScale, 0.0f);
+	passed &= RunBatchCase(args, outputs, "ProjectCoords",
+		[&](uint32_t i)
+		{
+			const float w = v[i].x * viewProjection._14 + v[i].y * viewProjection._24 + v[i].z * viewProjection._34 + viewProjection._44;
+			return Scalar::TransformCoord(v[i], viewProjection) / w;
+		},
+		[&]() { ProjectCoords(v.data(), outV.data(), args.count, viewProjection); });
+
+	// Quaternion operations, checked against the matrix they stand in for
+	const auto& q = inputs.rotations;
+	const auto& otherQ = inputs.otherRotations;
+	const auto& rm = inputs.rotationMatrices;
+	const auto& weights = inputs.weights;
+	passed &= RunQuaternionCase(args, outputs, "Quat Multiply",
+		[&](uint32_t i) { outM[i] = rm[i] * rm[last - i]; },
+		[&](uint32_t i) { outQ[i] = q[i] * q[last - i]; },
+		[&](uint32_t i) { return MaxError(Matrix4::MatrixRotationQuaternion(q[i] * q[last - i]), rm[i] * rm[last - i]); });
+	passed &= RunQuaternionCase(args, outputs, "Quat Rotate",
+		[&](uint32_t i) { outV[i] = TransformNormal(v[i], rm[i]); },
+		[&](uint32_t i) { outV[i] = Rotate(v[i], q[i]); },
+		[&](uint32_t i) { return MaxError(Rotate(v[i], q[i]), TransformNormal(v[i], rm[i])); });
+	passed &= RunQuaternionCase(args, outputs, "Quat Inverse",
+		[&](uint32_t i) { outM[i] = Transpose(rm[i]); },
+		[&](uint32_t i) { outQ[i] = Inverse(q[i]); },
+		[&](uint32_t i) { return MaxError(q[i] * Inverse(q[i]), Quaternion::Identity); });
+	passed &= RunQuaternionCase(args, outputs, "Quat To/From M",
+		[&](uint32_t i) { outM[i] = Matrix4::MatrixRotationQuaternion(q[i]); },
+		[&](uint32_t i) { outQ[i] = Quaternion::RotationMatrix(rm[i]); },
+		[&](uint32_t i) { return MaxError(Quaternion::RotationMatrix(rm[i]), q[i]); });
+
+	// Batch blends against per element calls, the fast slerp is checked against the exact one
+	passed &= RunBlendCase(args, outputs, "NlerpQuaternions",
+		[&](uint32_t i) { return Nlerp(q[i], otherQ[i], weights[i]); },
+		[&]() { NlerpQuaternions(q.data(), otherQ.data(), weights.data(), outQ.data(), args.count); });
+	passed &= RunBlendCase(args, outputs, "SlerpQuaternions",
+		[&](uint32_t i) { return Slerp(q[i], otherQ[i], weights[i]); },
+		[&]() { SlerpQuaternions(q.data(), otherQ.data(), weights.data(), outQ.data(), args.count); });
+
+	// The inverse has to undo the original, not just agree with the scalar version
+	float roundTripError = 0.0f;
+	for (uint32_t i = 0; i < args.count; ++i)
+	{
+		roundTripError = Max(roundTripError, MaxError(affine[i] * InverseAffine(affine[i]), Matrix4::Identity));
+	}
+	const bool roundTripPassed = roundTripError <= args.tolerance;
+	printf("%-16s max error %.2e %s\n", "M * Inverse(M)", roundTripError, roundTripPassed ? "" : "FAILED");
+	passed &= roundTripPassed;
+
+	return passed ? 0 : -1;
+#endif
+}
\ No newline at end of file
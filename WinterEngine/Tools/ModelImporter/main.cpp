@@ -1,10 +1,13 @@
 #include <WinterEngine/Inc/WinterEngine.h>
 
+#include <assimp/DefaultIOSystem.h>
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
+#include <cstdarg>
 #include <cstdio>
+#include <set>
 
 using namespace WinterEngine;
 using namespace WinterEngine::Graphics;
@@ -15,8 +18,41 @@ struct Arguments
 	std::filesystem::path inputFileName;
 	std::filesystem::path outputFileName;
 	float scale = 1.0f;
+	bool compress = false;
+	bool optimize = true;
+	uint32_t lodCount = 0;
+	uint32_t jobCount = 0;
+	bool force = false;
+	std::filesystem::path cacheDirectory;
+	int pruneCacheDays = -1;
 };
 
+constexpr uint32_t ImportFlags = aiProcessPreset_TargetRealtime_Quality | aiProcess_ConvertToLeftHanded;
+
+// Bump whenever the importer output changes so older cook cache entries stop matching
+constexpr uint32_t CookVersion = 8;
+
+// Batch imports run concurrently, each job collects its output and prints it in one piece
+thread_local std::string* tLogBuffer = nullptr;
+
+void Print(const char* format, ...)
+{
+	char buffer[1024];
+	va_list args;
+	va_start(args, format);
+	vsnprintf(buffer, sizeof(buffer), format, args);
+	va_end(args);
+
+	if (tLogBuffer != nullptr)
+	{
+		*tLogBuffer += buffer;
+	}
+	else
+	{
+		fputs(buffer, stdout);
+	}
+}
+
 Vector3 ToVector3(const aiVector3D& v)
 {
 	return {
@@ -34,6 +70,17 @@ Vector2 ToTexCoord(const aiVector3D& v)
 	};
 }
 
+// assimp matrices are column vector, the engine multiplies row vectors
+Matrix4 ToMatrix4(const aiMatrix4x4& m, float scale)
+{
+	return {
+		static_cast<float>(m.a1), static_cast<float>(m.b1), static_cast<float>(m.c1), static_cast<float>(m.d1),
+		static_cast<float>(m.a2), static_cast<float>(m.b2), static_cast<float>(m.c2), static_cast<float>(m.d2),
+		static_cast<float>(m.a3), static_cast<float>(m.b3), static_cast<float>(m.c3), static_cast<float>(m.d3),
+		static_cast<float>(m.a4) * scale, static_cast<float>(m.b4) * scale, static_cast<float>(m.c4) * scale, static_cast<float>(m.d4)
+	};
+}
+
 Color ToColor(const aiColor3D& c)
 {
 	return {
@@ -61,33 +108,332 @@ std::optional<Arguments> parseArgs(int argc, char* argv[])
 			args.scale = atof(argv[i + 1]);
 			++i;
 		}
+		else if (strcmp(argv[i], "-compress") == 0)
+		{
+			args.compress = true;
+		}
+		else if (strcmp(argv[i], "-nooptimize") == 0)
+		{
+			args.optimize = false;
+		}
+		else if (strcmp(argv[i], "-lods") == 0)
+		{
+			args.lodCount = static_cast<uint32_t>(atoi(argv[i + 1]));
+			++i;
+		}
+		else if (strcmp(argv[i], "-jobs") == 0)
+		{
+			args.jobCount = static_cast<uint32_t>(atoi(argv[i + 1]));
+			++i;
+		}
+		else if (strcmp(argv[i], "-force") == 0)
+		{
+			args.force = true;
+		}
+		else if (strcmp(argv[i], "-cache") == 0)
+		{
+			args.cacheDirectory = argv[i + 1];
+			++i;
+		}
+		else if (strcmp(argv[i], "-prunecache") == 0)
+		{
+			args.pruneCacheDays = atoi(argv[i + 1]);
+			++i;
+		}
 	}
 
 	return args;
 }
 
-void ExportEmbeddedTexture(const aiTexture* texture, const Arguments& args, const std::filesystem::path& fileName)
+using BoneIndexLookup = std::map<std::string, int>;
+
+// One bone per node so animated nodes without skin weights keep their place in the hierarchy
+int BuildSkeleton(const aiNode* node, int parentIndex, Skeleton& skeleton, BoneIndexLookup& boneIndexLookup, float scale)
+{
+	const int boneIndex = static_cast<int>(skeleton.bones.size());
+	Bone& bone = skeleton.bones.emplace_back();
+	bone.index = boneIndex;
+	bone.parentIndex = parentIndex;
+	bone.name = node->mName.C_Str();
+	if (bone.name.empty())
+	{
+		bone.name = "NoName" + std::to_string(boneIndex);
+	}
+	bone.toParentTransform = ToMatrix4(node->mTransformation, scale);
+	boneIndexLookup.emplace(bone.name, boneIndex);
+
+	if (parentIndex >= 0)
+	{
+		skeleton.bones[parentIndex].childIndices.push_back(boneIndex);
+	}
+
+	for (uint32_t i = 0; i < node->mNumChildren; ++i)
+	{
+		BuildSkeleton(node->mChildren[i], boneIndex, skeleton, boneIndexLookup, scale);
+	}
+	return boneIndex;
+}
+
+// Keeps the 4 strongest influences per vertex and renormalizes them to sum to 1
+void ReadBoneWeights(const aiMesh* aiMesh, Skeleton& skeleton, BoneIndexLookup& boneIndexLookup, float scale, Mesh& mesh)
+{
+	std::vector<std::vector<std::pair<int, float>>> influences(mesh.vertices.size());
+	for (uint32_t b = 0; b < aiMesh->mNumBones; ++b)
+	{
+		const aiBone* aiBone = aiMesh->mBones[b];
+		auto iter = boneIndexLookup.find(aiBone->mName.C_Str());
+		if (iter == boneIndexLookup.end())
+		{
+			// Bone without a node, hang it off the root
+			Bone& bone = skeleton.bones.emplace_back();
+			bone.index = static_cast<int>(skeleton.bones.size()) - 1;
+			bone.parentIndex = skeleton.rootIndex;
+			bone.name = aiBone->mName.C_Str();
+			skeleton.bones[skeleton.rootIndex].childIndices.push_back(bone.index);
+			iter = boneIndexLookup.emplace(bone.name, bone.index).first;
+		}
+
+		const int boneIndex = iter->second;
+		skeleton.bones[boneIndex].offsetTransform = ToMatrix4(aiBone->mOffsetMatrix, scale);
+		for (uint32_t w = 0; w < aiBone->mNumWeights; ++w)
+		{
+			const aiVertexWeight& weight = aiBone->mWeights[w];
+			if (weight.mVertexId < influences.size() && weight.mWeight > 0.0f)
+			{
+				influences[weight.mVertexId].emplace_back(boneIndex, static_cast<float>(weight.mWeight));
+			}
+		}
+	}
+
+	uint32_t truncatedCount = 0;
+	for (size_t v = 0; v < influences.size(); ++v)
+	{
+		auto& vertexInfluences = influences[v];
+		std::sort(vertexInfluences.begin(), vertexInfluences.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+		if (vertexInfluences.size() > Vertex::MaxBoneWeights)
+		{
+			vertexInfluences.resize(Vertex::MaxBoneWeights);
+			++truncatedCount;
+		}
+
+		float weightSum = 0.0f;
+		for (const auto& influence : vertexInfluences)
+		{
+			weightSum += influence.second;
+		}
+
+		// Unweighted vertices of a skinned mesh follow the root
+		if (vertexInfluences.empty())
+		{
+			vertexInfluences.emplace_back(skeleton.rootIndex, 1.0f);
+			weightSum = 1.0f;
+		}
+
+		Vertex& vertex = mesh.vertices[v];
+		for (size_t i = 0; i < vertexInfluences.size(); ++i)
+		{
+			vertex.boneIndices[i] = vertexInfluences[i].first;
+			vertex.boneWeights[i] = vertexInfluences[i].second / weightSum;
+		}
+	}
+
+	if (truncatedCount > 0)
+	{
+		Print("  %u vertices had more than %d influences\n", truncatedCount, Vertex::MaxBoneWeights);
+	}
+}
+
+// Bone of the node that places each mesh, the first one when a mesh is instanced. Walks the
+// nodes in the same order as BuildSkeleton so the bone index is the visit count
+void FindMeshBones(const aiNode* node, int& boneIndex, std::vector<int>& meshBones)
+{
+	const int nodeBoneIndex = boneIndex++;
+	for (uint32_t i = 0; i < node->mNumMeshes; ++i)
+	{
+		if (meshBones[node->mMeshes[i]] < 0)
+		{
+			meshBones[node->mMeshes[i]] = nodeBoneIndex;
+		}
+	}
+	for (uint32_t i = 0; i < node->mNumChildren; ++i)
+	{
+		FindMeshBones(node->mChildren[i], boneIndex, meshBones);
+	}
+}
+
+// A mesh without bones in a skinned scene (a prop, the eyes) is drawn skinned with the rest of
+// the model, so every vertex follows the bone of the node that places it with full weight. Its
+// vertices are in that node's space, which a bone that also deforms skin would undo with its
+// offset transform, so such a node gets a child bone with identity transforms for its meshes
+void BindRigidMesh(int nodeBoneIndex, const std::set<std::string>& skinBoneNames, Skeleton& skeleton, BoneIndexLookup& boneIndexLookup, Mesh& mesh)
+{
+	int boneIndex = skeleton.rootIndex;
+	if (nodeBoneIndex >= 0)
+	{
+		boneIndex = nodeBoneIndex;
+		const std::string nodeName = skeleton.bones[boneIndex].name;
+		if (skinBoneNames.count(nodeName) > 0)
+		{
+			const std::string rigidName = nodeName + "_Rigid";
+			auto iter = boneIndexLookup.find(rigidName);
+			if (iter == boneIndexLookup.end())
+			{
+				Bone& bone = skeleton.bones.emplace_back();
+				bone.index = static_cast<int>(skeleton.bones.size()) - 1;
+				bone.parentIndex = boneIndex;
+				bone.name = rigidName;
+				skeleton.bones[boneIndex].childIndices.push_back(bone.index);
+				iter = boneIndexLookup.emplace(rigidName, bone.index).first;
+			}
+			boneIndex = iter->second;
+		}
+	}
+
+	for (Vertex& vertex : mesh.vertices)
+	{
+		vertex.boneIndices[0] = boneIndex;
+		vertex.boneWeights[0] = 1.0f;
+	}
+}
+
+// One clip per assimp animation, channels for nodes outside the skeleton are dropped
+void ReadAnimations(const aiScene* scene, const BoneIndexLookup& boneIndexLookup, uint32_t boneCount, float scale, Model& model)
+{
+	for (uint32_t animationIndex = 0; animationIndex < scene->mNumAnimations; ++animationIndex)
+	{
+		const aiAnimation* aiAnimation = scene->mAnimations[animationIndex];
+		// assimp leaves this at 0 when the file does not say
+		const float ticksPerSecond = (aiAnimation->mTicksPerSecond > 0.0) ? static_cast<float>(aiAnimation->mTicksPerSecond) : 25.0f;
+
+		AnimationClip& clip = model.animationClips.emplace_back();
+		clip.name = aiAnimation->mName.C_Str();
+		if (clip.name.empty())
+		{
+			clip.name = "Clip" + std::to_string(animationIndex);
+		}
+		clip.duration = static_cast<float>(aiAnimation->mDuration) / ticksPerSecond;
+		clip.boneAnimations.resize(boneCount);
+
+		uint32_t skippedCount = 0;
+		for (uint32_t c = 0; c < aiAnimation->mNumChannels; ++c)
+		{
+			const aiNodeAnim* channel = aiAnimation->mChannels[c];
+			auto iter = boneIndexLookup.find(channel->mNodeName.C_Str());
+			if (iter == boneIndexLookup.end())
+			{
+				++skippedCount;
+				continue;
+			}
+
+			BoneAnimation& boneAnimation = clip.boneAnimations[iter->second];
+			for (uint32_t k = 0; k < channel->mNumPositionKeys; ++k)
+			{
+				const aiVectorKey& key = channel->mPositionKeys[k];
+				boneAnimation.positionKeys.times.push_back(static_cast<float>(key.mTime) / ticksPerSecond);
+				boneAnimation.positionKeys.values.push_back(ToVector3(key.mValue) * scale);
+			}
+			for (uint32_t k = 0; k < channel->mNumRotationKeys; ++k)
+			{
+				const aiQuatKey& key = channel->mRotationKeys[k];
+				boneAnimation.rotationKeys.times.push_back(static_cast<float>(key.mTime) / ticksPerSecond);
+				boneAnimation.rotationKeys.values.push_back({
+					static_cast<float>(key.mValue.x),
+					static_cast<float>(key.mValue.y),
+					static_cast<float>(key.mValue.z),
+					static_cast<float>(key.mValue.w) });
+			}
+			for (uint32_t k = 0; k < channel->mNumScalingKeys; ++k)
+			{
+				const aiVectorKey& key = channel->mScalingKeys[k];
+				boneAnimation.scaleKeys.times.push_back(static_cast<float>(key.mTime) / ticksPerSecond);
+				boneAnimation.scaleKeys.values.push_back(ToVector3(key.mValue));
+			}
+		}
+
+		Print("  %s: %.2f seconds, %u channels", clip.name.c_str(), clip.duration, aiAnimation->mNumChannels - skippedCount);
+		if (skippedCount > 0)
+		{
+			Print(", %u without a bone skipped", skippedCount);
+		}
+		Print("\n");
+	}
+}
+
+void PrintMeshStats(const char* label, const Mesh& mesh)
 {
-	printf("Extracting embedded texture %s\n", fileName.u8string().c_str());
+	const uint32_t vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+	const MeshOptimizer::VertexCacheStats cacheStats = MeshOptimizer::AnalyzeVertexCache(mesh.indices, vertexCount);
+	const MeshOptimizer::VertexFetchStats fetchStats = MeshOptimizer::AnalyzeVertexFetch(mesh.indices, vertexCount, sizeof(Vertex));
+	Print("  %s: %u vertices, ACMR %.3f, ATVR %.3f, overfetch %.3f\n",
+		label, vertexCount, cacheStats.acmr, cacheStats.atvr, fetchStats.overfetch);
+}
 
-	std::string fullFileName = args.outputFileName.u8string();
-	fullFileName = fullFileName.substr(0, fullFileName.rfind("/") + 1);
-	fullFileName += fileName.filename().u8string();
+void OptimizeMesh(Mesh& mesh)
+{
+	Print("Optimizing Mesh...\n");
+	PrintMeshStats("before", mesh);
+
+	const uint32_t welded = MeshOptimizer::WeldVertices(mesh);
+	MeshOptimizer::OptimizeVertexCache(mesh);
+	MeshOptimizer::OptimizeVertexFetch(mesh);
+
+	Print("  welded %u duplicate vertices\n", welded);
+	PrintMeshStats("after", mesh);
+}
+
+// Each level targets half the triangles of the previous one, stops early once the
+// simplifier can't reduce any further
+void GenerateLODs(Model::MeshData& meshData, uint32_t lodCount)
+{
+	Print("Generating LODs...\n");
+	Print("  LOD0: %u triangles\n", static_cast<uint32_t>(meshData.mesh.indices.size() / 3));
+
+	constexpr float MaxError = 0.05f;
+	uint32_t previousIndexCount = static_cast<uint32_t>(meshData.mesh.indices.size());
+	for (uint32_t level = 1; level <= lodCount; ++level)
+	{
+		const uint32_t targetIndexCount = (previousIndexCount / 6) * 3;
+		const auto startTime = std::chrono::high_resolution_clock::now();
+
+		Model::LOD lod;
+		lod.indices = MeshOptimizer::Simplify(meshData.mesh, targetIndexCount, MaxError, &lod.error);
+		MeshOptimizer::OptimizeVertexCache(lod.indices, static_cast<uint32_t>(meshData.mesh.vertices.size()));
+
+		const auto endTime = std::chrono::high_resolution_clock::now();
+		const double milliseconds = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+		Print("  LOD%u: %u triangles, error %.4f, %.2f ms\n",
+			level, static_cast<uint32_t>(lod.indices.size() / 3), lod.error, milliseconds);
+
+		if (lod.indices.empty() || lod.indices.size() >= previousIndexCount)
+		{
+			break;
+		}
+		previousIndexCount = static_cast<uint32_t>(lod.indices.size());
+		meshData.lods.push_back(std::move(lod));
+	}
+}
+
+void ExportEmbeddedTexture(const aiTexture* texture, const Arguments& args, const std::filesystem::path& fileName, std::vector<std::filesystem::path>& outputFiles)
+{
+	Print("Extracting embedded texture %s\n", fileName.u8string().c_str());
+
+	const std::string fullFileName = (args.outputFileName.parent_path() / fileName.filename()).u8string();
 
 	FILE* file = nullptr;
 	auto err = fopen_s(&file, fullFileName.c_str(), "wb");
 	if (err != 0 || file == nullptr)
 	{
-		printf("Error: failed to open file %s for saving \n", fullFileName.c_str());
+		Print("Error: failed to open file %s for saving \n", fullFileName.c_str());
 		return; 
 	}
 
 	size_t written = fwrite(texture->pcData, 1, texture->mWidth, file);
 	ASSERT(written == texture->mWidth, "Error, failed to extract embedded texture");
 	fclose(file);
+	outputFiles.push_back(fullFileName);
 }
 
-std::string FindTexture(const aiScene* scene, const aiMaterial* aiMaterial, aiTextureType textureType, const Arguments& args, const std::string& suffix, uint32_t materialIndex)
+std::string FindTexture(const aiScene* scene, const aiMaterial* aiMaterial, aiTextureType textureType, const Arguments& args, const std::string& suffix, uint32_t materialIndex, std::vector<std::filesystem::path>& outputFiles)
 {
 	const uint32_t textureCount = aiMaterial->GetTextureCount(textureType);
 	if (textureCount == 0)
@@ -127,8 +473,8 @@ std::string FindTexture(const aiScene* scene, const aiMaterial* aiMaterial, aiTe
 				ASSERT(false, "Error: unrecognized texture format");
 			}
 
-			ExportEmbeddedTexture(embeddedTexture, args, fileName);
-			printf("Adding texture %s\n", fileName.c_str());
+			ExportEmbeddedTexture(embeddedTexture, args, fileName, outputFiles);
+			Print("Adding texture %s\n", fileName.c_str());
 			textureName = fileName;
 		}
 		else if (auto embeddedTexture = scene->GetEmbeddedTexture(texturePath.C_Str()); embeddedTexture)
@@ -140,8 +486,8 @@ std::string FindTexture(const aiScene* scene, const aiMaterial* aiMaterial, aiTe
 			fileName += "_" + std::to_string(materialIndex);
 			fileName += embeddedFilePath.extension().u8string();
 
-			ExportEmbeddedTexture(embeddedTexture, args, fileName);
-			printf("Adding texture %s\n", fileName.c_str());
+			ExportEmbeddedTexture(embeddedTexture, args, fileName, outputFiles);
+			Print("Adding texture %s\n", fileName.c_str());
 			textureName = fileName;
 		}
 		else
@@ -149,7 +495,7 @@ std::string FindTexture(const aiScene* scene, const aiMaterial* aiMaterial, aiTe
 			std::filesystem::path filePath = texturePath.C_Str();
 			std::string fileName = filePath.filename().u8string();
 
-			printf("Adding texture %s\n", fileName.c_str());
+			Print("Adding texture %s\n", fileName.c_str());
 			textureName = fileName;
 		}
 
@@ -158,37 +504,160 @@ std::string FindTexture(const aiScene* scene, const aiMaterial* aiMaterial, aiTe
 	return textureName.filename().u8string();
 }
 
-int main(int argc, char* argv[])
+// Compact meshes store normals and tangents octahedral encoded, check the axes and the
+// octant corners come back pointing the same way and a zero vector stays zero
+bool ValidateOctahedral(float tolerance = 0.001f)
 {
-	const auto argOpt = parseArgs(argc, argv);
-	if (!argOpt.has_value())
+	std::vector<Vector3> directions = { Vector3::XAxis, Vector3::YAxis, Vector3::ZAxis, -Vector3::XAxis, -Vector3::YAxis, -Vector3::ZAxis };
+	for (int corner = 0; corner < 8; ++corner)
 	{
-		printf("Not enough arguments, import fbx failed!\n");
-		return -1;
+		const float x = (corner & 1) ? -1.0f : 1.0f;
+		const float y = (corner & 2) ? -1.0f : 1.0f;
+		const float z = (corner & 4) ? -1.0f : 1.0f;
+		directions.push_back(Normalize(Vector3{ x, y, z }));
 	}
 
-	printf("Begin Import\n");
-	const Arguments& args = argOpt.value();
+	bool valid = true;
+	int16_t encoded[2] = {};
+	for (const Vector3& direction : directions)
+	{
+		VertexCompression::EncodeOctahedral(direction, encoded);
+		const Vector3 decoded = VertexCompression::DecodeOctahedral(encoded);
+		if (Dot(decoded, direction) < 1.0f - tolerance)
+		{
+			Print("  (%.3f %.3f %.3f) -> [%d %d] -> (%.3f %.3f %.3f)\n",
+				direction.x, direction.y, direction.z, encoded[0], encoded[1], decoded.x, decoded.y, decoded.z);
+			valid = false;
+		}
+	}
+
+	VertexCompression::EncodeOctahedral(Vector3::Zero, encoded);
+	const Vector3 decoded = VertexCompression::DecodeOctahedral(encoded);
+	if (decoded.x != 0.0f || decoded.y != 0.0f || decoded.z != 0.0f)
+	{
+		Print("  zero vector -> [%d %d] -> (%.3f %.3f %.3f)\n", encoded[0], encoded[1], decoded.x, decoded.y, decoded.z);
+		valid = false;
+	}
+	return valid;
+}
+
+// Everything besides the source bytes that changes what an import writes
+std::string GetCookSettings(const Arguments& args)
+{
+	char settings[512];
+	snprintf(settings, sizeof(settings), "v%u flags=%u scale=%f optimize=%d lods=%u compress=%d output=%s",
+		CookVersion, ImportFlags, args.scale, args.optimize ? 1 : 0, args.lodCount, args.compress ? 1 : 0,
+		args.outputFileName.filename().u8string().c_str());
+	return settings;
+}
+
+// <name>.cookstamp holds the settings the outputs next to it were imported with, so a batch
+// doesn't skip outputs from an older importer or different settings as up to date
+std::filesystem::path GetCookStampPath(std::filesystem::path outputFileName)
+{
+	return outputFileName.replace_extension("cookstamp");
+}
+
+bool WriteCookStamp(const Arguments& args)
+{
+	FILE* file = nullptr;
+	fopen_s(&file, GetCookStampPath(args.outputFileName).u8string().c_str(), "w");
+	if (file == nullptr)
+	{
+		return false;
+	}
+	const std::string settings = GetCookSettings(args);
+	const bool written = fputs(settings.c_str(), file) >= 0;
+	fclose(file);
+	return written;
+}
+
+bool HasCookStamp(const Arguments& args)
+{
+	FILE* file = nullptr;
+	fopen_s(&file, GetCookStampPath(args.outputFileName).u8string().c_str(), "r");
+	if (file == nullptr)
+	{
+		return false;
+	}
+	char stamp[512] = {};
+	const bool read = fgets(stamp, sizeof(stamp), file) != nullptr;
+	fclose(file);
+	return read && GetCookSettings(args) == stamp;
+}
+
+// Keeps a list of every file assimp opens, the input's .mtl, .bin buffers and other sidecars
+// change the output as much as the input does
+class RecordingIOSystem final : public Assimp::DefaultIOSystem
+{
+public:
+	RecordingIOSystem(std::vector<std::filesystem::path>& openedFiles)
+		: mOpenedFiles(openedFiles)
+	{}
+
+	Assimp::IOStream* Open(const char* file, const char* mode) override
+	{
+		Assimp::IOStream* stream = DefaultIOSystem::Open(file, mode);
+		const std::filesystem::path filePath = std::filesystem::absolute(std::filesystem::u8path(file)).lexically_normal();
+		if (stream != nullptr && std::find(mOpenedFiles.begin(), mOpenedFiles.end(), filePath) == mOpenedFiles.end())
+		{
+			mOpenedFiles.push_back(filePath);
+		}
+		return stream;
+	}
+
+private:
+	std::vector<std::filesystem::path>& mOpenedFiles;
+};
+
+// Writes the .model, .modelbin and .material outputs and the stamp, outputFiles receives every
+// file written and sourceFiles every file read, the input included
+bool ImportModel(const Arguments& args, std::vector<std::filesystem::path>& outputFiles, std::vector<std::filesystem::path>& sourceFiles)
+{
+	Print("Begin Import\n");
 
 	//use assimp
 	Assimp::Importer importer;
+	importer.SetIOHandler(new RecordingIOSystem(sourceFiles));	// the importer owns it
 	//for importing skeletons properly
 	importer.SetPropertyBool(AI_CONFIG_IMPORT_FBX_PRESERVE_PIVOTS, false);
-	const uint32_t flags = aiProcessPreset_TargetRealtime_Quality | aiProcess_ConvertToLeftHanded;
-
-	const aiScene* scene = importer.ReadFile(args.inputFileName.u8string().c_str(), flags);
+	const aiScene* scene = importer.ReadFile(args.inputFileName.u8string().c_str(), ImportFlags);
 	if (scene == nullptr)
 	{
-		printf("Error: %s\n", importer.GetErrorString());
-		return -1;
+		Print("Error: %s\n", importer.GetErrorString());
+		return false;
 	}
 
-	printf("Importing %s...\n", args.inputFileName.u8string().c_str());
+	Print("Importing %s...\n", args.inputFileName.u8string().c_str());
 
 	Model model;
+	BoneIndexLookup boneIndexLookup;
+	bool hasBones = false;
+	for (uint32_t meshIndex = 0; meshIndex < scene->mNumMeshes; ++meshIndex)
+	{
+		hasBones = hasBones || scene->mMeshes[meshIndex]->HasBones();
+	}
+	std::vector<int> meshBones(scene->mNumMeshes, -1);
+	std::set<std::string> skinBoneNames;
+	if (hasBones)
+	{
+		Print("Building Skeleton...\n");
+		model.skeleton.rootIndex = BuildSkeleton(scene->mRootNode, -1, model.skeleton, boneIndexLookup, args.scale);
+		int nodeBoneIndex = 0;
+		FindMeshBones(scene->mRootNode, nodeBoneIndex, meshBones);
+		for (uint32_t meshIndex = 0; meshIndex < scene->mNumMeshes; ++meshIndex)
+		{
+			const aiMesh* aiMesh = scene->mMeshes[meshIndex];
+			for (uint32_t b = 0; b < aiMesh->mNumBones; ++b)
+			{
+				skinBoneNames.insert(aiMesh->mBones[b]->mName.C_Str());
+			}
+		}
+	}
+
 	if (scene->HasMeshes())
 	{
-		printf("Reading Mesh Data...\n");
+		Print("Reading Mesh Data...\n");
 		for (uint32_t meshIndex = 0; meshIndex < scene->mNumMeshes; ++meshIndex)
 		{
 			const auto& aiMesh = scene->mMeshes[meshIndex];
@@ -203,10 +672,10 @@ int main(int argc, char* argv[])
 
 			Model::MeshData& meshData = model.meshData.emplace_back();
 
-			printf("Reading Material Index...\n");
+			Print("Reading Material Index...\n");
 			meshData.materialIndex = aiMesh->mMaterialIndex;
 
-			printf("Reading Vertices...\n");
+			Print("Reading Vertices...\n");
 			Mesh& mesh = meshData.mesh;
 			mesh.vertices.reserve(numVertices);
 
@@ -217,13 +686,19 @@ int main(int argc, char* argv[])
 			for (uint32_t v = 0; v < numVertices; ++v)
 			{
 				Vertex& vertex = mesh.vertices.emplace_back();
-				vertex.position = ToVector3(positions[v]) * args.scale;
 				vertex.normal = ToVector3(normals[v]);
 				vertex.tangent = tangents ? ToVector3(tangents[v]) : Vector3::Zero;
 				vertex.uvCoord = texCoords ? ToTexCoord(texCoords[v]) : Vector2::Zero;
 			}
+			// aiVector3D is three packed floats, scale straight from assimp's array into the vertices
+			static_assert(sizeof(aiVector3D) == sizeof(Vector3), "aiVector3D must match Vector3");
+			if (!mesh.vertices.empty())
+			{
+				TransformCoords(reinterpret_cast<const Vector3*>(positions), sizeof(aiVector3D),
+					&mesh.vertices[0].position, sizeof(Vertex), numVertices, Matrix4::Scaling(args.scale));
+			}
 
-			printf("Reading Indices...\n");
+			Print("Reading Indices...\n");
 			mesh.indices.reserve(numIndices);
 			const auto& aiFaces = aiMesh->mFaces;
 			for (uint32_t f = 0; f < numFaces; ++f)
@@ -234,12 +709,41 @@ int main(int argc, char* argv[])
 					mesh.indices.push_back(aiFace.mIndices[i]);
 ;				}
 			}
+
+			if (aiMesh->HasBones())
+			{
+				Print("Reading Bone Weights...\n");
+				ReadBoneWeights(aiMesh, model.skeleton, boneIndexLookup, args.scale, mesh);
+			}
+			else if (hasBones)
+			{
+				Print("Binding rigid mesh to its node...\n");
+				BindRigidMesh(meshBones[meshIndex], skinBoneNames, model.skeleton, boneIndexLookup, mesh);
+			}
+
+			if (args.optimize)
+			{
+				OptimizeMesh(mesh);
+			}
+
+			if (args.lodCount > 0)
+			{
+				GenerateLODs(meshData, args.lodCount);
+			}
+
+			mesh.ComputeBounds();
 		}
 	}
 
+	if (!model.skeleton.bones.empty() && scene->HasAnimations())
+	{
+		Print("Reading Animations...\n");
+		ReadAnimations(scene, boneIndexLookup, static_cast<uint32_t>(model.skeleton.bones.size()), args.scale, model);
+	}
+
 	if (scene->HasMaterials())
 	{
-		printf("Reading Material data...\n");
+		Print("Reading Material data...\n");
 
 		const uint32_t numMaterials = scene->mNumMaterials;
 		model.materialData.reserve(numMaterials);
@@ -262,18 +766,570 @@ int main(int argc, char* argv[])
 			materialData.material.emissive = ToColor(emissive);
 			materialData.material.power = static_cast<float>(specularPower);
 
-			materialData.diffuseMapName = FindTexture(scene, aiMaterial, aiTextureType_DIFFUSE, args, "_diff", materialIndex);
-			materialData.normalMapName = FindTexture(scene, aiMaterial, aiTextureType_NORMALS, args, "_norm", materialIndex);
-			materialData.specMapName = FindTexture(scene, aiMaterial, aiTextureType_SPECULAR, args, "_spec", materialIndex);
-			materialData.bumpMapName = FindTexture(scene, aiMaterial, aiTextureType_DISPLACEMENT, args, "_bump", materialIndex);
+			materialData.diffuseMapName = FindTexture(scene, aiMaterial, aiTextureType_DIFFUSE, args, "_diff", materialIndex, outputFiles);
+			materialData.normalMapName = FindTexture(scene, aiMaterial, aiTextureType_NORMALS, args, "_norm", materialIndex, outputFiles);
+			materialData.specMapName = FindTexture(scene, aiMaterial, aiTextureType_SPECULAR, args, "_spec", materialIndex, outputFiles);
+			materialData.bumpMapName = FindTexture(scene, aiMaterial, aiTextureType_DISPLACEMENT, args, "_bump", materialIndex, outputFiles);
+		}
+	}
+
+	if (args.compress)
+	{
+		const bool valid = ValidateOctahedral();
+		Print("Validating octahedral round trip: %s\n", valid ? "passed" : "FAILED");
+		if (!valid)
+		{
+			return false;
 		}
 	}
 
-	printf("Saving Model...\n");
-	ModelIO::SaveModel(args.outputFileName, model);
+	// Outputs are recorded as they are written, files an earlier import left next to them are
+	// not this import's and must not end up in the cook cache
+	auto recordOutput = [&](bool written, const char* extension)
+	{
+		if (written)
+		{
+			std::filesystem::path outputFileName = args.outputFileName;
+			outputFiles.push_back(outputFileName.replace_extension(extension));
+		}
+	};
+
+	// The stamp goes before the first output is touched and comes back after the last one, so
+	// an import that fails part way is never taken for up to date
+	std::error_code error;
+	std::filesystem::remove(GetCookStampPath(args.outputFileName), error);
 
-	printf("Saving Material...\n");
-	ModelIO::SaveMaterial(args.outputFileName, model);
+	Print("Saving Model...\n");
+	recordOutput(ModelIO::SaveModel(args.outputFileName, model), "model");
+	const ModelIO::VertexStorage vertexStorage = args.compress ? ModelIO::VertexStorage::Compact : ModelIO::VertexStorage::Full;
+	const ModelIO::BinaryReport report = ModelIO::SaveModelBinary(args.outputFileName, model, vertexStorage);
+	recordOutput(report.fileBytes > 0, "modelbin");
+	Print("Binary: %u/%u meshes compact, vertices %llu -> %llu bytes, indices %llu bytes, file %llu bytes\n",
+		report.compactMeshCount, report.meshCount,
+		static_cast<unsigned long long>(report.fullVertexBytes),
+		static_cast<unsigned long long>(report.storedVertexBytes),
+		static_cast<unsigned long long>(report.indexBytes),
+		static_cast<unsigned long long>(report.fileBytes));
+	if (args.compress && report.fullVertexBytes > 0)
+	{
+		Print("Vertex data saved: %llu bytes (%.1f%%)\n",
+			static_cast<unsigned long long>(report.fullVertexBytes - report.storedVertexBytes),
+			100.0 * static_cast<double>(report.fullVertexBytes - report.storedVertexBytes) / static_cast<double>(report.fullVertexBytes));
+	}
 
-	return 0;
+	Print("Saving Material...\n");
+	recordOutput(ModelIO::SaveMaterial(args.outputFileName, model), "material");
+
+	if (!model.skeleton.bones.empty())
+	{
+		Print("Saving Skeleton...\n");
+		recordOutput(ModelIO::SaveSkeleton(args.outputFileName, model), "skeleton");
+		if (!model.animationClips.empty())
+		{
+			Print("Saving Animations...\n");
+			recordOutput(ModelIO::SaveAnimations(args.outputFileName, model), "animset");
+		}
+
+		// Reload what was written and make sure the weights survived the round trip
+		Model textModel;
+		Model binaryModel;
+		ModelIO::LoadModel(args.outputFileName, textModel);
+		ModelIO::LoadSkeleton(args.outputFileName, textModel);
+		ModelIO::LoadModelBinary(args.outputFileName, binaryModel);
+		binaryModel.skeleton = textModel.skeleton;
+		const bool valid = textModel.skeleton.bones.size() == model.skeleton.bones.size() &&
+			ModelIO::ValidateSkinWeights(textModel) && ModelIO::ValidateSkinWeights(binaryModel);
+		Print("Validating skin weights: %s (%u bones)\n", valid ? "passed" : "FAILED", static_cast<uint32_t>(model.skeleton.bones.size()));
+		if (!valid)
+		{
+			return false;
+		}
+	}
+
+	recordOutput(WriteCookStamp(args), "cookstamp");
+	return true;
+}
+
+// Cook cache: <cacheDirectory>/<key>/ holds copies of every output of one import, where
+// the key hashes the source bytes together with everything that changes the output.
+// Sidecar files the import read next to the source are listed with their hashes in the
+// entry, a hit needs them unchanged too. Entries are touched on every hit, -prunecache
+// <days> removes the ones unused for longer.
+constexpr const char* CookManifestName = "cook.manifest";
+constexpr const char* CookSourcesName = "cook.sources";
+
+uint64_t HashBytes(const void* data, size_t size, uint64_t hash = 14695981039346656037ull)
+{
+	// FNV-1a
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash = (hash ^ bytes[i]) * 1099511628211ull;
+	}
+	return hash;
+}
+
+std::optional<uint64_t> HashFile(const std::filesystem::path& filePath)
+{
+	// MappedFile turns down empty files, they still have a hash
+	std::error_code error;
+	if (std::filesystem::file_size(filePath, error) == 0 && !error)
+	{
+		return HashBytes(nullptr, 0);
+	}
+
+	Core::MappedFile file;
+	if (!file.Initialize(filePath))
+	{
+		return std::nullopt;
+	}
+	return HashBytes(file.GetData(), static_cast<size_t>(file.GetSize()));
+}
+
+std::optional<std::string> ComputeCookKey(const Arguments& args)
+{
+	const std::optional<uint64_t> sourceHash = HashFile(args.inputFileName);
+	if (!sourceHash.has_value())
+	{
+		return std::nullopt;
+	}
+
+	const std::string settings = GetCookSettings(args);
+	const uint64_t hash = HashBytes(settings.data(), settings.size(), sourceHash.value());
+
+	char key[17];
+	snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(hash));
+	return std::string(key);
+}
+
+// Lines of "<hash> <path>", one per sidecar
+bool AreSourcesUnchanged(const std::filesystem::path& entryDirectory)
+{
+	FILE* file = nullptr;
+	fopen_s(&file, (entryDirectory / CookSourcesName).u8string().c_str(), "r");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	bool unchanged = true;
+	char line[MAX_PATH + 32];
+	while (unchanged && fgets(line, sizeof(line), file) != nullptr)
+	{
+		std::string text = line;
+		while (!text.empty() && (text.back() == '\n' || text.back() == '\r'))
+		{
+			text.pop_back();
+		}
+		const size_t space = text.find(' ');
+		if (space == std::string::npos)
+		{
+			continue;
+		}
+
+		const std::filesystem::path sourceFile = std::filesystem::u8path(text.substr(space + 1));
+		const std::optional<uint64_t> hash = HashFile(sourceFile);
+		unchanged = hash.has_value() && hash.value() == strtoull(text.c_str(), nullptr, 16);
+		if (!unchanged)
+		{
+			Print("Cook cache entry %s is stale, %s changed\n", entryDirectory.u8string().c_str(), sourceFile.u8string().c_str());
+		}
+	}
+	fclose(file);
+	return unchanged;
+}
+
+bool RestoreFromCookCache(const std::filesystem::path& entryDirectory, const Arguments& args)
+{
+	// A stale entry goes, so the import that follows can store its outputs in its place
+	std::error_code error;
+	if (std::filesystem::exists(entryDirectory, error) && !AreSourcesUnchanged(entryDirectory))
+	{
+		std::filesystem::remove_all(entryDirectory, error);
+		return false;
+	}
+
+	FILE* file = nullptr;
+	fopen_s(&file, (entryDirectory / CookManifestName).u8string().c_str(), "r");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	std::vector<std::string> fileNames;
+	char line[MAX_PATH];
+	while (fgets(line, sizeof(line), file) != nullptr)
+	{
+		std::string fileName = line;
+		while (!fileName.empty() && (fileName.back() == '\n' || fileName.back() == '\r'))
+		{
+			fileName.pop_back();
+		}
+		if (!fileName.empty())
+		{
+			fileNames.push_back(fileName);
+		}
+	}
+	fclose(file);
+
+	const std::filesystem::path outputDirectory = args.outputFileName.parent_path();
+	for (const std::string& fileName : fileNames)
+	{
+		std::filesystem::copy_file(entryDirectory / fileName, outputDirectory / fileName, std::filesystem::copy_options::overwrite_existing, error);
+		if (error)
+		{
+			Print("Cook cache entry %s is incomplete\n", entryDirectory.u8string().c_str());
+			return false;
+		}
+	}
+
+	std::filesystem::last_write_time(entryDirectory / CookManifestName, std::filesystem::file_time_type::clock::now(), error);
+	return true;
+}
+
+void StoreInCookCache(const std::filesystem::path& entryDirectory, const Arguments& args, const std::vector<std::filesystem::path>& outputFiles,
+	const std::vector<std::filesystem::path>& sourceFiles)
+{
+	// Filled under a temporary name and renamed, so a concurrent batch job never sees half an entry
+	std::error_code error;
+	std::filesystem::path stagingDirectory = entryDirectory;
+	stagingDirectory += ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+	std::filesystem::remove_all(stagingDirectory, error);
+	std::filesystem::create_directories(stagingDirectory, error);
+
+	FILE* file = nullptr;
+	fopen_s(&file, (stagingDirectory / CookManifestName).u8string().c_str(), "w");
+	if (file == nullptr)
+	{
+		return;
+	}
+
+	for (const std::filesystem::path& outputFile : outputFiles)
+	{
+		std::filesystem::copy_file(outputFile, stagingDirectory / outputFile.filename(), std::filesystem::copy_options::overwrite_existing, error);
+		fprintf_s(file, "%s\n", outputFile.filename().u8string().c_str());
+	}
+	fclose(file);
+
+	// The input is already part of the key. A sidecar that can't be hashed leaves no entry,
+	// it couldn't be checked on the next hit
+	fopen_s(&file, (stagingDirectory / CookSourcesName).u8string().c_str(), "w");
+	bool stored = file != nullptr;
+	const std::filesystem::path inputFileName = std::filesystem::absolute(args.inputFileName).lexically_normal();
+	for (size_t i = 0; i < sourceFiles.size() && stored; ++i)
+	{
+		if (sourceFiles[i] == inputFileName)
+		{
+			continue;
+		}
+		const std::optional<uint64_t> hash = HashFile(sourceFiles[i]);
+		stored = hash.has_value();
+		if (stored)
+		{
+			fprintf_s(file, "%016llx %s\n", static_cast<unsigned long long>(hash.value()), sourceFiles[i].u8string().c_str());
+		}
+	}
+	if (file != nullptr)
+	{
+		fclose(file);
+	}
+	if (!stored)
+	{
+		std::filesystem::remove_all(stagingDirectory, error);
+		return;
+	}
+
+	std::filesystem::rename(stagingDirectory, entryDirectory, error);
+	if (error)
+	{
+		std::filesystem::remove_all(stagingDirectory, error);
+	}
+}
+
+// Import through the cook cache when one is configured
+bool CookModel(const Arguments& args)
+{
+	std::vector<std::filesystem::path> outputFiles;
+	std::vector<std::filesystem::path> sourceFiles;
+	if (args.cacheDirectory.empty())
+	{
+		return ImportModel(args, outputFiles, sourceFiles);
+	}
+
+	const std::optional<std::string> key = ComputeCookKey(args);
+	if (!key.has_value())
+	{
+		Print("Error: failed to read %s\n", args.inputFileName.u8string().c_str());
+		return false;
+	}
+
+	const std::filesystem::path entryDirectory = args.cacheDirectory / key.value();
+	if (RestoreFromCookCache(entryDirectory, args))
+	{
+		Print("Cook cache hit %s for %s\n", key.value().c_str(), args.inputFileName.u8string().c_str());
+		return true;
+	}
+
+	if (!ImportModel(args, outputFiles, sourceFiles))
+	{
+		return false;
+	}
+
+	StoreInCookCache(entryDirectory, args, outputFiles, sourceFiles);
+	return true;
+}
+
+void PruneCookCache(const Arguments& args)
+{
+	std::error_code error;
+	if (!std::filesystem::is_directory(args.cacheDirectory, error))
+	{
+		return;
+	}
+
+	const auto now = std::filesystem::file_time_type::clock::now();
+	const auto maxAge = std::chrono::hours(24 * args.pruneCacheDays);
+	uint32_t prunedCount = 0;
+	uint32_t keptCount = 0;
+	for (const auto& entry : std::filesystem::directory_iterator(args.cacheDirectory, error))
+	{
+		if (!entry.is_directory())
+		{
+			continue;
+		}
+
+		// Entries without a manifest are leftovers from an interrupted store
+		const auto lastUsed = std::filesystem::last_write_time(entry.path() / CookManifestName, error);
+		if (error || now - lastUsed > maxAge)
+		{
+			std::filesystem::remove_all(entry.path(), error);
+			++prunedCount;
+		}
+		else
+		{
+			++keptCount;
+		}
+	}
+	printf("Cook cache pruned %u entries, kept %u\n", prunedCount, keptCount);
+}
+
+struct BatchItem
+{
+	std::filesystem::path inputFileName;
+	std::filesystem::path outputFileName;
+};
+
+bool IsModelSource(const std::filesystem::path& filePath)
+{
+	std::string extension = filePath.extension().u8string();
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return static_cast<char>(tolower(c)); });
+	return extension == ".fbx" || extension == ".obj" || extension == ".dae" || extension == ".gltf" || extension == ".glb" || extension == ".3ds" || extension == ".blend";
+}
+
+// Manifest lines are "<input> [<output>]", quotes allow spaces, # starts a comment.
+// Relative paths are relative to the manifest, a missing output goes to <outputDir>/<name>.model
+void ReadManifest(const Arguments& args, std::vector<BatchItem>& items)
+{
+	FILE* file = nullptr;
+	fopen_s(&file, args.inputFileName.u8string().c_str(), "r");
+	if (file == nullptr)
+	{
+		Print("Error: failed to open manifest %s\n", args.inputFileName.u8string().c_str());
+		return;
+	}
+
+	const std::filesystem::path manifestDirectory = args.inputFileName.parent_path();
+	char line[1024];
+	while (fgets(line, sizeof(line), file) != nullptr)
+	{
+		std::vector<std::string> tokens;
+		const char* c = line;
+		while (true)
+		{
+			while (*c != '\0' && isspace(static_cast<unsigned char>(*c)))
+			{
+				++c;
+			}
+			if (*c == '\0' || *c == '#')
+			{
+				break;
+			}
+
+			std::string& token = tokens.emplace_back();
+			if (*c == '"')
+			{
+				for (++c; *c != '\0' && *c != '"' && *c != '\n'; ++c)
+				{
+					token += *c;
+				}
+				c += (*c == '"') ? 1 : 0;
+			}
+			else
+			{
+				for (; *c != '\0' && !isspace(static_cast<unsigned char>(*c)); ++c)
+				{
+					token += *c;
+				}
+			}
+		}
+
+		if (tokens.empty())
+		{
+			continue;
+		}
+
+		BatchItem& item = items.emplace_back();
+		item.inputFileName = manifestDirectory / tokens[0];
+		if (tokens.size() > 1)
+		{
+			item.outputFileName = manifestDirectory / tokens[1];
+		}
+		else
+		{
+			item.outputFileName = args.outputFileName / item.inputFileName.filename();
+			item.outputFileName.replace_extension("model");
+		}
+	}
+	fclose(file);
+}
+
+// Directory inputs mirror their folder layout under the output directory. Folders that can't
+// be read are skipped, any other error ends the walk with the items found so far
+void CollectDirectory(const Arguments& args, std::vector<BatchItem>& items)
+{
+	std::error_code error;
+	std::filesystem::recursive_directory_iterator iter(args.inputFileName, std::filesystem::directory_options::skip_permission_denied, error);
+	for (; !error && iter != std::filesystem::recursive_directory_iterator(); iter.increment(error))
+	{
+		const std::filesystem::directory_entry& entry = *iter;
+		std::error_code entryError;
+		if (!entry.is_regular_file(entryError) || !IsModelSource(entry.path()))
+		{
+			continue;
+		}
+
+		BatchItem& item = items.emplace_back();
+		item.inputFileName = entry.path();
+		item.outputFileName = args.outputFileName / std::filesystem::relative(entry.path(), args.inputFileName, entryError);
+		item.outputFileName.replace_extension("model");
+	}
+	if (error)
+	{
+		Print("Error: stopped reading %s: %s\n", args.inputFileName.u8string().c_str(), error.message().c_str());
+	}
+}
+
+// Newer than the source and imported with the same settings and importer version
+bool IsUpToDate(const Arguments& args)
+{
+	std::error_code error;
+	const auto sourceTime = std::filesystem::last_write_time(args.inputFileName, error);
+	if (error || !HasCookStamp(args))
+	{
+		return false;
+	}
+
+	std::filesystem::path outputFileName = args.outputFileName;
+	outputFileName.replace_extension("model");
+	const auto outputTime = std::filesystem::last_write_time(outputFileName, error);
+	return !error && outputTime >= sourceTime;
+}
+
+int ImportBatch(const Arguments& args)
+{
+	using Clock = std::chrono::high_resolution_clock;
+	const auto batchStartTime = Clock::now();
+
+	std::vector<BatchItem> items;
+	if (std::filesystem::is_directory(args.inputFileName))
+	{
+		CollectDirectory(args, items);
+	}
+	else
+	{
+		ReadManifest(args, items);
+	}
+
+	Core::JobSystem::StaticInitialize(args.jobCount);
+	printf("Batch importing %u files on %u threads\n",
+		static_cast<uint32_t>(items.size()), Core::JobSystem::Get()->GetThreadCount() + 1);
+
+	std::mutex printMutex;
+	std::atomic<uint32_t> importedCount = 0;
+	std::atomic<uint32_t> skippedCount = 0;
+	std::atomic<uint32_t> failedCount = 0;
+	Core::JobSystem::Get()->ParallelFor(static_cast<uint32_t>(items.size()), 1, [&](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			const BatchItem& item = items[i];
+			Arguments itemArgs = args;
+			itemArgs.inputFileName = item.inputFileName;
+			itemArgs.outputFileName = item.outputFileName;
+			if (!args.force && IsUpToDate(itemArgs))
+			{
+				++skippedCount;
+				std::lock_guard<std::mutex> lock(printMutex);
+				printf("[skip] %s is up to date\n", item.inputFileName.u8string().c_str());
+				continue;
+			}
+
+			std::string log;
+			tLogBuffer = &log;
+			const auto startTime = Clock::now();
+			std::error_code error;
+			std::filesystem::create_directories(item.outputFileName.parent_path(), error);
+			const bool imported = CookModel(itemArgs);
+			const double milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - startTime).count();
+			tLogBuffer = nullptr;
+
+			if (imported)
+			{
+				++importedCount;
+			}
+			else
+			{
+				++failedCount;
+			}
+
+			std::lock_guard<std::mutex> lock(printMutex);
+			fputs(log.c_str(), stdout);
+			printf("[%s] %s %.1f ms\n", imported ? "done" : "fail", item.inputFileName.u8string().c_str(), milliseconds);
+		}
+	});
+
+	Core::JobSystem::StaticTerminate();
+
+	const double totalMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - batchStartTime).count();
+	printf("Batch finished: %u imported, %u skipped, %u failed, %.1f ms total\n",
+		importedCount.load(), skippedCount.load(), failedCount.load(), totalMilliseconds);
+	return (failedCount > 0) ? -1 : 0;
+}
+
+int main(int argc, char* argv[])
+{
+	const auto argOpt = parseArgs(argc, argv);
+	if (!argOpt.has_value())
+	{
+		printf("Not enough arguments, import fbx failed!\n");
+		return -1;
+	}
+
+	// A directory or a manifest (anything that isn't a model source) imports as a batch
+	const Arguments& args = argOpt.value();
+	int result = 0;
+	if (std::filesystem::is_directory(args.inputFileName) || !IsModelSource(args.inputFileName))
+	{
+		result = ImportBatch(args);
+	}
+	else
+	{
+		result = CookModel(args) ? 0 : -1;
+	}
+
+	if (!args.cacheDirectory.empty() && args.pruneCacheDays >= 0)
+	{
+		PruneCookCache(args);
+	}
+	return result;
 }
\ No newline at end of file
@@ -0,0 +1,230 @@
+#include <WinterEngine/Inc/WinterEngine.h>
+
+#include <cstdio>
+#include <cstring>
+
+using namespace WinterEngine;
+using namespace WinterEngine::Graphics;
+using namespace WinterEngine::Math;
+
+// Runs StandardEffect, ShadowEffect and SimpleDraw frames on a headless GraphicsSystem, so
+// the CPU side of a frame is timed without a GPU, and checks the recorded frame stats
+struct Arguments
+{
+	uint32_t objectCount = 0;	// 0 = 100 and 1000 in turn, at least 2 otherwise
+	uint32_t frameCount = 60;
+};
+
+std::optional<Arguments> parseArgs(int argc, char* argv[])
+{
+	Arguments args;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "-objects") == 0 && i + 1 < argc)
+		{
+			args.objectCount = static_cast<uint32_t>(atoi(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-frames") == 0 && i + 1 < argc)
+		{
+			args.frameCount = static_cast<uint32_t>(atoi(argv[++i]));
+		}
+		else
+		{
+			return std::nullopt;
+		}
+	}
+	if (args.frameCount == 0 || args.objectCount == 1)
+	{
+		return std::nullopt;
+	}
+	return args;
+}
+
+struct Scene
+{
+	Camera camera;
+	DirectionalLight directionalLight;
+	StandardEffect standardEffect;
+	ShadowEffect shadowEffect;
+	std::vector<RenderObject> objects;
+	std::vector<uint32_t> indexCounts;	// per object, what one draw submits
+};
+
+void InitializeScene(uint32_t objectCount, Scene& scene)
+{
+	scene.camera.SetPosition({ 0.0f, 10.0f, -30.0f });
+	scene.camera.SetLookAt(Vector3::Zero);
+	scene.directionalLight.direction = Normalize(Vector3{ 1.0f, -1.0f, 1.0f });
+
+	scene.standardEffect.Initialize(L"../../Assets/Shaders/Standard.fx");
+	scene.standardEffect.SetCamera(scene.camera);
+	scene.standardEffect.SetDirectionalLight(scene.directionalLight);
+	scene.standardEffect.SetLightCamera(scene.shadowEffect.GetLightCamera());
+	scene.standardEffect.SetShadowMap(scene.shadowEffect.GetDepthMap());
+	scene.shadowEffect.Initialize();
+	scene.shadowEffect.SetDirectionalLight(scene.directionalLight);
+
+	// Every object has its own mesh buffer, like separately loaded models
+	const uint32_t columns = static_cast<uint32_t>(ceilf(sqrtf(static_cast<float>(objectCount))));
+	scene.objects.resize(objectCount);
+	scene.indexCounts.resize(objectCount);
+	for (uint32_t i = 0; i < objectCount; ++i)
+	{
+		const uint32_t slices = 8 + (i % 8);
+		const Mesh sphere = MeshBuilder::CreateSphere(slices, slices, 0.5f);
+		RenderObject& object = scene.objects[i];
+		object.meshBuffer.Initialize(sphere);
+		object.aabb = sphere.aabb;
+		object.boundingSphere = sphere.boundingSphere;
+		scene.indexCounts[i] = static_cast<uint32_t>(sphere.indices.size());
+		object.transform.position = { static_cast<float>(i % columns) * 2.0f, 0.5f, static_cast<float>(i / columns) * 2.0f };
+	}
+}
+
+void TerminateScene(Scene& scene)
+{
+	for (RenderObject& object : scene.objects)
+	{
+		object.Terminate();
+	}
+	scene.shadowEffect.Terminate();
+	scene.standardEffect.Terminate();
+}
+
+// Draws the first objectCount objects drawRepeat times each in both passes, then the grid
+GraphicsStats RenderFrame(Scene& scene, uint32_t objectCount, uint32_t drawRepeat)
+{
+	GraphicsSystem* gs = GraphicsSystem::Get();
+	gs->BeginRender();
+		scene.shadowEffect.Begin();
+		for (uint32_t i = 0; i < objectCount; ++i)
+		{
+			for (uint32_t r = 0; r < drawRepeat; ++r)
+			{
+				scene.shadowEffect.Render(scene.objects[i]);
+			}
+		}
+		scene.shadowEffect.End();
+
+		scene.standardEffect.Begin();
+		for (uint32_t i = 0; i < objectCount; ++i)
+		{
+			for (uint32_t r = 0; r < drawRepeat; ++r)
+			{
+				scene.standardEffect.Render(scene.objects[i]);
+			}
+		}
+		scene.standardEffect.End();
+
+		SimpleDraw::AddGroundPlane(20.0f, Colors::White);
+		SimpleDraw::Render(scene.camera);
+	gs->EndRender();
+	return gs->GetFrameStats();
+}
+
+bool SameCounts(const GraphicsStats& a, const GraphicsStats& b)
+{
+	return a.drawCalls == b.drawCalls &&
+		a.verticesSubmitted == b.verticesSubmitted &&
+		a.stateChanges == b.stateChanges &&
+		a.resourcesCreated == b.resourcesCreated &&
+		a.bytesUploaded == b.bytesUploaded;
+}
+
+uint32_t Check(const char* name, bool passed)
+{
+	if (!passed)
+	{
+		printf("  %-24s FAILED\n", name);
+	}
+	return passed ? 0 : 1;
+}
+
+bool RunScene(const Arguments& args, uint32_t objectCount)
+{
+	Scene scene;
+	InitializeScene(objectCount, scene);
+	printf("\n%u objects\n", objectCount);
+
+	// The first frame is the only one allowed to create anything
+	RenderFrame(scene, objectCount, 1);
+	GraphicsStats stats = RenderFrame(scene, objectCount, 1);
+	double renderTime = 0.0;
+	uint32_t unsteadyCount = 0;
+	for (uint32_t frame = 0; frame < args.frameCount; ++frame)
+	{
+		const GraphicsStats frameStats = RenderFrame(scene, objectCount, 1);
+		unsteadyCount += SameCounts(frameStats, stats) ? 0 : 1;
+		renderTime += frameStats.renderTime;
+	}
+	printf("  %-24s %10.3f ms\n", "CPU per frame", 1000.0 * renderTime / args.frameCount);
+	printf("  %-24s %10u\n", "Draw calls", stats.drawCalls);
+	printf("  %-24s %10u\n", "Vertices", stats.verticesSubmitted);
+	printf("  %-24s %10u\n", "State changes", stats.stateChanges);
+	printf("  %-24s %10.1f KB\n", "Uploaded", static_cast<double>(stats.bytesUploaded) / 1024.0);
+
+	// Against a frame with the first two objects: every other object adds one draw and one
+	// mesh bind per pass and nothing else changes state, the effects' own binds are shared.
+	// Two, because with one the standard pass draws the mesh the shadow pass left bound
+	const GraphicsStats pair = RenderFrame(scene, 2, 1);
+	uint32_t objectIndexCount = 0;
+	for (uint32_t i = 2; i < objectCount; ++i)
+	{
+		objectIndexCount += scene.indexCounts[i];
+	}
+	const uint32_t extraCount = objectCount - 2;
+
+	// Drawing every object twice in a row rebinds nothing new, only the draws go up
+	const GraphicsStats repeated = RenderFrame(scene, objectCount, 2);
+	const uint32_t allIndexCount = objectIndexCount + scene.indexCounts[0] + scene.indexCounts[1];
+	printf("  %-24s %10u draw calls, %u state changes\n", "Each object drawn twice", repeated.drawCalls, repeated.stateChanges);
+
+	uint32_t failedCount = 0;
+	failedCount += Check("Steady frames", unsteadyCount == 0 && stats.resourcesCreated == 0);
+	failedCount += Check("Draw calls", stats.drawCalls == pair.drawCalls + (2 * extraCount));
+	failedCount += Check("Vertices", stats.verticesSubmitted == pair.verticesSubmitted + (2 * objectIndexCount));
+	failedCount += Check("State changes", stats.stateChanges == pair.stateChanges + (2 * extraCount));
+	failedCount += Check("Repeated draw calls", repeated.drawCalls == stats.drawCalls + (2 * objectCount));
+	failedCount += Check("Repeated vertices", repeated.verticesSubmitted == stats.verticesSubmitted + (2 * allIndexCount));
+	failedCount += Check("Repeated state changes", repeated.stateChanges == stats.stateChanges);
+	printf("  %-24s %10u failed\n", "Frame stats checks", failedCount);
+
+	TerminateScene(scene);
+	return failedCount == 0;
+}
+
+int main(int argc, char* argv[])
+{
+	const auto argOpt = parseArgs(argc, argv);
+	if (!argOpt.has_value())
+	{
+		printf("Usage: RenderBenchmark [-objects N] [-frames N]\n");
+		return -1;
+	}
+	const Arguments& args = argOpt.value();
+
+	Core::JobSystem::StaticInitialize();
+	GraphicsSystem::StaticInitializeHeadless(1280, 720);
+	SimpleDraw::StaticInitialize(100000);
+	TextureCache::StaticInitialize("../../Assets/Images/");
+	printf("%u headless frames per scene\n", args.frameCount);
+
+	bool passed = true;
+	if (args.objectCount > 0)
+	{
+		passed &= RunScene(args, args.objectCount);
+	}
+	else
+	{
+		for (const uint32_t objectCount : { 100u, 1000u })
+		{
+			passed &= RunScene(args, objectCount);
+		}
+	}
+
+	TextureCache::StaticTerminate();
+	SimpleDraw::StaticTerminate();
+	GraphicsSystem::StaticTerminate();
+	Core::JobSystem::StaticTerminate();
+	return passed ? 0 : -1;
+}
\ No newline at end of file
@@ -0,0 +1,375 @@
+#include <WinterEngine/Inc/WinterEngine.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+using namespace WinterEngine;
+using namespace WinterEngine::Graphics;
+using namespace WinterEngine::Math;
+
+struct Arguments
+{
+	uint32_t objectCount = 0;	// 0 = 10k, 30k and 100k in turn
+	uint32_t frameCount = 60;
+	float movingPercent = 10.0f;
+	uint32_t queryCount = 1000;
+	uint32_t threadCount = 0;
+};
+
+std::optional<Arguments> parseArgs(int argc, char* argv[])
+{
+	Arguments args;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "-objects") == 0 && i + 1 < argc)
+		{
+			args.objectCount = static_cast<uint32_t>(atoi(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-frames") == 0 && i + 1 < argc)
+		{
+			args.frameCount = static_cast<uint32_t>(atoi(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-moving") == 0 && i + 1 < argc)
+		{
+			args.movingPercent = static_cast<float>(atof(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-queries") == 0 && i + 1 < argc)
+		{
+			args.queryCount = static_cast<uint32_t>(atoi(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-threads") == 0 && i + 1 < argc)
+		{
+			args.threadCount = static_cast<uint32_t>(atoi(argv[++i]));
+		}
+		else
+		{
+			return std::nullopt;
+		}
+	}
+	if (args.frameCount == 0 || args.queryCount == 0 || args.movingPercent < 0.0f || args.movingPercent > 100.0f)
+	{
+		return std::nullopt;
+	}
+	return args;
+}
+
+class Random
+{
+public:
+	float Next()
+	{
+		mSeed = (mSeed * 1664525u) + 1013904223u;
+		return static_cast<float>(mSeed >> 8) / static_cast<float>(1u << 24);
+	}
+	float Range(float min, float max) { return min + ((max - min) * Next()); }
+
+private:
+	uint32_t mSeed = 12345;
+};
+
+// Boxes from half a unit to a few units across, spread so the density stays the same
+// whatever the count: about one object per 64 cubic units
+struct Scene
+{
+	std::vector<AABB> boxes;
+	std::vector<Vector3> velocities;
+	float worldSize = 0.0f;
+};
+
+void GenerateScene(uint32_t objectCount, Scene& scene)
+{
+	Random random;
+	scene.worldSize = cbrtf(static_cast<float>(objectCount) * 64.0f);
+	scene.boxes.resize(objectCount);
+	scene.velocities.resize(objectCount);
+	for (uint32_t i = 0; i < objectCount; ++i)
+	{
+		const Vector3 center = { random.Range(0.0f, scene.worldSize), random.Range(0.0f, scene.worldSize * 0.25f), random.Range(0.0f, scene.worldSize) };
+		const Vector3 extents = { random.Range(0.25f, 1.5f), random.Range(0.25f, 1.5f), random.Range(0.25f, 1.5f) };
+		scene.boxes[i] = { center - extents, center + extents };
+		scene.velocities[i] = { random.Range(-3.0f, 3.0f), 0.0f, random.Range(-3.0f, 3.0f) };
+	}
+}
+
+struct Queries
+{
+	std::vector<Frustum> frustums;
+	std::vector<Sphere> spheres;
+	std::vector<Ray> rays;
+};
+
+void GenerateQueries(const Arguments& args, const Scene& scene, Queries& queries)
+{
+	Random random;
+	Camera camera;
+	camera.SetAspectRatio(16.0f / 9.0f);
+	camera.SetNearPlane(0.1f);
+	camera.SetFarPlane(scene.worldSize * 0.25f);
+	queries.frustums.resize(args.queryCount);
+	queries.spheres.resize(args.queryCount);
+	queries.rays.resize(args.queryCount);
+	for (uint32_t i = 0; i < args.queryCount; ++i)
+	{
+		const Vector3 position = { random.Range(0.0f, scene.worldSize), random.Range(0.0f, scene.worldSize * 0.25f), random.Range(0.0f, scene.worldSize) };
+		const Vector3 direction = Normalize(Vector3{ random.Range(-1.0f, 1.0f), random.Range(-0.2f, 0.2f), random.Range(-1.0f, 1.0f) } + Vector3{ 0.01f, 0.0f, 0.0f });
+		camera.SetPosition(position);
+		camera.SetDirection(direction);
+		queries.frustums[i] = camera.GetFrustum();
+		queries.spheres[i] = { position, random.Range(2.0f, 10.0f) };
+		queries.rays[i] = { position, direction };
+	}
+}
+
+template<class Kernel>
+double MeasureSeconds(Kernel&& kernel)
+{
+	using Clock = std::chrono::steady_clock;
+	const auto start = Clock::now();
+	kernel();
+	return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void Report(const char* name, double seconds, uint32_t runCount)
+{
+	printf("  %-24s %10.3f ms\n", name, 1000.0 * seconds / runCount);
+}
+
+void ReportQueries(const char* name, double bvhSeconds, double bruteForceSeconds, uint32_t queryCount, size_t resultCount)
+{
+	printf("  %-24s %10.2f us/query  %8.1fx vs brute force  %8.1f results/query\n",
+		name, 1000000.0 * bvhSeconds / queryCount, bruteForceSeconds / bvhSeconds, static_cast<double>(resultCount) / queryCount);
+}
+
+bool SameResults(std::vector<SceneBVH::ProxyId> results, std::vector<SceneBVH::ProxyId> expected)
+{
+	std::sort(results.begin(), results.end());
+	std::sort(expected.begin(), expected.end());
+	return results == expected;
+}
+
+// The box overlap test the BVH has to agree with
+bool OverlapsSphere(const AABB& aabb, const Sphere& sphere)
+{
+	const Vector3 closest = {
+		Clamp(sphere.center.x, aabb.min.x, aabb.max.x),
+		Clamp(sphere.center.y, aabb.min.y, aabb.max.y),
+		Clamp(sphere.center.z, aabb.min.z, aabb.max.z)
+	};
+	return MagnitudeSqr(closest - sphere.center) <= sphere.radius * sphere.radius;
+}
+
+bool RunScene(const Arguments& args, uint32_t objectCount)
+{
+	Scene scene;
+	GenerateScene(objectCount, scene);
+	Queries queries;
+	GenerateQueries(args, scene, queries);
+	const float rayLength = scene.worldSize;
+	printf("\n%u objects, world %.0f x %.0f x %.0f\n", objectCount, scene.worldSize, scene.worldSize * 0.25f, scene.worldSize);
+
+	// Proxy ids come out in insertion order, so proxy i is box i throughout
+	SceneBVH bvh;
+	const double insertTime = MeasureSeconds([&]()
+	{
+		for (uint32_t i = 0; i < objectCount; ++i)
+		{
+			bvh.Insert(scene.boxes[i], nullptr);
+		}
+	});
+	Report("Incremental insert", insertTime, 1);
+	printf("  %-24s %10.2f SAH cost, height %u\n", "", bvh.GetCost(), bvh.GetHeight());
+
+	const double buildTime = MeasureSeconds([&]() { bvh.Build(); });
+	const float buildCost = bvh.GetCost();
+	Report("SAH build", buildTime, 1);
+	printf("  %-24s %10.2f SAH cost, height %u\n", "", buildCost, bvh.GetHeight());
+
+	// A slice of the objects drifts every frame, the rest stays put
+	const uint32_t movingCount = static_cast<uint32_t>(objectCount * args.movingPercent / 100.0f);
+	const float frameTime = 1.0f / 60.0f;
+	uint32_t changedCount = 0;
+	const double moveTime = MeasureSeconds([&]()
+	{
+		for (uint32_t frame = 0; frame < args.frameCount; ++frame)
+		{
+			for (uint32_t i = 0; i < movingCount; ++i)
+			{
+				const Vector3 offset = scene.velocities[i] * frameTime;
+				scene.boxes[i] = { scene.boxes[i].min + offset, scene.boxes[i].max + offset };
+				changedCount += bvh.Update(i, scene.boxes[i]) ? 1 : 0;
+			}
+		}
+	});
+	Report("Update per frame", moveTime, args.frameCount);
+	printf("  %-24s %10u moves, %u touched the tree, SAH cost %.2f\n", "", movingCount * args.frameCount, changedCount, bvh.GetCost());
+
+	const double refitTime = MeasureSeconds([&]() { bvh.Refit(); });
+	Report("Refit", refitTime, 1);
+	printf("  %-24s %10.2f SAH cost\n", "", bvh.GetCost());
+
+	// Teleports go through remove and reinsert
+	Random random;
+	const uint32_t teleportCount = Max(movingCount / 10, 1u);
+	const double teleportTime = MeasureSeconds([&]()
+	{
+		for (uint32_t i = 0; i < teleportCount; ++i)
+		{
+			const uint32_t index = (i * 7919u) % objectCount;
+			const Vector3 offset = { random.Range(-0.5f, 0.5f) * scene.worldSize, 0.0f, random.Range(-0.5f, 0.5f) * scene.worldSize };
+			scene.boxes[index] = { scene.boxes[index].min + offset, scene.boxes[index].max + offset };
+			bvh.Update(index, scene.boxes[index]);
+		}
+	});
+	printf("  %-24s %10.3f us each, %u moves, SAH cost %.2f\n", "Reinsert", 1000000.0 * teleportTime / teleportCount, teleportCount, bvh.GetCost());
+
+	const double rebuildTime = MeasureSeconds([&]() { bvh.Build(); });
+	Report("Rebuild", rebuildTime, 1);
+	printf("  %-24s %10.2f SAH cost\n", "", bvh.GetCost());
+
+	// Brute force references over the same boxes. The frustum time is the SIMD batch cull,
+	// the expected results come from the scalar test so rounding on the planes agrees
+	std::vector<uint8_t> visible(objectCount);
+	const double bruteFrustumTime = MeasureSeconds([&]()
+	{
+		for (uint32_t q = 0; q < args.queryCount; ++q)
+		{
+			CullAABBs(queries.frustums[q], scene.boxes.data(), objectCount, visible.data());
+		}
+	});
+	std::vector<std::vector<SceneBVH::ProxyId>> expectedFrustum(args.queryCount);
+	for (uint32_t q = 0; q < args.queryCount; ++q)
+	{
+		for (uint32_t i = 0; i < objectCount; ++i)
+		{
+			if (IsVisible(queries.frustums[q], scene.boxes[i]))
+			{
+				expectedFrustum[q].push_back(i);
+			}
+		}
+	}
+
+	std::vector<std::vector<SceneBVH::ProxyId>> expectedSphere(args.queryCount);
+	const double bruteSphereTime = MeasureSeconds([&]()
+	{
+		for (uint32_t q = 0; q < args.queryCount; ++q)
+		{
+			for (uint32_t i = 0; i < objectCount; ++i)
+			{
+				if (OverlapsSphere(scene.boxes[i], queries.spheres[q]))
+				{
+					expectedSphere[q].push_back(i);
+				}
+			}
+		}
+	});
+
+	std::vector<SceneBVH::RayHit> expectedRay(args.queryCount);
+	const double bruteRayTime = MeasureSeconds([&]()
+	{
+		for (uint32_t q = 0; q < args.queryCount; ++q)
+		{
+			for (uint32_t i = 0; i < objectCount; ++i)
+			{
+				float distance = 0.0f;
+				if (Intersect(queries.rays[q], scene.boxes[i], rayLength, distance) && distance < expectedRay[q].distance)
+				{
+					expectedRay[q] = { i, distance };
+				}
+			}
+		}
+	});
+
+	std::vector<std::vector<SceneBVH::ProxyId>> frustumResults(args.queryCount);
+	const double frustumTime = MeasureSeconds([&]()
+	{
+		for (uint32_t q = 0; q < args.queryCount; ++q)
+		{
+			frustumResults[q].clear();
+			bvh.QueryFrustum(queries.frustums[q], frustumResults[q]);
+		}
+	});
+	std::vector<std::vector<SceneBVH::ProxyId>> batchFrustumResults;
+	const double batchFrustumTime = MeasureSeconds([&]() { bvh.QueryFrustums(queries.frustums.data(), args.queryCount, batchFrustumResults); });
+
+	std::vector<std::vector<SceneBVH::ProxyId>> sphereResults(args.queryCount);
+	const double sphereTime = MeasureSeconds([&]()
+	{
+		for (uint32_t q = 0; q < args.queryCount; ++q)
+		{
+			sphereResults[q].clear();
+			bvh.QuerySphere(queries.spheres[q], sphereResults[q]);
+		}
+	});
+	std::vector<std::vector<SceneBVH::ProxyId>> batchSphereResults;
+	const double batchSphereTime = MeasureSeconds([&]() { bvh.QuerySpheres(queries.spheres.data(), args.queryCount, batchSphereResults); });
+
+	std::vector<SceneBVH::RayHit> rayResults(args.queryCount);
+	const double rayTime = MeasureSeconds([&]()
+	{
+		for (uint32_t q = 0; q < args.queryCount; ++q)
+		{
+			bvh.RayCast(queries.rays[q], rayLength, rayResults[q]);
+		}
+	});
+	std::vector<SceneBVH::RayHit> batchRayResults(args.queryCount);
+	const double batchRayTime = MeasureSeconds([&]() { bvh.RayCasts(queries.rays.data(), args.queryCount, rayLength, batchRayResults.data()); });
+
+	size_t frustumCount = 0;
+	size_t sphereCount = 0;
+	size_t rayCount = 0;
+	uint32_t mismatchCount = 0;
+	for (uint32_t q = 0; q < args.queryCount; ++q)
+	{
+		frustumCount += frustumResults[q].size();
+		sphereCount += sphereResults[q].size();
+		rayCount += (rayResults[q].proxy != SceneBVH::InvalidProxy) ? 1 : 0;
+		mismatchCount += SameResults(frustumResults[q], expectedFrustum[q]) ? 0 : 1;
+		mismatchCount += SameResults(batchFrustumResults[q], expectedFrustum[q]) ? 0 : 1;
+		mismatchCount += SameResults(sphereResults[q], expectedSphere[q]) ? 0 : 1;
+		mismatchCount += SameResults(batchSphereResults[q], expectedSphere[q]) ? 0 : 1;
+		// Boxes can touch at the same distance, only the distance has to agree
+		mismatchCount += (rayResults[q].distance == expectedRay[q].distance) ? 0 : 1;
+		mismatchCount += (batchRayResults[q].distance == expectedRay[q].distance) ? 0 : 1;
+	}
+
+	ReportQueries("Frustum", frustumTime, bruteFrustumTime, args.queryCount, frustumCount);
+	ReportQueries("Frustum batch", batchFrustumTime, bruteFrustumTime, args.queryCount, frustumCount);
+	ReportQueries("Sphere", sphereTime, bruteSphereTime, args.queryCount, sphereCount);
+	ReportQueries("Sphere batch", batchSphereTime, bruteSphereTime, args.queryCount, sphereCount);
+	ReportQueries("Ray", rayTime, bruteRayTime, args.queryCount, rayCount);
+	ReportQueries("Ray batch", batchRayTime, bruteRayTime, args.queryCount, rayCount);
+	printf("  %-24s %10u mismatches %s\n", "BVH vs brute force", mismatchCount, (mismatchCount == 0) ? "" : "FAILED");
+	return mismatchCount == 0;
+}
+
+int main(int argc, char* argv[])
+{
+	const auto argOpt = parseArgs(argc, argv);
+	if (!argOpt.has_value())
+	{
+		printf("Usage: SceneBenchmark [-objects N] [-frames N] [-moving percent] [-queries N] [-threads N]\n");
+		return -1;
+	}
+	const Arguments& args = argOpt.value();
+
+	Core::JobSystem::StaticInitialize(args.threadCount);
+	printf("%u frames with %.0f%% of objects moving, %u queries of each kind, %u worker threads\n",
+		args.frameCount, args.movingPercent, args.queryCount, Core::JobSystem::Get()->GetThreadCount());
+
+	bool passed = true;
+	if (args.objectCount > 0)
+	{
+		passed &= RunScene(args, args.objectCount);
+	}
+	else
+	{
+		for (const uint32_t objectCount : { 10000u, 30000u, 100000u })
+		{
+			passed &= RunScene(args, objectCount);
+		}
+	}
+
+	Core::JobSystem::StaticTerminate();
+	return passed ? 0 : -1;
+}
\ No newline at end of file
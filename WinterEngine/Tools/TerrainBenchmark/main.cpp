@@ -0,0 +1,1183 @@
+#include <WinterEngine/Inc/WinterEngine.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+using namespace WinterEngine;
+using namespace WinterEngine::Graphics;
+using namespace WinterEngine::Math;
+
+struct Arguments
+{
+	uint32_t size = 1025;	// samples per side of the generated heightmap
+	float maxHeight = 100.0f;
+	uint32_t rayCount = 10000;
+	uint32_t bruteForceCount = 64;	// rays also cast against every triangle
+	uint32_t threadCount = 0;
+	float tolerance = 1e-3f;
+	float lodDistance = 64.0f;
+	uint32_t selectCount = 100;	// SelectChunks calls timed per camera
+	uint32_t streamSize = 4097;	// samples per side of the streamed map, 0 skips streaming
+	uint32_t tileSize = 256;
+	float budget = 4.0f;	// MB of resident tiles
+	float loadRadius = 1024.0f;
+	float streamSeconds = 4.0f;
+	float speed = 800.0f;	// units per second the view flies over the streamed map
+	uint32_t ingestSize = 4097;	// largest map loaded from a RAW file, sizes double from 1025, 0 skips
+	uint32_t agentCount = 100000;	// most agents snapped to the ground, counts go up 10x from 1000, 0 skips
+};
+
+std::optional<Arguments> parseArgs(int argc, char* argv[])
+{
+	Arguments args;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "-size") == 0 && i + 1 < argc)
+		{
+			args.size = static_cast<uint32_t>(atoi(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-height") == 0 && i + 1 < argc)
+		{
+			args.maxHeight = static_cast<float>(atof(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-rays") == 0 && i + 1 < argc)
+		{
+			args.rayCount = static_cast<uint32_t>(atoi(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-brute") == 0 && i + 1 < argc)
+		{
+			args.bruteForceCount = static_cast<uint32_t>(atoi(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-threads") == 0 && i + 1 < argc)
+		{
+			args.threadCount = static_cast<uint32_t>(atoi(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-tolerance") == 0 && i + 1 < argc)
+		{
+			args.tolerance = static_cast<float>(atof(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-lod") == 0 && i + 1 < argc)
+		{
+			args.lodDistance = static_cast<float>(atof(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-selects") == 0 && i + 1 < argc)
+		{
+			args.selectCount = static_cast<uint32_t>(atoi(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-stream") == 0 && i + 1 < argc)
+		{
+			args.streamSize = static_cast<uint32_t>(atoi(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-tile") == 0 && i + 1 < argc)
+		{
+			args.tileSize = static_cast<uint32_t>(atoi(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-budget") == 0 && i + 1 < argc)
+		{
+			args.budget = static_cast<float>(atof(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-radius") == 0 && i + 1 < argc)
+		{
+			args.loadRadius = static_cast<float>(atof(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-seconds") == 0 && i + 1 < argc)
+		{
+			args.streamSeconds = static_cast<float>(atof(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-speed") == 0 && i + 1 < argc)
+		{
+			args.speed = static_cast<float>(atof(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-ingest") == 0 && i + 1 < argc)
+		{
+			args.ingestSize = static_cast<uint32_t>(atoi(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-agents") == 0 && i + 1 < argc)
+		{
+			args.agentCount = static_cast<uint32_t>(atoi(argv[++i]));
+		}
+		else
+		{
+			return std::nullopt;
+		}
+	}
+	if (args.size < 2 || args.rayCount == 0 || args.maxHeight <= 0.0f || args.lodDistance <= 0.0f || args.selectCount == 0 ||
+		(args.streamSize != 0 && (args.streamSize < 2 || args.tileSize == 0 || args.budget <= 0.0f)))
+	{
+		return std::nullopt;
+	}
+	args.bruteForceCount = Min(args.bruteForceCount, args.rayCount);
+	return args;
+}
+
+class Random
+{
+public:
+	float Next()
+	{
+		mSeed = (mSeed * 1664525u) + 1013904223u;
+		return static_cast<float>(mSeed >> 8) / static_cast<float>(1u << 24);
+	}
+	float Range(float min, float max) { return min + ((max - min) * Next()); }
+
+private:
+	uint32_t mSeed = 12345;
+};
+
+// Octaves of smoothed value noise, hills a few hundred samples across with rougher detail on
+// top. Heights are in [0, 1]
+void GenerateHeights(uint32_t size, std::vector<float>& heights)
+{
+	Random random;
+	heights.assign(static_cast<size_t>(size) * size, 0.0f);
+	float amplitude = 1.0f;
+	float amplitudeSum = 0.0f;
+	for (uint32_t period = 256; period >= 4; period /= 2)
+	{
+		const uint32_t latticeSize = (size / period) + 2;
+		std::vector<float> lattice(latticeSize * latticeSize);
+		for (float& value : lattice)
+		{
+			value = random.Next();
+		}
+		for (uint32_t z = 0; z < size; ++z)
+		{
+			for (uint32_t x = 0; x < size; ++x)
+			{
+				const uint32_t lx = x / period;
+				const uint32_t lz = z / period;
+				const float fx = static_cast<float>(x % period) / period;
+				const float fz = static_cast<float>(z % period) / period;
+				const float sx = fx * fx * (3.0f - (2.0f * fx));
+				const float sz = fz * fz * (3.0f - (2.0f * fz));
+				const float top = Lerp(lattice[lx + (lz * latticeSize)], lattice[lx + 1 + (lz * latticeSize)], sx);
+				const float bottom = Lerp(lattice[lx + ((lz + 1) * latticeSize)], lattice[lx + 1 + ((lz + 1) * latticeSize)], sx);
+				heights[x + (z * size)] += Lerp(top, bottom, sz) * amplitude;
+			}
+		}
+		amplitudeSum += amplitude;
+		amplitude *= 0.5f;
+	}
+
+	for (float& height : heights)
+	{
+		height /= amplitudeSum;
+	}
+}
+
+template<class Sample>
+void GenerateHeightmap(uint32_t size, std::vector<Sample>& samples)
+{
+	std::vector<float> heights;
+	GenerateHeights(size, heights);
+
+	constexpr float maxSample = static_cast<float>(std::numeric_limits<Sample>::max());
+	samples.resize(heights.size());
+	for (size_t i = 0; i < samples.size(); ++i)
+	{
+		samples[i] = static_cast<Sample>(Clamp(heights[i] * maxSample, 0.0f, maxSample));
+	}
+}
+
+template<class Kernel>
+double MeasureSeconds(Kernel&& kernel)
+{
+	using Clock = std::chrono::steady_clock;
+	const auto start = Clock::now();
+	kernel();
+	return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void Report(const char* name, double seconds)
+{
+	printf("  %-24s %10.3f ms\n", name, 1000.0 * seconds);
+}
+
+void ReportRays(const char* name, double seconds, uint32_t rayCount, uint32_t hitCount)
+{
+	printf("  %-24s %10.3f us/ray  %8.2f M rays/s  %6.1f%% hit\n",
+		name, 1000000.0 * seconds / rayCount, rayCount / seconds / 1000000.0, 100.0 * hitCount / rayCount);
+}
+
+// Closest hit over every triangle, what both acceleration structures have to agree with
+float RayCastBruteForce(const Mesh& mesh, const Ray& ray, float maxDistance)
+{
+	float closest = FLT_MAX;
+	for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+	{
+		float distance = 0.0f;
+		if (Intersect(ray, mesh.vertices[mesh.indices[i]].position, mesh.vertices[mesh.indices[i + 1]].position, mesh.vertices[mesh.indices[i + 2]].position, Min(closest, maxDistance), distance))
+		{
+			closest = distance;
+		}
+	}
+	return closest;
+}
+
+bool SameDistance(float a, float b, float tolerance)
+{
+	if (a == FLT_MAX || b == FLT_MAX)
+	{
+		return a == b;
+	}
+	return Abs(a - b) <= tolerance * Max(1.0f, Max(a, b));
+}
+
+constexpr float NormalTolerance = 1e-4f;	// the packed normals are 16 bit octahedral
+
+size_t GetTerrainBytes(const Terrain& terrain)
+{
+	return (terrain.GetVertices().size() * sizeof(TerrainVertex)) + (terrain.GetChunkIndices().size() * sizeof(uint32_t));
+}
+
+size_t GetMeshBytes(const Mesh& mesh)
+{
+	return (mesh.vertices.size() * sizeof(Vertex)) + (mesh.indices.size() * sizeof(uint32_t));
+}
+
+// Normal and tangent from central differences done one at a time, what the terrain has to match
+template<class Sample>
+void GetReferenceNormal(const std::vector<Sample>& samples, uint32_t size, float maxHeight, uint32_t x, uint32_t z, Vector3& normal, Vector3& tangent)
+{
+	constexpr float maxSample = static_cast<float>(std::numeric_limits<Sample>::max());
+	auto height = [&](uint32_t x, uint32_t z) { return (samples[x + (z * size)] / maxSample) * maxHeight; };
+	const uint32_t left = (x > 0) ? x - 1 : x;
+	const uint32_t right = Min(x + 1, size - 1);
+	const uint32_t below = (z > 0) ? z - 1 : z;
+	const uint32_t above = Min(z + 1, size - 1);
+	const float dhdx = (height(right, z) - height(left, z)) / static_cast<float>(right - left);
+	const float dhdz = (height(x, above) - height(x, below)) / static_cast<float>(above - below);
+	normal = Normalize(Vector3{ -dhdx, 1.0f, -dhdz });
+	tangent = Normalize(Vector3{ 1.0f, dhdx, 0.0f });
+}
+
+bool SameDirection(const Vector3& a, const Vector3& b, float tolerance)
+{
+	return MagnitudeSqr(a - b) <= tolerance * tolerance;
+}
+
+// Counts the expanded vertices that differ from a plain scalar build: positions and uvs have to
+// match exactly, normals and tangents within tolerance
+template<class Sample>
+uint32_t CountWrongVertices(const Mesh& mesh, const std::vector<Sample>& samples, uint32_t size, float maxHeight, float tileCount, float tolerance)
+{
+	constexpr float maxSample = static_cast<float>(std::numeric_limits<Sample>::max());
+	uint32_t wrongCount = 0;
+	for (uint32_t z = 0; z < size; ++z)
+	{
+		for (uint32_t x = 0; x < size; ++x)
+		{
+			Vector3 normal;
+			Vector3 tangent;
+			GetReferenceNormal(samples, size, maxHeight, x, z, normal, tangent);
+
+			const Vertex& vertex = mesh.vertices[x + (z * size)];
+			const float height = (samples[x + (z * size)] / maxSample) * maxHeight;
+			const bool samePosition = vertex.position.x == static_cast<float>(x) && vertex.position.y == height && vertex.position.z == static_cast<float>(z);
+			const bool sameUV = vertex.uvCoord.x == (static_cast<float>(x) / size) * tileCount && vertex.uvCoord.y == (static_cast<float>(z) / size) * tileCount;
+			const bool sameNormal = SameDirection(vertex.normal, normal, tolerance) && SameDirection(vertex.tangent, tangent, tolerance);
+			wrongCount += (samePosition && sameUV && sameNormal) ? 0 : 1;
+		}
+	}
+	return wrongCount;
+}
+
+// Same for the compact vertices: exact heights, decoded normals within tolerance
+template<class Sample>
+uint32_t CountWrongSamples(const Terrain& terrain, const std::vector<Sample>& samples, uint32_t size, float maxHeight, float tolerance)
+{
+	constexpr float maxSample = static_cast<float>(std::numeric_limits<Sample>::max());
+	const std::vector<TerrainVertex>& vertices = terrain.GetVertices();
+	uint32_t wrongCount = 0;
+	for (uint32_t z = 0; z < size; ++z)
+	{
+		for (uint32_t x = 0; x < size; ++x)
+		{
+			Vector3 normal;
+			Vector3 tangent;
+			GetReferenceNormal(samples, size, maxHeight, x, z, normal, tangent);
+
+			const TerrainVertex& vertex = vertices[x + (z * size)];
+			const bool sameHeight = vertex.height == (samples[x + (z * size)] / maxSample) * maxHeight;
+			const bool sameNormal = SameDirection(VertexCompression::DecodeOctahedral(vertex.normal), normal, tolerance);
+			wrongCount += (sameHeight && sameNormal) ? 0 : 1;
+		}
+	}
+	return wrongCount;
+}
+
+bool RunTerrain(const Arguments& args)
+{
+	std::vector<uint8_t> samples;
+	GenerateHeightmap(args.size, samples);
+
+	Terrain terrain;
+	const double initializeTime = MeasureSeconds([&]() { terrain.Initialize(samples.data(), args.size, args.size, args.maxHeight, 10.0f); });
+	Mesh mesh;
+	const double expandTime = MeasureSeconds([&]() { terrain.ExpandMesh(mesh); });
+	const uint32_t wrongCount = CountWrongVertices(mesh, samples, args.size, args.maxHeight, 10.0f, NormalTolerance);
+	printf("\nTerrain %u x %u samples, %u triangles\n", args.size, args.size, terrain.GetTriangleCount());
+	Report("Initialize", initializeTime);
+	Report("ExpandMesh", expandTime);
+	printf("  %-24s %10.1f MB terrain, %.1f MB expanded, %u vertices wrong\n", "Memory",
+		GetTerrainBytes(terrain) / (1024.0 * 1024.0), GetMeshBytes(mesh) / (1024.0 * 1024.0), wrongCount);
+
+	MeshBVH meshBVH;
+	const double buildTime = MeasureSeconds([&]() { meshBVH.Initialize(mesh); });
+	Report("MeshBVH build", buildTime);
+	printf("  %-24s %10u nodes\n", "", meshBVH.GetNodeCount());
+
+	// Half picking rays looking down from above, half grazing rays skimming over the hills
+	// from just above the ground, the hard case for the height blocks
+	Random random;
+	const float extent = static_cast<float>(args.size - 1);
+	const float rayLength = extent * 2.0f;
+	std::vector<Ray> rays(args.rayCount);
+	for (uint32_t i = 0; i < args.rayCount; ++i)
+	{
+		Ray& ray = rays[i];
+		const bool grazing = (i % 2) == 1;
+		ray.origin = { random.Range(0.0f, extent), 0.0f, random.Range(0.0f, extent) };
+		ray.origin.y = terrain.GetHeight(ray.origin) + (grazing ? random.Range(1.0f, 10.0f) : args.maxHeight * 1.5f);
+		const float pitch = grazing ? random.Range(-0.05f, 0.01f) : random.Range(-1.0f, -0.2f);
+		const float yaw = random.Range(0.0f, Constants::TwoPi);
+		ray.direction = Normalize(Vector3{ cosf(yaw), pitch, sinf(yaw) });
+	}
+
+	std::vector<Terrain::RayHit> terrainHits(args.rayCount);
+	const double terrainTime = MeasureSeconds([&]()
+	{
+		for (uint32_t i = 0; i < args.rayCount; ++i)
+		{
+			terrainHits[i] = {};
+			terrain.RayCast(rays[i], rayLength, terrainHits[i]);
+		}
+	});
+	std::vector<Terrain::RayHit> terrainBatchHits(args.rayCount);
+	const double terrainBatchTime = MeasureSeconds([&]() { terrain.RayCasts(rays.data(), args.rayCount, rayLength, terrainBatchHits.data()); });
+
+	std::vector<MeshBVH::RayHit> meshHits(args.rayCount);
+	const double meshTime = MeasureSeconds([&]()
+	{
+		for (uint32_t i = 0; i < args.rayCount; ++i)
+		{
+			meshHits[i] = {};
+			meshBVH.RayCast(rays[i], rayLength, meshHits[i]);
+		}
+	});
+	std::vector<MeshBVH::RayHit> meshBatchHits(args.rayCount);
+	const double meshBatchTime = MeasureSeconds([&]() { meshBVH.RayCasts(rays.data(), args.rayCount, rayLength, meshBatchHits.data()); });
+
+	std::vector<float> bruteForceDistances(args.bruteForceCount);
+	const double bruteForceTime = MeasureSeconds([&]()
+	{
+		for (uint32_t i = 0; i < args.bruteForceCount; ++i)
+		{
+			bruteForceDistances[i] = RayCastBruteForce(mesh, rays[i], rayLength);
+		}
+	});
+
+	uint32_t terrainHitCount = 0;
+	uint32_t meshHitCount = 0;
+	uint32_t bruteForceHitCount = 0;
+	uint32_t mismatchCount = 0;
+	for (uint32_t i = 0; i < args.rayCount; ++i)
+	{
+		terrainHitCount += (terrainHits[i].distance != FLT_MAX) ? 1 : 0;
+		meshHitCount += (meshHits[i].distance != FLT_MAX) ? 1 : 0;
+		mismatchCount += SameDistance(terrainHits[i].distance, meshHits[i].distance, args.tolerance) ? 0 : 1;
+		mismatchCount += SameDistance(terrainHits[i].distance, terrainBatchHits[i].distance, 0.0f) ? 0 : 1;
+		mismatchCount += SameDistance(meshHits[i].distance, meshBatchHits[i].distance, 0.0f) ? 0 : 1;
+		if (i < args.bruteForceCount)
+		{
+			bruteForceHitCount += (bruteForceDistances[i] != FLT_MAX) ? 1 : 0;
+			mismatchCount += SameDistance(terrainHits[i].distance, bruteForceDistances[i], args.tolerance) ? 0 : 1;
+		}
+	}
+
+	ReportRays("Terrain DDA", terrainTime, args.rayCount, terrainHitCount);
+	ReportRays("Terrain DDA batch", terrainBatchTime, args.rayCount, terrainHitCount);
+	ReportRays("MeshBVH", meshTime, args.rayCount, meshHitCount);
+	ReportRays("MeshBVH batch", meshBatchTime, args.rayCount, meshHitCount);
+	if (args.bruteForceCount > 0)
+	{
+		ReportRays("Brute force", bruteForceTime, args.bruteForceCount, bruteForceHitCount);
+	}
+	printf("  %-24s %10u mismatches %s\n", "DDA vs BVH vs brute", mismatchCount, (mismatchCount == 0) ? "" : "FAILED");
+	return mismatchCount == 0;
+}
+
+// Closed mesh seen from every side, rays start outside and aim somewhere near the middle
+bool RunMesh(const Arguments& args)
+{
+	const Mesh mesh = MeshBuilder::CreateSphere(512, 512, 10.0f);
+	printf("\nSphere mesh, %zu triangles\n", mesh.indices.size() / 3);
+
+	MeshBVH meshBVH;
+	const double buildTime = MeasureSeconds([&]() { meshBVH.Initialize(mesh); });
+	Report("MeshBVH build", buildTime);
+	printf("  %-24s %10u nodes\n", "", meshBVH.GetNodeCount());
+
+	Random random;
+	std::vector<Ray> rays(args.rayCount);
+	for (Ray& ray : rays)
+	{
+		ray.origin = Normalize(Vector3{ random.Range(-1.0f, 1.0f), random.Range(-1.0f, 1.0f), random.Range(-1.0f, 1.0f) } + Vector3{ 0.0f, 0.0f, 0.01f }) * 30.0f;
+		const Vector3 target = { random.Range(-12.0f, 12.0f), random.Range(-12.0f, 12.0f), random.Range(-12.0f, 12.0f) };
+		ray.direction = Normalize(target - ray.origin);
+	}
+
+	const float rayLength = 100.0f;
+	std::vector<MeshBVH::RayHit> hits(args.rayCount);
+	const double meshTime = MeasureSeconds([&]()
+	{
+		for (uint32_t i = 0; i < args.rayCount; ++i)
+		{
+			hits[i] = {};
+			meshBVH.RayCast(rays[i], rayLength, hits[i]);
+		}
+	});
+	std::vector<MeshBVH::RayHit> batchHits(args.rayCount);
+	const double batchTime = MeasureSeconds([&]() { meshBVH.RayCasts(rays.data(), args.rayCount, rayLength, batchHits.data()); });
+
+	std::vector<float> bruteForceDistances(args.bruteForceCount);
+	const double bruteForceTime = MeasureSeconds([&]()
+	{
+		for (uint32_t i = 0; i < args.bruteForceCount; ++i)
+		{
+			bruteForceDistances[i] = RayCastBruteForce(mesh, rays[i], rayLength);
+		}
+	});
+
+	uint32_t hitCount = 0;
+	uint32_t bruteForceHitCount = 0;
+	uint32_t mismatchCount = 0;
+	for (uint32_t i = 0; i < args.rayCount; ++i)
+	{
+		hitCount += (hits[i].distance != FLT_MAX) ? 1 : 0;
+		mismatchCount += SameDistance(hits[i].distance, batchHits[i].distance, 0.0f) ? 0 : 1;
+		if (i < args.bruteForceCount)
+		{
+			bruteForceHitCount += (bruteForceDistances[i] != FLT_MAX) ? 1 : 0;
+			mismatchCount += SameDistance(hits[i].distance, bruteForceDistances[i], args.tolerance) ? 0 : 1;
+		}
+	}
+
+	ReportRays("MeshBVH", meshTime, args.rayCount, hitCount);
+	ReportRays("MeshBVH batch", batchTime, args.rayCount, hitCount);
+	if (args.bruteForceCount > 0)
+	{
+		ReportRays("Brute force", bruteForceTime, args.bruteForceCount, bruteForceHitCount);
+	}
+	printf("  %-24s %10u mismatches %s\n", "BVH vs brute", mismatchCount, (mismatchCount == 0) ? "" : "FAILED");
+	return mismatchCount == 0;
+}
+
+// Every edge of the selected chunks has to be shared by exactly two triangles, except along the
+// outside of the terrain. A crack between LODs leaves edges used once in the middle of the map,
+// overlapping triangles use one more than twice. Flipped or missing triangles show in the area
+bool IsWatertight(const Terrain& terrain, const Terrain::ChunkSelection& selection)
+{
+	const uint32_t columns = static_cast<uint32_t>(terrain.GetWidth());
+	const uint32_t rows = static_cast<uint32_t>(terrain.GetHeight());
+	const std::vector<uint32_t>& indices = terrain.GetChunkIndices();
+	auto position = [columns](uint32_t vertex) { return Vector3{ static_cast<float>(vertex % columns), 0.0f, static_cast<float>(vertex / columns) }; };
+
+	std::vector<uint64_t> edges;
+	double area = 0.0;
+	bool flipped = false;
+	for (const Terrain::ChunkDraw& draw : selection.draws)
+	{
+		for (uint32_t i = 0; i < draw.indexCount; i += 3)
+		{
+			uint32_t corners[3];
+			for (uint32_t c = 0; c < 3; ++c)
+			{
+				corners[c] = indices[draw.startIndex + i + c] + draw.baseVertex;
+			}
+			for (uint32_t c = 0; c < 3; ++c)
+			{
+				const uint64_t a = Min(corners[c], corners[(c + 1) % 3]);
+				const uint64_t b = Max(corners[c], corners[(c + 1) % 3]);
+				edges.push_back((a << 32) | b);
+			}
+
+			// Clockwise seen from above, like the full mesh
+			const Vector3 p0 = position(corners[0]);
+			const Vector3 p1 = position(corners[1]);
+			const Vector3 p2 = position(corners[2]);
+			const double signedArea = 0.5 * (((p1.x - p0.x) * (p2.z - p0.z)) - ((p2.x - p0.x) * (p1.z - p0.z)));
+			flipped |= signedArea >= 0.0;
+			area -= signedArea;
+		}
+	}
+
+	auto onBorder = [columns, rows](uint32_t vertex)
+	{
+		const uint32_t x = vertex % columns;
+		const uint32_t z = vertex / columns;
+		return x == 0 || z == 0 || x + 1 == columns || z + 1 == rows;
+	};
+	std::sort(edges.begin(), edges.end());
+	uint32_t badEdges = 0;
+	for (size_t i = 0; i < edges.size();)
+	{
+		size_t end = i + 1;
+		while (end < edges.size() && edges[end] == edges[i])
+		{
+			++end;
+		}
+		const uint32_t a = static_cast<uint32_t>(edges[i] >> 32);
+		const uint32_t b = static_cast<uint32_t>(edges[i]);
+		const size_t uses = end - i;
+		const bool outside = onBorder(a) && onBorder(b) && ((a % columns) == (b % columns) || (a / columns) == (b / columns));
+		badEdges += (uses == 2 || (uses == 1 && outside)) ? 0 : 1;
+		i = end;
+	}
+
+	const double expectedArea = static_cast<double>(columns - 1) * (rows - 1);
+	return badEdges == 0 && !flipped && Abs(static_cast<float>(area - expectedArea)) < 1e-3f;
+}
+
+bool RunChunks(const Arguments& args)
+{
+	std::vector<uint8_t> samples;
+	GenerateHeightmap(args.size, samples);
+	Terrain terrain;
+	terrain.Initialize(samples.data(), args.size, args.size, args.maxHeight, 10.0f);
+	terrain.SetLodDistance(args.lodDistance);
+
+	const uint32_t fullTriangles = terrain.GetTriangleCount();
+	printf("\nChunks %u, %u cells per side, lod distance %.0f, %zu chunk indices (%.1f MB)\n",
+		terrain.GetChunkCount(), Terrain::ChunkSize, args.lodDistance, terrain.GetChunkIndices().size(),
+		terrain.GetChunkIndices().size() * sizeof(uint32_t) / (1024.0 * 1024.0));
+	printf("  %-24s %8s %12s %12s %8s %10s %8s\n", "camera", "chunks", "culled only", "culled+lod", "of full", "select us", "sealed");
+
+	struct View
+	{
+		const char* name;
+		Vector3 position;
+		Vector3 target;
+	};
+	const float extent = static_cast<float>(args.size - 1);
+	const float center = extent * 0.5f;
+	const View views[] = {
+		{ "Ground, centre", { center, 0.0f, center }, { extent, 0.0f, center } },
+		{ "Ground, corner", { 4.0f, 0.0f, 4.0f }, { extent, 0.0f, extent } },
+		{ "Ground, edge outwards", { center, 0.0f, 4.0f }, { center, 0.0f, -extent } },
+		{ "Overview", { center, extent * 0.5f, -extent * 0.25f }, { center, 0.0f, center } },
+		{ "Looking down", { center, args.maxHeight * 4.0f, center }, { center, 0.0f, center + args.maxHeight } },
+	};
+
+	Frustum everything;
+	for (Plane& plane : everything.planes)
+	{
+		plane.d = 1e30f;
+	}
+
+	bool passed = true;
+	Terrain::ChunkSelection selection;
+	for (const View& view : views)
+	{
+		Camera camera;
+		camera.SetAspectRatio(16.0f / 9.0f);
+		camera.SetFarPlane(extent * 2.0f);
+		Vector3 position = view.position;
+		Vector3 target = view.target;
+		position.y += terrain.GetHeight(position) + 2.0f;
+		target.y += terrain.GetHeight(target) + 2.0f;
+		camera.SetPosition(position);
+		camera.SetLookAt(target);
+		const Frustum frustum = camera.GetFrustum();
+
+		terrain.SetLodDistance(FLT_MAX);
+		terrain.SelectChunks(frustum, position, selection);
+		const uint32_t cullOnlyTriangles = selection.triangleCount;
+
+		terrain.SetLodDistance(args.lodDistance);
+		const double selectTime = MeasureSeconds([&]()
+		{
+			for (uint32_t i = 0; i < args.selectCount; ++i)
+			{
+				terrain.SelectChunks(frustum, position, selection);
+			}
+		});
+		const uint32_t visibleChunks = selection.visibleChunks;
+		const uint32_t selectedTriangles = selection.triangleCount;
+
+		// Same LODs with every chunk drawn, so the whole surface can be checked for cracks
+		terrain.SelectChunks(everything, position, selection);
+		const bool sealed = IsWatertight(terrain, selection);
+		passed &= sealed;
+
+		printf("  %-24s %8u %12u %12u %7.2f%% %10.2f %8s\n", view.name, visibleChunks, cullOnlyTriangles, selectedTriangles,
+			100.0 * selectedTriangles / fullTriangles, 1000000.0 * selectTime / args.selectCount, sealed ? "yes" : "FAILED");
+	}
+	printf("  %-24s %8u %12u\n", "Full draw", terrain.GetChunkCount(), fullTriangles);
+	return passed;
+}
+
+// Height straight from the samples, the way Terrain::GetHeight interpolates them
+template<class Sample>
+float GetSampleHeight(const std::vector<Sample>& samples, uint32_t size, float maxHeight, const Vector3& position)
+{
+	constexpr float maxSample = static_cast<float>(std::numeric_limits<Sample>::max());
+	const uint32_t x = static_cast<uint32_t>(position.x);
+	const uint32_t z = static_cast<uint32_t>(position.z);
+	auto height = [&](uint32_t sx, uint32_t sz) { return (samples[sx + (static_cast<size_t>(sz) * size)] / maxSample) * maxHeight; };
+	const float bl = height(x, z);
+	const float br = height(x + 1, z);
+	const float tl = height(x, z + 1);
+	const float tr = height(x + 1, z + 1);
+	const float u = position.x - x;
+	const float v = position.z - z;
+	return (u > v) ? br + ((tr - br) * v) + ((bl - br) * (1.0f - u)) : tl + ((tr - tl) * u) + ((bl - tl) * (1.0f - v));
+}
+
+// Streams in every tile of a 16 bit map, reads every cell back and checks every tile mesh against
+// the reference normals, then damages the header and the table of a copy and expects Initialize
+// to turn each one down
+bool CheckTileFiles(const Arguments& args)
+{
+	constexpr uint32_t size = 513;
+	std::vector<uint16_t> samples;
+	GenerateHeightmap(size, samples);
+
+	const std::filesystem::path tilePath = std::filesystem::temp_directory_path() / "TerrainBenchmark16.tiles";
+	if (!TerrainStreamer::WriteTiles(tilePath, samples.data(), size, size, args.maxHeight, args.tileSize))
+	{
+		printf("  failed to write %s\n", tilePath.u8string().c_str());
+		return false;
+	}
+
+	TerrainStreamer::Settings settings;
+	settings.residentBudget = SIZE_MAX;
+	settings.loadRadius = size * 2.0f;
+	TerrainStreamer streamer;
+	uint32_t heightChecks = 0;
+	uint32_t mismatchCount = 0;
+	uint32_t vertexChecks = 0;
+	uint32_t wrongVertexCount = 0;
+	if (streamer.Initialize(tilePath, settings))
+	{
+		const uint32_t tileCount = streamer.GetTileRows() * streamer.GetTileColumns();
+		for (uint32_t attempt = 0; attempt < 10000 && streamer.GetStats().residentTiles < tileCount; ++attempt)
+		{
+			streamer.Update(Vector3::Zero, 0.0f);
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		Random random;
+		for (uint32_t z = 0; z + 1 < size; ++z)
+		{
+			for (uint32_t x = 0; x + 1 < size; ++x)
+			{
+				const Vector3 position = { x + random.Range(0.0f, 0.99f), 0.0f, z + random.Range(0.0f, 0.99f) };
+				float height = 0.0f;
+				const bool resident = streamer.GetHeight(position, height);
+				mismatchCount += (resident && height == GetSampleHeight(samples, size, args.maxHeight, position)) ? 0 : 1;
+				++heightChecks;
+			}
+		}
+
+		// Vertices on shared edges are checked once per tile, so seams between tiles show up too
+		Mesh mesh;
+		for (uint32_t tileZ = 0; tileZ < streamer.GetTileRows(); ++tileZ)
+		{
+			for (uint32_t tileX = 0; tileX < streamer.GetTileColumns(); ++tileX)
+			{
+				const TerrainStreamer::Tile* tile = streamer.GetTile(tileX, tileZ);
+				if (tile == nullptr)
+				{
+					++wrongVertexCount;
+					continue;
+				}
+				streamer.BuildTileMesh(*tile, mesh);
+				for (const Vertex& vertex : mesh.vertices)
+				{
+					const uint32_t x = static_cast<uint32_t>(vertex.position.x);
+					const uint32_t z = static_cast<uint32_t>(vertex.position.z);
+					Vector3 normal;
+					Vector3 tangent;
+					GetReferenceNormal(samples, size, args.maxHeight, x, z, normal, tangent);
+					const bool sameNormal = SameDirection(vertex.normal, normal, NormalTolerance) && SameDirection(vertex.tangent, tangent, NormalTolerance);
+					wrongVertexCount += sameNormal ? 0 : 1;
+					++vertexChecks;
+				}
+			}
+		}
+		streamer.Terminate();
+	}
+	else
+	{
+		mismatchCount = 1;
+	}
+
+	std::vector<uint8_t> file(std::filesystem::file_size(tilePath));
+	FILE* source = nullptr;
+	fopen_s(&source, tilePath.u8string().c_str(), "rb");
+	const bool read = source != nullptr && fread(file.data(), 1, file.size(), source) == file.size();
+	if (source != nullptr)
+	{
+		fclose(source);
+	}
+
+	// New tileSize, tileRows and tileColumns, which follow each other from byte 16 of the header.
+	// 0 keeps a field
+	struct Damage
+	{
+		uint32_t tileSize;
+		uint32_t tileRows;
+		uint32_t tileColumns;
+		size_t trim;	// bytes cut off the end
+	};
+	const Damage damages[] =
+	{
+		{ 0, 0, 0, 1 },	// table cut short
+		{ 0, 1, 0, 0 },	// tiles don't reach the far side
+		{ 0, 100, 0, 0 },	// more tiles than the map needs
+		{ 0xFFFFFFFF, 1, 1, 0 },	// one tile so large its byte count overflows
+	};
+	uint32_t acceptedCount = read ? 0 : 1;
+	const std::filesystem::path damagedPath = std::filesystem::temp_directory_path() / "TerrainBenchmarkDamaged.tiles";
+	for (const Damage& damage : damages)
+	{
+		std::vector<uint8_t> damaged(file.begin(), file.end() - damage.trim);
+		const uint32_t fields[] = { damage.tileSize, damage.tileRows, damage.tileColumns };
+		for (size_t i = 0; i < std::size(fields); ++i)
+		{
+			if (fields[i] != 0)
+			{
+				memcpy(damaged.data() + 16 + (i * sizeof(uint32_t)), &fields[i], sizeof(uint32_t));
+			}
+		}
+		FILE* target = nullptr;
+		fopen_s(&target, damagedPath.u8string().c_str(), "wb");
+		if (target != nullptr)
+		{
+			fwrite(damaged.data(), 1, damaged.size(), target);
+			fclose(target);
+		}
+		TerrainStreamer damagedStreamer;
+		acceptedCount += damagedStreamer.Initialize(damagedPath, settings) ? 1 : 0;
+	}
+
+	printf("  %-24s %10u of %u heights wrong, %u of %u vertices wrong, %u of %u damaged files accepted\n", "16 bit tiles",
+		mismatchCount, heightChecks, wrongVertexCount, vertexChecks, acceptedCount, static_cast<uint32_t>(std::size(damages)));
+	std::filesystem::remove(damagedPath);
+	std::filesystem::remove(tilePath);
+	return mismatchCount == 0 && wrongVertexCount == 0 && acceptedCount == 0;
+}
+
+// Flies the view in a circle over a map larger than the budget at 60 frames per second of real
+// time, so the workers stream against the clock the way they would in game
+bool RunStreaming(const Arguments& args)
+{
+	const uint32_t size = args.streamSize;
+	std::vector<uint8_t> samples;
+	GenerateHeightmap(size, samples);
+
+	const std::filesystem::path tilePath = std::filesystem::temp_directory_path() / "TerrainBenchmark.tiles";
+	bool written = false;
+	const double writeTime = MeasureSeconds([&]() { written = TerrainStreamer::WriteTiles(tilePath, samples.data(), size, size, args.maxHeight, args.tileSize); });
+	if (!written)
+	{
+		printf("\nStreaming: failed to write %s\n", tilePath.u8string().c_str());
+		return false;
+	}
+
+	TerrainStreamer::Settings settings;
+	settings.residentBudget = static_cast<size_t>(args.budget * 1024.0f * 1024.0f);
+	settings.loadRadius = args.loadRadius;
+	TerrainStreamer streamer;
+	if (!streamer.Initialize(tilePath, settings))
+	{
+		return false;
+	}
+
+	uint32_t loadedCount = 0;
+	uint32_t evictedCount = 0;
+	streamer.SetCallbacks([&loadedCount](const TerrainStreamer::Tile&) { ++loadedCount; }, [&evictedCount](const TerrainStreamer::Tile&) { ++evictedCount; });
+
+	const double megabyte = 1024.0 * 1024.0;
+	const uint32_t tileCount = streamer.GetTileRows() * streamer.GetTileColumns();
+	printf("\nStreaming %u x %u samples, %u tiles of %u cells (%.1f MB), budget %.1f MB, radius %.0f\n",
+		size, size, tileCount, args.tileSize, tileCount * streamer.GetTileBytes() / megabyte, args.budget, args.loadRadius);
+	Report("Write tiles", writeTime);
+
+	Random random;
+	const float extent = static_cast<float>(size - 1);
+	const float radius = extent * 0.35f;
+	const float frameTime = 1.0f / 60.0f;
+	const uint32_t frameCount = static_cast<uint32_t>(args.streamSeconds / frameTime);
+	uint32_t heightChecks = 0;
+	uint32_t mismatchCount = 0;
+	uint32_t overBudgetFrames = 0;
+	float peakLoadsPerSecond = 0.0f;
+	double totalUpdateTime = 0.0;
+
+	using Clock = std::chrono::steady_clock;
+	auto frameStart = Clock::now();
+	for (uint32_t frame = 0; frame < frameCount; ++frame)
+	{
+		const float angle = frame * frameTime * args.speed / radius;
+		const Vector3 viewPosition = { (extent * 0.5f) + (cosf(angle) * radius), 0.0f, (extent * 0.5f) + (sinf(angle) * radius) };
+		streamer.Update(viewPosition, frameTime);
+
+		const TerrainStreamer::Stats& stats = streamer.GetStats();
+		totalUpdateTime += stats.updateTime;
+		peakLoadsPerSecond = Max(peakLoadsPerSecond, stats.loadsPerSecond);
+		overBudgetFrames += (stats.residentBytes > settings.residentBudget) ? 1 : 0;
+
+		// Whatever is resident has to read back exactly what was written
+		for (uint32_t i = 0; i < 16; ++i)
+		{
+			const Vector3 position = { viewPosition.x + random.Range(-args.loadRadius, args.loadRadius), 0.0f, viewPosition.z + random.Range(-args.loadRadius, args.loadRadius) };
+			float height = 0.0f;
+			if (streamer.GetHeight(position, height))
+			{
+				++heightChecks;
+				mismatchCount += (height == GetSampleHeight(samples, size, args.maxHeight, position)) ? 0 : 1;
+			}
+		}
+
+		frameStart += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(frameTime));
+		std::this_thread::sleep_until(frameStart);
+	}
+
+	const TerrainStreamer::Stats stats = streamer.GetStats();
+	const bool consistent = (loadedCount - evictedCount) == stats.residentTiles && loadedCount == stats.totalLoads && evictedCount == stats.totalEvictions;
+	printf("  %-24s %10u frames, %.0f units travelled\n", "View", frameCount, frameCount * frameTime * args.speed);
+	printf("  %-24s %10u total, %.1f per second (peak %.1f), %.3f ms each on a worker\n", "Tile loads",
+		stats.totalLoads, stats.totalLoads / (frameCount * frameTime), peakLoadsPerSecond, stats.averageLoadTime);
+	printf("  %-24s %10u\n", "Tile evictions", stats.totalEvictions);
+	printf("  %-24s %10.2f MB now, %.2f MB peak, %u frames over budget\n", "Resident",
+		stats.residentBytes / megabyte, stats.peakResidentBytes / megabyte, overBudgetFrames);
+	printf("  %-24s %10.3f ms average, %.3f ms worst, %u hitches over %.1f ms\n", "Update",
+		totalUpdateTime / frameCount, stats.worstUpdateTime, stats.hitches, settings.hitchTime);
+	printf("  %-24s %10u frames with the tile under the view missing\n", "Misses", stats.misses);
+	printf("  %-24s %10u of %u heights wrong, callbacks %s\n", "Check", mismatchCount, heightChecks, consistent ? "consistent" : "FAILED");
+
+	streamer.Terminate();
+	std::filesystem::remove(tilePath);
+	const bool filesPassed = CheckTileFiles(args);
+	return mismatchCount == 0 && overBudgetFrames == 0 && consistent && evictedCount == loadedCount && filesPassed;
+}
+
+// Terrain::Initialize as it was: one fgetc per sample, normals straight up and indices pushed
+// back one at a time, with the bounds the mesh needs for culling
+void LegacyInitialize(const std::filesystem::path& fileName, float maxHeight, float tileCount, Mesh& mesh)
+{
+	FILE* file = nullptr;
+	fopen_s(&file, fileName.u8string().c_str(), "rb");
+	if (file == nullptr)
+	{
+		return;
+	}
+
+	fseek(file, 0L, SEEK_END);
+	const uint32_t fileSize = ftell(file);
+	const uint32_t dimensions = static_cast<uint32_t>(sqrt(static_cast<float>(fileSize)));
+	fseek(file, 0L, SEEK_SET);
+
+	const uint32_t rows = dimensions;
+	const uint32_t columns = dimensions;
+	mesh.vertices.resize(rows * columns);
+	for (uint32_t z = 0; z < rows; ++z)
+	{
+		for (uint32_t x = 0; x < columns; ++x)
+		{
+			const auto c = fgetc(file);
+			const float height = (c / 255.0f) * maxHeight;
+			Vertex& v = mesh.vertices[x + (z * columns)];
+			v.position = { static_cast<float>(x), height, static_cast<float>(z) };
+			v.normal = Vector3::YAxis;
+			v.tangent = Vector3::XAxis;
+			v.uvCoord.x = (static_cast<float>(x) / columns) * tileCount;
+			v.uvCoord.y = (static_cast<float>(z) / rows) * tileCount;
+		}
+	}
+	fclose(file);
+
+	mesh.indices.reserve((rows - 1) * (columns - 1) * 6);
+	for (uint32_t z = 0; z < rows - 1; ++z)
+	{
+		for (uint32_t x = 0; x < columns - 1; ++x)
+		{
+			const uint32_t bl = x + (z * columns);
+			const uint32_t tl = x + ((z + 1) * columns);
+			const uint32_t br = (x + 1) + (z * columns);
+			const uint32_t tr = (x + 1) + ((z + 1) * columns);
+			mesh.indices.push_back(bl);
+			mesh.indices.push_back(tl);
+			mesh.indices.push_back(tr);
+			mesh.indices.push_back(bl);
+			mesh.indices.push_back(tr);
+			mesh.indices.push_back(br);
+		}
+	}
+	mesh.ComputeBounds();
+}
+
+template<class Sample>
+bool WriteRaw(const std::filesystem::path& fileName, const std::vector<Sample>& samples)
+{
+	FILE* file = nullptr;
+	fopen_s(&file, fileName.u8string().c_str(), "wb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+	const size_t written = fwrite(samples.data(), sizeof(Sample), samples.size(), file);
+	fclose(file);
+	return written == samples.size();
+}
+
+bool RunIngest(const Arguments& args)
+{
+	constexpr float tileCount = 10.0f;
+	const std::filesystem::path rawPath = std::filesystem::temp_directory_path() / "TerrainBenchmark.raw";
+	const double megabyte = 1024.0 * 1024.0;
+	bool passed = true;
+
+	printf("\nHeightmap ingest, RAW file to a ready terrain\n");
+	printf("  %-12s %12s %12s %12s %10s %10s %12s %12s\n", "Size", "Legacy 8", "New 8", "New 16", "Speedup", "Wrong", "Legacy MB", "New MB");
+	for (uint32_t size = 1025; size <= args.ingestSize; size = ((size - 1) * 2) + 1)
+	{
+		std::vector<uint8_t> samples8;
+		std::vector<uint16_t> samples16;
+		GenerateHeightmap(size, samples8);
+		GenerateHeightmap(size, samples16);
+
+		// One terrain alive at a time, the legacy mesh of an 8k map is over 5 GB
+		double legacyTime = 0.0;
+		double newTime8 = 0.0;
+		double newTime16 = 0.0;
+		uint32_t wrongCount = 0;
+		size_t meshBytes = 0;
+		size_t terrainBytes = 0;
+		if (!WriteRaw(rawPath, samples8))
+		{
+			printf("  failed to write %s\n", rawPath.u8string().c_str());
+			return false;
+		}
+		{
+			Mesh mesh;
+			legacyTime = MeasureSeconds([&]() { LegacyInitialize(rawPath, args.maxHeight, tileCount, mesh); });
+			meshBytes = GetMeshBytes(mesh);
+		}
+		{
+			Terrain terrain;
+			newTime8 = MeasureSeconds([&]() { terrain.Initialize(rawPath, args.maxHeight, tileCount); });
+			wrongCount += CountWrongSamples(terrain, samples8, size, args.maxHeight, NormalTolerance);
+			terrainBytes = GetTerrainBytes(terrain);
+		}
+
+		if (!WriteRaw(rawPath, samples16))
+		{
+			printf("  failed to write %s\n", rawPath.u8string().c_str());
+			return false;
+		}
+		{
+			Terrain terrain;
+			newTime16 = MeasureSeconds([&]() { terrain.Initialize(rawPath, args.maxHeight, tileCount, Terrain::SampleFormat::UInt16); });
+			wrongCount += CountWrongSamples(terrain, samples16, size, args.maxHeight, NormalTolerance);
+		}
+
+		char sizeName[32];
+		snprintf(sizeName, sizeof(sizeName), "%u^2", size);
+		printf("  %-12s %9.1f ms %9.1f ms %9.1f ms %9.1fx %10u %12.1f %12.1f\n",
+			sizeName, 1000.0 * legacyTime, 1000.0 * newTime8, 1000.0 * newTime16, legacyTime / newTime8, wrongCount, meshBytes / megabyte, terrainBytes / megabyte);
+		passed &= wrongCount == 0;
+	}
+	printf("  New includes the height blocks and chunks the legacy path did not build\n");
+
+	std::filesystem::remove(rawPath);
+	return passed;
+}
+
+void ReportQueries(const char* name, double seconds, uint32_t queryCount)
+{
+	printf("  %-24s %10.2f M queries/s  %8.1f us per frame\n", name, queryCount / seconds / 1000000.0, 1000000.0 * seconds);
+}
+
+bool SameSample(const Terrain::GroundSample& a, const Terrain::GroundSample& b)
+{
+	return a.height == b.height && a.normal.x == b.normal.x && a.normal.y == b.normal.y && a.normal.z == b.normal.z && a.slope == b.slope && a.inside == b.inside;
+}
+
+// Agents scattered over the map and a little past its edges, snapped to the ground once a frame
+bool RunGround(const Arguments& args)
+{
+	std::vector<uint8_t> samples;
+	GenerateHeightmap(args.size, samples);
+	Terrain terrain;
+	terrain.Initialize(samples.data(), args.size, args.size, args.maxHeight, 10.0f);
+
+	const float extent = static_cast<float>(args.size - 1);
+	const float margin = extent * 0.05f;
+	bool passed = true;
+	printf("\nGround queries on %u x %u samples, %.0f%% of the agents past the edges\n", args.size, args.size,
+		100.0f * (1.0f - (extent * extent) / ((extent + (2.0f * margin)) * (extent + (2.0f * margin)))));
+	for (uint32_t agentCount = 1000; agentCount <= args.agentCount; agentCount *= 10)
+	{
+		Random random;
+		std::vector<Vector3> positions(agentCount);
+		for (Vector3& position : positions)
+		{
+			position = { random.Range(-margin, extent + margin), 0.0f, random.Range(-margin, extent + margin) };
+		}
+
+		// Enough frames for every count to run a few million queries
+		const uint32_t frameCount = Max(1u, 2000000u / agentCount);
+		std::vector<float> heights(agentCount);
+		std::vector<Terrain::GroundSample> triangleSamples(agentCount);
+		std::vector<Terrain::GroundSample> bilinearSamples(agentCount);
+		std::vector<Terrain::GroundSample> fallbackSamples(agentCount);
+		Terrain::GroundQuery triangleQuery;
+		Terrain::GroundQuery bilinearQuery;
+		bilinearQuery.interpolation = Terrain::Interpolation::Bilinear;
+		Terrain::GroundQuery fallbackQuery;
+		fallbackQuery.outOfBounds = Terrain::OutOfBounds::Fallback;
+		fallbackQuery.fallbackHeight = -1.0f;
+
+		// Seconds per frame, best of three runs
+		auto measureFrame = [frameCount](auto&& kernel)
+		{
+			double best = DBL_MAX;
+			for (int run = 0; run < 3; ++run)
+			{
+				best = Min(best, MeasureSeconds([&]()
+				{
+					for (uint32_t frame = 0; frame < frameCount; ++frame)
+					{
+						kernel();
+					}
+				}));
+			}
+			return best / frameCount;
+		};
+
+		const double heightTime = measureFrame([&]()
+		{
+			for (uint32_t i = 0; i < agentCount; ++i)
+			{
+				heights[i] = terrain.GetHeight(positions[i]);
+			}
+		});
+		// What gameplay code had to do for a normal: two more heights one sample away
+		std::vector<Vector3> differenceNormals(agentCount);
+		const double differenceTime = measureFrame([&]()
+		{
+			for (uint32_t i = 0; i < agentCount; ++i)
+			{
+				const float height = terrain.GetHeight(positions[i]);
+				const float heightX = terrain.GetHeight(positions[i] + Vector3::XAxis);
+				const float heightZ = terrain.GetHeight(positions[i] + Vector3::ZAxis);
+				differenceNormals[i] = Normalize(Vector3{ height - heightX, 1.0f, height - heightZ });
+			}
+		});
+		size_t insideCount = 0;
+		const double triangleTime = measureFrame([&]()
+		{
+			insideCount = terrain.GetGround(positions.data(), agentCount, triangleQuery, triangleSamples.data());
+		});
+		const double bilinearTime = measureFrame([&]()
+		{
+			terrain.GetGround(positions.data(), agentCount, bilinearQuery, bilinearSamples.data());
+		});
+		const size_t fallbackInsideCount = terrain.GetGround(positions.data(), agentCount, fallbackQuery, fallbackSamples.data());
+
+		// Clamped agents have to land on the ground at the closest point of the edge
+		std::vector<Vector3> clampedPositions(agentCount);
+		for (uint32_t i = 0; i < agentCount; ++i)
+		{
+			clampedPositions[i] = { Clamp(positions[i].x, 0.0f, extent), 0.0f, Clamp(positions[i].z, 0.0f, extent) };
+		}
+		std::vector<Terrain::GroundSample> clampedSamples(agentCount);
+		terrain.GetGround(clampedPositions.data(), agentCount, triangleQuery, clampedSamples.data());
+
+		uint32_t wrongCount = 0;
+		uint32_t rayChecks = 0;
+		size_t expectedInside = 0;
+		for (uint32_t i = 0; i < agentCount; ++i)
+		{
+			const Vector3& position = positions[i];
+			const Terrain::GroundSample& sample = triangleSamples[i];
+			const bool inside = position.x >= 0.0f && position.x <= extent && position.z >= 0.0f && position.z <= extent;
+			expectedInside += inside ? 1 : 0;
+
+			bool right = sample.inside == inside && fallbackSamples[i].inside == inside;
+			right &= clampedSamples[i].height == sample.height && clampedSamples[i].normal.y == sample.normal.y;
+			if (inside)
+			{
+				right &= SameSample(fallbackSamples[i], sample);
+				// GetHeight leaves out the far edges
+				right &= (position.x >= extent || position.z >= extent) || heights[i] == sample.height;
+			}
+			else
+			{
+				right &= fallbackSamples[i].height == fallbackQuery.fallbackHeight && fallbackSamples[i].normal.y == 1.0f && fallbackSamples[i].slope == 0.0f;
+			}
+
+			// The normal and height of the triangle a ray straight down hits
+			if (inside && rayChecks < 1000)
+			{
+				++rayChecks;
+				Terrain::RayHit hit;
+				const Ray ray = { { position.x, args.maxHeight * 2.0f, position.z }, { 0.0f, -1.0f, 0.0f } };
+				right &= terrain.RayCast(ray, args.maxHeight * 4.0f, hit) && SameDistance(hit.position.y, sample.height, 1e-4f) &&
+					SameDirection(hit.normal, sample.normal, NormalTolerance) && SameDistance(sample.slope, sqrtf(1.0f - (sample.normal.y * sample.normal.y)) / sample.normal.y, 1e-3f);
+			}
+			wrongCount += right ? 0 : 1;
+		}
+		const bool counted = insideCount == expectedInside && fallbackInsideCount == expectedInside;
+
+		printf("  %u agents, %zu on the map, %u frames\n", agentCount, insideCount, frameCount);
+		ReportQueries("GetHeight per agent", heightTime, agentCount);
+		ReportQueries("GetHeight x3 for normals", differenceTime, agentCount);
+		ReportQueries("GetGround triangle", triangleTime, agentCount);
+		ReportQueries("GetGround bilinear", bilinearTime, agentCount);
+		printf("  %-24s %10u of %u agents wrong, %u checked against a ray, inside count %s\n", "Check", wrongCount, agentCount, rayChecks, counted ? "right" : "WRONG");
+		passed &= wrongCount == 0 && counted;
+	}
+	return passed;
+}
+
+int main(int argc, char* argv[])
+{
+	const auto argOpt = parseArgs(argc, argv);
+	if (!argOpt.has_value())
+	{
+		printf("Usage: TerrainBenchmark [-size N] [-height H] [-rays N] [-brute N] [-threads N] [-tolerance T] [-lod D] [-selects N]\n"
+			"       [-stream N] [-tile N] [-budget MB] [-radius R] [-seconds S] [-speed S] [-ingest N] [-agents N]\n");
+		return -1;
+	}
+	const Arguments& args = argOpt.value();
+
+	Core::JobSystem::StaticInitialize(args.threadCount);
+	printf("%u rays, %u checked by brute force, %u worker threads\n", args.rayCount, args.bruteForceCount, Core::JobSystem::Get()->GetThreadCount());
+
+	bool passed = true;
+	passed &= RunTerrain(args);
+	passed &= RunMesh(args);
+	passed &= RunChunks(args);
+	if (args.streamSize != 0)
+	{
+		passed &= RunStreaming(args);
+	}
+	if (args.ingestSize != 0)
+	{
+		passed &= RunIngest(args);
+	}
+	if (args.agentCount != 0)
+	{
+		passed &= RunGround(args);
+	}
+
+	Core::JobSystem::StaticTerminate();
+	return passed ? 0 : -1;
+}
\ No newline at end of file
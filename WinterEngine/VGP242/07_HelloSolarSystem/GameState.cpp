@@ -4,6 +4,14 @@ using namespace WinterEngine;
 using namespace WinterEngine::Graphics;
 using namespace WinterEngine::Input;
 
+namespace
+{
+	Math::Quaternion RotationY(float angle)
+	{
+		return { 0.0f, sinf(angle * 0.5f), 0.0f, cosf(angle * 0.5f) };
+	}
+}
+
 void GameState::Initialize()
 {
 	mCamera.SetPosition({ 0.0f, 1.0f, -5.0f });
@@ -14,19 +22,29 @@ void GameState::Initialize()
 	mDirectionalLight.diffuse = { 0.7f, 0.7f, 0.7f, 1.0f };
 	mDirectionalLight.specular = { 0.9f, 0.9f, 0.9f, 1.0f };
 
+	TransformSystem* ts = TransformSystem::Get();
+	mEarthAnchorId = ts->Create();
+	mMoonOrbitId = ts->Create({}, mEarthAnchorId);
+
 	Mesh mesh = MeshBuilder::CreateSphere(100, 100, 1.0f);
-	float xPos = 0.0f;
-	for (int i = 0; i < 1; ++i)
-	{
-		RenderObject& planet = mPlanets.emplace_back();
-		planet.meshBuffer.Initialize(mesh);
-		planet.diffuseMapId = TextureCache::Get()->LoadTexture("planets/earth/earth.jpg");
-		planet.normalMapId = TextureCache::Get()->LoadTexture("planets/earth/earth_normal.jpg");
-		planet.specMapId = TextureCache::Get()->LoadTexture("planets/earth/earth_spec.jpg");
-		planet.bumpMapId = TextureCache::Get()->LoadTexture("planets/earth/earth_bump.jpg");
-		planet.transform.position.x = xPos;
-		++xPos;
-	}
+	RenderObject& earth = mPlanets.emplace_back();
+	earth.meshBuffer.Initialize(mesh);
+	earth.diffuseMapId = TextureCache::Get()->LoadTexture("planets/earth/earth.jpg");
+	earth.normalMapId = TextureCache::Get()->LoadTexture("planets/earth/earth_normal.jpg");
+	earth.specMapId = TextureCache::Get()->LoadTexture("planets/earth/earth_spec.jpg");
+	earth.bumpMapId = TextureCache::Get()->LoadTexture("planets/earth/earth_bump.jpg");
+	earth.transformId = ts->Create({}, mEarthAnchorId);
+
+	Transform moonLocal;
+	moonLocal.position = { 2.5f, 0.0f, 0.0f };
+	moonLocal.scale = { 0.27f, 0.27f, 0.27f };
+	RenderObject& moon = mPlanets.emplace_back();
+	moon.meshBuffer.Initialize(mesh);
+	moon.diffuseMapId = TextureCache::Get()->LoadTexture("planets/pluto.jpg");
+	moon.normalMapId = 0;
+	moon.specMapId = 0;
+	moon.bumpMapId = 0;
+	moon.transformId = ts->Create(moonLocal, mMoonOrbitId);
 
 	std::filesystem::path shaderFilePath = L"../../Assets/Shaders/CelShading.fx";
 	mStandardEffect.Initialize(shaderFilePath);
@@ -36,10 +54,14 @@ void GameState::Initialize()
 void GameState::Terminate()
 {
 	mStandardEffect.Terminate();
+	TransformSystem* ts = TransformSystem::Get();
 	for (RenderObject& planet : mPlanets)
 	{
+		ts->Destroy(planet.transformId);
 		planet.Terminate();
 	}
+	ts->Destroy(mMoonOrbitId);
+	ts->Destroy(mEarthAnchorId);
 }
 
 void GameState::Update(float deltaTime)
@@ -77,6 +99,13 @@ void GameState::Update(float deltaTime)
 		mCamera.Yaw(input->GetMouseMoveX() * turnSpeed * deltaTime);
 		mCamera.Pitch(input->GetMouseMoveY() * turnSpeed * deltaTime);
 	}
+
+	// Only local transforms change here, App updates the world matrices before rendering
+	mEarthSpin = fmodf(mEarthSpin + 0.5f * deltaTime, Math::Constants::TwoPi);
+	mMoonOrbit = fmodf(mMoonOrbit + 0.2f * deltaTime, Math::Constants::TwoPi);
+	TransformSystem* ts = TransformSystem::Get();
+	ts->SetRotation(mPlanets[0].transformId, RotationY(mEarthSpin));
+	ts->SetRotation(mMoonOrbitId, RotationY(mMoonOrbit));
 }
 void GameState::Render()
 {
@@ -102,6 +131,15 @@ void GameState::DebugUI()
 			ImGui::ColorEdit4("Diffuse##Light", &mDirectionalLight.diffuse.r);
 			ImGui::ColorEdit4("Specular##Light", &mDirectionalLight.specular.r);
 		}
+		if (ImGui::CollapsingHeader("Earth", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			Transform anchor = TransformSystem::Get()->GetLocal(mEarthAnchorId);
+			if (ImGui::DragFloat3("Position##Earth", &anchor.position.x, 0.1f))
+			{
+				TransformSystem::Get()->SetLocal(mEarthAnchorId, anchor);
+			}
+			ImGui::Text("Transforms updated: %u / %u", TransformSystem::Get()->GetLastUpdateCount(), TransformSystem::Get()->GetTransformCount());
+		}
 		if (ImGui::CollapsingHeader("Material", ImGuiTreeNodeFlags_DefaultOpen))
 		{
 			ImGui::ColorEdit4("Ambient##Material", &mPlanets[0].material.ambient.r);
@@ -15,6 +15,12 @@ protected:
 	WinterEngine::Graphics::Camera mCamera;
 	std::vector<WinterEngine::Graphics::RenderObject> mPlanets;
 
+	// Earth and the moon's orbit hang off the same anchor so moving it carries both
+	WinterEngine::Graphics::TransformId mEarthAnchorId = 0;
+	WinterEngine::Graphics::TransformId mMoonOrbitId = 0;
+	float mEarthSpin = 0.0f;
+	float mMoonOrbit = 0.0f;
+
 	WinterEngine::Graphics::StandardEffect mStandardEffect;
 	WinterEngine::Graphics::DirectionalLight mDirectionalLight;
 };
\ No newline at end of file
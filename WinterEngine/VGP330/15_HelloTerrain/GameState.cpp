@@ -23,11 +23,16 @@ void GameState::Initialize()
 	mTerrainEffect.SetCamera(mCamera);
 	mTerrainEffect.SetDirectionalLight(mDirectionalLight);
 
-	mCharacter.Initialize(L"../../Assets/Models/Character01/Nightshade_J_Friedrich.model");
+	mCharacter.InitializeStreamed(L"../../Assets/Models/Character01/Nightshade_J_Friedrich.model");
 
 	mTerrain.Initialize(L"../../Assets/Images/terrain/heightmap_512x512.raw", 20.0f, 10.0f);
 
-	mGround.meshBuffer.Initialize(mTerrain.GetMesh());
+	mTerrainEffect.SetTerrain(mTerrain);
+
+	const std::vector<TerrainVertex>& terrainVertices = mTerrain.GetVertices();
+	const std::vector<uint32_t>& chunkIndices = mTerrain.GetChunkIndices();
+	mGround.meshBuffer.Initialize(terrainVertices.data(), sizeof(TerrainVertex), static_cast<uint32_t>(terrainVertices.size()),
+		chunkIndices.data(), static_cast<uint32_t>(chunkIndices.size()));
 	mGround.diffuseMapId = TextureCache::Get()->LoadTexture("terrain/dirt_seamless.jpg");
 	mGround.normalMapId = TextureCache::Get()->LoadTexture("terrain/grass_2048.jpg");
 }
@@ -41,6 +46,8 @@ void GameState::Terminate()
 
 void GameState::Update(float deltaTime)
 {
+	mCharacter.StreamMeshes();
+
 	auto input = Input::InputSystem::Get();
 	const float moveSpeed = input->IsKeyDown(KeyCode::LSHIFT) ? 10.0f : 1.0f;
 	const float turnSpeed = 0.1f;
@@ -79,6 +86,8 @@ void GameState::Update(float deltaTime)
 	float height = mTerrain.GetHeight(camPos);
 	camPos.y = height + 1.5f;
 	mCamera.SetPosition(camPos);
+
+	mTerrain.SelectChunks(mCamera.GetFrustum(), mCamera.GetPosition(), mChunkSelection);
 }
 void GameState::Render()
 {
@@ -87,7 +96,7 @@ void GameState::Render()
 	mStandardEffect.End();
 	
 	mTerrainEffect.Begin();
-		mTerrainEffect.Render(mGround);
+		mTerrainEffect.Render(mGround, mChunkSelection);
 	mTerrainEffect.End();
 }
 
@@ -108,5 +117,15 @@ void GameState::DebugUI()
 	ImGui::Separator();
 	mStandardEffect.DebugUI();
 	mTerrainEffect.DebugUI();
+	if (ImGui::CollapsingHeader("Terrain", ImGuiTreeNodeFlags_DefaultOpen))
+	{
+		float lodDistance = mTerrain.GetLodDistance();
+		if (ImGui::DragFloat("LodDistance", &lodDistance, 1.0f, 1.0f, 1000.0f))
+		{
+			mTerrain.SetLodDistance(lodDistance);
+		}
+		ImGui::Text("Chunks: %u visible of %u", mChunkSelection.visibleChunks, mTerrain.GetChunkCount());
+		ImGui::Text("Triangles: %u of %u", mChunkSelection.triangleCount, mTerrain.GetTriangleCount());
+	}
 	ImGui::End();
 }
\ No newline at end of file
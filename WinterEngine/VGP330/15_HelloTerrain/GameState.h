@@ -19,6 +19,7 @@ protected:
 	WinterEngine::Graphics::TerrainEffect mTerrainEffect;
 
 	WinterEngine::Graphics::Terrain mTerrain;
+	WinterEngine::Graphics::Terrain::ChunkSelection mChunkSelection;
 	WinterEngine::Graphics::RenderGroup mCharacter;
 	WinterEngine::Graphics::RenderObject mGround;
 };
\ No newline at end of file
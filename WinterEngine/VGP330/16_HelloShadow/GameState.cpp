@@ -24,15 +24,26 @@ void GameState::Initialize()
 	mShadowEffect.Initialize();
 	mShadowEffect.SetDirectionalLight(mDirectionalLight);
 	
-	mCharacter.Initialize(L"../../Assets/Models/Character01/Nightshade_J_Friedrich.model");
+	mCharacter.InitializeAsync(L"../../Assets/Models/Character01/Nightshade_J_Friedrich.model");
 
 	Mesh sphere = MeshBuilder::CreateSphere(100, 100, 1.0f);
 	mSphere.meshBuffer.Initialize(sphere);
+	mSphere.aabb = sphere.aabb;
+	mSphere.boundingSphere = sphere.boundingSphere;
 	mSphere.transform.position = { 2.0f, 2.0f, 1.0f };
 
 	Mesh groundMesh = MeshBuilder::CreateGroundPlane(10, 10, 1.0f);
 	mGround.meshBuffer.Initialize(groundMesh);
-	mGround.diffuseMapId = TextureCache::Get()->LoadTexture("misc/concrete.jpg");
+	mGround.aabb = groundMesh.aabb;
+	mGround.boundingSphere = groundMesh.boundingSphere;
+	mGround.diffuseMapId = TextureCache::Get()->LoadTextureAsync("misc/concrete.jpg");
+
+	// Only casters go into the shadow pass
+	mShadowCulling.Add(mCharacter);
+	mShadowCulling.Add(mSphere);
+	mCameraCulling.Add(mCharacter);
+	mCameraCulling.Add(mSphere);
+	mCameraCulling.Add(mGround);
 }
 void GameState::Terminate()
 {
@@ -45,6 +56,8 @@ void GameState::Terminate()
 
 void GameState::Update(float deltaTime)
 {
+	mCharacter.StreamMeshes();
+
 	auto input = Input::InputSystem::Get();
 	const float moveSpeed = input->IsKeyDown(KeyCode::LSHIFT) ? 10.0f : 1.0f;
 	const float turnSpeed = 0.1f;
@@ -78,19 +91,24 @@ void GameState::Update(float deltaTime)
 		mCamera.Yaw(input->GetMouseMoveX() * turnSpeed * deltaTime);
 		mCamera.Pitch(input->GetMouseMoveY() * turnSpeed * deltaTime);
 	}
+
+	// Shadow map only needs to cover the casters, the character grows as its meshes stream in
+	if (mFitShadowToCasters)
+	{
+		mShadowEffect.FitToBounds(Math::Merge(mCharacter.GetWorldSphere(), mSphere.GetWorldSphere()));
+	}
 }
 void GameState::Render()
 {
 	//Only objects that cast shadows
 	mShadowEffect.Begin();
-		mShadowEffect.Render(mCharacter);
-		mShadowEffect.Render(mSphere);
+		mShadowCulling.Cull(mShadowEffect.GetLightCamera());
+		mShadowEffect.Render(mShadowCulling);
 	mShadowEffect.End();
 
+	mCameraCulling.Cull(mCamera);
 	mStandardEffect.Begin();
-		mStandardEffect.Render(mCharacter);
-		mStandardEffect.Render(mSphere);
-		mStandardEffect.Render(mGround);
+		mStandardEffect.Render(mCameraCulling);
 	mStandardEffect.End();
 }
 
@@ -109,6 +127,10 @@ void GameState::DebugUI()
 		ImGui::ColorEdit4("Specular##Light", &mDirectionalLight.specular.r);
 	}
 	mStandardEffect.DebugUI();
+	ImGui::Checkbox("FitShadowToCasters", &mFitShadowToCasters);
 	mShadowEffect.DebugUI();
+	mShadowCulling.DebugUI("ShadowCulling");
+	mCameraCulling.DebugUI("CameraCulling");
+	GraphicsSystem::Get()->DebugUI();
 	ImGui::End();
 }
\ No newline at end of file
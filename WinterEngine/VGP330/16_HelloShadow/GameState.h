@@ -17,8 +17,12 @@ protected:
 	
 	WinterEngine::Graphics::StandardEffect mStandardEffect;
 	WinterEngine::Graphics::ShadowEffect mShadowEffect;
+	WinterEngine::Graphics::CullingPass mShadowCulling;
+	WinterEngine::Graphics::CullingPass mCameraCulling;
 
 	WinterEngine::Graphics::RenderObject mSphere;
 	WinterEngine::Graphics::RenderGroup mCharacter;
 	WinterEngine::Graphics::RenderObject mGround;
+
+	bool mFitShadowToCasters = true;
 };
\ No newline at end of file